@@ -9,6 +9,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Includes
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <InternalFileSystem.h> // Load dependency library
 
@@ -23,6 +25,47 @@ typedef struct ralf_s ralf_t;
 
 class LbmWm1110
 {
+public:
+    enum class BatteryInput
+    {
+        VDD,    // Default
+        VDDH,
+        AIN0,
+        AIN1,
+        AIN2,
+        AIN3,
+        AIN4,
+        AIN5,
+        AIN6,
+        AIN7,
+    };
+
+    struct BatteryCurvePoint
+    {
+        uint16_t millivolts;
+        uint8_t percent;
+    };
+
+    struct CrashRecord
+    {
+        uint32_t resetReason;       // nRF RESETREAS of the reset following the fault
+        uint32_t uptimeSeconds;     // Uptime at the fault, 0xffffffff if unknown
+        uint8_t supervisorTask;     // Last task launched by the modem supervisor, 0xff if unknown
+        uint8_t radioPlannerHook;   // Radio planner hook owning the radio, 0xff if unknown
+        uint8_t watchdogClient;     // Starved context: supervisor, radio planner, GNSS, Wi-Fi, transceiver, app, transceiver from an interrupt from 0, 0xff if unknown
+        uint16_t line;              // Assert line, 0 if unknown
+        char function[21];          // Assert function, empty if unknown
+    };
+
+    enum class RadioUpdateResult
+    {
+        OK,
+        SOURCE_ERROR,       // Image size invalid or image read failed
+        BOOTLOADER_ERROR,   // Transceiver bootloader failed or rejected the image
+        IMAGE_MISMATCH,     // Image does not match the expected crc32
+        VERSION_MISMATCH,   // New firmware does not report the expected version
+    };
+
 private:
     static LbmWm1110* instance_;
 
@@ -40,7 +83,22 @@ public:
     static void begin();
     static ralf_t* getRadio();
     static void startWatchdog();
-    static void reloadWatchdog();
+    static void reloadWatchdog();   // Call from loop() only. Feeds the watchdog only while the modem, the radio and the scans are alive too
+
+    static size_t getCrashLog(CrashRecord* records, size_t count);  // Newest first, available after begin()
+    static void clearCrashLog();
+
+    static void getRngStats(uint32_t* poolHits, uint32_t* poolStalls);  // Random words served from the pool, and those which waited for the generator
+
+    static void setTelemetryMaxAge(uint32_t seconds);
+    static void setBatteryInput(BatteryInput input, float dividerRatio = 1.0f);
+    static void setBatteryCurve(const BatteryCurvePoint* curve, size_t count);  // Ordered by decreasing voltage, not copied
+    static void setBatteryModel(const std::function<uint8_t(uint16_t millivolts)>& model);  // Returns percent, or 0xff if unknown
+
+    // Transceiver firmware update, call before the modem is initialized. imageCrc is the crc32 of the whole image.
+    // An interrupted update of the same image resumes where it stopped.
+    static RadioUpdateResult updateRadioFirmware(const uint32_t* image, size_t words, uint32_t imageCrc, uint16_t firmwareVersion, const std::function<void(uint32_t written, uint32_t total)>& progress = nullptr);
+    static RadioUpdateResult updateRadioFirmware(const std::function<bool(uint32_t offset, void* buffer, size_t size)>& read, uint32_t imageSize, uint32_t imageCrc, uint16_t firmwareVersion, const std::function<void(uint32_t written, uint32_t total)>& progress = nullptr);
 
 };
 
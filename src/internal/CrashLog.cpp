@@ -0,0 +1,174 @@
+/*
+ * CrashLog.cpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "CrashLog.hpp"
+#include <cstring>
+#include "internal/nrf_hal/flash.hpp"
+#include "internal/nrf_hal/system.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Types
+
+// Fault context kept in RAM until the reset, the record is written to flash on the next boot
+struct CrashContext
+{
+    uint32_t magic;
+    uint32_t uptimeSeconds;
+    uint16_t line;
+    uint8_t supervisorTask;
+    uint8_t radioPlannerHook;
+    uint8_t watchdogClient;
+    char function[CrashLog::FUNCTION_LENGTH];
+    uint32_t magicInverted;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+
+static constexpr uint32_t CRASH_CONTEXT_MAGIC = 0x43524153; // "CRAS"
+static constexpr uint32_t EMPTY_SEQUENCE = 0xffffffff;
+
+// Not initialized by the startup code, retained across software and watchdog resets
+static CrashContext Context __attribute__((section(".noinit")));
+
+////////////////////////////////////////////////////////////////////////////////
+// CrashLog
+
+CrashLog::CrashLog() :
+    page_{ 0 }
+{
+    memset(records_, 0xff, sizeof(records_));
+}
+
+void CrashLog::begin(uint32_t page)
+{
+    page_ = page;
+    nrf_hal::Flash::read(page_, records_, sizeof(records_));
+
+    const uint32_t resetReason = nrf_hal::System::getResetReason();
+    nrf_hal::System::clearResetReason(resetReason);
+
+    const bool captured = Context.magic == CRASH_CONTEXT_MAGIC && Context.magicInverted == ~CRASH_CONTEXT_MAGIC;
+    Context.magic = 0;
+
+    // Power-on and brown-out resets cannot be told apart, and a software reset is only a fault after a capture
+    const bool fault = (resetReason & (POWER_RESETREAS_DOG_Msk | POWER_RESETREAS_LOCKUP_Msk)) != 0 ||
+                       ((resetReason & POWER_RESETREAS_SREQ_Msk) != 0 && captured);
+    if (!fault) return;
+
+    const int newest = findNewest();
+    const uint32_t sequence = newest < 0 ? 0 : records_[newest].sequence + 1;
+
+    Record& record = records_[sequence % RECORD_COUNT];
+    memset(&record, 0xff, sizeof(record));
+    record.sequence = sequence;
+    record.resetReason = resetReason;
+    if (captured)
+    {
+        record.uptimeSeconds = Context.uptimeSeconds;
+        record.line = Context.line;
+        record.supervisorTask = Context.supervisorTask;
+        record.radioPlannerHook = Context.radioPlannerHook;
+        record.watchdogClient = Context.watchdogClient;
+        memcpy(record.function, Context.function, sizeof(record.function));
+    }
+    else
+    {
+        record.line = 0;
+        memset(record.function, 0, sizeof(record.function));
+    }
+
+    store();
+}
+
+void CrashLog::capture(const char* function, uint32_t line, uint32_t uptimeSeconds, uint8_t supervisorTask, uint8_t radioPlannerHook, uint8_t watchdogClient)
+{
+    memset(Context.function, 0, sizeof(Context.function));
+    if (function != nullptr) strncpy(Context.function, function, sizeof(Context.function));
+
+    Context.uptimeSeconds = uptimeSeconds;
+    Context.line = line <= UINT16_MAX ? line : UINT16_MAX;
+    Context.supervisorTask = supervisorTask;
+    Context.radioPlannerHook = radioPlannerHook;
+    Context.watchdogClient = watchdogClient;
+    Context.magicInverted = ~CRASH_CONTEXT_MAGIC;
+    Context.magic = CRASH_CONTEXT_MAGIC;
+}
+
+bool CrashLog::isReportPending() const
+{
+    for (const Record& record : records_)
+    {
+        if (record.sequence != EMPTY_SEQUENCE && record.reported == 0xff) return true;
+    }
+
+    return false;
+}
+
+void CrashLog::setReported()
+{
+    if (!isReportPending()) return;
+
+    for (Record& record : records_)
+    {
+        if (record.sequence != EMPTY_SEQUENCE) record.reported = 0;
+    }
+
+    store();
+}
+
+size_t CrashLog::read(Record* records, size_t count) const
+{
+    if (records == nullptr) abort();
+
+    const int newest = findNewest();
+    if (newest < 0) return 0;
+
+    // Newest first
+    size_t n = 0;
+    for (uint32_t sequence = records_[newest].sequence; n < count && n < RECORD_COUNT; --sequence)
+    {
+        const Record& record = records_[sequence % RECORD_COUNT];
+        if (record.sequence != sequence) break;
+
+        records[n++] = record;
+        if (sequence == 0) break;
+    }
+
+    return n;
+}
+
+void CrashLog::clear()
+{
+    if (findNewest() < 0) return;
+
+    memset(records_, 0xff, sizeof(records_));
+    store();
+}
+
+int CrashLog::findNewest() const
+{
+    int newest = -1;
+    for (size_t i = 0; i < RECORD_COUNT; ++i)
+    {
+        if (records_[i].sequence == EMPTY_SEQUENCE) continue;
+        if (newest < 0 || records_[i].sequence > records_[newest].sequence) newest = i;
+    }
+
+    return newest;
+}
+
+void CrashLog::store()
+{
+    if (page_ == 0) abort();    // begin() not called
+
+    nrf_hal::Flash::write(page_, records_, sizeof(records_));
+}
+
+////////////////////////////////////////////////////////////////////////////////
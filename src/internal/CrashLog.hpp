@@ -0,0 +1,61 @@
+/*
+ * CrashLog.hpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////
+// CrashLog
+
+class CrashLog
+{
+public:
+    static constexpr size_t RECORD_COUNT = 8;
+    static constexpr size_t FUNCTION_LENGTH = 20;
+    static constexpr uint8_t UNKNOWN_ID = 0xff;
+
+    struct Record
+    {
+        uint32_t sequence;                  // Record number, 0xffffffff for an empty slot
+        uint32_t resetReason;               // nRF RESETREAS of the reset following the fault
+        uint32_t uptimeSeconds;             // Uptime at the fault, 0xffffffff if unknown
+        uint16_t line;                      // Assert line, 0 if unknown
+        uint8_t supervisorTask;             // Last task launched by the modem supervisor, UNKNOWN_ID if unknown
+        uint8_t radioPlannerHook;           // Radio planner hook owning the radio, UNKNOWN_ID if unknown
+        uint8_t reported;                   // 0xff until sent through DM_INFO_CRASHLOG
+        char function[FUNCTION_LENGTH];     // Assert function, not null terminated when FUNCTION_LENGTH long
+        uint8_t watchdogClient;             // Watchdog client which starved, UNKNOWN_ID if unknown
+        uint8_t rfu[2];
+    };
+
+private:
+    uint32_t page_;
+    Record records_[RECORD_COUNT];
+
+public:
+    CrashLog();
+
+    void begin(uint32_t page);
+
+    static void capture(const char* function, uint32_t line, uint32_t uptimeSeconds, uint8_t supervisorTask, uint8_t radioPlannerHook, uint8_t watchdogClient);
+
+    bool isReportPending() const;
+    void setReported();
+    size_t read(Record* records, size_t count) const;
+    void clear();
+
+private:
+    int findNewest() const;
+    void store();
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
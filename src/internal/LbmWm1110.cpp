@@ -9,6 +9,8 @@
 
 #include "LbmWm1110.hpp"
 #include "Wm1110Hardware.hpp"
+#include "internal/nrf_hal/saadc.hpp"
+#include <cstring>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Variables
@@ -54,12 +56,118 @@ ralf_t* LbmWm1110::getRadio()
 
 void LbmWm1110::startWatchdog()
 {
-    Wm1110Hardware::getInstance().wdt.begin();
+    Wm1110Hardware::getInstance().startWatchdog();
 }
 
 void LbmWm1110::reloadWatchdog()
 {
-    Wm1110Hardware::getInstance().wdt.reload();
+    Wm1110Hardware::getInstance().reloadWatchdog();
+}
+
+size_t LbmWm1110::getCrashLog(CrashRecord* records, size_t count)
+{
+    if (records == nullptr) abort();
+
+    CrashLog::Record record[CrashLog::RECORD_COUNT];
+    const size_t recordCount = Wm1110Hardware::getInstance().crashLog.read(record, CrashLog::RECORD_COUNT);
+
+    size_t n = 0;
+    for (; n < count && n < recordCount; ++n)
+    {
+        records[n].resetReason = record[n].resetReason;
+        records[n].uptimeSeconds = record[n].uptimeSeconds;
+        records[n].supervisorTask = record[n].supervisorTask;
+        records[n].radioPlannerHook = record[n].radioPlannerHook;
+        records[n].watchdogClient = record[n].watchdogClient;
+        records[n].line = record[n].line;
+        memset(records[n].function, 0, sizeof(records[n].function));
+        memcpy(records[n].function, record[n].function, CrashLog::FUNCTION_LENGTH);
+    }
+
+    return n;
+}
+
+void LbmWm1110::clearCrashLog()
+{
+    Wm1110Hardware::getInstance().crashLog.clear();
+}
+
+void LbmWm1110::getRngStats(uint32_t* poolHits, uint32_t* poolStalls)
+{
+    if (poolHits == nullptr || poolStalls == nullptr) abort();
+
+    *poolHits = Wm1110Hardware::getInstance().rng.getPoolHits();
+    *poolStalls = Wm1110Hardware::getInstance().rng.getPoolStalls();
+}
+
+void LbmWm1110::setTelemetryMaxAge(uint32_t seconds)
+{
+    Wm1110Hardware::getInstance().telemetry.setMaxAge(seconds);
+}
+
+void LbmWm1110::setBatteryInput(BatteryInput input, float dividerRatio)
+{
+    uint32_t saadcInput;
+    switch (input)
+    {
+    case BatteryInput::VDD:
+        saadcInput = nrf_hal::Saadc::INPUT_VDD;
+        break;
+    case BatteryInput::VDDH:
+        saadcInput = nrf_hal::Saadc::INPUT_VDDHDIV5;
+        break;
+    default:
+        saadcInput = nrf_hal::Saadc::INPUT_AIN0 + static_cast<int>(input) - static_cast<int>(BatteryInput::AIN0);
+        break;
+    }
+
+    Wm1110Hardware::getInstance().telemetry.setBatteryInput(saadcInput, dividerRatio);
+}
+
+void LbmWm1110::setBatteryCurve(const BatteryCurvePoint* curve, size_t count)
+{
+    if (curve == nullptr || count <= 0) abort();
+
+    Wm1110Hardware::getInstance().telemetry.setBatteryModel([curve, count](uint16_t millivolts)
+    {
+        return Telemetry::interpolate(curve, count, millivolts);
+    });
+}
+
+void LbmWm1110::setBatteryModel(const std::function<uint8_t(uint16_t millivolts)>& model)
+{
+    Wm1110Hardware::getInstance().telemetry.setBatteryModel(model);
+}
+
+LbmWm1110::RadioUpdateResult LbmWm1110::updateRadioFirmware(const uint32_t* image, size_t words, uint32_t imageCrc, uint16_t firmwareVersion, const std::function<void(uint32_t written, uint32_t total)>& progress)
+{
+    if (image == nullptr) abort();
+
+    return updateRadioFirmware([image, words](uint32_t offset, void* buffer, size_t size)
+    {
+        if (offset + size > words * sizeof(uint32_t)) return false;
+        memcpy(buffer, reinterpret_cast<const uint8_t*>(image) + offset, size);
+        return true;
+    }, words * sizeof(uint32_t), imageCrc, firmwareVersion, progress);
+}
+
+LbmWm1110::RadioUpdateResult LbmWm1110::updateRadioFirmware(const std::function<bool(uint32_t offset, void* buffer, size_t size)>& read, uint32_t imageSize, uint32_t imageCrc, uint16_t firmwareVersion, const std::function<void(uint32_t written, uint32_t total)>& progress)
+{
+    const Lr11xxUpdater::Result result = Wm1110Hardware::getInstance().updateRadioFirmware(read, imageSize, imageCrc, firmwareVersion, progress);
+
+    switch (result)
+    {
+    case Lr11xxUpdater::Result::OK:
+        return RadioUpdateResult::OK;
+    case Lr11xxUpdater::Result::SOURCE_ERROR:
+        return RadioUpdateResult::SOURCE_ERROR;
+    case Lr11xxUpdater::Result::IMAGE_MISMATCH:
+        return RadioUpdateResult::IMAGE_MISMATCH;
+    case Lr11xxUpdater::Result::VERSION_MISMATCH:
+        return RadioUpdateResult::VERSION_MISMATCH;
+    default:
+        return RadioUpdateResult::BOOTLOADER_ERROR;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
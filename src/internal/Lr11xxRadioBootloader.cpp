@@ -0,0 +1,72 @@
+/*
+ * Lr11xxRadioBootloader.cpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "Lr11xxUpdater.hpp"
+#include <cstdlib>
+#include "internal/nrf_hal/system.hpp"
+#include "internal/Wm1110Hardware.hpp"
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_bootloader.h"
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_system.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Lr11xxUpdater::RadioBootloader
+
+bool Lr11xxUpdater::RadioBootloader::enter()
+{
+    Wm1110Hardware& hardware = Wm1110Hardware::getInstance();
+    hardware.enterBootloaderMode();
+
+    lr11xx_bootloader_stat1_t stat1;
+    lr11xx_bootloader_stat2_t stat2;
+    lr11xx_bootloader_irq_mask_t irqStatus;
+    if (lr11xx_bootloader_get_status(&hardware, &stat1, &stat2, &irqStatus) != LR11XX_STATUS_OK) return false;
+
+    return !stat2.is_running_from_flash;
+}
+
+bool Lr11xxUpdater::RadioBootloader::erase()
+{
+    return lr11xx_bootloader_erase_flash(&Wm1110Hardware::getInstance()) == LR11XX_STATUS_OK;
+}
+
+bool Lr11xxUpdater::RadioBootloader::write(uint32_t offset, const uint32_t* words, size_t count)
+{
+    if (count > BLOCK_WORDS) abort();
+
+    // The command returns as soon as it is sent, the next command waits for BUSY
+    return lr11xx_bootloader_write_flash_encrypted(&Wm1110Hardware::getInstance(), offset, words, static_cast<uint8_t>(count)) == LR11XX_STATUS_OK;
+}
+
+bool Lr11xxUpdater::RadioBootloader::reboot()
+{
+    if (lr11xx_bootloader_reboot(&Wm1110Hardware::getInstance(), false) != LR11XX_STATUS_OK) return false;
+
+    nrf_hal::System::delayMs(200);  // Let the bootloader check the image and start the firmware
+
+    return true;
+}
+
+bool Lr11xxUpdater::RadioBootloader::getFirmwareVersion(uint16_t* version)
+{
+    Wm1110Hardware& hardware = Wm1110Hardware::getInstance();
+
+    lr11xx_bootloader_stat1_t stat1;
+    lr11xx_bootloader_stat2_t stat2;
+    lr11xx_bootloader_irq_mask_t irqStatus;
+    if (lr11xx_bootloader_get_status(&hardware, &stat1, &stat2, &irqStatus) != LR11XX_STATUS_OK) return false;
+    if (!stat2.is_running_from_flash) return false;    // Image rejected, still in the bootloader
+
+    lr11xx_system_version_t systemVersion;
+    if (lr11xx_system_get_version(&hardware, &systemVersion) != LR11XX_STATUS_OK) return false;
+    *version = systemVersion.fw;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,130 @@
+/*
+ * Lr11xxUpdater.cpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "Lr11xxUpdater.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include "internal/nrf_hal/flash.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Lr11xxUpdater
+
+Lr11xxUpdater::Lr11xxUpdater(Bootloader& bootloader, uint32_t page) :
+    bootloader_{ bootloader },
+    page_{ page }
+{
+}
+
+Lr11xxUpdater::Result Lr11xxUpdater::update(const Source& source, uint32_t imageSize, uint32_t imageCrc, uint16_t firmwareVersion, const Progress& progress)
+{
+    if (!source) abort();
+    if (imageSize <= 0 || imageSize % sizeof(uint32_t) != 0) return Result::SOURCE_ERROR;
+
+    Checkpoint checkpoint;
+    if (!loadCheckpoint(&checkpoint) || checkpoint.imageSize != imageSize || checkpoint.imageCrc != imageCrc || checkpoint.offset > imageSize || checkpoint.offset % sizeof(uint32_t) != 0)
+    {
+        checkpoint = Checkpoint{ CHECKPOINT_MAGIC, imageSize, imageCrc, 0, 0, 0 };
+    }
+
+    if (!bootloader_.enter()) return Result::BOOTLOADER_ERROR;
+    if (checkpoint.offset <= 0)
+    {
+        if (!bootloader_.erase()) return Result::BOOTLOADER_ERROR;
+        storeCheckpoint(&checkpoint);
+    }
+
+    // Two buffers, the next block is read and hashed while the transceiver programs the current one
+    uint32_t block[2][BLOCK_WORDS];
+    int current = 0;
+    uint32_t offset = checkpoint.offset;
+    uint32_t crc = checkpoint.crc;
+
+    uint32_t blockSize = std::min<uint32_t>(sizeof(block[0]), imageSize - offset);
+    if (offset < imageSize && !source(offset, block[current], blockSize)) return Result::SOURCE_ERROR;
+
+    while (offset < imageSize)
+    {
+        if (!bootloader_.write(offset, block[current], blockSize / sizeof(uint32_t))) return Result::BOOTLOADER_ERROR;
+
+        // The write command is only accepted once the previous block is programmed
+        if (offset - checkpoint.offset >= CHECKPOINT_INTERVAL)
+        {
+            checkpoint.offset = offset;
+            checkpoint.crc = crc;
+            storeCheckpoint(&checkpoint);
+        }
+
+        crc = crc32(crc, block[current], blockSize);
+        offset += blockSize;
+        current ^= 1;
+
+        if (offset < imageSize)
+        {
+            blockSize = std::min<uint32_t>(sizeof(block[0]), imageSize - offset);
+            if (!source(offset, block[current], blockSize)) return Result::SOURCE_ERROR;
+        }
+
+        if (progress) progress(offset, imageSize);
+    }
+
+    if (crc != imageCrc)
+    {
+        clearCheckpoint();
+        return Result::IMAGE_MISMATCH;
+    }
+
+    if (!bootloader_.reboot()) return Result::BOOTLOADER_ERROR;
+
+    uint16_t version;
+    const bool running = bootloader_.getFirmwareVersion(&version);
+    clearCheckpoint();
+    if (!running) return Result::BOOTLOADER_ERROR;
+    if (version != firmwareVersion) return Result::VERSION_MISMATCH;
+
+    return Result::OK;
+}
+
+uint32_t Lr11xxUpdater::crc32(uint32_t crc, const void* data, size_t size)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+bool Lr11xxUpdater::loadCheckpoint(Checkpoint* checkpoint) const
+{
+    nrf_hal::Flash::read(page_, checkpoint, sizeof(*checkpoint));
+    if (checkpoint->magic != CHECKPOINT_MAGIC) return false;
+
+    return checkpoint->check == ~(checkpoint->magic ^ checkpoint->imageSize ^ checkpoint->imageCrc ^ checkpoint->offset ^ checkpoint->crc);
+}
+
+void Lr11xxUpdater::storeCheckpoint(Checkpoint* checkpoint)
+{
+    checkpoint->check = ~(checkpoint->magic ^ checkpoint->imageSize ^ checkpoint->imageCrc ^ checkpoint->offset ^ checkpoint->crc);
+    nrf_hal::Flash::write(page_, checkpoint, sizeof(*checkpoint));
+}
+
+void Lr11xxUpdater::clearCheckpoint()
+{
+    Checkpoint checkpoint{};
+    nrf_hal::Flash::write(page_, &checkpoint, sizeof(checkpoint));
+}
+
+////////////////////////////////////////////////////////////////////////////////
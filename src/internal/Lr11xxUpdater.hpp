@@ -0,0 +1,92 @@
+/*
+ * Lr11xxUpdater.hpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+////////////////////////////////////////////////////////////////////////////////
+// Lr11xxUpdater
+
+class Lr11xxUpdater
+{
+public:
+    static constexpr size_t BLOCK_WORDS = 64;                   // Largest WriteFlashEncrypted command
+    static constexpr uint32_t CHECKPOINT_INTERVAL = 16 * 1024;  // Bytes written between two checkpoints
+
+    enum class Result
+    {
+        OK,
+        SOURCE_ERROR,       // Image size invalid or source read failed
+        BOOTLOADER_ERROR,   // Command failed, or the bootloader rejected the image at reboot
+        IMAGE_MISMATCH,     // Streamed image does not match the expected crc
+        VERSION_MISMATCH,   // Firmware started but does not report the expected version
+    };
+
+    // Reads size bytes of the image at offset, size is a multiple of 4
+    using Source = std::function<bool(uint32_t offset, void* buffer, size_t size)>;
+    using Progress = std::function<void(uint32_t written, uint32_t total)>;
+
+    class Bootloader
+    {
+    public:
+        virtual ~Bootloader() {}
+        virtual bool enter() = 0;                                                   // Reset the transceiver into its bootloader
+        virtual bool erase() = 0;
+        virtual bool write(uint32_t offset, const uint32_t* words, size_t count) = 0;  // May return while the transceiver is still programming
+        virtual bool reboot() = 0;                                                  // Start the firmware in flash
+        virtual bool getFirmwareVersion(uint16_t* version) = 0;                     // False if the firmware is not running
+    };
+
+    // Bootloader of the transceiver of Wm1110Hardware
+    class RadioBootloader : public Bootloader
+    {
+    public:
+        bool enter() override;
+        bool erase() override;
+        bool write(uint32_t offset, const uint32_t* words, size_t count) override;
+        bool reboot() override;
+        bool getFirmwareVersion(uint16_t* version) override;
+    };
+
+private:
+    static constexpr uint32_t CHECKPOINT_MAGIC = 0x4c524655;    // "LRFU"
+
+    struct Checkpoint
+    {
+        uint32_t magic;
+        uint32_t imageSize;
+        uint32_t imageCrc;
+        uint32_t offset;        // Bytes known to be programmed
+        uint32_t crc;           // Running crc of the bytes before offset
+        uint32_t check;         // ~(magic ^ imageSize ^ imageCrc ^ offset ^ crc)
+    };
+
+private:
+    Bootloader& bootloader_;
+    uint32_t page_;
+
+public:
+    Lr11xxUpdater(Bootloader& bootloader, uint32_t page);
+
+    // Resumes from the checkpoint when the same image was interrupted, the transceiver is left running the new firmware
+    Result update(const Source& source, uint32_t imageSize, uint32_t imageCrc, uint16_t firmwareVersion, const Progress& progress = nullptr);
+
+    static uint32_t crc32(uint32_t crc, const void* data, size_t size);    // Start with 0
+
+private:
+    bool loadCheckpoint(Checkpoint* checkpoint) const;
+    void storeCheckpoint(Checkpoint* checkpoint);
+    void clearCheckpoint();
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,120 @@
+/*
+ * Telemetry.cpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "Telemetry.hpp"
+#include <cstdlib>
+#include <type_traits>
+#include "internal/nrf_hal/saadc.hpp"
+#include "internal/nrf_hal/system.hpp"
+#include "internal/nrf_hal/temp.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+
+// Battery directly on VDD (2xAA, coin cell), ordered by decreasing voltage
+static const Telemetry::CurvePoint DefaultBatteryCurve[] =
+{
+    { 3000, 100 },
+    { 2900,  90 },
+    { 2800,  70 },
+    { 2700,  50 },
+    { 2600,  30 },
+    { 2500,  20 },
+    { 2400,  10 },
+    { 2200,   0 },
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Telemetry
+
+Telemetry::Telemetry() :
+    maxAgeSeconds_{ DEFAULT_MAX_AGE_SECONDS },
+    batteryInput_{ nrf_hal::Saadc::INPUT_VDD },
+    batteryScale_{ 1.0f },
+    batteryModel_{},
+    supplyMillivolts_{},
+    batteryMillivolts_{},
+    quarterCelsius_{}
+{
+}
+
+void Telemetry::setMaxAge(uint32_t seconds)
+{
+    maxAgeSeconds_ = seconds;
+}
+
+void Telemetry::setBatteryInput(uint32_t saadcInput, float scale)
+{
+    if (scale <= 0.0f) abort();
+
+    batteryInput_ = saadcInput;
+    batteryScale_ = scale;
+    batteryMillivolts_.valid = false;
+}
+
+void Telemetry::setBatteryModel(const std::function<uint8_t(uint16_t)>& model)
+{
+    batteryModel_ = model;
+}
+
+void Telemetry::refresh(uint32_t now)
+{
+    supplyMillivolts_ = { nrf_hal::Saadc::readMillivolts(nrf_hal::Saadc::INPUT_VDD), now, true };
+    batteryMillivolts_ = { static_cast<int32_t>(nrf_hal::Saadc::readMillivolts(batteryInput_) * batteryScale_), now, true };
+    quarterCelsius_ = { nrf_hal::Temp::readQuarterCelsius(), now, true };
+}
+
+uint16_t Telemetry::getSupplyMillivolts(uint32_t now)
+{
+    if (!isFresh(supplyMillivolts_, now) && !nrf_hal::System::isInInterrupt())
+    {
+        supplyMillivolts_ = { nrf_hal::Saadc::readMillivolts(nrf_hal::Saadc::INPUT_VDD), now, true };
+    }
+
+    return supplyMillivolts_.value;
+}
+
+uint16_t Telemetry::getBatteryMillivolts(uint32_t now)
+{
+    if (!isFresh(batteryMillivolts_, now) && !nrf_hal::System::isInInterrupt())
+    {
+        batteryMillivolts_ = { static_cast<int32_t>(nrf_hal::Saadc::readMillivolts(batteryInput_) * batteryScale_), now, true };
+    }
+
+    return batteryMillivolts_.value < UINT16_MAX ? batteryMillivolts_.value : UINT16_MAX;
+}
+
+uint8_t Telemetry::getBatteryPercent(uint32_t now)
+{
+    const uint16_t millivolts = getBatteryMillivolts(now);
+
+    if (batteryModel_) return batteryModel_(millivolts);
+
+    return interpolate(DefaultBatteryCurve, std::extent<decltype(DefaultBatteryCurve)>::value, millivolts);
+}
+
+int8_t Telemetry::getTemperature(uint32_t now)
+{
+    if (!isFresh(quarterCelsius_, now) && !nrf_hal::System::isInInterrupt())
+    {
+        quarterCelsius_ = { nrf_hal::Temp::readQuarterCelsius(), now, true };
+    }
+
+    const int32_t celsius = quarterCelsius_.value / 4;
+
+    return celsius < INT8_MIN ? INT8_MIN : celsius > INT8_MAX ? INT8_MAX : celsius;
+}
+
+// Both conversions spin on their end event, and sd_temp_get() must not be called from a high priority interrupt
+bool Telemetry::isFresh(const Reading& reading, uint32_t now) const
+{
+    return reading.valid && now - reading.timestamp <= maxAgeSeconds_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
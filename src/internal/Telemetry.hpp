@@ -0,0 +1,88 @@
+/*
+ * Telemetry.hpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+////////////////////////////////////////////////////////////////////////////////
+// Telemetry
+
+class Telemetry
+{
+public:
+    static constexpr uint32_t DEFAULT_MAX_AGE_SECONDS = 60;
+    static constexpr uint8_t BATTERY_UNKNOWN = 0xff;
+
+    struct CurvePoint
+    {
+        uint16_t millivolts;
+        uint8_t percent;
+    };
+
+private:
+    struct Reading
+    {
+        int32_t value;
+        uint32_t timestamp;
+        bool valid;
+    };
+
+private:
+    uint32_t maxAgeSeconds_;
+    uint32_t batteryInput_;
+    float batteryScale_;
+    std::function<uint8_t(uint16_t)> batteryModel_;    // Default curve if empty
+
+    Reading supplyMillivolts_;
+    Reading batteryMillivolts_;
+    Reading quarterCelsius_;
+
+public:
+    Telemetry();
+
+    void setMaxAge(uint32_t seconds);
+    void setBatteryInput(uint32_t saadcInput, float scale);
+    void setBatteryModel(const std::function<uint8_t(uint16_t)>& model);
+
+    // Under interrupt the getters return the last readings, conversions only run from thread mode
+    void refresh(uint32_t now);
+    uint16_t getSupplyMillivolts(uint32_t now);
+    uint16_t getBatteryMillivolts(uint32_t now);
+    uint8_t getBatteryPercent(uint32_t now);
+    int8_t getTemperature(uint32_t now);
+
+    // Percent of a discharge curve ordered by decreasing voltage, Point has millivolts and percent members
+    template <typename Point>
+    static uint8_t interpolate(const Point* curve, size_t count, uint16_t millivolts)
+    {
+        if (millivolts >= curve[0].millivolts) return curve[0].percent;
+
+        for (size_t i = 1; i < count; ++i)
+        {
+            if (millivolts >= curve[i].millivolts)
+            {
+                const int32_t span = curve[i - 1].millivolts - curve[i].millivolts;
+                const int32_t delta = curve[i - 1].percent - curve[i].percent;
+
+                return curve[i].percent + delta * (millivolts - curve[i].millivolts) / span;
+            }
+        }
+
+        return curve[count - 1].percent;
+    }
+
+private:
+    bool isFresh(const Reading& reading, uint32_t now) const;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,95 @@
+/*
+ * Watchdog.cpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "Watchdog.hpp"
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+
+// Stored as the crash function, at most CrashLog::FUNCTION_LENGTH characters
+static const char* const ClientNames[Watchdog::CLIENT_COUNT] =
+{
+    "watchdog:supervisor",
+    "watchdog:rp",
+    "watchdog:gnss",
+    "watchdog:wifi",
+    "watchdog:transceiver",
+    "watchdog:app",
+    "watchdog:trx_irq",
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Watchdog
+
+Watchdog::Watchdog()
+{
+    for (size_t i = 0; i < CLIENT_COUNT; ++i)
+    {
+        heartbeats_[i].timeMs = 0;
+        heartbeats_[i].deadlineMs = 0;
+        heartbeats_[i].armed = false;
+    }
+}
+
+void Watchdog::heartbeat(Client client, uint32_t now, uint32_t deadlineMs)
+{
+    const size_t i = static_cast<size_t>(client);
+    if (i >= CLIENT_COUNT) abort();
+
+    heartbeats_[i].armed = false;   // Not evaluated from an interrupt while half written
+    heartbeats_[i].timeMs = now;
+    heartbeats_[i].deadlineMs = deadlineMs;
+    heartbeats_[i].armed = true;
+}
+
+void Watchdog::release(Client client)
+{
+    const size_t i = static_cast<size_t>(client);
+    if (i >= CLIENT_COUNT) abort();
+
+    heartbeats_[i].armed = false;
+}
+
+bool Watchdog::isHealthy(uint32_t now) const
+{
+    for (size_t i = 0; i < CLIENT_COUNT; ++i)
+    {
+        if (heartbeats_[i].armed && now - heartbeats_[i].timeMs > heartbeats_[i].deadlineMs) return false;
+    }
+
+    return true;
+}
+
+uint8_t Watchdog::findStarved(uint32_t now) const
+{
+    // When the hardware times out before any deadline, the client blocking the others is the latest one
+    uint8_t starved = NO_CLIENT;
+    int64_t starvedLateness = 0;
+    for (size_t i = 0; i < CLIENT_COUNT; ++i)
+    {
+        if (!heartbeats_[i].armed) continue;
+
+        const int64_t lateness = static_cast<int64_t>(now - heartbeats_[i].timeMs) - heartbeats_[i].deadlineMs;
+        if (starved == NO_CLIENT || lateness > starvedLateness)
+        {
+            starved = i;
+            starvedLateness = lateness;
+        }
+    }
+
+    return starved;
+}
+
+const char* Watchdog::getName(uint8_t client)
+{
+    return client < CLIENT_COUNT ? ClientNames[client] : "watchdog";
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,61 @@
+/*
+ * Watchdog.hpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////
+// Watchdog
+
+// Heartbeats of the contexts which must all be alive before the hardware watchdog is fed
+class Watchdog
+{
+public:
+    enum class Client : uint8_t
+    {
+        SUPERVISOR,     // Task launched by the modem supervisor, until the stack is idle again
+        RADIO_PLANNER,  // Radio and timer interrupts of the radio planner
+        GNSS,           // GNSS scan of the middleware
+        WIFI,           // Wi-Fi scan of the middleware
+        TRANSCEIVER,    // Wait for the BUSY line from the main loop
+        APP,            // Application main loop
+        TRANSCEIVER_IRQ, // Wait for the BUSY line from an interrupt, which may preempt the main loop one
+    };
+
+    static constexpr size_t CLIENT_COUNT = 7;
+    static constexpr uint8_t NO_CLIENT = 0xff;
+
+private:
+    struct Heartbeat
+    {
+        uint32_t timeMs;
+        uint32_t deadlineMs;
+        bool armed;     // Released clients are idle and always healthy
+    };
+
+private:
+    volatile Heartbeat heartbeats_[CLIENT_COUNT];
+
+public:
+    Watchdog();
+
+    // A client only beats from its own context, the deadline is the longest time before its next beat or release
+    void heartbeat(Client client, uint32_t now, uint32_t deadlineMs);
+    void release(Client client);
+
+    bool isHealthy(uint32_t now) const;
+    uint8_t findStarved(uint32_t now) const;    // Armed client the furthest past its deadline, NO_CLIENT if none is armed
+
+    static const char* getName(uint8_t client);
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
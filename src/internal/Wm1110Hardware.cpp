@@ -10,6 +10,8 @@
 #include "Wm1110Hardware.hpp"
 #include "internal/nrf_hal/system.hpp"
 #include "lbm/smtc_modem_core/smtc_ralf/src/ralf_lr11xx.h"
+#include "lbm/smtc_modem_core/modem_supervisor/modem_supervisor.h"
+#include "lbm/smtc_modem_core/device_management/modem_context.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Variables
@@ -29,7 +31,8 @@ Wm1110Hardware& Wm1110Hardware::getInstance()
     return *instance_;
 }
 
-Wm1110Hardware::Wm1110Hardware()
+Wm1110Hardware::Wm1110Hardware() :
+    watchdogStarted_{ false }
 {
     radio = RALF_LR11XX_INSTANTIATE(this);
 }
@@ -74,6 +77,9 @@ void Wm1110Hardware::begin()
     rng.begin();
     timerOneshot.begin();
 
+    crashLog.begin(CRASH_LOG_PAGE);
+    telemetry.refresh(rtcTimer.getElapsedSeconds());
+
     radioMode_ = RadioMode::AWAKE;
 }
 
@@ -147,7 +153,67 @@ void Wm1110Hardware::wakeupAndWaitForReady()
         radioMode_ = RadioMode::AWAKE;
     }
 
+    // A radio interrupt may access the transceiver while the main loop waits, each context has its own client
+    const Watchdog::Client client = nrf_hal::System::isInInterrupt() ? Watchdog::Client::TRANSCEIVER_IRQ : Watchdog::Client::TRANSCEIVER;
+    heartbeatWatchdog(client, BUSY_DEADLINE_MS);
     while (busy_.read()){}  // Seeed: Spin
+    releaseWatchdog(client);
+}
+
+void Wm1110Hardware::startWatchdog()
+{
+    wdt.begin([]
+    {
+        Wm1110Hardware& hardware = Wm1110Hardware::getInstance();
+        const uint8_t client = hardware.watchdog.findStarved(hardware.rtcTimer.getElapsedMilliseconds());
+
+        hardware.captureCrash(Watchdog::getName(client), 0, client);
+    });
+    watchdogStarted_ = true;
+
+    // The application is watched from the start, a loop which never reloads is reported as starved
+    reloadWatchdog();
+}
+
+void Wm1110Hardware::reloadWatchdog()
+{
+    if (!watchdogStarted_) return;
+
+    // The other clients only update their heartbeat, so that a client beating from an interrupt can't keep feeding the
+    // hardware while the main loop is stuck. The application has the whole hardware timeout before its next reload
+    const uint32_t now = rtcTimer.getElapsedMilliseconds();
+    watchdog.heartbeat(Watchdog::Client::APP, now, wdt.getReloadMilliseconds());
+    if (watchdog.isHealthy(now)) wdt.reload();
+}
+
+void Wm1110Hardware::heartbeatWatchdog(Watchdog::Client client, uint32_t deadlineMs)
+{
+    if (!watchdogStarted_) return;
+
+    watchdog.heartbeat(client, rtcTimer.getElapsedMilliseconds(), deadlineMs);
+}
+
+void Wm1110Hardware::releaseWatchdog(Watchdog::Client client)
+{
+    if (!watchdogStarted_) return;
+
+    watchdog.release(client);
+}
+
+void Wm1110Hardware::captureCrash(const char* function, uint32_t line, uint8_t watchdogClient)
+{
+    // Called on asserts and from the watchdog timeout interrupt, only reads the current state
+    const radio_planner_t* rp = modem_context_get_modem_rp();
+
+    CrashLog::capture(function, line, rtcTimer.getElapsedSeconds(), modem_supervisor_get_current_task_id(), rp != nullptr ? rp->radio_task_id : CrashLog::UNKNOWN_ID, watchdogClient);
+}
+
+Lr11xxUpdater::Result Wm1110Hardware::updateRadioFirmware(const Lr11xxUpdater::Source& source, uint32_t imageSize, uint32_t imageCrc, uint16_t firmwareVersion, const Lr11xxUpdater::Progress& progress)
+{
+    Lr11xxUpdater::RadioBootloader bootloader;
+    Lr11xxUpdater updater(bootloader, RADIO_UPDATE_PAGE);
+
+    return updater.update(source, imageSize, imageCrc, firmwareVersion, progress);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,10 @@
 #include "internal/nrf_hal/rng.hpp"
 #include "internal/nrf_hal/timer.hpp"
 #include "internal/nrf_hal/wdt.hpp"
+#include "internal/CrashLog.hpp"
+#include "internal/Watchdog.hpp"
+#include "internal/Telemetry.hpp"
+#include "internal/Lr11xxUpdater.hpp"
 #include "lbm/smtc_modem_core/smtc_ralf/src/ralf.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +30,11 @@
 
 class Wm1110Hardware
 {
+public:
+    static constexpr uintptr_t FLASH_APPLICATION_END_ADDR = 0xed000;   // Look at nrf52840_s140_v6.ld
+    static constexpr uint32_t FLASH_APPLICATION_END_PAGE = FLASH_APPLICATION_END_ADDR / nrf_hal::Flash::PAGE_SIZE;
+    static constexpr uint32_t FLASH_LBM_CONTEXT_PAGE_COUNT = 4;        // Pages below the application end, one per LBM context type
+
 private:
     enum class RadioMode
     {
@@ -47,6 +56,11 @@ private:
     static constexpr int TIMER_ONESHOT_ID   = 2;
     static constexpr int WDT_ID             = 0;
 
+    static constexpr uint32_t CRASH_LOG_PAGE = FLASH_APPLICATION_END_PAGE - FLASH_LBM_CONTEXT_PAGE_COUNT - 1;
+    static constexpr uint32_t RADIO_UPDATE_PAGE = CRASH_LOG_PAGE - 1;
+
+    static constexpr uint32_t BUSY_DEADLINE_MS = 500;   // Longest BUSY of a command, the flash erase of the bootloader excepted
+
 private:
     static Wm1110Hardware* instance_;
 
@@ -59,6 +73,7 @@ private:
     nrf_hal::GpioOutputPin<LR1110_SPI_NSS_PIN, 1> ss_;
     nrf_hal::Spim<SPIM_ID, LR1110_SPI_SCK_PIN, LR1110_SPI_MOSI_PIN, LR1110_SPI_MISO_PIN, NRF_SPIM_FREQ_16M> spim_;
     RadioMode radioMode_;
+    bool watchdogStarted_;
 
 public:
     nrf_hal::Flash flash;
@@ -67,6 +82,9 @@ public:
     nrf_hal::Rng rng;
     nrf_hal::TimerOneshot<TIMER_ONESHOT_ID> timerOneshot;
     nrf_hal::Wdt<WDT_ID> wdt;
+    Watchdog watchdog;
+    CrashLog crashLog;
+    Telemetry telemetry;
 
     ralf_t radio;
 
@@ -91,6 +109,12 @@ public:
     void transfer(const uint8_t* txData, uint8_t* rxData, size_t length);
     void changedToSleep();
     void wakeupAndWaitForReady();
+    void startWatchdog();
+    void reloadWatchdog();  // From the application main loop only, the hardware watchdog is fed when all clients are healthy
+    void heartbeatWatchdog(Watchdog::Client client, uint32_t deadlineMs);
+    void releaseWatchdog(Watchdog::Client client);
+    void captureCrash(const char* function, uint32_t line, uint8_t watchdogClient = CrashLog::UNKNOWN_ID);
+    Lr11xxUpdater::Result updateRadioFirmware(const Lr11xxUpdater::Source& source, uint32_t imageSize, uint32_t imageCrc, uint16_t firmwareVersion, const Lr11xxUpdater::Progress& progress);
 
 };
 
@@ -93,6 +93,13 @@ const lr11xx_pa_pwr_cfg_t pa_hp_cfg_table[LR11XX_MAX_PWR_HP_LF - LR11XX_MIN_PWR_
 
 const lr11xx_pa_pwr_cfg_t pa_hf_cfg_table[LR11XX_MAX_PWR_PA_HF - LR11XX_MIN_PWR_PA_HF + 1] = LR11XX_PA_HF_CFG_TABLE;
 
+// LR1110 datasheet currents, to be replaced by the values measured on the module
+static const ral_lr11xx_bsp_consumption_calibration_t consumption_calibration = {
+    .tx_gain_per_mille = 1000,
+    .rx_gain_per_mille = 1000,
+    .offset_in_ua      = 0,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -258,6 +265,12 @@ void ral_lr11xx_bsp_get_rssi_calibration_table( const void* context, const uint3
     }
 }
 
+void ral_lr11xx_bsp_get_consumption_calibration( const void*                               context,
+                                                 ral_lr11xx_bsp_consumption_calibration_t* calibration )
+{
+    *calibration = consumption_calibration;
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -12,19 +12,16 @@
 #include "internal/nrf_hal/trace.hpp"
 #include "internal/Wm1110Hardware.hpp"
 
-static constexpr uintptr_t FLASH_APPLICATION_END_ADDR = 0xed000;    // Look at nrf52840_s140_v6.ld
+static_assert(MODEM_CONTEXT_TYPE_SIZE == Wm1110Hardware::FLASH_LBM_CONTEXT_PAGE_COUNT, "One flash page per LBM context type");
 
 static const uint32_t FlashLbmConextPages[MODEM_CONTEXT_TYPE_SIZE] =
 {
-    FLASH_APPLICATION_END_ADDR / Wm1110Hardware::getInstance().flash.PAGE_SIZE - 1, // CONTEXT_MODEM
-    FLASH_APPLICATION_END_ADDR / Wm1110Hardware::getInstance().flash.PAGE_SIZE - 2, // CONTEXT_LR1MAC
-    FLASH_APPLICATION_END_ADDR / Wm1110Hardware::getInstance().flash.PAGE_SIZE - 3, // CONTEXT_DEVNONCE
-    FLASH_APPLICATION_END_ADDR / Wm1110Hardware::getInstance().flash.PAGE_SIZE - 4, // CONTEXT_SECURE_ELEMENT
+    Wm1110Hardware::FLASH_APPLICATION_END_PAGE - 1, // CONTEXT_MODEM
+    Wm1110Hardware::FLASH_APPLICATION_END_PAGE - 2, // CONTEXT_LR1MAC
+    Wm1110Hardware::FLASH_APPLICATION_END_PAGE - 3, // CONTEXT_DEVNONCE
+    Wm1110Hardware::FLASH_APPLICATION_END_PAGE - 4, // CONTEXT_SECURE_ELEMENT
 };
 
-static uint8_t CrashLog[CRASH_LOG_SIZE];
-static volatile bool CrashLogAvailable;
-
 /* ------------ Reset management ------------*/
 
 void smtc_modem_hal_reset_mcu( void )
@@ -39,6 +36,18 @@ void smtc_modem_hal_reload_wdog( void )
     // No need to implement since this function is not called from SWL2001
 }
 
+void smtc_modem_hal_wdog_heartbeat( const modem_wdog_client_t client, const uint32_t deadline_ms )
+{
+    static_assert(WDOG_CLIENT_WIFI == static_cast<int>(Watchdog::Client::WIFI), "Watchdog client mismatch");
+
+    Wm1110Hardware::getInstance().heartbeatWatchdog(static_cast<Watchdog::Client>(client), deadline_ms);
+}
+
+void smtc_modem_hal_wdog_release( const modem_wdog_client_t client )
+{
+    Wm1110Hardware::getInstance().releaseWatchdog(static_cast<Watchdog::Client>(client));
+}
+
 /* ------------ Time management ------------*/
 
 uint32_t smtc_modem_hal_get_time_in_s( void )
@@ -71,6 +80,11 @@ uint32_t smtc_modem_hal_get_radio_irq_timestamp_in_100us( void )
     return Wm1110Hardware::getInstance().rtcTimer.getElapsed100Microseconds();
 }
 
+uint32_t smtc_modem_hal_get_cpu_cycle_count( void )
+{
+    return nrf_hal::System::getCycleCount();
+}
+
 /* ------------ Timer management ------------*/
 
 void smtc_modem_hal_start_timer( const uint32_t milliseconds, void ( *callback )( void* context ), void* context )
@@ -132,30 +146,51 @@ void smtc_modem_hal_context_store( const modem_context_type_t ctx_type, const ui
 
 void smtc_modem_hal_store_crashlog( uint8_t crashlog[CRASH_LOG_SIZE] )
 {
-    memcpy(CrashLog, crashlog, CRASH_LOG_SIZE);
+    // LBM stores the function name, the record is written to flash on the next boot
+    Wm1110Hardware::getInstance().captureCrash(reinterpret_cast<const char*>(crashlog), 0);
 }
 
 void smtc_modem_hal_restore_crashlog( uint8_t crashlog[CRASH_LOG_SIZE] )
 {
-    memcpy(crashlog, CrashLog, CRASH_LOG_SIZE);
+    // | reset reason (4) | uptime (4) | supervisor task (1) | radio planner hook (1) | line (2) | function (20) |
+    static_assert(4 + 4 + 1 + 1 + 2 + CrashLog::FUNCTION_LENGTH == CRASH_LOG_SIZE, "Crash log size mismatch");
+
+    memset(crashlog, 0, CRASH_LOG_SIZE);
+
+    CrashLog::Record record;
+    if (Wm1110Hardware::getInstance().crashLog.read(&record, 1) != 1) return;
+
+    crashlog[0] = record.resetReason;
+    crashlog[1] = record.resetReason >> 8;
+    crashlog[2] = record.resetReason >> 16;
+    crashlog[3] = record.resetReason >> 24;
+    crashlog[4] = record.uptimeSeconds;
+    crashlog[5] = record.uptimeSeconds >> 8;
+    crashlog[6] = record.uptimeSeconds >> 16;
+    crashlog[7] = record.uptimeSeconds >> 24;
+    crashlog[8] = record.supervisorTask;
+    crashlog[9] = record.radioPlannerHook;
+    crashlog[10] = record.line;
+    crashlog[11] = record.line >> 8;
+    memcpy(&crashlog[12], record.function, CrashLog::FUNCTION_LENGTH);
 }
 
 void smtc_modem_hal_set_crashlog_status( bool available )
 {
-    CrashLogAvailable = available;
+    // Availability comes from the records written on boot after a fault, only the report is tracked here
+    if (!available) Wm1110Hardware::getInstance().crashLog.setReported();
 }
 
 bool smtc_modem_hal_get_crashlog_status( void )
 {
-    return CrashLogAvailable;
+    return Wm1110Hardware::getInstance().crashLog.isReportPending();
 }
 
 /* ------------ assert management ------------*/
 
 void smtc_modem_hal_assert_fail( uint8_t* func, uint32_t line )
 {
-    smtc_modem_hal_store_crashlog(func);
-    smtc_modem_hal_set_crashlog_status(true);
+    Wm1110Hardware::getInstance().captureCrash(reinterpret_cast<const char*>(func), line);
     smtc_modem_hal_print_trace("\x1B[0;31m" "crash log :%s:%u\n" "\x1B[0m", func, line);
     smtc_modem_hal_reset_mcu();
 }
@@ -192,7 +227,7 @@ uint32_t smtc_modem_hal_get_random_nb_in_range( const uint32_t val_1, const uint
     }
     else
     {
-        return Wm1110Hardware::getInstance().rng.read() % (maxValue - minValue + 1) + minValue;
+        return Wm1110Hardware::getInstance().rng.readBelow(maxValue - minValue + 1) + minValue;
     }
 }
 
@@ -221,7 +256,8 @@ int32_t smtc_modem_hal_get_signed_random_nb_in_range( const int32_t val_1, const
     }
     else
     {
-        return Wm1110Hardware::getInstance().rng.read() % (maxValue - minValue + 1) + minValue;
+        const uint32_t bound = static_cast<uint32_t>(maxValue) - static_cast<uint32_t>(minValue) + 1;
+        return static_cast<int32_t>(Wm1110Hardware::getInstance().rng.readBelow(bound) + static_cast<uint32_t>(minValue));
     }
 }
 
@@ -256,17 +292,30 @@ uint32_t smtc_modem_hal_get_radio_tcxo_startup_delay_ms( void )
 
 uint8_t smtc_modem_hal_get_battery_level( void )
 {
-    return 254;
+    Wm1110Hardware& hardware = Wm1110Hardware::getInstance();
+
+    const uint8_t percent = hardware.telemetry.getBatteryPercent(hardware.rtcTimer.getElapsedSeconds());
+    if (percent == Telemetry::BATTERY_UNKNOWN) return 255;  // DevStatusAns: unable to measure
+
+    // DevStatusAns: 1 (minimum) to 254 (maximum)
+    return 1 + (percent < 100 ? percent : 100) * 253 / 100;
 }
 
 int8_t smtc_modem_hal_get_temperature( void )
 {
-    return 20;
+    Wm1110Hardware& hardware = Wm1110Hardware::getInstance();
+
+    return hardware.telemetry.getTemperature(hardware.rtcTimer.getElapsedSeconds());
 }
 
 uint8_t smtc_modem_hal_get_voltage( void )
 {
-    return 254;
+    Wm1110Hardware& hardware = Wm1110Hardware::getInstance();
+
+    // DM_INFO_VOLTAGE: 1/50 V
+    const uint16_t voltage = hardware.telemetry.getSupplyMillivolts(hardware.rtcTimer.getElapsedSeconds()) / 20;
+
+    return voltage < UINT8_MAX ? voltage : UINT8_MAX;
 }
 
 int8_t smtc_modem_hal_get_board_delay_ms( void )
@@ -12,7 +12,11 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Variables
 
-volatile uint8_t nrf_hal::Rng::rngValue_[4];
-volatile size_t nrf_hal::Rng::rngValueCount_ = sizeof(rngValue_);
+volatile uint8_t nrf_hal::Rng::pool_[POOL_CAPACITY];
+volatile size_t nrf_hal::Rng::poolHead_ = 0;
+volatile size_t nrf_hal::Rng::poolTail_ = 0;
+size_t nrf_hal::Rng::poolDepth_ = POOL_CAPACITY;
+uint32_t nrf_hal::Rng::poolHits_ = 0;
+uint32_t nrf_hal::Rng::poolStalls_ = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
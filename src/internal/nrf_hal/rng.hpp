@@ -27,23 +27,74 @@ namespace nrf_hal
 
 class Rng
 {
+public:
+    static constexpr size_t POOL_CAPACITY = 64;   // Bytes
+
 private:
-    static volatile uint8_t rngValue_[4];
-    static volatile size_t rngValueCount_;
+    // Single producer (RNG interrupt or refill()), single consumer (read()), indexes are free running
+    static volatile uint8_t pool_[POOL_CAPACITY];
+    static volatile size_t poolHead_;
+    static volatile size_t poolTail_;
+    static size_t poolDepth_;
+    static uint32_t poolHits_;
+    static uint32_t poolStalls_;
 
 private:
+    static size_t available()
+    {
+        return poolHead_ - poolTail_;
+    }
+
     static void rngIsr(uint8_t rng_data)
     {
-        if (sizeof(rngValue_) <= rngValueCount_) abort();
+        if (poolDepth_ <= available())  // Late conversion after the stop
+        {
+            nrfx_rng_stop();
+            return;
+        }
+
+        pool_[poolHead_ % POOL_CAPACITY] = rng_data;
+        ++poolHead_;
+        if (available() >= poolDepth_) nrfx_rng_stop();
+    }
+
+    static void refill()
+    {
+#ifdef SOFTDEVICE_PRESENT
+        if (System::isSoftDeviceEnabled())
+        {
+            uint8_t sdAvailable;
+            if (sd_rand_application_bytes_available_get(&sdAvailable) != NRF_SUCCESS) abort();
 
-        rngValue_[rngValueCount_] = rng_data;
-        ++rngValueCount_;
-        if (rngValueCount_ >= sizeof(rngValue_)) nrfx_rng_stop();
+            size_t count = poolDepth_ - available();
+            if (count > sdAvailable) count = sdAvailable;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint8_t value;
+                if (sd_rand_application_vector_get(&value, sizeof(value)) != NRF_SUCCESS) abort();
+                pool_[poolHead_ % POOL_CAPACITY] = value;
+                ++poolHead_;
+            }
+        }
+        else
+#endif
+        {
+            nrfx_rng_start();   // Runs in the background until the pool is full
+        }
     }
 
 public:
-    static void begin(uint8_t interruptPriority = NRFX_GPIOTE_DEFAULT_CONFIG_IRQ_PRIORITY)
+    // poolDepth is the number of bytes kept ready, up to POOL_CAPACITY
+    static void begin(uint8_t interruptPriority = NRFX_GPIOTE_DEFAULT_CONFIG_IRQ_PRIORITY, size_t poolDepth = POOL_CAPACITY)
     {
+        if (poolDepth < sizeof(uint32_t) || POOL_CAPACITY < poolDepth) abort();
+
+        poolHead_ = 0;
+        poolTail_ = 0;
+        poolDepth_ = poolDepth;
+        poolHits_ = 0;
+        poolStalls_ = 0;
+
 #ifdef SOFTDEVICE_PRESENT
         if (System::isSoftDeviceEnabled())
         {
@@ -55,46 +106,67 @@ public:
 #endif
         {
             nrfx_rng_config_t rng_config = NRFX_RNG_DEFAULT_CONFIG;
+            rng_config.error_correction = true; // Remove the bias of the raw bit stream, the pool hides the slower rate
 
             if (nrfx_rng_init(&rng_config, rngIsr) != NRFX_SUCCESS) abort();
-
-            rngValueCount_ = 0;
-            nrfx_rng_start();
         }
+
+        refill();
     }
 
     static uint32_t read()
     {
-#ifdef SOFTDEVICE_PRESENT
-        if (System::isSoftDeviceEnabled())
+        if (available() >= sizeof(uint32_t))
+        {
+            ++poolHits_;
+        }
+        else
         {
-            uint8_t available;
+            ++poolStalls_;
             do
             {
-                if (sd_rand_application_bytes_available_get(&available) != NRF_SUCCESS) abort();
+                refill();
             }
-            while (available < 4);  // Seeed: Spin
-
-            uint32_t value;
-            if (sd_rand_application_vector_get(reinterpret_cast<uint8_t*>(&value), sizeof(value)) != NRF_SUCCESS) abort();
-
-            return value;
+            while (available() < sizeof(uint32_t));    // Seeed: Spin
         }
-        else
-#endif
+
+        uint32_t value = 0;
+        for (size_t i = 0; i < sizeof(value); ++i)
         {
-            while (rngValueCount_ < sizeof(rngValue_)){}    // Seeed: Spin
+            value = value << 8 | pool_[poolTail_ % POOL_CAPACITY];
+            ++poolTail_;
+        }
 
-            const uint32_t value = rngValue_[3] << 24 |
-                                   rngValue_[2] << 16 |
-                                   rngValue_[1] << 8  |
-                                   rngValue_[0];
+        refill();
 
-            rngValueCount_ = 0;
-            nrfx_rng_start();
+        return value;
+    }
+
+    // Uniform in [0, bound), bound must not be 0
+    static uint32_t readBelow(uint32_t bound)
+    {
+        if (bound <= 0) abort();
 
-            return value;
+        // Reject the values of the incomplete last period of bound, 2^32 % bound values at most
+        const uint32_t threshold = (0 - bound) % bound;
+        uint32_t value;
+        do
+        {
+            value = read();
         }
+        while (value < threshold);
+
+        return value % bound;
+    }
+
+    static uint32_t getPoolHits()
+    {
+        return poolHits_;
+    }
+
+    static uint32_t getPoolStalls()
+    {
+        return poolStalls_;
     }
 
 };
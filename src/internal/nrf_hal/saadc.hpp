@@ -0,0 +1,87 @@
+/*
+ * saadc.hpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstdint>
+#include <cstdlib>
+#include <nrf.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace nrf_hal
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// Saadc
+
+class Saadc
+{
+private:
+    static constexpr int CHANNEL = 0;
+    static constexpr int32_t FULL_SCALE_MV = 3600;  // 0.6V internal reference, gain 1/6
+    static constexpr int32_t RESOLUTION = 4096;     // 12bit
+
+public:
+    static constexpr uint32_t INPUT_VDD = SAADC_CH_PSELP_PSELP_VDD;
+    static constexpr uint32_t INPUT_VDDHDIV5 = SAADC_CH_PSELP_PSELP_VDDHDIV5;
+    static constexpr uint32_t INPUT_AIN0 = SAADC_CH_PSELP_PSELP_AnalogInput0;    // AINn is INPUT_AIN0 + n
+
+public:
+    // Single blocking conversion (about 40us), the channel is released afterwards for analogRead()
+    static int32_t readMillivolts(uint32_t input)
+    {
+        if ((input < INPUT_AIN0 || INPUT_VDD < input) && input != INPUT_VDDHDIV5) abort();
+
+        volatile int16_t result = 0;
+
+        NRF_SAADC->RESOLUTION = SAADC_RESOLUTION_VAL_12bit;
+        NRF_SAADC->OVERSAMPLE = SAADC_OVERSAMPLE_OVERSAMPLE_Bypass;
+        NRF_SAADC->CH[CHANNEL].CONFIG = (SAADC_CH_CONFIG_GAIN_Gain1_6 << SAADC_CH_CONFIG_GAIN_Pos) |
+                                        (SAADC_CH_CONFIG_REFSEL_Internal << SAADC_CH_CONFIG_REFSEL_Pos) |
+                                        (SAADC_CH_CONFIG_TACQ_10us << SAADC_CH_CONFIG_TACQ_Pos) |
+                                        (SAADC_CH_CONFIG_MODE_SE << SAADC_CH_CONFIG_MODE_Pos);
+        NRF_SAADC->CH[CHANNEL].PSELN = SAADC_CH_PSELN_PSELN_NC;
+        NRF_SAADC->CH[CHANNEL].PSELP = input;
+        NRF_SAADC->RESULT.PTR = reinterpret_cast<uint32_t>(&result);
+        NRF_SAADC->RESULT.MAXCNT = 1;
+        NRF_SAADC->ENABLE = SAADC_ENABLE_ENABLE_Enabled;
+
+        NRF_SAADC->EVENTS_STARTED = 0;
+        NRF_SAADC->TASKS_START = 1;
+        while (NRF_SAADC->EVENTS_STARTED == 0){}    // Seeed: Spin
+        NRF_SAADC->EVENTS_STARTED = 0;
+
+        NRF_SAADC->EVENTS_END = 0;
+        NRF_SAADC->TASKS_SAMPLE = 1;
+        while (NRF_SAADC->EVENTS_END == 0){}        // Seeed: Spin
+        NRF_SAADC->EVENTS_END = 0;
+
+        NRF_SAADC->EVENTS_STOPPED = 0;
+        NRF_SAADC->TASKS_STOP = 1;
+        while (NRF_SAADC->EVENTS_STOPPED == 0){}    // Seeed: Spin
+        NRF_SAADC->EVENTS_STOPPED = 0;
+
+        NRF_SAADC->ENABLE = SAADC_ENABLE_ENABLE_Disabled;
+        NRF_SAADC->CH[CHANNEL].PSELP = SAADC_CH_PSELP_PSELP_NC;
+
+        const int32_t millivolts = (result < 0 ? 0 : result) * FULL_SCALE_MV / RESOLUTION;
+
+        return input == INPUT_VDDHDIV5 ? millivolts * 5 : millivolts;
+    }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
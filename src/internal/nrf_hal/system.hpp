@@ -56,6 +56,56 @@ public:
         }
     }
 
+    static uint32_t getResetReason()
+    {
+#ifdef SOFTDEVICE_PRESENT
+        if (isSoftDeviceEnabled())
+        {
+            uint32_t reason;
+            if (sd_power_reset_reason_get(&reason) != NRF_SUCCESS) abort();
+
+            return reason;
+        }
+        else
+#endif
+        {
+            return NRF_POWER->RESETREAS;
+        }
+    }
+
+    static void clearResetReason(uint32_t reason)
+    {
+        // RESETREAS is cumulative until the reported bits are written back
+#ifdef SOFTDEVICE_PRESENT
+        if (isSoftDeviceEnabled())
+        {
+            if (sd_power_reset_reason_clr(reason) != NRF_SUCCESS) abort();
+        }
+        else
+#endif
+        {
+            NRF_POWER->RESETREAS = reason;
+        }
+    }
+
+    static bool isInInterrupt()
+    {
+        return __get_IPSR() != 0;
+    }
+
+    static uint32_t getCycleCount()
+    {
+        // DWT cycle counter, started on first use
+        if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+        {
+            CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+            DWT->CYCCNT = 0;
+            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        }
+
+        return DWT->CYCCNT;
+    }
+
     static void delayMs(uint32_t milliseconds)
     {
         delay(milliseconds);
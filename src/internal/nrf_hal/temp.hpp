@@ -0,0 +1,63 @@
+/*
+ * temp.hpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstdint>
+#include <cstdlib>
+#include <nrf.h>
+#include <nrf_soc.h>
+#include "system.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace nrf_hal
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// Temp
+
+class Temp
+{
+public:
+    // Die temperature in 0.25 degree Celsius steps, blocking conversion (about 36us)
+    static int32_t readQuarterCelsius()
+    {
+#ifdef SOFTDEVICE_PRESENT
+        if (System::isSoftDeviceEnabled())
+        {
+            int32_t temp;
+            if (sd_temp_get(&temp) != NRF_SUCCESS) abort();
+
+            return temp;
+        }
+        else
+#endif
+        {
+            NRF_TEMP->EVENTS_DATARDY = 0;
+            NRF_TEMP->TASKS_START = 1;
+            while (NRF_TEMP->EVENTS_DATARDY == 0){}     // Seeed: Spin
+            NRF_TEMP->EVENTS_DATARDY = 0;
+
+            const int32_t temp = static_cast<int32_t>(NRF_TEMP->TEMP);
+            NRF_TEMP->TASKS_STOP = 1;
+
+            return temp;
+        }
+    }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
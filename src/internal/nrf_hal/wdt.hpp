@@ -27,10 +27,15 @@ class Wdt
 {
 private:
     static nrfx_wdt_t wdt_;
+    static void (*timeoutCallback_)();
+    static uint32_t reloadMilliseconds_;
 
 private:
     static void wdtIsr()
     {
+        // The chip resets 2 cycles of the 32.768kHz clock after the timeout event, the callback must be very short.
+        if (timeoutCallback_ != nullptr) timeoutCallback_();
+
         nrf_hal::System::reset();
     }
 
@@ -43,10 +48,13 @@ public:
         abort();
     }
 
-    static void begin()
+    static void begin(void (*timeoutCallback)() = nullptr)
     {
+        timeoutCallback_ = timeoutCallback;
+
         nrfx_wdt_config_t config = NRFX_WDT_DEFAULT_CONFIG;
         if (nrfx_wdt_init(&wdt_, &config, wdtIsr) != NRFX_SUCCESS) abort();
+        reloadMilliseconds_ = config.reload_value;
 
         nrfx_wdt_channel_id channelId;
         if (nrfx_wdt_channel_alloc(&wdt_, &channelId) != NRFX_SUCCESS) abort();
@@ -59,11 +67,22 @@ public:
         nrfx_wdt_feed(&wdt_);
     }
 
+    static uint32_t getReloadMilliseconds()     // 0 before begin()
+    {
+        return reloadMilliseconds_;
+    }
+
 };
 
 template <int ID>
 nrfx_wdt_t Wdt<ID>::wdt_;
 
+template <int ID>
+void (*Wdt<ID>::timeoutCallback_)() = nullptr;
+
+template <int ID>
+uint32_t Wdt<ID>::reloadMilliseconds_ = 0;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Namespace
 
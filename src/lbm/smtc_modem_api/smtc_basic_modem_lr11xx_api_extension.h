@@ -64,11 +64,70 @@ extern "C" {
  */
 #define SMTC_MODEM_PIN_LENGTH 4
 
+/**
+ * @brief Maximum number of ranging exchanges of a manager round
+ */
+#define SMTC_MODEM_RANGING_MAX_EXCHANGES 32
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
  */
 
+/**
+ * @brief Ranging roles
+ */
+typedef enum smtc_modem_ranging_role_e
+{
+    SMTC_MODEM_RANGING_ROLE_MANAGER     = 0,  //!< Sends ranging requests and measures the distance
+    SMTC_MODEM_RANGING_ROLE_SUBORDINATE = 1,  //!< Answers the ranging requests sent to its address
+} smtc_modem_ranging_role_t;
+
+/**
+ * @brief Ranging bandwidths
+ */
+typedef enum smtc_modem_ranging_bw_e
+{
+    SMTC_MODEM_RANGING_BW_125_KHZ = 0,
+    SMTC_MODEM_RANGING_BW_250_KHZ = 1,
+    SMTC_MODEM_RANGING_BW_500_KHZ = 2,
+    SMTC_MODEM_RANGING_BW_COUNT,
+} smtc_modem_ranging_bw_t;
+
+/**
+ * @brief Ranging session parameters
+ */
+typedef struct smtc_modem_ranging_params_s
+{
+    uint32_t                  rf_freq_in_hz;
+    int8_t                    output_pwr_in_dbm;
+    uint8_t                   sf;            //!< Spreading factor, 5 to 12
+    smtc_modem_ranging_bw_t   bw;
+    uint32_t                  peer_address;  //!< Address the requests are sent to in manager role
+    uint8_t                   nb_exchanges;  //!< Exchanges of a round, 1 to SMTC_MODEM_RANGING_MAX_EXCHANGES
+    uint16_t                  nb_rounds;     //!< Rounds of the session, at least 1
+    smtc_modem_ranging_role_t first_role;
+    bool                      alternate;     //!< Swap the role after each round
+} smtc_modem_ranging_params_t;
+
+/**
+ * @brief Result of a ranging round
+ */
+typedef struct smtc_modem_ranging_result_s
+{
+    smtc_modem_ranging_role_t role;
+    uint16_t                  round;         //!< Round index, from 0
+    int32_t                   distance_m;    //!< Mean distance of the exchanges kept, manager only
+    uint32_t                  deviation_m;   //!< Median absolute deviation of the distances, manager only
+    int16_t                   rssi_dbm;      //!< Mean ranging rssi of the exchanges kept, manager only
+    uint8_t                   nb_exchanges;  //!< Exchanges attempted, manager only
+    uint8_t                   nb_answered;   //!< Exchanges answered by the peer, manager only
+    uint8_t                   nb_kept;       //!< Answered exchanges left by the outlier rejection, manager only
+    uint8_t                   quality;       //!< nb_kept over nb_exchanges in percent, manager only
+    uint8_t                   nb_responses;  //!< Requests answered, subordinate only
+    uint8_t                   nb_discarded;  //!< Requests sent to another address, subordinate only
+} smtc_modem_ranging_result_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -119,6 +178,84 @@ smtc_modem_return_code_t smtc_modem_get_chip_eui( uint8_t stack_id, uint8_t chip
  */
 smtc_modem_return_code_t smtc_modem_derive_keys( uint8_t stack_id );
 
+/*!
+ * @brief Set the address answered in subordinate role
+ *
+ * @remark This command can only be used with LR11XX radio
+ *
+ * @param [in] address       Ranging address of the device
+ * @param [in] check_length  Number of address bytes compared with the requests, LSB first, 1 to 4
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK       Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID  \p check_length is out of range
+ */
+smtc_modem_return_code_t smtc_modem_ranging_set_address( uint32_t address, uint8_t check_length );
+
+/*!
+ * @brief Set the transceiver delay compensated by the ranging at a spreading factor and bandwidth
+ *
+ * @remark This command can only be used with LR11XX radio. Both peers have to use the same value. It takes
+ * effect at the next exchange.
+ *
+ * @param [in] sf               Spreading factor, 5 to 12
+ * @param [in] bw               Bandwidth
+ * @param [in] delay_indicator  Delay measured for the board, 0 to restore the value recommended by the driver
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK       Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID  \p sf or \p bw is out of range
+ */
+smtc_modem_return_code_t smtc_modem_ranging_set_calibration( uint8_t sf, smtc_modem_ranging_bw_t bw,
+                                                             uint32_t delay_indicator );
+
+/*!
+ * @brief Start a ranging session
+ *
+ * @remark This command can only be used with LR11XX radio. Exchanges are radio planner tasks with a lower priority
+ * than the LoRaWAN stack: an exchange interrupted by a LoRaWAN transmission or reception window is run again
+ * afterwards. A SMTC_MODEM_EVENT_RANGING event is raised at the end of each round.
+ *
+ * A manager round runs \p nb_exchanges exchanges back to back. A subordinate round listens for twice the duration
+ * of a manager round, so that two peers started in opposite roles with \p alternate set stay paired.
+ *
+ * The frequency must be valid in the LoRaWAN region. Requests and responses are charged to the duty cycle of the
+ * region like the uplinks, and a round is delayed until its band allows all of its exchanges.
+ *
+ * @param [in] params  Session parameters
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK       Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY     Modem is in test mode or a session is running
+ * @retval SMTC_MODEM_RC_INVALID  A parameter is out of range, or a round does not fit in the band duty cycle
+ */
+smtc_modem_return_code_t smtc_modem_ranging_start( const smtc_modem_ranging_params_t* params );
+
+/*!
+ * @brief Stop the ranging session, the round in progress is dropped
+ *
+ * @remark This command can only be used with LR11XX radio
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK  Command executed without errors
+ */
+smtc_modem_return_code_t smtc_modem_ranging_stop( void );
+
+/*!
+ * @brief Get the result of the last finished round
+ *
+ * @remark This command can only be used with LR11XX radio
+ *
+ * @param [out] running  True while the session runs
+ * @param [out] result   Result of the last round
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK       Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID  A pointer is NULL
+ * @retval SMTC_MODEM_RC_FAIL     No round finished since the session started
+ */
+smtc_modem_return_code_t smtc_modem_ranging_get_result( bool* running, smtc_modem_ranging_result_t* result );
+
 #ifdef __cplusplus
 }
 #endif
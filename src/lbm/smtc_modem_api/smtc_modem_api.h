@@ -87,6 +87,11 @@ extern "C" {
  */
 #define SMTC_MODEM_D2D_PING_SLOTS_MASK_SIZE 16
 
+/**
+ * @brief Number of reception sessions in the statistics: unicast then multicast groups 0 to 3
+ */
+#define SMTC_MODEM_RX_SESSION_COUNT 5
+
 /**
  * @defgroup SMTC_MODEM_EVENT_DEF Event codes definitions
  * @{
@@ -109,6 +114,8 @@ extern "C" {
 #define SMTC_MODEM_EVENT_USER_RADIO_ACCESS 0x12       //!< radio callback when user use the radio by itself
 #define SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO 0x13  //!< Ping Slot Info answered by network
 #define SMTC_MODEM_EVENT_CLASS_B_STATUS 0x14          //!< Downlink class B is ready or not
+#define SMTC_MODEM_EVENT_ENERGY_GOVERNOR 0x19         //!< Energy governor level changed
+#define SMTC_MODEM_EVENT_RANGING 0x1A                 //!< Ranging round finished
 #define SMTC_MODEM_EVENT_NONE 0xFF                    //!< No event available
 /**
  * @}
@@ -442,6 +449,100 @@ typedef enum smtc_modem_class_b_ping_slot_periodicity_e
     SMTC_MODEM_CLASS_B_PINGSLOT_128_S,
 } smtc_modem_class_b_ping_slot_periodicity_t;
 
+/**
+ * @brief Class B clock drift statistics
+ */
+typedef struct smtc_modem_class_b_drift_stats_s
+{
+    int32_t  drift_ppb;           //!< Estimated clock drift left by the beacon tracking, in ppb
+    uint32_t uncertainty_ppb;     //!< Drift bound covered by the beacon and ping slot rx windows, in ppb
+    uint8_t  nb_samples;          //!< Number of received beacons used by the estimator
+    bool     is_valid;            //!< The estimate is used to size the rx windows
+    uint32_t crystal_error_ppm;   //!< Crystal error currently applied to the rx windows, in ppm
+    uint32_t nb_rx_windows;       //!< Number of rx windows sized with the estimate
+    uint32_t rx_window_saved_ms;  //!< Cumulated rx window time saved compared to the configured crystal error
+} smtc_modem_class_b_drift_stats_t;
+
+/**
+ * @brief Class C continuous reception statistics
+ */
+typedef struct smtc_modem_class_c_stats_s
+{
+    uint32_t nb_rx_start;       //!< Number of continuous reception starts
+    uint32_t nb_rx_fast_start;  //!< Number of starts which reused the radio configuration of the previous one
+    uint32_t deaf_time_ms;      //!< Cumulated time without continuous reception while class C is running
+    uint32_t deaf_time_max_ms;  //!< Longest time without continuous reception while class C is running
+    uint32_t nb_rx_foreign;     //!< Number of frames dropped because no session listens to their DevAddr
+
+    // Per session: unicast then multicast groups 0 to 3
+    uint32_t nb_rx_accepted[SMTC_MODEM_RX_SESSION_COUNT];  //!< Number of accepted frames
+    uint32_t nb_rx_rejected[SMTC_MODEM_RX_SESSION_COUNT];  //!< Number of frames dropped on FCnt or MIC
+} smtc_modem_class_c_stats_t;
+
+/**
+ * @brief Energy accounting consumers
+ */
+typedef enum smtc_modem_energy_consumer_e
+{
+    SMTC_MODEM_ENERGY_MODEM,        //!< LoRaWAN class A stack, LBT and other modem tasks
+    SMTC_MODEM_ENERGY_CLASS_B,      //!< Class B beacons, ping slots and device to device uplinks
+    SMTC_MODEM_ENERGY_CLASS_C,      //!< Class C continuous reception
+    SMTC_MODEM_ENERGY_USER_TASK_0,  //!< User radio access task 0
+    SMTC_MODEM_ENERGY_USER_TASK_1,  //!< User radio access task 1
+    SMTC_MODEM_ENERGY_USER_TASK_2,  //!< User radio access task 2
+    SMTC_MODEM_ENERGY_RANGING,      //!< Device to device ranging
+    SMTC_MODEM_ENERGY_CONSUMER_NUMBER,
+} smtc_modem_energy_consumer_t;
+
+/**
+ * @brief Energy accounting of a consumer
+ */
+typedef struct smtc_modem_energy_stats_s
+{
+    uint32_t tx_time_ms;       //!< Cumulated transmission time
+    uint32_t rx_time_ms;       //!< Cumulated reception and listen before talk time
+    uint32_t tx_charge_uah;    //!< Charge drawn while transmitting, in uAh
+    uint32_t rx_charge_uah;    //!< Charge drawn while receiving, in uAh
+    uint32_t scan_charge_uah;  //!< Charge of the radio acquisition of GNSS and Wi-Fi scans, in uAh
+    uint32_t cpu_charge_uah;   //!< Charge of the transceiver processing of GNSS and Wi-Fi scans, in uAh
+} smtc_modem_energy_stats_t;
+
+/**
+ * @brief Activities charged to the energy budget
+ */
+typedef enum smtc_modem_energy_activity_e
+{
+    SMTC_MODEM_ENERGY_ACTIVITY_UPLINK,    //!< Transmissions of the stack
+    SMTC_MODEM_ENERGY_ACTIVITY_DOWNLINK,  //!< Reception windows of the stack, class B and class C included
+    SMTC_MODEM_ENERGY_ACTIVITY_GNSS,      //!< GNSS scans reported by the middleware
+    SMTC_MODEM_ENERGY_ACTIVITY_WIFI,      //!< Wi-Fi scans reported by the middleware
+    SMTC_MODEM_ENERGY_ACTIVITY_NUMBER,
+} smtc_modem_energy_activity_t;
+
+/**
+ * @brief Energy governor levels, returned by the SMTC_MODEM_EVENT_ENERGY_GOVERNOR event
+ */
+typedef enum smtc_modem_energy_governor_level_e
+{
+    SMTC_MODEM_ENERGY_GOVERNOR_NORMAL    = 0,  //!< Less than half of the budget spent, or no budget set
+    SMTC_MODEM_ENERGY_GOVERNOR_SAVING    = 1,  //!< Scan delays doubled, retransmissions halved, periodic DM skipped
+    SMTC_MODEM_ENERGY_GOVERNOR_CRITICAL  = 2,  //!< 80% spent, scan delays x4, a single transmission per uplink
+    SMTC_MODEM_ENERGY_GOVERNOR_EXHAUSTED = 3,  //!< Budget spent, scans are deferred to the next period
+} smtc_modem_energy_governor_level_t;
+
+/**
+ * @brief Energy governor status of the current budget period
+ */
+typedef struct smtc_modem_energy_governor_status_s
+{
+    smtc_modem_energy_governor_level_t level;
+    uint32_t                           budget_uah;     //!< Charge allowed per period, 0 when disabled
+    uint32_t                           period_s;       //!< Period length
+    uint32_t                           period_left_s;  //!< Time before the budget is renewed
+    uint32_t                           remaining_uah;  //!< Charge left in the current period
+    uint32_t spent_uah[SMTC_MODEM_ENERGY_ACTIVITY_NUMBER];  //!< Charge spent in the current period per activity
+} smtc_modem_energy_governor_status_t;
+
 /**
  * @brief Frame pending status
  */
@@ -460,6 +561,15 @@ typedef enum smtc_modem_d2d_class_b_tx_done_status_e
     SMTC_MODEM_EVENT_D2D_CLASS_B_TX_DONE_SENT     = 1,
 } smtc_modem_d2d_class_b_tx_done_status_t;
 
+/**
+ * @brief Status returned by the SMTC_MODEM_EVENT_RANGING event
+ */
+typedef enum smtc_modem_event_ranging_status_e
+{
+    SMTC_MODEM_EVENT_RANGING_MANAGER_DONE     = 0,  //!< Manager round finished, distance in the ranging result
+    SMTC_MODEM_EVENT_RANGING_SUBORDINATE_DONE = 1,  //!< Subordinate window closed, answers in the ranging result
+} smtc_modem_event_ranging_status_t;
+
 /**
  * @brief Structure holding event-related data
  */
@@ -541,6 +651,14 @@ typedef struct smtc_modem_event_s
             uint8_t                nb_trans_not_send;
         } d2d_class_b_tx_done;
         struct
+        {
+            smtc_modem_energy_governor_level_t level;
+        } energy_governor;
+        struct
+        {
+            smtc_modem_event_ranging_status_t status;
+        } ranging;
+        struct
         {
             uint8_t status;
         } middleware_event_status;
@@ -816,6 +934,50 @@ smtc_modem_return_code_t smtc_modem_time_set_sync_invalid_delay_s( uint32_t sync
  */
 smtc_modem_return_code_t smtc_modem_time_get_sync_invalid_delay_s( uint32_t* sync_invalid_delay_s );
 
+/**
+ * @brief Get the clock drift estimated over the successive time synchronizations
+ *
+ * @remark The drift is estimated once 3 time corrections have been received from the network. It is then used to
+ *         extrapolate the time returned by @ref smtc_modem_get_time. A positive drift means the local clock is slow.
+ *
+ * @param [out] drift_ppb       Estimated drift in part per billion
+ * @param [out] uncertainty_ppb Uncertainty of the estimated drift in part per billion
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       \p drift_ppb and/or \p uncertainty_ppb are NULL
+ * @retval SMTC_MODEM_RC_NO_TIME       Not enough time synchronizations to estimate the drift
+ * @retval SMTC_MODEM_RC_BUSY          Modem is currently in test mode
+ */
+smtc_modem_return_code_t smtc_modem_time_get_drift( int32_t* drift_ppb, uint32_t* uncertainty_ppb );
+
+/**
+ * @brief Set the maximum predicted time error used to stretch the interval between time synchronization messages
+ *
+ * @remark Once the drift is estimated, the interval set with @ref smtc_modem_time_set_sync_interval_s is stretched
+ *         as long as the predicted time error stays below \p max_error_ms. It never exceeds the invalid delay.
+ * @remark The default value is 0: the interval is never stretched
+ *
+ * @param [in] max_error_ms Maximum predicted time error in millisecond
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY          Modem is currently in test mode
+ */
+smtc_modem_return_code_t smtc_modem_time_set_sync_max_error_ms( uint32_t max_error_ms );
+
+/**
+ * @brief Get the maximum predicted time error used to stretch the interval between time synchronization messages
+ *
+ * @param [out] max_error_ms Maximum predicted time error in millisecond
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       \p max_error_ms is NULL
+ * @retval SMTC_MODEM_RC_BUSY          Modem is currently in test mode
+ */
+smtc_modem_return_code_t smtc_modem_time_get_sync_max_error_ms( uint32_t* max_error_ms );
+
 /**
  * @brief Get the modem status
  *
@@ -960,6 +1122,74 @@ smtc_modem_return_code_t smtc_modem_get_class( uint8_t stack_id, smtc_modem_clas
  */
 smtc_modem_return_code_t smtc_modem_set_class( uint8_t stack_id, smtc_modem_class_t lorawan_class );
 
+/**
+ * @brief Get Class C continuous reception statistics
+ *
+ * @remark The deaf time is the time spent between two continuous receptions while class C is running: downlink
+ * processing, class A windows, transmissions and other radio tasks
+ *
+ * @param [in]  stack_id Stack identifier
+ * @param [out] stats    Class C statistics
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p stats is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_class_c_get_stats( uint8_t stack_id, smtc_modem_class_c_stats_t* stats );
+
+/**
+ * @brief Get the energy accounting of a consumer since the last reset
+ *
+ * @remark Radio currents are the datasheet values corrected by the board calibration, GNSS and Wi-Fi scans are charged
+ * from the timings reported by the transceiver
+ *
+ * @param [in]  consumer Energy consumer
+ * @param [out] stats    Energy accounting of \p consumer
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p stats is NULL or \p consumer is invalid
+ */
+smtc_modem_return_code_t smtc_modem_get_energy_stats( smtc_modem_energy_consumer_t consumer,
+                                                      smtc_modem_energy_stats_t*   stats );
+
+/**
+ * @brief Reset the energy accounting of all consumers
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ */
+smtc_modem_return_code_t smtc_modem_reset_energy_stats( void );
+
+/**
+ * @brief Set the energy budget of the modem and start a new budget period
+ *
+ * @remark Uplinks, downlink windows and the GNSS and Wi-Fi scans of the middleware are charged to the budget. As it
+ * runs out, scan delays are stretched, the number of transmissions of each uplink is reduced and the periodic DM
+ * reports are skipped. A SMTC_MODEM_EVENT_ENERGY_GOVERNOR event is raised on each level change.
+ *
+ * @param [in] budget_uah Charge allowed per period in uAh, 0 disables the governor
+ * @param [in] period_s   Period length in seconds, 0 selects one day
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ */
+smtc_modem_return_code_t smtc_modem_set_energy_budget( uint32_t budget_uah, uint32_t period_s );
+
+/**
+ * @brief Get the energy governor status of the current budget period
+ *
+ * @param [out] status Energy governor status
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p status is NULL
+ */
+smtc_modem_return_code_t smtc_modem_get_energy_governor_status( smtc_modem_energy_governor_status_t* status );
+
 /**
  * @brief Configure a multicast group
  *
@@ -1329,6 +1559,23 @@ smtc_modem_return_code_t smtc_modem_dm_get_info_fields( uint8_t* dm_fields_paylo
  */
 smtc_modem_return_code_t smtc_modem_dm_set_info_fields( const uint8_t* dm_fields_payload, uint8_t dm_field_length );
 
+/**
+ * @brief Only report the Device Management (DM) info fields that changed since the last periodic report
+ *
+ * @remark When enabled, a periodic DM message only carries the fields whose value differs from the last transmitted
+ * report, and no message is sent if none of them changed. A full report is sent right after join and then every
+ * \p full_refresh_period periodic reports. Fields are spread over several frames only when they do not fit in the max
+ * payload of the current datarate.
+ *
+ * @param [in] enable              true to only report changed fields, false to report all fields every interval
+ * @param [in] full_refresh_period Number of periodic reports between two full reports, 0 to disable full refresh
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY          Modem is currently in test mode
+ */
+smtc_modem_return_code_t smtc_modem_dm_set_info_changes_only( bool enable, uint8_t full_refresh_period );
+
 /**
  * @brief Request an immediate Device Management (DM) status
  *
@@ -1397,6 +1644,40 @@ smtc_modem_return_code_t smtc_modem_join_network( uint8_t stack_id );
  */
 smtc_modem_return_code_t smtc_modem_leave_network( uint8_t stack_id );
 
+/**
+ * @brief Get the join requests sent and the join accepts received at a datarate since the last reset
+ *
+ * @param [in]  stack_id     Stack identifier
+ * @param [in]  datarate     Datarate of the join requests
+ * @param [out] nb_attempts  Join requests sent
+ * @param [out] nb_accepts   Join accepts received
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p nb_attempts or \p nb_accepts is NULL, or \p datarate is out of range
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_get_join_stats( uint8_t stack_id, uint8_t datarate, uint16_t* nb_attempts,
+                                                    uint16_t* nb_accepts );
+
+/**
+ * @brief Get the join requests sent since the last join accept
+ *
+ * @remark The count is kept across reset and sets the random back-off before the next join request, the window starts
+ *         at 16 seconds and doubles with each failed join request up to one hour
+ *
+ * @param [in]  stack_id   Stack identifier
+ * @param [out] nb_failed  Failed join requests
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p nb_failed is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_get_join_nb_failed( uint8_t stack_id, uint16_t* nb_failed );
+
 /**
  * @brief Suspend the radio communications initiated by the modem
  *
@@ -1857,6 +2138,58 @@ smtc_modem_return_code_t smtc_modem_set_nb_trans( uint8_t stack_id, uint8_t nb_t
  */
 smtc_modem_return_code_t smtc_modem_get_nb_trans( uint8_t stack_id, uint8_t* nb_trans );
 
+/**
+ * @brief Enable the LR-FHSS datarate policy
+ *
+ * When an LR-FHSS datarate is drawn from a custom or mobile ADR profile, the policy sends the uplink at the CR 2/3
+ * datarate of the same bandwidth while the last link check margin allows it and its delivery rate holds, and at the
+ * CR 1/3 one otherwise. The datarate is only changed if the payload fits in it. Network controlled datarates are
+ * never changed.
+ *
+ * @param [in]  stack_id  Stack identifier
+ * @param [in]  enabled   Policy state
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_set_lr_fhss_dr_policy( uint8_t stack_id, bool enabled );
+
+/**
+ * @brief Get the LR-FHSS datarate policy state
+ *
+ * @param [in]  stack_id  Stack identifier
+ * @param [out] enabled   Policy state
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p enabled is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_get_lr_fhss_dr_policy( uint8_t stack_id, bool* enabled );
+
+/**
+ * @brief Get the delivery rate of an LR-FHSS datarate
+ *
+ * The delivery rate averages the last confirmed uplinks and LinkCheckReq sent at \p datarate, whether they were
+ * answered or not. It is reset when the region changes.
+ *
+ * @param [in]  stack_id       Stack identifier
+ * @param [in]  datarate       LR-FHSS datarate
+ * @param [out] delivery_rate  Delivery rate in percent
+ * @param [out] nb_tracked     Number of answers expected at \p datarate, saturated to 255
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p datarate is not an enabled LR-FHSS datarate, or an output is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_get_lr_fhss_delivery_rate( uint8_t stack_id, uint8_t datarate,
+                                                               uint8_t* delivery_rate, uint8_t* nb_tracked );
+
 /**
  * @brief Set modem crystal error
  *
@@ -1962,6 +2295,24 @@ smtc_modem_return_code_t smtc_modem_class_b_set_ping_slot_periodicity(
 smtc_modem_return_code_t smtc_modem_class_b_get_ping_slot_periodicity(
     uint8_t stack_id, smtc_modem_class_b_ping_slot_periodicity_t* ping_slot_periodicity );
 
+/**
+ * @brief Get Class B clock drift statistics
+ *
+ * @remark The clock drift is estimated from the timing of the received beacons. Once the estimate is valid, the beacon
+ * and ping slot rx windows are sized with it instead of the configured crystal error
+ *
+ * @param [in]  stack_id Stack identifier
+ * @param [out] drift_stats Clock drift statistics
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                 Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID            \p drift_stats is NULL
+ * @retval SMTC_MODEM_RC_BUSY               Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID   Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_class_b_get_drift_stats( uint8_t                           stack_id,
+                                                             smtc_modem_class_b_drift_stats_t* drift_stats );
+
 /**
  * @brief Get network frame pending status
  *
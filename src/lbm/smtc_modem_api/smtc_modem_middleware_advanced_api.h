@@ -193,6 +193,48 @@ smtc_modem_return_code_t smtc_modem_rp_add_user_radio_access_task( smtc_modem_rp
  */
 smtc_modem_return_code_t smtc_modem_rp_abort_user_radio_access_task( uint8_t user_task_id );
 
+/**
+ * @brief Charge a user task with the energy reported by the transceiver
+ *
+ * @remark Radio planner tasks are charged from their duration, the scans run by a user task are only known once the
+ * transceiver reports their timings
+ *
+ * @param [in] user_task_id     ID of the user task
+ * @param [in] scan_charge_uah  Charge of the radio acquisition, in uAh
+ * @param [in] cpu_charge_uah   Charge of the transceiver processing, in uAh
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                 Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID            Wrong user_task_id
+ */
+smtc_modem_return_code_t smtc_modem_rp_add_user_radio_access_charge( uint8_t user_task_id, uint32_t scan_charge_uah,
+                                                                     uint32_t cpu_charge_uah );
+
+/**
+ * @brief Charge a scan to the energy budget
+ *
+ * @param [in] activity     SMTC_MODEM_ENERGY_ACTIVITY_GNSS or SMTC_MODEM_ENERGY_ACTIVITY_WIFI
+ * @param [in] charge_uah   Charge of the scan, in uAh
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                 Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID            Wrong activity
+ */
+smtc_modem_return_code_t smtc_modem_energy_governor_add_scan_charge( smtc_modem_energy_activity_t activity,
+                                                                     uint32_t                     charge_uah );
+
+/**
+ * @brief Get the delay to apply before a scan according to the energy budget
+ *
+ * @param [in]  delay_s             Delay requested by the application, in seconds
+ * @param [out] governed_delay_s    Delay to apply, in seconds
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                 Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID            \p governed_delay_s is NULL
+ */
+smtc_modem_return_code_t smtc_modem_energy_governor_get_scan_delay( uint32_t delay_s, uint32_t* governed_delay_s );
+
 /**
  * @brief Request a LoRaWAN extended uplink
  *
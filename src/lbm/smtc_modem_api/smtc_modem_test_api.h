@@ -59,6 +59,11 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Maximum number of channels of a spectrum survey, the largest regional channel plan (CN470 RP 1.0)
+ */
+#define SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS 96
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -123,6 +128,44 @@ typedef enum smtc_modem_test_cr_e
 
 /* clang-format on */
 
+/**
+ * @brief Spectrum survey result of one channel
+ */
+typedef struct smtc_modem_test_survey_result_s
+{
+    uint32_t frequency_hz;        //!< Channel frequency
+    uint32_t nb_samples;          //!< Number of rssi samples
+    int16_t  rssi_min_dbm;        //!< Lowest sample
+    int16_t  rssi_max_dbm;        //!< Highest sample
+    int16_t  rssi_median_dbm;     //!< 50th percentile, 4 dB resolution
+    int16_t  rssi_p90_dbm;        //!< 90th percentile, 4 dB resolution
+    int16_t  rssi_p99_dbm;        //!< 99th percentile, 4 dB resolution
+    uint8_t  busy_ratio_percent;  //!< Share of samples at or above the busy threshold
+} smtc_modem_test_survey_result_t;
+
+/**
+ * @brief Packet error rate result of one power step, as seen by the receiver
+ */
+typedef struct smtc_modem_test_per_result_s
+{
+    int8_t   power_dbm;        //!< Transmit power of the step
+    uint16_t nb_frames;        //!< Frames sent in the step
+    uint16_t nb_received;      //!< Frames received valid, each sequence number counted once
+    uint16_t nb_lost;          //!< Frames never received valid
+    uint16_t nb_duplicated;    //!< Sequence numbers received again
+    uint16_t nb_corrupted;     //!< Frames failing the radio or the frame crc
+    int16_t  rssi_min_dbm;     //!< Lowest packet rssi
+    int16_t  rssi_max_dbm;     //!< Highest packet rssi
+    int16_t  rssi_mean_dbm;    //!< Mean packet rssi
+    int16_t  rssi_median_dbm;  //!< 50th percentile, 4 dB resolution
+    int16_t  rssi_p10_dbm;     //!< 10th percentile, 4 dB resolution
+    int16_t  snr_min_db;       //!< Lowest packet snr
+    int16_t  snr_max_db;       //!< Highest packet snr
+    int16_t  snr_mean_db;      //!< Mean packet snr
+    int16_t  snr_median_db;    //!< 50th percentile, 2 dB resolution
+    int16_t  snr_p10_db;       //!< 10th percentile, 2 dB resolution
+} smtc_modem_test_per_result_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -229,6 +272,109 @@ smtc_modem_return_code_t smtc_modem_test_rssi( uint32_t frequency_hz, smtc_modem
  */
 smtc_modem_return_code_t smtc_modem_test_get_rssi( int8_t* rssi );
 
+/**
+ * @brief Test mode spectrum survey
+ * @remark Sweeps the channels, listening dwell_time_ms on each and sampling the rssi every 10 ms. Results are kept in
+ *         RAM until the next survey and can be read while it runs. smtc_modem_test_nop stops the survey.
+ *         Only available when the modem is built with ADD_SMTC_TEST_SURVEY, SMTC_MODEM_RC_FAIL otherwise.
+ *
+ * @param [in] frequencies_hz      Channel list, NULL for the enabled channels of the current region
+ * @param [in] nb_frequencies      Number of channels of the list, up to SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS
+ * @param [in] bw                  Measurement bandwidth following smtc_modem_test_bw_t definition
+ * @param [in] dwell_time_ms       Listening time per channel and per sweep
+ * @param [in] nb_sweeps           Number of sweeps, 0 to sweep until stopped
+ * @param [in] busy_threshold_dbm  Samples at or above this level count as busy
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_survey_start( const uint32_t* frequencies_hz, uint8_t nb_frequencies,
+                                                       smtc_modem_test_bw_t bw, uint16_t dwell_time_ms,
+                                                       uint16_t nb_sweeps, int16_t busy_threshold_dbm );
+
+/**
+ * @brief Get the spectrum survey progress
+ *
+ * @param [out] running         True while the survey sweeps
+ * @param [out] nb_channels     Number of surveyed channels
+ * @param [out] nb_sweeps_done  Number of completed sweeps
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_survey_get_status( bool* running, uint8_t* nb_channels,
+                                                            uint16_t* nb_sweeps_done );
+
+/**
+ * @brief Get the spectrum survey result of one channel
+ *
+ * @param [in]  index   Channel index in the survey list
+ * @param [out] result  Channel statistics
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_survey_get_result( uint8_t index, smtc_modem_test_survey_result_t* result );
+
+/**
+ * @brief Test mode packet error rate transmitter
+ * @remark Sends nb_frames LoRa frames at each power from power_start_dbm to power_stop_dbm, up to 16 steps. Each
+ *         frame carries its sequence number, its step and the sweep plan, so the receiver needs no configuration
+ *         besides the radio settings. smtc_modem_test_nop stops the transmitter.
+ *
+ * @param [in] frequency_hz     Frequency in Hz
+ * @param [in] sf               Spreading factor following smtc_modem_test_sf_t definition, FSK is not supported
+ * @param [in] bw               Bandwidth following smtc_modem_test_bw_t definition
+ * @param [in] cr               Coding rate following smtc_modem_test_cr_t definition
+ * @param [in] payload_length   Frame length, 13 bytes or more
+ * @param [in] nb_frames        Frames per power step
+ * @param [in] interval_ms      Time between the start of two frames, stretched to the time on air when shorter
+ * @param [in] power_start_dbm  Power of the first step
+ * @param [in] power_stop_dbm   Power of the last step, never overshot
+ * @param [in] power_step_db    Power change between two steps, 0 for a single step
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_per_tx_start( uint32_t frequency_hz, smtc_modem_test_sf_t sf,
+                                                       smtc_modem_test_bw_t bw, smtc_modem_test_cr_t cr,
+                                                       uint8_t payload_length, uint16_t nb_frames, uint32_t interval_ms,
+                                                       int8_t power_start_dbm, int8_t power_stop_dbm,
+                                                       int8_t power_step_db );
+
+/**
+ * @brief Test mode packet error rate receiver
+ * @remark Listens continuously and sorts the frames of smtc_modem_test_per_tx_start into received, duplicated and
+ *         corrupted ones per power step. Results are kept in RAM until the next test and can be read while it runs.
+ *         smtc_modem_test_nop stops the receiver.
+ *
+ * @param [in] frequency_hz  Frequency in Hz
+ * @param [in] sf            Spreading factor following smtc_modem_test_sf_t definition, FSK is not supported
+ * @param [in] bw            Bandwidth following smtc_modem_test_bw_t definition
+ * @param [in] cr            Coding rate following smtc_modem_test_cr_t definition
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_per_rx_start( uint32_t frequency_hz, smtc_modem_test_sf_t sf,
+                                                       smtc_modem_test_bw_t bw, smtc_modem_test_cr_t cr );
+
+/**
+ * @brief Get the packet error rate test progress
+ *
+ * @param [out] running    True while frames are sent or listened to
+ * @param [out] nb_steps   Power steps of the sweep, 0 on the receiver until a valid frame is received
+ * @param [out] nb_frames  Frames sent by the transmitter, or heard by the receiver whatever their state
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_per_get_status( bool* running, uint8_t* nb_steps, uint32_t* nb_frames );
+
+/**
+ * @brief Get the packet error rate result of one power step, only available on the receiver
+ *
+ * @param [in]  step    Power step index, lower than nb_steps of smtc_modem_test_per_get_status
+ * @param [out] result  Step statistics
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_per_get_result( uint8_t step, smtc_modem_test_per_result_t* result );
+
 /**
  * @brief Reset the Radio for test purpose
  * @remark
@@ -392,6 +392,15 @@ dm_rc_t dm_parse_cmd( dm_cmd_msg_t* cmd_input )
                 cmd_input->up_count = 0;
                 cmd_input->up_delay = 0;
             }
+            else
+            {
+                // last downlink of the session: read the almanac status back once
+                uint32_t almanac_crc = 0;
+                if( almanac_update_verify( modem_context_get_modem_radio_ctx( ), &almanac_crc ) == ALMANAC_OK )
+                {
+                    SMTC_MODEM_HAL_TRACE_PRINTF( "Almanac update done, crc 0x%08x\n", almanac_crc );
+                }
+            }
             // update event almanac update
             increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_ALMANAC_UPDATE, event_almanac_update_status );
         }
@@ -413,6 +422,8 @@ dm_rc_t dm_parse_cmd( dm_cmd_msg_t* cmd_input )
 
         buff[2] = DM_ALM_FUPDATE;
         memcpy( &buff[3], cmd_input->buffer, cmd_input->buffer_len );
+        // forced update: do not skip blocks that look already current
+        almanac_update_invalidate( );
         rc = almanac_update_process_downlink_payload( modem_context_get_modem_radio_ctx( ), buff,
                                                       cmd_input->buffer_len + 3 );
         if( rc == ALMANAC_OK )
@@ -428,6 +439,15 @@ dm_rc_t dm_parse_cmd( dm_cmd_msg_t* cmd_input )
                 cmd_input->up_count = 0;
                 cmd_input->up_delay = 0;
             }
+            else
+            {
+                // last downlink of the session: read the almanac status back once
+                uint32_t almanac_crc = 0;
+                if( almanac_update_verify( modem_context_get_modem_radio_ctx( ), &almanac_crc ) == ALMANAC_OK )
+                {
+                    SMTC_MODEM_HAL_TRACE_PRINTF( "Almanac update done, crc 0x%08x\n", almanac_crc );
+                }
+            }
             // update event almanac update
             increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_ALMANAC_UPDATE, event_almanac_update_status );
         }
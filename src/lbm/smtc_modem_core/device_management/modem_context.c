@@ -81,6 +81,13 @@
 #define MODEM_APPKEY_CRC_STATUS_VALID ( 0 )
 #define MODEM_APPKEY_CRC_STATUS_INVALID ( 1 )
 
+/*!
+ * \brief Size of the buffers holding the last reported value of each periodic DM field
+ *
+ * \remark Must be greater or equal to the sum of dm_info_field_sz[]
+ */
+#define DM_REPORT_VALUES_SIZE ( 96 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -100,6 +107,24 @@ typedef struct modem_context_nvm_idx_s
     uint32_t crc;  // !! crc MUST be the last field of the structure !!
 } modem_context_nvm_t;
 
+/*!
+ * \brief Change tracking of the periodic DM report
+ *
+ * \remark reported_* hold the fields of the last transmitted periodic report, staged_* the fields placed in the
+ *          frame currently being transmitted. Values are stored at the prefix sum of dm_info_field_sz[]
+ */
+typedef struct dm_report_tracking_s
+{
+    bool     changes_only;         // only emit fields whose value differs from the last report
+    uint8_t  full_refresh_period;  // one full report every full_refresh_period reports (0: never)
+    uint8_t  nb_reports;           // number of report cycles started since last full refresh
+    bool     is_full;              // current report cycle is a full one
+    uint32_t reported_bitfield;
+    uint32_t staged_bitfield;
+    uint8_t  reported_values[DM_REPORT_VALUES_SIZE];
+    uint8_t  staged_values[DM_REPORT_VALUES_SIZE];
+} dm_report_tracking_t;
+
 #if !defined( LR1110_MODEM_E )
 static int16_t  modem_appkey_status = MODEM_APPKEY_CRC_STATUS_INVALID;
 static uint32_t modem_appkey_crc    = 0;
@@ -129,6 +154,7 @@ static uint32_t dm_info_bitfield_now              = 0;
 static uint8_t  tag_number                        = 0;
 static uint8_t  tag_number_now                    = 0;
 static uint8_t  number_of_muted_day               = 0;
+static dm_report_tracking_t         dm_report;
 static dm_dl_opportunities_config_t dm_pending_dl = { .up_count = 0, .up_delay = 0 };
 static uint32_t                     user_alarm    = 0x7FFFFFFF;
 static uint8_t                      asynchronous_msgnumber = 0;
@@ -154,6 +180,9 @@ static bool                 is_modem_in_test_mode = false;
 static int8_t               rx_pathloss_db        = 0;
 static int8_t               tx_power_offset_db    = 0;
 static radio_planner_t*     modem_rp              = NULL;
+static energy_governor_t    energy_governor;
+static uint64_t             energy_governor_tx_ua_ms;  // radio planner tx charge already given to the governor
+static uint64_t             energy_governor_rx_ua_ms;  // radio planner rx charge already given to the governor
 static modem_power_config_t power_config_lut[POWER_CONFIG_LUT_SIZE];
 #if defined( SMTC_D2D )
 static modem_context_class_b_d2d_t class_b_d2d_ctx;
@@ -191,6 +220,7 @@ struct
     uint8_t                      tag_number;
     uint8_t                      tag_number_now;
     uint8_t                      number_of_muted_day;
+    dm_report_tracking_t         dm_report;
     dm_dl_opportunities_config_t dm_pending_dl;
     uint32_t                     user_alarm;
     uint8_t                      asynchronous_msgnumber;
@@ -213,6 +243,9 @@ struct
     int8_t                       rx_pathloss_db;
     int8_t                       tx_power_offset_db;
     radio_planner_t*             modem_rp;
+    energy_governor_t            energy_governor;
+    uint64_t                     energy_governor_tx_ua_ms;
+    uint64_t                     energy_governor_rx_ua_ms;
     modem_power_config_t         power_config_lut[POWER_CONFIG_LUT_SIZE];
 #if defined( SMTC_D2D )
     modem_context_class_b_d2d_t  class_b_d2d_ctx;
@@ -248,6 +281,7 @@ struct
 #define  tag_number                                 modem_ctx_context.tag_number
 #define  tag_number_now                             modem_ctx_context.tag_number_now
 #define  number_of_muted_day                        modem_ctx_context.number_of_muted_day
+#define  dm_report                                  modem_ctx_context.dm_report
 #define  dm_pending_dl                              modem_ctx_context.dm_pending_dl
 #define  user_alarm                                 modem_ctx_context.user_alarm
 #define  asynchronous_msgnumber                     modem_ctx_context.asynchronous_msgnumber
@@ -270,6 +304,9 @@ struct
 #define  rx_pathloss_db                             modem_ctx_context.rx_pathloss_db
 #define  tx_power_offset_db                         modem_ctx_context.tx_power_offset_db
 #define  modem_rp                                   modem_ctx_context.modem_rp
+#define  energy_governor                            modem_ctx_context.energy_governor
+#define  energy_governor_tx_ua_ms                   modem_ctx_context.energy_governor_tx_ua_ms
+#define  energy_governor_rx_ua_ms                   modem_ctx_context.energy_governor_rx_ua_ms
 #define  power_config_lut                           modem_ctx_context.power_config_lut
 #define  class_b_d2d_ctx                            modem_ctx_context.class_b_d2d_ctx
 #define modem_lbm_notification_extended_1_callback  modem_ctx_context.modem_lbm_notification_extended_1_callback
@@ -351,6 +388,30 @@ static dm_cmd_length_valid_t check_dm_status_max_size( uint32_t info_requested,
     return DM_CMD_LENGTH_VALID;
 }
 
+/*!
+ * \brief   Get the charge of all transmissions and receptions run by the radio planner
+ *
+ * \param [out] tx_ua_ms                    Transmission charge in uA.ms
+ * \param [out] rx_ua_ms                    Reception charge in uA.ms
+ */
+static void modem_context_get_radio_charge( uint64_t* tx_ua_ms, uint64_t* rx_ua_ms )
+{
+    rp_energy_t energy;
+
+    *tx_ua_ms = 0;
+    *rx_ua_ms = 0;
+    if( modem_rp == NULL )
+    {
+        return;
+    }
+    rp_get_energy( modem_rp, &energy );
+    for( uint8_t hook_id = 0; hook_id < RP_NB_HOOKS; hook_id++ )
+    {
+        *tx_ua_ms += energy.charge_ua_ms[hook_id][RP_ENERGY_TX];
+        *rx_ua_ms += energy.charge_ua_ms[hook_id][RP_ENERGY_RX];
+    }
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -382,6 +443,8 @@ void modem_context_init( )
     tag_number                  = 0;
     tag_number_now              = 0;
     number_of_muted_day         = 0;
+    memset( &dm_report, 0, sizeof( dm_report ) );
+    dm_report.full_refresh_period = DEFAULT_DM_FULL_REFRESH_PERIOD;
     dm_pending_dl.up_count      = 0;
     dm_pending_dl.up_delay      = 0;
     user_alarm                  = 0;
@@ -410,6 +473,9 @@ void modem_context_init( )
     memset( &modem_dwn_pkt, 0, sizeof( modem_downlink_msg_t ) );
     // init power config tab to 0x80 as it corresponds to an expected power of 128dbm, value that is never reached
     memset( power_config_lut, 0x80, POWER_CONFIG_LUT_SIZE * sizeof( modem_power_config_t ) );
+    energy_governor_init( &energy_governor );
+    energy_governor_tx_ua_ms = 0;
+    energy_governor_rx_ua_ms = 0;
 #if defined( SMTC_D2D )
     memset( &class_b_d2d_ctx, 0, sizeof( modem_context_class_b_d2d_t ) );
 #endif  // SMTC_D2D
@@ -1247,6 +1313,65 @@ dm_rc_t set_dm_info( const uint8_t* requested_info_list, uint8_t len, dm_info_ra
     return ret;
 }
 
+/*!
+ * \brief   Offset of a DM field in the change tracking value buffers
+ *
+ * \param [in]  tag                     DM field code
+ * \retval uint8_t                      Offset in bytes
+ */
+static uint8_t dm_report_field_offset( uint8_t tag )
+{
+    uint8_t offset = 0;
+    for( uint8_t i = 0; i < tag; i++ )
+    {
+        offset += dm_info_field_sz[i];
+    }
+    return offset;
+}
+
+/*!
+ * \brief   Start a new periodic DM report cycle and decide whether it is a full one
+ */
+static void dm_report_cycle_start( void )
+{
+    dm_report.is_full =
+        ( dm_report.changes_only == false ) || ( ( dm_report.full_refresh_period > 0 ) && ( dm_report.nb_reports == 0 ) );
+
+    dm_report.nb_reports++;
+    if( ( dm_report.full_refresh_period == 0 ) || ( dm_report.nb_reports >= dm_report.full_refresh_period ) )
+    {
+        dm_report.nb_reports = 0;
+    }
+}
+
+/*!
+ * \brief   Stage a periodic DM field and tell whether it has to be emitted
+ *
+ * \param [in]  tag                     DM field code
+ * \param [in]  value                   Field value as written in the uplink payload
+ * \retval bool                         false if the field is unchanged since the last report and can be pruned
+ */
+static bool dm_report_stage_field( uint8_t tag, const uint8_t* value )
+{
+    uint8_t offset = dm_report_field_offset( tag );
+    uint8_t size   = dm_info_field_sz[tag];
+
+    if( ( size == 0 ) || ( ( offset + size ) > DM_REPORT_VALUES_SIZE ) )
+    {
+        return true;
+    }
+
+    if( ( dm_report.is_full == false ) && ( ( dm_report.reported_bitfield & ( 1 << tag ) ) != 0 ) &&
+        ( memcmp( &dm_report.reported_values[offset], value, size ) == 0 ) )
+    {
+        return false;
+    }
+
+    memcpy( &dm_report.staged_values[offset], value, size );
+    dm_report.staged_bitfield |= ( 1 << tag );
+    return true;
+}
+
 bool dm_status_payload( uint8_t* dm_uplink_message, uint8_t* dm_uplink_message_len, uint8_t max_size,
                         dm_info_rate_t flag )
 {
@@ -1280,6 +1405,10 @@ bool dm_status_payload( uint8_t* dm_uplink_message, uint8_t* dm_uplink_message_l
     {
         *tag = 0;
     }
+    if( ( flag == DM_INFO_PERIODIC ) && ( *tag == 0 ) )
+    {
+        dm_report_cycle_start( );
+    }
     // SMTC_MODEM_HAL_TRACE_PRINTF("info_requested = %d \n",info_requested);
     while( ( *tag ) < DM_INFO_MAX )
     {
@@ -1436,7 +1565,16 @@ bool dm_status_payload( uint8_t* dm_uplink_message, uint8_t* dm_uplink_message_l
             // Check if last message can be enqueued
             if( ( p_tmp - dm_uplink_message ) <= max_size )
             {
-                p = p_tmp;
+                if( ( flag == DM_INFO_PERIODIC ) &&
+                    ( dm_report_stage_field( *tag, p_tmp - dm_info_field_sz[*tag] ) == false ) )
+                {
+                    // unchanged since last report: drop the field from the payload
+                    p_tmp = p;
+                }
+                else
+                {
+                    p = p_tmp;
+                }
             }
             else
             {
@@ -1799,6 +1937,47 @@ void modem_context_reset_dm_tag_number( void )
     tag_number = 0;
 }
 
+void modem_context_set_dm_changes_only( bool enable, uint8_t full_refresh_period )
+{
+    dm_report.changes_only        = enable;
+    dm_report.full_refresh_period = full_refresh_period;
+    dm_report.nb_reports          = 0;
+}
+
+void modem_context_get_dm_changes_only( bool* enable, uint8_t* full_refresh_period )
+{
+    *enable              = dm_report.changes_only;
+    *full_refresh_period = dm_report.full_refresh_period;
+}
+
+void modem_context_reset_dm_report_tracking( void )
+{
+    dm_report.reported_bitfield = 0;
+    dm_report.staged_bitfield   = 0;
+    dm_report.nb_reports        = 0;
+}
+
+void modem_context_commit_dm_report( void )
+{
+    uint8_t offset = 0;
+
+    for( uint8_t tag = 0; tag < DM_INFO_MAX; tag++ )
+    {
+        if( ( dm_report.staged_bitfield & ( 1 << tag ) ) != 0 )
+        {
+            memcpy( &dm_report.reported_values[offset], &dm_report.staged_values[offset], dm_info_field_sz[tag] );
+        }
+        offset += dm_info_field_sz[tag];
+    }
+    dm_report.reported_bitfield |= dm_report.staged_bitfield;
+    dm_report.staged_bitfield = 0;
+}
+
+void modem_context_discard_dm_report( void )
+{
+    dm_report.staged_bitfield = 0;
+}
+
 uint32_t modem_get_dm_info_bitfield_periodic( void )
 {
     return ( dm_info_bitfield_periodic );
@@ -2085,6 +2264,70 @@ void modem_context_get_class_b_d2d_last_metadata( modem_context_class_b_d2d_t* c
 }
 #endif  // SMTC_D2D
 
+void modem_context_set_energy_budget( uint32_t budget_uah, uint32_t period_s )
+{
+    // Only the radio activity of the new period is charged
+    modem_context_get_radio_charge( &energy_governor_tx_ua_ms, &energy_governor_rx_ua_ms );
+
+    smtc_modem_hal_disable_modem_irq( );
+    energy_governor_set_budget( &energy_governor, budget_uah, period_s, smtc_modem_hal_get_time_in_s( ) );
+    smtc_modem_hal_enable_modem_irq( );
+
+    modem_context_energy_governor_update( );
+}
+
+void modem_context_energy_governor_add_charge( energy_governor_activity_t activity, uint32_t charge_uah )
+{
+    smtc_modem_hal_disable_modem_irq( );
+    energy_governor_add_charge( &energy_governor, activity, ( uint64_t ) charge_uah * ENERGY_GOVERNOR_UA_MS_PER_UAH );
+    smtc_modem_hal_enable_modem_irq( );
+}
+
+void modem_context_energy_governor_update( void )
+{
+    uint64_t tx_ua_ms;
+    uint64_t rx_ua_ms;
+
+    modem_context_get_radio_charge( &tx_ua_ms, &rx_ua_ms );
+
+    // The energy accounting was reset, its totals start again from 0
+    if( tx_ua_ms < energy_governor_tx_ua_ms )
+    {
+        energy_governor_tx_ua_ms = 0;
+    }
+    if( rx_ua_ms < energy_governor_rx_ua_ms )
+    {
+        energy_governor_rx_ua_ms = 0;
+    }
+
+    smtc_modem_hal_disable_modem_irq( );
+    energy_governor_add_charge( &energy_governor, ENERGY_GOVERNOR_ACTIVITY_UPLINK,
+                                tx_ua_ms - energy_governor_tx_ua_ms );
+    energy_governor_add_charge( &energy_governor, ENERGY_GOVERNOR_ACTIVITY_DOWNLINK,
+                                rx_ua_ms - energy_governor_rx_ua_ms );
+    bool level_changed = energy_governor_update( &energy_governor, smtc_modem_hal_get_time_in_s( ) );
+    smtc_modem_hal_enable_modem_irq( );
+
+    energy_governor_tx_ua_ms = tx_ua_ms;
+    energy_governor_rx_ua_ms = rx_ua_ms;
+
+    if( level_changed == true )
+    {
+        energy_governor_level_t level = energy_governor_get_level( &energy_governor );
+
+        SMTC_MODEM_HAL_TRACE_WARNING( "Energy governor level %d, %u uAh left\n", level,
+                                      energy_governor_get_remaining_uah( &energy_governor ) );
+        increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_ENERGY_GOVERNOR, level );
+    }
+}
+
+void modem_context_get_energy_governor( energy_governor_t* eg )
+{
+    smtc_modem_hal_disable_modem_irq( );
+    memcpy( eg, &energy_governor, sizeof( energy_governor_t ) );
+    smtc_modem_hal_enable_modem_irq( );
+}
+
 void modem_set_extended_callback( func_callback callback, uint8_t extended_uplink_id )
 {
     if( extended_uplink_id == 1 )
@@ -49,6 +49,7 @@ extern "C" {
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_defs.h"
 #include "lbm/smtc_modem_core/smtc_modem_services/headers/alc_sync.h"
 #include "lbm/smtc_modem_core/radio_planner/src/radio_planner.h"
+#include "lbm/smtc_modem_core/modem_services/energy_governor.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -60,6 +61,7 @@ extern "C" {
 #define DEFAULT_DM_REPORTING_INTERVAL 0x81  // 1h
 #define DEFAULT_DM_REPORTING_FIELDS 0x7B    // status, charge, temp, signal, uptime, rxtime
 #define DEFAULT_DM_MUTE_DAY 0
+#define DEFAULT_DM_FULL_REFRESH_PERIOD 24  // full report every 24 periodic reports when changes only is enabled
 #define DEFAULT_ADR_MOBILE_MODE_TIMEOUT 0  // desactivated by default
 
 #define UPLOAD_SID 0
@@ -69,7 +71,7 @@ extern "C" {
 
 #define POWER_CONFIG_LUT_SIZE 6
 
-#define MODEM_NUMBER_OF_EVENTS 0x19  // number of possible events in modem
+#define MODEM_NUMBER_OF_EVENTS 0x1B  // number of possible events in modem
 
 /*
  * -----------------------------------------------------------------------------
@@ -906,6 +908,43 @@ uint32_t modem_get_dm_info_bitfield_periodic( void );
  */
 void modem_context_reset_dm_tag_number( void );
 
+/*!
+ * \brief   Enable or disable the change tracking mode of the periodic DM report
+ * \remark  When enabled only the fields whose value differs from the last transmitted report are emitted, and a
+ *          full report is sent every full_refresh_period reports (0: no periodic full report)
+ * \param   [in]  enable               true to only report changed fields
+ * \param   [in]  full_refresh_period  number of reports between two full reports
+ * \retval void
+ */
+void modem_context_set_dm_changes_only( bool enable, uint8_t full_refresh_period );
+
+/*!
+ * \brief   Get the change tracking mode of the periodic DM report
+ * \param   [out] enable               true if only changed fields are reported
+ * \param   [out] full_refresh_period  number of reports between two full reports
+ * \retval void
+ */
+void modem_context_get_dm_changes_only( bool* enable, uint8_t* full_refresh_period );
+
+/*!
+ * \brief   Forget the last reported DM values so that the next periodic report is a full one
+ * \retval void
+ */
+void modem_context_reset_dm_report_tracking( void );
+
+/*!
+ * \brief   Mark the fields of the last built periodic DM frame as reported
+ * \remark  To be called once the frame has been transmitted
+ * \retval void
+ */
+void modem_context_commit_dm_report( void );
+
+/*!
+ * \brief   Drop the fields of the last built periodic DM frame, they will be emitted again in the next report
+ * \retval void
+ */
+void modem_context_discard_dm_report( void );
+
 /*!
  * \brief    get info_bitfield_periodic
  * \remark   return alarm value in seconds
@@ -1153,6 +1192,38 @@ void modem_context_set_class_b_d2d_last_metadata( uint8_t mc_grp_id, bool tx_don
  */
 void modem_context_get_class_b_d2d_last_metadata( modem_context_class_b_d2d_t* class_b_d2d );
 
+/**
+ * @brief Set the energy budget and start a new budget period
+ *
+ * @param [in] budget_uah   Charge allowed per period in uAh, 0 disables the governor
+ * @param [in] period_s     Period length in seconds, 0 selects one day
+ */
+void modem_context_set_energy_budget( uint32_t budget_uah, uint32_t period_s );
+
+/**
+ * @brief Charge an activity which is not run by the radio planner tasks of the stack, like a GNSS or Wi-Fi scan
+ *
+ * @remark Can be called from interrupt context
+ *
+ * @param [in] activity     Activity
+ * @param [in] charge_uah   Charge in uAh
+ */
+void modem_context_energy_governor_add_charge( energy_governor_activity_t activity, uint32_t charge_uah );
+
+/**
+ * @brief Charge the uplinks and downlinks run since the last call and re-evaluate the governor level
+ *
+ * @remark A SMTC_MODEM_EVENT_ENERGY_GOVERNOR event is raised when the level changes
+ */
+void modem_context_energy_governor_update( void );
+
+/**
+ * @brief Get a copy of the energy governor
+ *
+ * @param [out] eg  Governor state
+ */
+void modem_context_get_energy_governor( energy_governor_t* eg );
+
 /**
  * @brief Set  callback provided by the middleware layer
  *
@@ -446,6 +446,16 @@ uint32_t lorawan_api_next_join_time_second_get( void )
     return lr1mac_core_next_join_time_second_get( &lr1_mac_obj );
 }
 
+status_lorawan_t lorawan_api_join_stats_get( uint8_t datarate, uint16_t* nb_attempts, uint16_t* nb_accepts )
+{
+    return lr1mac_core_join_stats_get( &lr1_mac_obj, datarate, nb_attempts, nb_accepts );
+}
+
+uint16_t lorawan_api_join_nb_failed_get( void )
+{
+    return lr1mac_core_join_nb_failed_get( &lr1_mac_obj );
+}
+
 int32_t lorawan_api_next_free_duty_cycle_ms_get( void )
 {
     return lr1mac_core_next_free_duty_cycle_ms_get( &lr1_mac_obj );
@@ -497,6 +507,11 @@ void lorawan_api_class_c_stop( void )
     lr1mac_class_c_stop( &class_c_obj );
 }
 
+void lorawan_api_class_c_get_stats( lr1mac_class_c_stats_t* stats )
+{
+    lr1mac_class_c_get_stats( &class_c_obj, stats );
+}
+
 lorawan_multicast_rc_t lorawan_api_multicast_set_group_session_keys( uint8_t       mc_group_id,
                                                                      const uint8_t mc_ntw_skey[LORAWAN_KEY_SIZE],
                                                                      const uint8_t mc_app_skey[LORAWAN_KEY_SIZE] )
@@ -765,6 +780,30 @@ status_lorawan_t lorawan_api_nb_trans_set( uint8_t nb_trans )
     return lr1_stack_nb_trans_set( &lr1_mac_obj, nb_trans );
 }
 
+void lorawan_api_nb_trans_cpt_limit( uint8_t nb_trans_max )
+{
+    if( ( nb_trans_max > 0 ) && ( lr1_mac_obj.nb_trans_cpt > nb_trans_max ) )
+    {
+        lr1_mac_obj.nb_trans_cpt = nb_trans_max;
+    }
+}
+
+void lorawan_api_lr_fhss_dr_policy_set( bool enabled )
+{
+    lr1_stack_lr_fhss_dr_policy_set( &lr1_mac_obj, enabled );
+}
+
+bool lorawan_api_lr_fhss_dr_policy_get( void )
+{
+    return lr1_stack_lr_fhss_dr_policy_get( &lr1_mac_obj );
+}
+
+status_lorawan_t lorawan_api_lr_fhss_delivery_rate_get( uint8_t datarate, uint8_t* delivery_rate,
+                                                        uint8_t* nb_tracked )
+{
+    return lr1_stack_lr_fhss_delivery_rate_get( &lr1_mac_obj, datarate, delivery_rate, nb_tracked );
+}
+
 uint32_t lorawan_api_get_crystal_error( void )
 {
     return lr1_stack_get_crystal_error( &lr1_mac_obj );
@@ -833,30 +872,7 @@ status_lorawan_t lorawan_api_set_region_sub_band( uint8_t band )
 
 uint32_t lorawan_api_get_toa( uint8_t len )
 {
-    lr1_stack_mac_t* lr1_mac = &lr1_mac_obj;
-    uint32_t toa = 0;
-    uint8_t            tx_sf;
-    lr1mac_bandwidth_t tx_bw;
-    smtc_real_lora_dr_to_sf_bw( lr1_mac->real, lr1_mac->tx_data_rate, &tx_sf, &tx_bw );
-
-    ralf_params_lora_t lora_param;
-    memset( &lora_param, 0, sizeof( ralf_params_lora_t ) );
-
-    lora_param.mod_params.sf   = ( ral_lora_sf_t ) tx_sf;
-    lora_param.mod_params.bw   = ( ral_lora_bw_t ) tx_bw;
-    lora_param.mod_params.cr   = smtc_real_get_coding_rate( lr1_mac->real );
-    lora_param.mod_params.ldro = ral_compute_lora_ldro( lora_param.mod_params.sf, lora_param.mod_params.bw );
-
-    lora_param.pkt_params.crc_is_on            = true;
-    lora_param.pkt_params.invert_iq_is_on      = false;
-    lora_param.pkt_params.pld_len_in_bytes     = len;
-    lora_param.pkt_params.preamble_len_in_symb = smtc_real_get_preamble_len( lr1_mac->real, lora_param.mod_params.sf );
-    lora_param.pkt_params.header_type          = RAL_LORA_PKT_EXPLICIT;
-
-    toa = ral_get_lora_time_on_air_in_ms( ( &lr1_mac->rp->radio->ral ), ( &lora_param.pkt_params ),
-                                            ( &lora_param.mod_params ) );
-
-    return toa;
+    return lr1_stack_toa_get_for_payload_size( &lr1_mac_obj, len );
 }
 
 void lorawan_api_lbt_set_parameters( uint32_t listen_duration_ms, int16_t threshold_dbm, uint32_t bw_hz )
@@ -904,6 +920,11 @@ void lorawan_api_beacon_get_metadata( smtc_beacon_metadata_t* beacon_metadata )
     smtc_beacon_sniff_get_metadata( &lr1_beacon_obj, beacon_metadata );
 }
 
+void lorawan_api_beacon_get_drift_stats( smtc_beacon_drift_stats_t* drift_stats )
+{
+    smtc_beacon_sniff_get_drift_stats( &lr1_beacon_obj, drift_stats );
+}
+
 status_lorawan_t lorawan_api_get_ping_slot_info_req_status( void )
 {
     return lr1_mac_core_get_ping_slot_info_req_status( &lr1_mac_obj );
@@ -53,6 +53,7 @@ extern "C" {
 #include "lbm/smtc_modem_core/lr1mac/src/smtc_real/src/smtc_real_defs.h"
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_class_b/smtc_beacon_sniff.h"
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_class_b/smtc_d2d.h"
+#include "lbm/smtc_modem_core/lr1mac/src/lr1mac_class_c/lr1mac_class_c.h"
 #include "lbm/smtc_modem_core/radio_planner/src/radio_planner.h"
 #include "lbm/smtc_modem_core/modem_services/fifo_ctrl.h"
 
@@ -387,6 +388,23 @@ receive_win_t lorawan_api_rx_window_get( void );
  */
 uint32_t lorawan_api_next_join_time_second_get( void );
 
+/**
+ * @brief returns the join requests sent and the join accepts received at a datarate since reset
+ *
+ * @param [in]  datarate    Datarate
+ * @param [out] nb_attempts Join requests sent
+ * @param [out] nb_accepts  Join accepts received
+ * @return status_lorawan_t ERRORLORAWAN if datarate is out of range
+ */
+status_lorawan_t lorawan_api_join_stats_get( uint8_t datarate, uint16_t* nb_attempts, uint16_t* nb_accepts );
+
+/**
+ * @brief returns the join requests sent since the last join accept
+ *
+ * @return uint16_t Failed join requests, kept across reset
+ */
+uint16_t lorawan_api_join_nb_failed_get( void );
+
 /**
  * @brief when > 0, returns the min time to perform a new uplink request
  *
@@ -440,6 +458,13 @@ void lorawan_api_class_c_start( void );
  */
 void lorawan_api_class_c_stop( void );
 
+/**
+ * @brief Get class C continuous reception statistics
+ *
+ * @param [out] stats The class C statistics
+ */
+void lorawan_api_class_c_get_stats( lr1mac_class_c_stats_t* stats );
+
 /**
  * @brief Configure a multicast group session keys
  *
@@ -781,6 +806,40 @@ uint8_t lorawan_api_nb_trans_get( void );
  */
 status_lorawan_t lorawan_api_nb_trans_set( uint8_t nb_trans );
 
+/**
+ * @brief Limit the number of transmissions left for the uplink just sent
+ * @remark The configured nb trans is kept for the next uplinks
+ *
+ * @param [in] nb_trans_max Maximum number of transmissions, at least 1
+ */
+void lorawan_api_nb_trans_cpt_limit( uint8_t nb_trans_max );
+
+/**
+ * @brief Enable the LR-FHSS datarate policy, it chooses the coding rate of the LR-FHSS datarates drawn from a
+ *        distribution
+ *
+ * @param [in] enabled Policy state
+ */
+void lorawan_api_lr_fhss_dr_policy_set( bool enabled );
+
+/**
+ * @brief Get the LR-FHSS datarate policy state
+ *
+ * @return bool true if enabled
+ */
+bool lorawan_api_lr_fhss_dr_policy_get( void );
+
+/**
+ * @brief Get the delivery rate of an LR-FHSS datarate
+ *
+ * @param [in]  datarate        LR-FHSS datarate
+ * @param [out] delivery_rate   Delivery rate in percent
+ * @param [out] nb_tracked      Number of answers expected at this datarate
+ * @return status_lorawan_t ERRORLORAWAN if datarate is not an enabled LR-FHSS datarate
+ */
+status_lorawan_t lorawan_api_lr_fhss_delivery_rate_get( uint8_t datarate, uint8_t* delivery_rate,
+                                                        uint8_t* nb_tracked );
+
 /**
  * @brief Get the current crystal error
  *
@@ -943,6 +1002,13 @@ void lorawan_api_beacon_sniff_stop( void );
  */
 void lorawan_api_beacon_get_metadata( smtc_beacon_metadata_t* beacon_metadata );
 
+/**
+ * @brief Get the clock drift statistics estimated from the received beacons
+ *
+ * @param [out] drift_stats The clock drift statistics
+ */
+void lorawan_api_beacon_get_drift_stats( smtc_beacon_drift_stats_t* drift_stats );
+
 /**
  * @brief Get Ping Slot Info Request status
  *
@@ -98,6 +98,8 @@ static status_lorawan_t device_time_ans_parser( lr1_stack_mac_t* lr1_mac );
 static void             beacon_freq_req_parser( lr1_stack_mac_t* lr1_mac );
 static void             ping_slot_channel_req_parser( lr1_stack_mac_t* lr1_mac );
 static status_lorawan_t ping_slot_info_ans_parser( lr1_stack_mac_t* lr1_mac );
+static bool             lr1_stack_is_lr_fhss_dr( lr1_stack_mac_t* lr1_mac, uint8_t datarate );
+static bool             lr1_stack_is_lr_fhss_dr_robust( lr1_stack_mac_t* lr1_mac, uint8_t datarate );
 
 /*
  *-----------------------------------------------------------------------------------
@@ -130,6 +132,8 @@ void lr1_stack_mac_init( lr1_stack_mac_t* lr1_mac, lr1mac_activation_mode_t acti
     lr1_mac->timestamp_tx_done_device_time_req_ms_tmp = 0;
     memset( lr1_mac->fine_tune_board_setting_delay_ms, 0, sizeof( lr1_mac->fine_tune_board_setting_delay_ms ) );
     memset( lr1_mac->join_nonce, 0xFF, sizeof( lr1_mac->join_nonce ) );
+    smtc_lr_fhss_scheduler_init( &lr1_mac->lr_fhss_scheduler );
+    smtc_join_scheduler_init( &lr1_mac->join_scheduler, SMTC_LR1MAC_DEVNONCE_SAVE_PERIOD );
 
     lr1_stack_mac_session_init( lr1_mac );
 }
@@ -165,6 +169,10 @@ void lr1_stack_mac_region_init( lr1_stack_mac_t* lr1_mac, smtc_real_region_types
 {
     smtc_real_init( lr1_mac->real, region_type );
 
+    // Entries are keyed by region, this only releases the ones of the previous region
+    smtc_toa_cache_init( &lr1_mac->toa_cache );
+    smtc_lr_fhss_scheduler_reset_stats( &lr1_mac->lr_fhss_scheduler );
+
     // Init duty-cycle object
     smtc_duty_cycle_init( lr1_mac->dtc_obj );
     if( real_const.const_dtc_supported == true )
@@ -390,6 +398,9 @@ void lr1_stack_mac_rx_gfsk_launch_callback_for_rp( void* rp_void )
 
 void lr1_stack_mac_tx_radio_start( lr1_stack_mac_t* lr1_mac )
 {
+#if defined( LR1MAC_PROFILE_TX_RADIO_START )
+    const uint32_t start_cycles = smtc_modem_hal_get_cpu_cycle_count( );
+#endif
     rp_radio_params_t radio_params = { 0 };
     rp_task_t         rp_task      = { 0 };
     uint32_t          toa          = 0;
@@ -426,9 +437,6 @@ void lr1_stack_mac_tx_radio_start( lr1_stack_mac_t* lr1_mac )
         radio_params.pkt_type = RAL_PKT_TYPE_LORA;
         radio_params.tx.lora  = lora_param;
 
-        toa = ral_get_lora_time_on_air_in_ms( ( &lr1_mac->rp->radio->ral ), ( &lora_param.pkt_params ),
-                                              ( &lora_param.mod_params ) );
-
         rp_task.type                  = RP_TASK_TYPE_TX_LORA;
         rp_task.launch_task_callbacks = lr1_stack_mac_tx_lora_launch_callback_for_rp;
     }
@@ -464,9 +472,6 @@ void lr1_stack_mac_tx_radio_start( lr1_stack_mac_t* lr1_mac )
         radio_params.pkt_type = RAL_PKT_TYPE_GFSK;
         radio_params.tx.gfsk  = gfsk_param;
 
-        toa = ral_get_gfsk_time_on_air_in_ms( ( &lr1_mac->rp->radio->ral ), ( &gfsk_param.pkt_params ),
-                                              ( &gfsk_param.mod_params ) );
-
         rp_task.type                  = RP_TASK_TYPE_TX_FSK;
         rp_task.launch_task_callbacks = lr1_stack_mac_tx_gfsk_launch_callback_for_rp;
     }
@@ -481,9 +486,6 @@ void lr1_stack_mac_tx_radio_start( lr1_stack_mac_t* lr1_mac )
 
         lr_fhss_param.output_pwr_in_dbm = smtc_real_clamp_output_power_eirp_vs_freq_and_dr(
             lr1_mac->real, lr1_mac->tx_power, lr1_mac->tx_frequency, lr1_mac->tx_data_rate );
-        uint32_t nb_max_hop_sequence =
-            ral_lr_fhss_get_hop_sequence_count( &lr1_mac->rp->radio->ral, &lr_fhss_param.ral_lr_fhss_params );
-        lr_fhss_param.hop_sequence_id = smtc_modem_hal_get_random_nb_in_range( 0, nb_max_hop_sequence );
         lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.modulation_type = LR_FHSS_V1_MODULATION_TYPE_GMSK_488;
         lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.cr              = tx_cr;
         lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.grid            = smtc_real_lr_fhss_get_grid( lr1_mac->real );
@@ -494,10 +496,17 @@ void lr1_stack_mac_tx_radio_start( lr1_stack_mac_t* lr1_mac )
         lr_fhss_param.ral_lr_fhss_params.center_frequency_in_hz   = lr1_mac->tx_frequency;
         lr_fhss_param.ral_lr_fhss_params.device_offset            = 0;
 
-        radio_params.tx.lr_fhss = lr_fhss_param;
+        // The number of hop sequences depends on the grid and the bandwidth, set above
+        uint32_t nb_hop_sequences =
+            ral_lr_fhss_get_hop_sequence_count( &lr1_mac->rp->radio->ral, &lr_fhss_param.ral_lr_fhss_params );
+        lr_fhss_param.hop_sequence_id = smtc_modem_hal_get_random_nb_in_range( 0, nb_hop_sequences - 1 );
+        // The LinkCheckReq carried by this uplink is only marked as sent at its tx done
+        smtc_lr_fhss_scheduler_on_uplink( &lr1_mac->lr_fhss_scheduler, lr1_mac->tx_data_rate,
+                                          lr1_mac->tx_mtype == CONF_DATA_UP,
+                                          ( lr1_mac->link_check_user_req == USER_MAC_REQ_REQUESTED ) ||
+                                              ( lr1_mac->link_check_user_req == USER_MAC_REQ_SENT ) );
 
-        ral_lr_fhss_get_time_on_air_in_ms( ( &lr1_mac->rp->radio->ral ), &lr_fhss_param.ral_lr_fhss_params,
-                                           lr1_mac->tx_payload_size, &toa );
+        radio_params.tx.lr_fhss = lr_fhss_param;
 
         // SMTC_MODEM_HAL_TRACE_PRINTF( "  Hop ID = %d\n", lr_fhss_param.hop_sequence_id );
 
@@ -509,6 +518,9 @@ void lr1_stack_mac_tx_radio_start( lr1_stack_mac_t* lr1_mac )
         smtc_modem_hal_lr1mac_panic( "TX MODULATION NOT SUPPORTED\n" );
     }
 
+    // Same parameters as above, the toa only depends on the region, the datarate and the payload size
+    toa = lr1_stack_toa_get( lr1_mac );
+
     uint8_t my_hook_id;
     if( rp_hook_get_id( lr1_mac->rp, lr1_mac, &my_hook_id ) != RP_HOOK_STATUS_OK )
     {
@@ -534,6 +546,10 @@ void lr1_stack_mac_tx_radio_start( lr1_stack_mac_t* lr1_mac )
         lr1_mac->radio_process_state = RADIOSTATE_ABORTED_BY_RP;
         SMTC_MODEM_HAL_TRACE_PRINTF( "Radio planner hook %d is busy\n", my_hook_id );
     }
+#if defined( LR1MAC_PROFILE_TX_RADIO_START )
+    SMTC_MODEM_HAL_TRACE_PRINTF( "tx_radio_start: %u cycles, toa %u ms\n",
+                                 smtc_modem_hal_get_cpu_cycle_count( ) - start_cycles, toa );
+#endif
 }
 
 void lr1_stack_mac_rx_radio_start( lr1_stack_mac_t* lr1_mac, const rx_win_type_t type, const uint32_t time_to_start )
@@ -1091,6 +1107,15 @@ void lr1_stack_mac_update_tx_done( lr1_stack_mac_t* lr1_mac )
 
 void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
 {
+    // The downlink has been parsed, record whether the answer expected by an LR-FHSS uplink came
+    if( lr1_stack_is_lr_fhss_dr( lr1_mac, lr1_mac->tx_data_rate ) == true )
+    {
+        smtc_lr_fhss_scheduler_on_downlink( &lr1_mac->lr_fhss_scheduler, lr1_mac->rx_ack_bit == 1,
+                                            lr1_mac->link_check_user_req == USER_MAC_REQ_ACKED,
+                                            lr1_mac->link_check_margin,
+                                            lr1_stack_is_lr_fhss_dr_robust( lr1_mac, lr1_mac->tx_data_rate ) );
+    }
+
     lr1_mac->adr_ack_limit       = lr1_mac->adr_ack_limit_init;
     lr1_mac->adr_ack_delay       = lr1_mac->adr_ack_delay_init;
     lr1_mac->type_of_ans_to_send = NOFRAME_TOSEND;
@@ -1122,6 +1147,9 @@ void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
             // ts=cur_ts+(toa_s*10000) = cur_ts + (toa_ms / 1000) * 10000 = cur_ts + toa_ms*10
         }
 
+        // Random back-off on top of the join duty-cycle, its window doubles with each failed join request
+        lr1_mac->next_time_to_join_seconds += smtc_join_scheduler_get_backoff_s( &lr1_mac->join_scheduler );
+
         // Now join status can be set as not joined
         lr1_mac->join_status = NOT_JOINED;
     }
@@ -1242,14 +1270,17 @@ status_lorawan_t lr1_stack_mac_cmd_parse( lr1_stack_mac_t* lr1_mac )
     lr1_mac->tx_fopts_length       = 0;
     lr1_mac->tx_fopts_lengthsticky = 0;
 
+    // First pass: delimit the whole block before applying any command, so that a block which can't be answered is
+    // rejected without partially updating the mac and region context
+    if( lr1_stack_mac_cmd_block_check( lr1_mac->nwk_payload, &lr1_mac->nwk_payload_size ) >
+        DEVICE_MAC_PAYLOAD_MAX_SIZE )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "too much cmd in the payload\n" );
+        return ( ERRORLORAWAN );
+    }
+
     while( lr1_mac->nwk_payload_size > lr1_mac->nwk_payload_index )
     {  //@note MacNwkPayloadSize and lr1_mac->nwk_payload[0] are updated in Parser's method
-
-        if( lr1_mac->tx_fopts_length > DEVICE_MAC_PAYLOAD_MAX_SIZE )
-        {
-            SMTC_MODEM_HAL_TRACE_WARNING( "too much cmd in the payload\n" );
-            return ( ERRORLORAWAN );
-        }
         cmd_identifier = lr1_mac->nwk_payload[lr1_mac->nwk_payload_index];
         switch( cmd_identifier )
         {
@@ -1491,83 +1522,94 @@ int32_t lr1_stack_network_next_free_duty_cycle_ms_get( lr1_stack_mac_t* lr1_mac
 
 uint32_t lr1_stack_toa_get( lr1_stack_mac_t* lr1_mac )
 {
-    uint32_t toa = 0;
+    return lr1_stack_toa_get_for_payload_size( lr1_mac, lr1_mac->tx_payload_size );
+}
 
-    modulation_type_t tx_modulation_type =
-        smtc_real_get_modulation_type_from_datarate( lr1_mac->real, lr1_mac->tx_data_rate );
+uint32_t lr1_stack_toa_get_for_payload_size( lr1_stack_mac_t* lr1_mac, uint8_t payload_size )
+{
+    uint32_t toa         = 0;
+    uint8_t  region_type = ( uint8_t ) lr1_mac->real->region_type;
 
-    if( tx_modulation_type == LORA )
+    if( smtc_toa_cache_get( &lr1_mac->toa_cache, region_type, lr1_mac->tx_data_rate, payload_size, &toa ) == false )
     {
-        uint8_t            tx_sf;
-        lr1mac_bandwidth_t tx_bw;
-        smtc_real_lora_dr_to_sf_bw( lr1_mac->real, lr1_mac->tx_data_rate, &tx_sf, &tx_bw );
+        toa = smtc_toa_cache_compute( lr1_mac->real, &lr1_mac->rp->radio->ral, lr1_mac->tx_data_rate, payload_size );
+        smtc_toa_cache_set( &lr1_mac->toa_cache, region_type, lr1_mac->tx_data_rate, payload_size, toa );
+    }
+    return toa;
+}
 
-        ralf_params_lora_t lora_param;
-        memset( &lora_param, 0, sizeof( ralf_params_lora_t ) );
+void lr1_stack_lr_fhss_select_dr( lr1_stack_mac_t* lr1_mac, uint8_t payload_size )
+{
+    if( ( lr1_mac->lr_fhss_scheduler.dr_policy_enabled == false ) || ( lr1_mac->adr_mode_select == STATIC_ADR_MODE ) ||
+        ( lr1_stack_is_lr_fhss_dr( lr1_mac, lr1_mac->tx_data_rate ) == false ) )
+    {
+        return;
+    }
 
-        lora_param.mod_params.sf   = ( ral_lora_sf_t ) tx_sf;
-        lora_param.mod_params.bw   = ( ral_lora_bw_t ) tx_bw;
-        lora_param.mod_params.cr   = smtc_real_get_coding_rate( lr1_mac->real );
-        lora_param.mod_params.ldro = ral_compute_lora_ldro( lora_param.mod_params.sf, lora_param.mod_params.bw );
+    // Look for the CR 1/3 and CR 2/3 datarates sharing the bandwidth, and so the occupied band, of the drawn one
+    lr_fhss_v1_cr_t tx_cr;
+    lr_fhss_v1_bw_t tx_bw;
+    uint8_t         robust_dr = lr1_mac->tx_data_rate;
+    uint8_t         fast_dr   = lr1_mac->tx_data_rate;
+    smtc_real_lr_fhss_dr_to_cr_bw( lr1_mac->real, lr1_mac->tx_data_rate, &tx_cr, &tx_bw );
 
-        lora_param.pkt_params.crc_is_on        = true;
-        lora_param.pkt_params.invert_iq_is_on  = false;
-        lora_param.pkt_params.pld_len_in_bytes = lr1_mac->tx_payload_size;
-        lora_param.pkt_params.preamble_len_in_symb =
-            smtc_real_get_preamble_len( lr1_mac->real, lora_param.mod_params.sf );
-        lora_param.pkt_params.header_type = RAL_LORA_PKT_EXPLICIT;
+    for( uint8_t dr = real_const.const_min_tx_dr; dr <= real_const.const_max_tx_dr; dr++ )
+    {
+        lr_fhss_v1_cr_t cr;
+        lr_fhss_v1_bw_t bw;
 
-        toa = ral_get_lora_time_on_air_in_ms( ( &lr1_mac->rp->radio->ral ), ( &lora_param.pkt_params ),
-                                              ( &lora_param.mod_params ) );
+        if( lr1_stack_is_lr_fhss_dr( lr1_mac, dr ) == false )
+        {
+            continue;
+        }
+        smtc_real_lr_fhss_dr_to_cr_bw( lr1_mac->real, dr, &cr, &bw );
+        if( bw == tx_bw )
+        {
+            if( cr == LR_FHSS_V1_CR_1_3 )
+            {
+                robust_dr = dr;
+            }
+            else if( cr == LR_FHSS_V1_CR_2_3 )
+            {
+                fast_dr = dr;
+            }
+        }
     }
-    else if( tx_modulation_type == FSK )
+    if( robust_dr == fast_dr )
     {
-        uint8_t tx_bitrate;
-        smtc_real_fsk_dr_to_bitrate( lr1_mac->real, lr1_mac->tx_data_rate, &tx_bitrate );
-
-        ralf_params_gfsk_t gfsk_param;
-        memset( &gfsk_param, 0, sizeof( ralf_params_gfsk_t ) );
-
-        gfsk_param.rf_freq_in_hz                    = lr1_mac->tx_frequency;
-        gfsk_param.sync_word                        = smtc_real_get_gfsk_sync_word( lr1_mac->real );
-        gfsk_param.dc_free_is_on                    = true;
-        gfsk_param.whitening_seed                   = GFSK_WHITENING_SEED;
-        gfsk_param.crc_seed                         = GFSK_CRC_SEED;
-        gfsk_param.crc_polynomial                   = GFSK_CRC_POLYNOMIAL;
-        gfsk_param.mod_params.fdev_in_hz            = 25000;
-        gfsk_param.mod_params.br_in_bps             = tx_bitrate * 1000;
-        gfsk_param.mod_params.bw_dsb_in_hz          = 100000;
-        gfsk_param.pkt_params.pld_len_in_bytes      = lr1_mac->tx_payload_size;
-        gfsk_param.pkt_params.preamble_len_in_bits  = 40;
-        gfsk_param.pkt_params.header_type           = RAL_GFSK_PKT_VAR_LEN;
-        gfsk_param.pkt_params.sync_word_len_in_bits = 24;
-        gfsk_param.pkt_params.dc_free               = RAL_GFSK_DC_FREE_WHITENING;
-        gfsk_param.pkt_params.crc_type              = RAL_GFSK_CRC_2_BYTES_INV;
-
-        toa = ral_get_gfsk_time_on_air_in_ms( ( &lr1_mac->rp->radio->ral ), ( &gfsk_param.pkt_params ),
-                                              ( &gfsk_param.mod_params ) );
+        return;
     }
-    else if( tx_modulation_type == LR_FHSS )
+
+    uint8_t new_dr =
+        smtc_lr_fhss_scheduler_select_dr( &lr1_mac->lr_fhss_scheduler, lr1_mac->tx_data_rate, robust_dr, fast_dr );
+    if( ( new_dr != lr1_mac->tx_data_rate ) &&
+        ( smtc_real_is_payload_size_valid( lr1_mac->real, new_dr, payload_size, UP_LINK,
+                                           lr1_mac->tx_fopts_current_length ) == OKLORAWAN ) )
     {
-        lr_fhss_v1_cr_t tx_cr;
-        lr_fhss_v1_bw_t tx_bw;
-        smtc_real_lr_fhss_dr_to_cr_bw( lr1_mac->real, lr1_mac->tx_data_rate, &tx_cr, &tx_bw );
+        lr1_mac->tx_data_rate = new_dr;
+    }
+}
 
-        ralf_params_lr_fhss_t lr_fhss_param;
-        memset( &lr_fhss_param, 0, sizeof( ralf_params_lr_fhss_t ) );
+void lr1_stack_lr_fhss_dr_policy_set( lr1_stack_mac_t* lr1_mac, bool enabled )
+{
+    lr1_mac->lr_fhss_scheduler.dr_policy_enabled = enabled;
+}
 
-        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.cr             = tx_cr;
-        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.enable_hopping = true;
-        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.header_count   = smtc_real_lr_fhss_get_header_count( tx_cr );
+bool lr1_stack_lr_fhss_dr_policy_get( lr1_stack_mac_t* lr1_mac )
+{
+    return lr1_mac->lr_fhss_scheduler.dr_policy_enabled;
+}
 
-        ral_lr_fhss_get_time_on_air_in_ms( ( &lr1_mac->rp->radio->ral ), &lr_fhss_param.ral_lr_fhss_params,
-                                           lr1_mac->tx_payload_size, &toa );
-    }
-    else
+status_lorawan_t lr1_stack_lr_fhss_delivery_rate_get( lr1_stack_mac_t* lr1_mac, uint8_t datarate,
+                                                      uint8_t* delivery_rate, uint8_t* nb_tracked )
+{
+    if( ( datarate >= SMTC_LR_FHSS_SCHEDULER_NB_DR ) || ( lr1_stack_is_lr_fhss_dr( lr1_mac, datarate ) == false ) )
     {
-        smtc_modem_hal_lr1mac_panic( "TX MODULATION NOT SUPPORTED\n" );
+        return ERRORLORAWAN;
     }
-    return toa;
+    *delivery_rate = lr1_mac->lr_fhss_scheduler.delivery_rate[datarate];
+    *nb_tracked    = lr1_mac->lr_fhss_scheduler.nb_tracked[datarate];
+    return OKLORAWAN;
 }
 
 uint8_t lr1_stack_nb_trans_get( lr1_stack_mac_t* lr1_mac )
@@ -2430,6 +2472,24 @@ static void ping_slot_channel_req_parser( lr1_stack_mac_t* lr1_mac )
     }
 }
 
+static bool lr1_stack_is_lr_fhss_dr( lr1_stack_mac_t* lr1_mac, uint8_t datarate )
+{
+    // Out of range datarates make the region panic, they are never in the mask
+    uint16_t dr_mask = smtc_real_mask_tx_dr_channel_up_dwell_time_check( lr1_mac->real );
+
+    return ( datarate < 16 ) && ( SMTC_GET_BIT16( &dr_mask, datarate ) == 1 ) &&
+           ( smtc_real_get_modulation_type_from_datarate( lr1_mac->real, datarate ) == LR_FHSS );
+}
+
+static bool lr1_stack_is_lr_fhss_dr_robust( lr1_stack_mac_t* lr1_mac, uint8_t datarate )
+{
+    lr_fhss_v1_cr_t cr;
+    lr_fhss_v1_bw_t bw;
+
+    smtc_real_lr_fhss_dr_to_cr_bw( lr1_mac->real, datarate, &cr, &bw );
+    return cr == LR_FHSS_V1_CR_1_3;
+}
+
 /*********************************************************************************************************************/
 /*                                                 Private NWK MANAGEMENTS :
  * ping_slot_info_ans_parser                        */
@@ -46,6 +46,9 @@ extern "C" {
 #include "lbm/smtc_modem_core/radio_planner/src/radio_planner.h"
 #include "lbm/smtc_modem_core/lr1mac/src/services/smtc_duty_cycle.h"
 #include "lbm/smtc_modem_core/lr1mac/src/services/smtc_lbt.h"
+#include "lbm/smtc_modem_core/lr1mac/src/services/smtc_toa_cache.h"
+#include "lbm/smtc_modem_core/lr1mac/src/services/smtc_lr_fhss_scheduler.h"
+#include "lbm/smtc_modem_core/lr1mac/src/services/smtc_join_scheduler.h"
 
 #ifndef MIN_RX_WINDOW_SYMB
 #define MIN_RX_WINDOW_SYMB 6  // open rx window at least 6 symbols
@@ -67,6 +70,10 @@ typedef struct lr1_stack_mac_s
     smtc_dtc_t*   dtc_obj;
     smtc_lbt_t*   lbt_obj;
 
+    smtc_toa_cache_t         toa_cache;          // Time on air of the recent uplink configurations
+    smtc_lr_fhss_scheduler_t lr_fhss_scheduler;  // Datarate policy of the LR-FHSS uplinks
+    smtc_join_scheduler_t    join_scheduler;     // Join back-off, DevNonce reservation and join statistics
+
     void ( *push_callback )( void* );
     void* push_context;
 
@@ -403,6 +410,51 @@ int32_t lr1_stack_network_next_free_duty_cycle_ms_get( lr1_stack_mac_t* lr1_mac
  */
 uint32_t lr1_stack_toa_get( lr1_stack_mac_t* lr1_mac );
 
+/*!
+ * \brief lr1_stack_toa_get_for_payload_size
+ * \remark toa of a frame of payload_size bytes at the current tx datarate, served from the toa cache when possible
+ * \param [IN]  lr1_stack_mac_t
+ * \param [IN]  payload_size
+ * \return toa in ms
+ */
+uint32_t lr1_stack_toa_get_for_payload_size( lr1_stack_mac_t* lr1_mac, uint8_t payload_size );
+
+/*!
+ * \brief lr1_stack_lr_fhss_select_dr
+ * \remark if the LR-FHSS datarate policy is enabled, choose the coding rate of the LR-FHSS datarate drawn for the
+ *         next uplink. The datarate is only changed if a payload of payload_size bytes fits in the new one
+ * \param [IN]  lr1_stack_mac_t
+ * \param [IN]  payload_size
+ */
+void lr1_stack_lr_fhss_select_dr( lr1_stack_mac_t* lr1_mac, uint8_t payload_size );
+
+/*!
+ * \brief lr1_stack_lr_fhss_dr_policy_set
+ * \remark the policy only applies to the datarates drawn from a distribution, never to network controlled ones
+ * \param [IN]  lr1_stack_mac_t
+ * \param [IN]  enabled
+ */
+void lr1_stack_lr_fhss_dr_policy_set( lr1_stack_mac_t* lr1_mac, bool enabled );
+
+/*!
+ * \brief lr1_stack_lr_fhss_dr_policy_get
+ * \param [IN]  lr1_stack_mac_t
+ * \return true if the LR-FHSS datarate policy is enabled
+ */
+bool lr1_stack_lr_fhss_dr_policy_get( lr1_stack_mac_t* lr1_mac );
+
+/*!
+ * \brief lr1_stack_lr_fhss_delivery_rate_get
+ * \remark tracked from the confirmed uplinks and the LinkCheckReq sent at this datarate
+ * \param [IN]  lr1_stack_mac_t
+ * \param [IN]  datarate
+ * \param [OUT] delivery_rate in percent
+ * \param [OUT] nb_tracked number of answers expected, saturated to 255
+ * \return ERRORLORAWAN if datarate is not an enabled LR-FHSS datarate
+ */
+status_lorawan_t lr1_stack_lr_fhss_delivery_rate_get( lr1_stack_mac_t* lr1_mac, uint8_t datarate,
+                                                      uint8_t* delivery_rate, uint8_t* nb_tracked );
+
 /**
  * @brief
  *
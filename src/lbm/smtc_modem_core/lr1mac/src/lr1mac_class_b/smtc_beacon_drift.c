@@ -0,0 +1,233 @@
+/*!
+ * \file      smtc_beacon_drift.c
+ *
+ * \brief     Clock drift estimation from received beacons for LoRaWAN class B devices
+ *
+ * Revised BSD License
+ * Copyright Semtech Corporation 2023. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // memset
+
+#include "lbm/smtc_modem_core/modem_config/smtc_modem_hal_dbg_trace.h"
+#include "smtc_beacon_drift.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Integer square root
+ *
+ * @param [in] value
+ * @return uint32_t floor( sqrt( value ) )
+ */
+static uint32_t smtc_beacon_drift_isqrt( uint64_t value );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_beacon_drift_reset( smtc_beacon_drift_t* drift, uint32_t crystal_error_ppm )
+{
+    memset( drift, 0, sizeof( smtc_beacon_drift_t ) );
+    drift->crystal_error_ppm = crystal_error_ppm;
+    drift->uncertainty_ppb   = crystal_error_ppm * 1000;
+}
+
+void smtc_beacon_drift_add_sample( smtc_beacon_drift_t* drift, int32_t phase_error_100us, uint32_t interval_ms,
+                                   int8_t temperature )
+{
+    if( interval_ms == 0 )
+    {
+        return;
+    }
+
+    // 100us over interval_ms expressed in ppb
+    int64_t sample_ppb = ( ( int64_t ) phase_error_100us * 100000000LL ) / ( int64_t ) interval_ms;
+
+    drift->sample_ppb[drift->sample_index]         = ( int32_t ) sample_ppb;
+    drift->sample_temperature[drift->sample_index] = temperature;
+    drift->sample_index                            = ( drift->sample_index + 1 ) % BEACON_DRIFT_NB_SAMPLES;
+    if( drift->nb_samples < BEACON_DRIFT_NB_SAMPLES )
+    {
+        drift->nb_samples++;
+    }
+
+    drift->temperature_min = INT8_MAX;
+    drift->temperature_max = INT8_MIN;
+    for( uint8_t i = 0; i < drift->nb_samples; i++ )
+    {
+        if( drift->sample_temperature[i] < drift->temperature_min )
+        {
+            drift->temperature_min = drift->sample_temperature[i];
+        }
+        if( drift->sample_temperature[i] > drift->temperature_max )
+        {
+            drift->temperature_max = drift->sample_temperature[i];
+        }
+    }
+}
+
+uint32_t smtc_beacon_drift_update( smtc_beacon_drift_t* drift, uint32_t crystal_error_ppm, int8_t temperature )
+{
+    int64_t n     = drift->nb_samples;
+    int64_t sum_x = 0;
+    int64_t sum_y = 0;
+    int64_t sxx   = 0;
+    int64_t sxy   = 0;
+    int64_t sr2   = 0;
+    bool    fit_temperature =
+        ( ( drift->temperature_max - drift->temperature_min ) >= BEACON_DRIFT_TEMPERATURE_SPREAD ) ? true : false;
+
+    drift->is_valid = false;
+
+    if( ( n < BEACON_DRIFT_MIN_SAMPLES ) ||
+        ( temperature < ( drift->temperature_min - BEACON_DRIFT_TEMPERATURE_SPREAD ) ) ||
+        ( temperature > ( drift->temperature_max + BEACON_DRIFT_TEMPERATURE_SPREAD ) ) )
+    {
+        drift->crystal_error_ppm = crystal_error_ppm;
+        return drift->crystal_error_ppm;
+    }
+
+    for( uint8_t i = 0; i < n; i++ )
+    {
+        sum_x += drift->sample_temperature[i];
+        sum_y += drift->sample_ppb[i];
+    }
+
+    // Least square fit y = mean_y + slope * ( x - mean_x ), computed on n * ( x - mean_x ) to stay in integers
+    if( fit_temperature == true )
+    {
+        for( uint8_t i = 0; i < n; i++ )
+        {
+            int64_t dx = ( n * drift->sample_temperature[i] ) - sum_x;
+            sxx += dx * dx;
+            sxy += dx * drift->sample_ppb[i];
+        }
+    }
+
+    for( uint8_t i = 0; i < n; i++ )
+    {
+        int64_t predicted = sum_y / n;
+        if( sxx != 0 )
+        {
+            predicted += ( sxy * ( ( n * drift->sample_temperature[i] ) - sum_x ) ) / sxx;
+        }
+        int64_t residual = drift->sample_ppb[i] - predicted;
+        sr2 += residual * residual;
+    }
+
+    int64_t drift_ppb = sum_y / n;
+    if( sxx != 0 )
+    {
+        drift_ppb += ( sxy * ( ( n * temperature ) - sum_x ) ) / sxx;
+    }
+    uint32_t sigma_ppb = smtc_beacon_drift_isqrt( ( uint64_t ) sr2 / ( uint64_t )( n - ( ( sxx != 0 ) ? 2 : 1 ) ) );
+
+    drift->drift_ppb       = ( int32_t ) drift_ppb;
+    drift->uncertainty_ppb = ( uint32_t )( ( drift_ppb < 0 ) ? -drift_ppb : drift_ppb ) +
+                             ( BEACON_DRIFT_NB_SIGMA * sigma_ppb ) + BEACON_DRIFT_MARGIN_PPB;
+
+    // Rx windows are sized in ppm
+    drift->crystal_error_ppm = ( drift->uncertainty_ppb + 999 ) / 1000;
+    if( drift->crystal_error_ppm >= crystal_error_ppm )
+    {
+        drift->crystal_error_ppm = crystal_error_ppm;
+    }
+    else
+    {
+        drift->is_valid = true;
+    }
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Beacon drift %d ppb, sigma %u ppb, crystal error applied %u ppm\n",
+                                 drift->drift_ppb, sigma_ppb, drift->crystal_error_ppm );
+    return drift->crystal_error_ppm;
+}
+
+void smtc_beacon_drift_account_rx_window( smtc_beacon_drift_t* drift, uint32_t rx_window_ms,
+                                          uint32_t rx_window_bsp_ms )
+{
+    if( drift->is_valid == false )
+    {
+        return;
+    }
+    drift->nb_rx_windows++;
+    if( rx_window_bsp_ms > rx_window_ms )
+    {
+        drift->rx_window_saved_ms += rx_window_bsp_ms - rx_window_ms;
+    }
+}
+
+void smtc_beacon_drift_get_stats( const smtc_beacon_drift_t* drift, smtc_beacon_drift_stats_t* stats )
+{
+    stats->drift_ppb          = drift->drift_ppb;
+    stats->uncertainty_ppb    = drift->uncertainty_ppb;
+    stats->nb_samples         = drift->nb_samples;
+    stats->is_valid           = drift->is_valid;
+    stats->crystal_error_ppm  = drift->crystal_error_ppm;
+    stats->nb_rx_windows      = drift->nb_rx_windows;
+    stats->rx_window_saved_ms = drift->rx_window_saved_ms;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint32_t smtc_beacon_drift_isqrt( uint64_t value )
+{
+    uint64_t root = 0;
+    uint64_t bit  = 1ULL << 62;
+
+    while( bit > value )
+    {
+        bit >>= 2;
+    }
+    while( bit != 0 )
+    {
+        if( value >= root + bit )
+        {
+            value -= root + bit;
+            root = ( root >> 1 ) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return ( uint32_t ) root;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,173 @@
+/*!
+ * \file      smtc_beacon_drift.h
+ *
+ * \brief     Clock drift estimation from received beacons for LoRaWAN class B devices
+ *
+ * Revised BSD License
+ * Copyright Semtech Corporation 2023. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __SMTC_BEACON_DRIFT_H__
+#define __SMTC_BEACON_DRIFT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/**
+ * @brief Number of beacon timing samples kept to estimate the clock drift
+ */
+#define BEACON_DRIFT_NB_SAMPLES ( 8 )
+/**
+ * @brief Minimum number of samples before the estimated drift is used to size the rx windows
+ */
+#define BEACON_DRIFT_MIN_SAMPLES ( 4 )
+/**
+ * @brief Minimum temperature spread (in celsius) between samples to fit the drift against the temperature
+ */
+#define BEACON_DRIFT_TEMPERATURE_SPREAD ( 3 )
+/**
+ * @brief Margin in ppb added to the estimated uncertainty to cover the 100us timestamp resolution over a beacon period
+ */
+#define BEACON_DRIFT_MARGIN_PPB ( 1000 )
+/**
+ * @brief Number of standard deviations of the residual drift covered by the rx windows
+ */
+#define BEACON_DRIFT_NB_SIGMA ( 3 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Clock drift statistics
+ */
+typedef struct smtc_beacon_drift_stats_s
+{
+    int32_t  drift_ppb;            //!< estimated residual clock drift at the current temperature, in ppb
+    uint32_t uncertainty_ppb;      //!< drift bound covered by the rx windows (drift + BEACON_DRIFT_NB_SIGMA sigma)
+    uint8_t  nb_samples;           //!< number of beacon samples used by the estimator
+    bool     is_valid;             //!< the estimate is used to size the rx windows
+    uint32_t crystal_error_ppm;    //!< crystal error currently applied to the beacon and ping slot rx windows
+    uint32_t nb_rx_windows;        //!< number of beacon and ping slot rx windows sized with the estimate
+    uint32_t rx_window_saved_ms;   //!< cumulated rx window time saved compared to the bsp crystal error
+} smtc_beacon_drift_stats_t;
+
+/**
+ * @brief Clock drift estimator context
+ * @remark the estimator fits the residual phase error of the beacon pll, normalized by the time elapsed since the
+ * previous received beacon, against the temperature measured at beacon reception
+ */
+typedef struct smtc_beacon_drift_s
+{
+    int32_t  sample_ppb[BEACON_DRIFT_NB_SAMPLES];          //!< ring of measured drift samples in ppb
+    int8_t   sample_temperature[BEACON_DRIFT_NB_SAMPLES];  //!< temperature in celsius of each sample
+    uint8_t  nb_samples;                                   //!< number of valid samples in the ring
+    uint8_t  sample_index;                                 //!< next write index in the ring
+    int8_t   temperature_min;                              //!< lowest temperature of the valid samples
+    int8_t   temperature_max;                              //!< highest temperature of the valid samples
+    int32_t  drift_ppb;                                    //!< last estimated drift
+    uint32_t uncertainty_ppb;                              //!< last estimated drift bound
+    bool     is_valid;                                     //!< the estimate can be used
+    uint32_t crystal_error_ppm;  //!< crystal error to apply to the rx windows until the next beacon
+    uint32_t nb_rx_windows;      //!< number of rx windows sized with the estimate
+    uint32_t rx_window_saved_ms;  //!< cumulated rx window time saved compared to the bsp crystal error
+} smtc_beacon_drift_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Reset the drift estimator, samples and statistics are cleared
+ *
+ * @param [out] drift              Drift estimator object
+ * @param [in] crystal_error_ppm   Bsp crystal error in ppm applied until the estimate is valid
+ */
+void smtc_beacon_drift_reset( smtc_beacon_drift_t* drift, uint32_t crystal_error_ppm );
+
+/**
+ * @brief Add a beacon timing sample to the estimator
+ *
+ * @param [in,out] drift        Drift estimator object
+ * @param [in] phase_error_100us Phase error between the received beacon and the predicted beacon time
+ * @param [in] interval_ms       Time elapsed since the previous received beacon
+ * @param [in] temperature       Temperature in celsius at beacon reception
+ */
+void smtc_beacon_drift_add_sample( smtc_beacon_drift_t* drift, int32_t phase_error_100us, uint32_t interval_ms,
+                                   int8_t temperature );
+
+/**
+ * @brief Update the drift estimate and the crystal error applied to the rx windows
+ *
+ * @remark the bsp crystal error is used as long as the estimate is not valid or when the temperature leaves the range
+ * covered by the samples
+ *
+ * @param [in,out] drift          Drift estimator object
+ * @param [in] crystal_error_ppm  Bsp crystal error in ppm, upper bound of the applied crystal error
+ * @param [in] temperature        Current temperature in celsius
+ * @return uint32_t               The crystal error in ppm to apply to the rx windows
+ */
+uint32_t smtc_beacon_drift_update( smtc_beacon_drift_t* drift, uint32_t crystal_error_ppm, int8_t temperature );
+
+/**
+ * @brief Account an rx window sized with the estimated crystal error
+ *
+ * @param [in,out] drift           Drift estimator object
+ * @param [in] rx_window_ms        Rx window duration with the applied crystal error
+ * @param [in] rx_window_bsp_ms    Rx window duration with the bsp crystal error
+ */
+void smtc_beacon_drift_account_rx_window( smtc_beacon_drift_t* drift, uint32_t rx_window_ms,
+                                          uint32_t rx_window_bsp_ms );
+
+/**
+ * @brief Get the drift estimator statistics
+ *
+ * @param [in] drift   Drift estimator object
+ * @param [out] stats  Drift statistics
+ */
+void smtc_beacon_drift_get_stats( const smtc_beacon_drift_t* drift, smtc_beacon_drift_stats_t* stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_BEACON_DRIFT_H__
+
+/* --- EOF ------------------------------------------------------------------ */
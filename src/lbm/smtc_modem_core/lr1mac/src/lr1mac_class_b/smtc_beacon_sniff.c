@@ -117,8 +117,9 @@ static void compute_beacon_metadata( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t
  *
  * @param [in,out] lr1_beacon_obj Beacon object
  * @param [in] timestamp  Beacon timestamp
+ * @param [in] temperature  Temperature sampled when the beacon task was enqueued, used by the clock drift estimator
  */
-static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t timestamp );
+static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t timestamp, int8_t temperature );
 
 /**
  * @brief update beacon state
@@ -237,6 +238,8 @@ void smtc_beacon_sniff_init( smtc_lr1_beacon_t* lr1_beacon_obj, smtc_ping_slot_t
     lr1_beacon_obj->push_context         = push_context;
     lr1_beacon_obj->dpll_frequency_100us = BEACON_PERIOD_MS * 10;
     lr1_beacon_obj->listen_beacon_rate   = DEFAULT_LISTEN_BEACON_RATE;
+    smtc_beacon_drift_reset( &lr1_beacon_obj->drift, lr1_mac->crystal_error );
+    ping_slot_obj->drift = &lr1_beacon_obj->drift;
 
     rp_release_hook( lr1_beacon_obj->rp, lr1_beacon_obj->beacon_sniff_id_rp );
     rp_hook_init( lr1_beacon_obj->rp, lr1_beacon_obj->beacon_sniff_id_rp,
@@ -328,6 +331,9 @@ void beacon_rp_request( smtc_lr1_beacon_t* lr1_beacon_obj )
     rp_task.start_time_ms         = compute_start_time( lr1_beacon_obj );
     rp_task.duration_time_ms      = BEACON_SYMB_DURATION_MS( ) * lr1_beacon_obj->beacon_open_rx_nb_symb;
     rp_task.launch_task_callbacks = smtc_beacon_sniff_launch_callback_for_rp;
+    // the temperature is sampled once per beacon period and given to the drift estimator when the beacon is received,
+    // under interrupt the hal returns its last reading which the supervisor refreshes from the main loop
+    lr1_beacon_obj->temperature = smtc_modem_hal_get_temperature( );
 
     rp_radio_params_t rp_radio_params      = { 0 };
     rp_radio_params.pkt_type               = RAL_PKT_TYPE_LORA;
@@ -386,6 +392,7 @@ void smtc_beacon_sniff_rp_callback( smtc_lr1_beacon_t* lr1_beacon_obj )
 
     rp_status_t rp_status         = lr1_beacon_obj->rp->status[lr1_beacon_obj->beacon_sniff_id_rp];
     uint32_t    beacon_epoch_time = 0;
+    int8_t      temperature       = lr1_beacon_obj->temperature;
     // assuming that the radio hw latency between the end of the packet and the timestamp of the rx packet is about
     // 1/2 symbol
     uint32_t timestamp = lr1_beacon_obj->rp->irq_timestamp_100us[lr1_beacon_obj->beacon_sniff_id_rp] -
@@ -401,8 +408,9 @@ void smtc_beacon_sniff_rp_callback( smtc_lr1_beacon_t* lr1_beacon_obj )
             ( uint8_t ) lr1_beacon_obj->rp->payload_size[lr1_beacon_obj->beacon_sniff_id_rp];
     }
 
-    update_beacon_pll( lr1_beacon_obj, timestamp );
+    update_beacon_pll( lr1_beacon_obj, timestamp, temperature );
     update_beacon_state( lr1_beacon_obj );
+    smtc_beacon_drift_update( &lr1_beacon_obj->drift, lr1_beacon_obj->lr1_mac->crystal_error, temperature );
 
     compute_beacon_metadata( lr1_beacon_obj, timestamp / 10, beacon_epoch_time );
     update_beacon_rx_nb_symb( lr1_beacon_obj, DPLL_PHASE_MS( ) );
@@ -447,6 +455,11 @@ void smtc_beacon_sniff_get_metadata( smtc_lr1_beacon_t* lr1_beacon_obj, smtc_bea
     memcpy( beacon_metadata, &lr1_beacon_obj->beacon_metadata, sizeof( smtc_beacon_metadata_t ) );
 }
 
+void smtc_beacon_sniff_get_drift_stats( smtc_lr1_beacon_t* lr1_beacon_obj, smtc_beacon_drift_stats_t* drift_stats )
+{
+    smtc_beacon_drift_get_stats( &lr1_beacon_obj->drift, drift_stats );
+}
+
 uint32_t smtc_decode_beacon_epoch_time( uint8_t* beacon_payload, uint8_t beacon_sf )
 {
     // the format of the beacon payload is different according to the beacon sf. The following formula is a way to
@@ -610,7 +623,7 @@ static void compute_beacon_metadata( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t
     }
 }
 
-static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t timestamp )
+static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t timestamp, int8_t temperature )
 {
     if( lr1_beacon_obj->is_valid_beacon == true )
     {
@@ -624,6 +637,8 @@ static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t times
             lr1_beacon_obj->dpll_error_wo_filtering = 0;
             lr1_beacon_obj->dpll_error_sum          = 0;
             lr1_beacon_obj->dpll_phase_100us        = timestamp - 10 * lr1_beacon_obj->beacon_toa;
+            // pll frequency is restarted, previous drift samples are no more relevant
+            smtc_beacon_drift_reset( &lr1_beacon_obj->drift, lr1_beacon_obj->lr1_mac->crystal_error );
         }
         if( lr1_beacon_obj->beacon_state == BEACON_LOCK )
         {
@@ -632,6 +647,10 @@ static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t times
             lr1_beacon_obj->dpll_error =
                 ( BEACON_PLL_PHASE_GAIN_MUL * lr1_beacon_obj->dpll_error + lr1_beacon_obj->dpll_error_wo_filtering ) /
                 BEACON_PLL_PHASE_GAIN_DIV;
+            // the phase error left by the pll prediction is the drift the rx windows have to cover
+            smtc_beacon_drift_add_sample(
+                &lr1_beacon_obj->drift, lr1_beacon_obj->dpll_error_wo_filtering,
+                ( timestamp / 10 ) - lr1_beacon_obj->beacon_metadata.last_beacon_received_timestamp, temperature );
             lr1_beacon_obj->dpll_error_sum += lr1_beacon_obj->dpll_error;
             if( lr1_beacon_obj->dpll_error_sum > BEACON_PLL_FREQUENCY_GAIN )
             {
@@ -711,7 +730,19 @@ static void update_beacon_rx_nb_symb( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_
             lr1_beacon_obj->lr1_mac->real, BEACON_DATA_RATE( ),
             ( target_time - lr1_beacon_obj->beacon_metadata.last_beacon_received_timestamp ),
             &lr1_beacon_obj->beacon_open_rx_nb_symb, &rx_timeout_symb_in_ms_tmp, &rx_timeout_symb_locked_in_ms_tmp, 0,
-            lr1_beacon_obj->lr1_mac->crystal_error );
+            lr1_beacon_obj->drift.crystal_error_ppm );
+        if( lr1_beacon_obj->drift.crystal_error_ppm != lr1_beacon_obj->lr1_mac->crystal_error )
+        {
+            uint16_t beacon_open_rx_nb_symb_bsp;
+            smtc_real_get_rx_window_parameters(
+                lr1_beacon_obj->lr1_mac->real, BEACON_DATA_RATE( ),
+                ( target_time - lr1_beacon_obj->beacon_metadata.last_beacon_received_timestamp ),
+                &beacon_open_rx_nb_symb_bsp, &rx_timeout_symb_in_ms_tmp, &rx_timeout_symb_locked_in_ms_tmp, 0,
+                lr1_beacon_obj->lr1_mac->crystal_error );
+            smtc_beacon_drift_account_rx_window( &lr1_beacon_obj->drift,
+                                                 lr1_beacon_obj->beacon_open_rx_nb_symb * BEACON_SYMB_DURATION_MS( ),
+                                                 beacon_open_rx_nb_symb_bsp * BEACON_SYMB_DURATION_MS( ) );
+        }
         // in case of beacon has not been YET received 4 times consecutively it enlarge the rx windows.
         if( lr1_beacon_obj->beacon_metadata.last_beacon_lost_consecutively == 0 )
         {
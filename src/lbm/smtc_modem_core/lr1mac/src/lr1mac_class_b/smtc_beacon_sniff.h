@@ -38,6 +38,7 @@
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_defs.h"
 #include "lbm/smtc_modem_core/radio_planner/src/radio_planner.h"
 #include "smtc_ping_slot.h"
+#include "smtc_beacon_drift.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -195,6 +196,8 @@ typedef struct smtc_lr1_beacon_s
     void* push_context;  //!< the context given by the upper layer to transmit with the previous push_callback function
 
     smtc_beacon_metadata_t beacon_metadata;  // the beacon metadata
+    smtc_beacon_drift_t    drift;            //!< the clock drift estimated from the received beacons
+    int8_t                 temperature;      //!< the temperature sampled when the beacon task is enqueued
 } smtc_lr1_beacon_t;
 
 /**
@@ -259,6 +262,14 @@ void smtc_beacon_sniff_rp_callback( smtc_lr1_beacon_t* lr1_beacon_obj );
  */
 void smtc_beacon_sniff_get_metadata( smtc_lr1_beacon_t* lr1_beacon_obj, smtc_beacon_metadata_t* beacon_metadata );
 
+/**
+ * @brief Get clock drift statistics
+ *
+ * @param [in] lr1_beacon_obj Beacon object
+ * @param [out] drift_stats return clock drift statistics as defined in @ref smtc_beacon_drift_stats_t
+ */
+void smtc_beacon_sniff_get_drift_stats( smtc_lr1_beacon_t* lr1_beacon_obj, smtc_beacon_drift_stats_t* drift_stats );
+
 /**
  * @brief Decode the epoch time field in beacon payload
  * @remark the beacon payload format is dependant of the spreading factor
@@ -56,11 +56,18 @@
 #define RX_SESSION_PARAM ping_slot_obj->rx_session_param
 #define RX_SESSION_PARAM_CURRENT ping_slot_obj->rx_session_param[ping_slot_obj->rx_session_index]
 
+#define PING_SLOT_SCHEDULE_ENTRY( slot, session ) ( uint16_t )( ( ( slot ) << 4 ) | ( ( session ) &0x0F ) )
+#define PING_SLOT_SCHEDULE_SLOT( entry ) ( ( entry ) >> 4 )
+#define PING_SLOT_SCHEDULE_SESSION( entry ) ( ( rx_session_type_t )( ( entry ) &0x0F ) )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
  */
 
+#define PING_SLOT_LEN_MS 30
+#define PING_SLOT_LEN_100US ( PING_SLOT_LEN_MS * 10 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -104,22 +111,33 @@ static uint32_t smtc_ping_slot_get_duration_timeout_ms( smtc_ping_slot_t* ping_s
 static int smtc_ping_slot_mac_downlink_check( smtc_ping_slot_t* ping_slot_obj );
 
 /**
- * @brief Compute the next ping offset for each session (unicast, multicast)
+ * @brief Build the merged ping slots timeline of all enabled sessions (unicast, multicast)
+ *
+ * @remark the priority between two colliding Rx ping slots is resolved here
  *
  * @param ping_slot_obj
- * @param timestamp     // new ping offset will be in future in regards of this timestamp
+ * @param first_slot    // First slot index of the beacon window to be scheduled
  */
-static void smtc_ping_slot_compute_next_ping_offset_time( smtc_ping_slot_t* ping_slot_obj, uint32_t timestamp );
+static void smtc_ping_slot_schedule_build( smtc_ping_slot_t* ping_slot_obj, uint16_t first_slot );
 
 /**
- * @brief Search the next ping slot Rx window
+ * @brief Walk the schedule up to the next ping slot Rx window
  *
- * @remark the priority between to Rx ping slot is check here
+ * @param ping_slot_obj
+ * @param timestamp     // next ping slot will be in future in regards of this timestamp
+ */
+static void smtc_ping_slot_schedule_search_next( smtc_ping_slot_t* ping_slot_obj, uint32_t timestamp );
+
+/**
+ * @brief Check if a session has the priority on another one when their ping slots collide
  *
  * @param ping_slot_obj
- * @param timestamp_rtc
+ * @param session       // Candidate session
+ * @param other         // Already scheduled session
+ * @return true if session takes priority over other
  */
-static void smtc_ping_slot_search_closest_ping_offset_time( smtc_ping_slot_t* ping_slot_obj, uint32_t timestamp_rtc );
+static bool smtc_ping_slot_has_priority( smtc_ping_slot_t* ping_slot_obj, rx_session_type_t session,
+                                         rx_session_type_t other );
 
 /**
  * @brief Compute Time On Air of a payload size
@@ -235,6 +253,11 @@ void smtc_ping_slot_init_after_beacon( smtc_ping_slot_t* ping_slot_obj, uint32_t
                 ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time_100us / 10;
         }
     }
+
+    // Crypto is only needed once per session and per beacon period, merge all sessions in a single timeline now
+    ping_slot_obj->schedule.slot0_time_100us = beacon_timestamp + ( 10 * beacon_reserved_ms );
+    ping_slot_obj->schedule.slot0_time_ms    = ping_slot_obj->schedule.slot0_time_100us / 10;
+    smtc_ping_slot_schedule_build( ping_slot_obj, 0 );
 }
 
 /* function call by beacon_sniff obj at the begining of each beacon period
@@ -278,7 +301,6 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
     do
     {
         timestamp_rtc = smtc_modem_hal_get_time_in_ms( );
-        smtc_ping_slot_compute_next_ping_offset_time( ping_slot_obj, timestamp_rtc );
         if( ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->enabled == true )
         {
             // copy context from LR1MAC class A for the unicast session
@@ -312,7 +334,19 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
             return;
         }
 
-        smtc_ping_slot_search_closest_ping_offset_time( ping_slot_obj, timestamp_rtc );
+        if( ping_slot_obj->schedule.to_rebuild == true )
+        {
+            // Sessions priority changed, resolve collisions again for the remaining slots of the beacon period
+            if( ping_slot_obj->schedule.cursor < ping_slot_obj->schedule.nb_entry )
+            {
+                smtc_ping_slot_schedule_build(
+                    ping_slot_obj,
+                    PING_SLOT_SCHEDULE_SLOT( ping_slot_obj->schedule.entry[ping_slot_obj->schedule.cursor] ) );
+            }
+            ping_slot_obj->schedule.to_rebuild = false;
+        }
+
+        smtc_ping_slot_schedule_search_next( ping_slot_obj, timestamp_rtc );
 
         if( ping_slot_obj->rx_session_index == RX_SESSION_COUNT )
         {
@@ -336,12 +370,29 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
 
         modulation_type = smtc_real_get_modulation_type_from_datarate( ping_slot_obj->lr1_mac->real, ping_slot_dr );
 
+        uint32_t crystal_error = ( ping_slot_obj->drift != NULL ) ? ping_slot_obj->drift->crystal_error_ppm
+                                                                  : ping_slot_obj->lr1_mac->crystal_error;
         smtc_real_get_rx_window_parameters( ping_slot_obj->lr1_mac->real, RX_SESSION_PARAM_CURRENT->rx_data_rate,
                                             ( RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time -
                                               ping_slot_obj->last_valid_rx_beacon_ms ),
                                             &RX_SESSION_PARAM_CURRENT->rx_window_symb, &rx_timeout_symb_in_ms_tmp,
                                             &rx_timeout_symb_locked_in_ms_tmp, RX_BEACON_TIMESTAMP_ERROR,
-                                            ping_slot_obj->lr1_mac->crystal_error );
+                                            crystal_error );
+
+        if( ( ping_slot_obj->drift != NULL ) && ( crystal_error != ping_slot_obj->lr1_mac->crystal_error ) )
+        {
+            uint16_t rx_window_symb_bsp;
+            uint32_t rx_timeout_symb_in_ms_bsp;
+            uint32_t rx_timeout_symb_locked_in_ms_bsp;
+            smtc_real_get_rx_window_parameters(
+                ping_slot_obj->lr1_mac->real, RX_SESSION_PARAM_CURRENT->rx_data_rate,
+                ( RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time -
+                  ping_slot_obj->last_valid_rx_beacon_ms ),
+                &rx_window_symb_bsp, &rx_timeout_symb_in_ms_bsp, &rx_timeout_symb_locked_in_ms_bsp,
+                RX_BEACON_TIMESTAMP_ERROR, ping_slot_obj->lr1_mac->crystal_error );
+            smtc_beacon_drift_account_rx_window( ping_slot_obj->drift, rx_timeout_symb_in_ms_tmp,
+                                                 rx_timeout_symb_in_ms_bsp );
+        }
 
         if( modulation_type == LORA )
         {
@@ -471,9 +522,9 @@ void smtc_ping_slot_rp_callback( smtc_ping_slot_t* ping_slot_obj )
         // have to burn the current ping slot and the potential collide ping slot (could appear if an other task with
         // higher priority is enqueued in the radioplanner, in this case ping slot is still in the future but aborted by
         // the rp)
-        if( rp_status == RP_STATUS_TASK_ABORTED )
+        if( ( rp_status == RP_STATUS_TASK_ABORTED ) && ( ping_slot_obj->rx_session_index < RX_SESSION_COUNT ) )
         {
-            smtc_ping_slot_compute_next_ping_offset_time(
+            smtc_ping_slot_schedule_search_next(
                 ping_slot_obj,
                 RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time +
                     smtc_ping_slot_get_duration_timeout_ms( ping_slot_obj, RX_SESSION_PARAM_CURRENT->rx_window_symb,
@@ -656,6 +707,9 @@ smtc_multicast_config_rc_t smtc_ping_slot_multicast_b_stop_session( smtc_ping_sl
         rp_task_abort( ping_slot_obj->rp, ping_slot_obj->ping_slot_id4rp );
     }
 
+    // The stopped session may have hidden slots of other sessions
+    ping_slot_obj->schedule.to_rebuild = true;
+
     // Reset frequency and datarate to their not init values
     ping_slot_obj->rx_session_param[mc_group_id + 1]->rx_frequency = 0;
     ping_slot_obj->rx_session_param[mc_group_id + 1]->rx_data_rate = LR1MAC_MC_NO_DATARATE;
@@ -745,183 +799,150 @@ static int smtc_ping_slot_mac_downlink_check( smtc_ping_slot_t* ping_slot_obj )
     return ( status );
 }
 
-static void smtc_ping_slot_compute_next_ping_offset_time( smtc_ping_slot_t* ping_slot_obj, uint32_t timestamp )
+static bool smtc_ping_slot_has_priority( smtc_ping_slot_t* ping_slot_obj, rx_session_type_t session,
+                                         rx_session_type_t other )
 {
-    // Compute the new ping slot for each session
-    for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_CLASS_B_SESSION; i++ )
+    // The new ping slot has more priority
+    if( RX_SESSION_PARAM[other]->fpending_bit < RX_SESSION_PARAM[session]->fpending_bit )
     {
-        if( ping_slot_obj->rx_session_param[i]->enabled == true )
-        {
-            // While ( (ping slot in past) AND (ping_number > 0)
-            while( ( ( int32_t )( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time -
-                                  timestamp ) <= 0 ) &&
-                   ( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_number > 0 ) )
-            {
-                ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_number--;
-                ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time +=
-                    ( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_period * 30 );
-                ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time_100us +=
-                    ( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_period * 300 );
-            }
-        }
+        return true;
+    }
+    // Priority is the same, DevAddr SHALL take priority
+    if( ( RX_SESSION_PARAM[other]->fpending_bit == RX_SESSION_PARAM[session]->fpending_bit ) &&
+        ( RX_SESSION_PARAM[other]->dev_addr < RX_SESSION_PARAM[session]->dev_addr ) )
+    {
+        return true;
     }
+    return false;
 }
 
-static void smtc_ping_slot_search_closest_ping_offset_time( smtc_ping_slot_t* ping_slot_obj, uint32_t timestamp_rtc )
+static void smtc_ping_slot_schedule_build( smtc_ping_slot_t* ping_slot_obj, uint16_t first_slot )
 {
-    ping_slot_obj->rx_session_index = RX_SESSION_COUNT;
+    smtc_ping_slot_schedule_t* schedule = &ping_slot_obj->schedule;
+    uint16_t                   next_slot[LR1MAC_NUMBER_OF_CLASS_B_SESSION];
+    uint32_t                   duration_ms[LR1MAC_NUMBER_OF_CLASS_B_SESSION];
+    uint16_t                   end_slot;
+
+    schedule->nb_entry   = 0;
+    schedule->cursor     = 0;
+    schedule->to_rebuild = false;
+
+    // No ping slot could be opened in the beacon guard
+    int32_t window_ms =
+        ( int32_t )( ping_slot_obj->next_beacon_timestamp - ping_slot_obj->beacon_guard_ms - schedule->slot0_time_ms );
+    if( window_ms <= 0 )
+    {
+        return;
+    }
+    end_slot = ( ( uint32_t ) window_ms + PING_SLOT_LEN_MS - 1 ) / PING_SLOT_LEN_MS;
+    if( end_slot > PING_SLOT_NB_SLOTS_IN_BEACON_WINDOW )
+    {
+        end_slot = PING_SLOT_NB_SLOTS_IN_BEACON_WINDOW;
+    }
 
-    // Init with a first ping offset in future, else we will never found the next closest offset in future
+    // First slot of each enabled session from first_slot
     for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_CLASS_B_SESSION; i++ )
     {
+        next_slot[i] = end_slot;
         if( RX_SESSION_PARAM[i]->enabled == true )
         {
-            if( ( int32_t )( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time -
-                             ( ping_slot_obj->next_beacon_timestamp - ping_slot_obj->beacon_guard_ms ) ) <= 0 )
-            {
-                if( ( ( int32_t )( RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time - timestamp_rtc ) > 0 ) )
-                {
-                    ping_slot_obj->rx_session_index = i;
+            uint16_t period = RX_SESSION_PARAM[i]->ping_slot_parameters.ping_period;
+            uint16_t offset = ( RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time_100us -
+                                schedule->slot0_time_100us ) /
+                              PING_SLOT_LEN_100US;
 
-                    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "Ping Slot session %d enabled", i );
-                    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "--> offset %u, init\n",
-                                                       RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time );
-                    break;
-                }
+            offset %= period;
+            if( offset < first_slot )
+            {
+                offset += ( ( first_slot - offset + period - 1 ) / period ) * period;
             }
+            if( offset < end_slot )
+            {
+                next_slot[i] = offset;
+            }
+            duration_ms[i] = smtc_ping_slot_get_duration_timeout_ms( ping_slot_obj, RX_SESSION_PARAM[i]->rx_window_symb,
+                                                                     RX_SESSION_PARAM[i]->rx_data_rate );
         }
     }
 
-    // No more ping slot available
-    if( ping_slot_obj->rx_session_index == RX_SESSION_COUNT )
+    // Merge all sessions slots in time order
+    while( 1 )
     {
-        SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " No more ping slot available \n" );
-        return;
-    }
+        rx_session_type_t session = RX_SESSION_COUNT;
+        uint16_t          slot    = end_slot;
+        for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_CLASS_B_SESSION; i++ )
+        {
+            if( next_slot[i] < slot )
+            {
+                slot    = next_slot[i];
+                session = i;
+            }
+        }
+        if( session == RX_SESSION_COUNT )
+        {
+            break;
+        }
 
-    // Search the next closest ping slot
-    for( rx_session_type_t i = ping_slot_obj->rx_session_index; i < LR1MAC_NUMBER_OF_CLASS_B_SESSION; i++ )
-    {
-        if( ping_slot_obj->rx_session_index == i )
+        next_slot[session] += RX_SESSION_PARAM[session]->ping_slot_parameters.ping_period;
+        if( next_slot[session] >= end_slot )
         {
-            continue;
+            next_slot[session] = end_slot;
         }
-        // Search Ping Slot for each enabled session
-        if( RX_SESSION_PARAM[i]->enabled == true )
+
+        // Resolve collision with the previous scheduled slots: ( t0 + delay0 ) >= t1
+        bool keep = true;
+        while( schedule->nb_entry > 0 )
         {
-            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "Ping Slot session %d enabled", i );
-            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "--> offset %u, ",
-                                               RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time );
+            uint16_t          prev_entry   = schedule->entry[schedule->nb_entry - 1];
+            rx_session_type_t prev_session = PING_SLOT_SCHEDULE_SESSION( prev_entry );
 
-            // Ignore session if all ping number were used
-            if( ( ( int32_t )( RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time - timestamp_rtc ) < 0 ) &&
-                ( RX_SESSION_PARAM[i]->ping_slot_parameters.ping_number == 0 ) )
+            if( ( ( uint32_t )( slot - PING_SLOT_SCHEDULE_SLOT( prev_entry ) ) * PING_SLOT_LEN_MS ) >
+                duration_ms[prev_session] )
             {
-                SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " no more ping slot for session %d\n", i );
-                continue;
+                break;
             }
-            if( ( int32_t )( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time -
-                             ( ping_slot_obj->next_beacon_timestamp - ping_slot_obj->beacon_guard_ms ) ) >= 0 )
+            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "!!!Ping Slot collision session %d/%d !!!!\n", prev_session, session );
+            if( smtc_ping_slot_has_priority( ping_slot_obj, session, prev_session ) == false )
             {
-                SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " no more ping slot for session (guard) %d\n", i );
-                continue;
+                keep = false;
+                break;
             }
+            schedule->nb_entry--;
+        }
 
-            // t1 = t0
-            if( ( int32_t )( RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time -
-                             RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time ) == 0 )
-            {
-                SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "!!!Ping Slot collision t1 = t0 !!!!\n" );
+        if( keep == true )
+        {
+            schedule->entry[schedule->nb_entry++] = PING_SLOT_SCHEDULE_ENTRY( slot, session );
+        }
+    }
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "Ping Slot schedule %u slots from slot %u\n", schedule->nb_entry, first_slot );
+}
 
-                // The new ping slot has more priority
-                if( RX_SESSION_PARAM_CURRENT->fpending_bit < RX_SESSION_PARAM[i]->fpending_bit )
-                {
-                    ping_slot_obj->rx_session_index = i;
-                }
-                // Priority is the same, DevAddr SHALL take priority
-                else if( RX_SESSION_PARAM_CURRENT->fpending_bit == RX_SESSION_PARAM[i]->fpending_bit )
-                {
-                    if( RX_SESSION_PARAM_CURRENT->dev_addr < RX_SESSION_PARAM[i]->dev_addr )
-                    {
-                        SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " next time %u ",
-                                                           RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time );
+static void smtc_ping_slot_schedule_search_next( smtc_ping_slot_t* ping_slot_obj, uint32_t timestamp )
+{
+    smtc_ping_slot_schedule_t* schedule = &ping_slot_obj->schedule;
 
-                        ping_slot_obj->rx_session_index = i;
-                    }
-                }
-            }
-            // t1 < t0
-            else if( ( int32_t )( RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time -
-                                  RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time ) < 0 )
-            {
-                // ( t1 + delay1 ) < t0
-                if( ( int32_t )( RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time +
-                                 smtc_ping_slot_get_duration_timeout_ms( ping_slot_obj,
-                                                                         RX_SESSION_PARAM[i]->rx_window_symb,
-                                                                         RX_SESSION_PARAM[i]->rx_data_rate ) -
-                                 RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time ) < 0 )
-                {
-                    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " first time %u",
-                                                       RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time );
+    ping_slot_obj->rx_session_index = RX_SESSION_COUNT;
 
-                    ping_slot_obj->rx_session_index = i;
-                }
-                else  // collision: t1 will end after t0 start
-                {
-                    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "!!!Ping Slot collision t1/t0 !!!!\n" );
-                    // The new ping slot is more priority
-                    if( RX_SESSION_PARAM_CURRENT->fpending_bit < RX_SESSION_PARAM[i]->fpending_bit )
-                    {
-                        ping_slot_obj->rx_session_index = i;
-                    }
-                    // Priority is the same, DevAddr SHALL take priority
-                    else if( RX_SESSION_PARAM_CURRENT->fpending_bit == RX_SESSION_PARAM[i]->fpending_bit )
-                    {
-                        if( RX_SESSION_PARAM_CURRENT->dev_addr < RX_SESSION_PARAM[i]->dev_addr )
-                        {
-                            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG(
-                                " next time %u ", RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time );
-
-                            ping_slot_obj->rx_session_index = i;
-                        }
-                    }
-                }
-            }
-            else  // t0 < t1
-            {
-                // ( t0 + delay0 ) < t1
-                if( ( int32_t )( RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time +
-                                 smtc_ping_slot_get_duration_timeout_ms( ping_slot_obj,
-                                                                         RX_SESSION_PARAM_CURRENT->rx_window_symb,
-                                                                         RX_SESSION_PARAM_CURRENT->rx_data_rate ) -
-                                 RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time ) < 0 )
-                {
-                    // Keep t0
-                }
-                else  // collision: t0 will end after t1 start
-                {
-                    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "!!!Ping Slot collision t0/t1 !!!!\n" );
-                    // The new ping slot has more priority
-                    if( RX_SESSION_PARAM_CURRENT->fpending_bit < RX_SESSION_PARAM[i]->fpending_bit )
-                    {
-                        ping_slot_obj->rx_session_index = i;
-                    }
-                    // Priority is the same, DevAddr SHALL take priority
-                    else if( RX_SESSION_PARAM_CURRENT->fpending_bit == RX_SESSION_PARAM[i]->fpending_bit )
-                    {
-                        if( RX_SESSION_PARAM_CURRENT->dev_addr < RX_SESSION_PARAM[i]->dev_addr )
-                        {
-                            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG(
-                                " next time %u ", RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time );
-
-                            ping_slot_obj->rx_session_index = i;
-                        }
-                    }
-                }
-            }
-            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "\n" );
+    while( schedule->cursor < schedule->nb_entry )
+    {
+        uint16_t          entry   = schedule->entry[schedule->cursor];
+        rx_session_type_t session = PING_SLOT_SCHEDULE_SESSION( entry );
+        uint32_t          slot    = PING_SLOT_SCHEDULE_SLOT( entry );
+        uint32_t          time_ms = schedule->slot0_time_ms + ( slot * PING_SLOT_LEN_MS );
+
+        // Skip slots in the past and slots of sessions stopped since the schedule was built
+        if( ( RX_SESSION_PARAM[session]->enabled == true ) && ( ( int32_t )( time_ms - timestamp ) > 0 ) )
+        {
+            RX_SESSION_PARAM[session]->ping_slot_parameters.ping_offset_time = time_ms;
+            RX_SESSION_PARAM[session]->ping_slot_parameters.ping_offset_time_100us =
+                schedule->slot0_time_100us + ( slot * PING_SLOT_LEN_100US );
+            ping_slot_obj->rx_session_index = session;
+            return;
         }
+        schedule->cursor++;
     }
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " No more ping slot available \n" );
 }
 
 static rx_packet_type_t smtc_ping_slot_mac_rx_frame_decode( smtc_ping_slot_t* ping_slot_obj )
@@ -1004,6 +1025,7 @@ static rx_packet_type_t smtc_ping_slot_mac_rx_frame_decode( smtc_ping_slot_t* pi
         ping_slot_obj->rx_metadata.rx_fpending_bit = ( ping_slot_obj->rx_fctrl >> DL_FPENDING_BIT ) & 0x01;
 
         // Find current ping slot group and set the fpending prioritization
+        smtc_multicast_fpending_bit_prioritization_t fpending_bit_prev = RX_SESSION_PARAM_CURRENT->fpending_bit;
         if( ping_slot_obj->rx_session_index == RX_SESSION_UNICAST )
         {
             if( ping_slot_obj->rx_metadata.rx_fpending_bit == true )
@@ -1026,6 +1048,10 @@ static rx_packet_type_t smtc_ping_slot_mac_rx_frame_decode( smtc_ping_slot_t* pi
                 RX_SESSION_PARAM_CURRENT->fpending_bit = MULTICAST_WO_FPENDING;
             }
         }
+        if( RX_SESSION_PARAM_CURRENT->fpending_bit != fpending_bit_prev )
+        {
+            ping_slot_obj->schedule.to_rebuild = true;
+        }
 
         if( ping_slot_obj->rx_payload_empty == 0 )  // rx payload not empty
         {
@@ -47,6 +47,7 @@ extern "C" {
 #include "lbm/smtc_modem_core/lr1mac/src/services/smtc_multicast.h"
 #include "lbm/smtc_modem_core/radio_planner/src/radio_planner.h"
 #include "lbm/smtc_modem_core/smtc_modem_crypto/smtc_secure_element/smtc_secure_element.h"
+#include "smtc_beacon_drift.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -67,6 +68,21 @@ extern "C" {
  */
 #define LR1MAC_CLASS_B_MC_NO_DATARATE 0xFF
 
+/**
+ * @brief Number of 30ms ping slots in a beacon window (2^12)
+ */
+#define PING_SLOT_NB_SLOTS_IN_BEACON_WINDOW 4096
+
+/**
+ * @brief Max number of ping slots opened per session during a beacon window (periodicity 0)
+ */
+#define PING_SLOT_MAX_PING_NB 128
+
+/**
+ * @brief Max number of ping slots in the merged schedule of all sessions
+ */
+#define SMTC_PING_SLOT_SCHEDULE_MAX_SIZE ( LR1MAC_NUMBER_OF_CLASS_B_SESSION * PING_SLOT_MAX_PING_NB )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -91,6 +107,22 @@ typedef struct lr1mac_rx_b_session_param_e
     uint16_t                                     rx_window_symb;  // Number of Rx window symboles to listen preamble
 } lr1mac_rx_session_b_param_t;
 
+/**
+ * @brief Ping slots timeline of a beacon period, all sessions merged and sorted
+ *
+ * @remark Each entry packs the slot index in the beacon window (12 bits) with the session index (4 bits).
+ *         Collisions between sessions are resolved when the schedule is built, so the planner only has to walk it
+ */
+typedef struct smtc_ping_slot_schedule_s
+{
+    uint16_t entry[SMTC_PING_SLOT_SCHEDULE_MAX_SIZE];  // Sorted (slot index << 4) | session index
+    uint16_t nb_entry;                                 // Number of valid entries
+    uint16_t cursor;                                   // Index of the next entry to be launched
+    uint32_t slot0_time_100us;                         // Start time of slot 0 (end of beacon reserved)
+    uint32_t slot0_time_ms;                            // Start time of slot 0 in ms
+    bool     to_rebuild;                               // Sessions priority changed since the schedule was built
+} smtc_ping_slot_schedule_t;
+
 /**
  * @brief Ping Slot context
  *
@@ -141,6 +173,10 @@ typedef struct smtc_ping_slot_s
 
     uint32_t last_toa;  // Last downlink Time On Air
 
+    smtc_ping_slot_schedule_t schedule;  // Ping slots timeline of the current beacon period
+
+    smtc_beacon_drift_t* drift;  // Clock drift estimated by the beacon tracking, used to size the rx windows
+
 } smtc_ping_slot_t;
 
 /**
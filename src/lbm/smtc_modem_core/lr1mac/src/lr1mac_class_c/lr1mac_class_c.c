@@ -91,6 +91,8 @@ static rx_packet_type_t lr1mac_class_c_mac_rx_frame_decode( lr1mac_class_c_t* cl
 static void             lr1mac_class_c_rp_callback( lr1mac_class_c_t* class_c_obj );
 static int              lr1mac_class_c_mac_downlink_check_under_it( lr1mac_class_c_t* class_c_obj );
 static void             lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj );
+static void             lr1mac_class_c_rx_launch_callback_for_rp( void* rp_void );
+static void             lr1mac_class_c_rx_session_index_update( lr1mac_class_c_t* class_c_obj );
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -155,6 +157,7 @@ void lr1mac_class_c_stop( lr1mac_class_c_t* class_c_obj )
 #endif
     rp_task_abort( class_c_obj->rp, class_c_obj->class_c_id4rp );
     class_c_obj->rx_metadata.rx_window = RECEIVE_NONE;
+    class_c_obj->rx_stopped            = false;
 }
 
 void lr1mac_class_c_start( lr1mac_class_c_t* class_c_obj )
@@ -183,6 +186,8 @@ void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
     class_c_obj->rx_session_param[RX_SESSION_UNICAST]->rx_data_rate = class_c_obj->lr1_mac->rx2_data_rate;
     class_c_obj->rx_session_param[RX_SESSION_UNICAST]->rx_frequency = class_c_obj->lr1_mac->rx2_frequency;
 
+    lr1mac_class_c_rx_session_index_update( class_c_obj );
+
     class_c_obj->rx_session_index = RX_SESSION_COUNT;
     for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_RXC_SESSION; i++ )
     {
@@ -267,21 +272,28 @@ void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
         smtc_modem_hal_lr1mac_panic( "MODULATION NOT SUPPORTED\n" );
     }
 
-    rp_task_t rp_task        = { 0 };
-    rp_task.hook_id          = class_c_obj->class_c_id4rp;
-    rp_task.state            = RP_TASK_STATE_ASAP;
-    rp_task.start_time_ms    = smtc_modem_hal_get_time_in_ms( );
-    rp_task.duration_time_ms = LR1MAC_RCX_MIN_DURATION_MS;
+    // The radio configuration can only be reused if the session parameters did not change since the last launch
+    class_c_obj->rx_reuse_config = ( class_c_obj->rx_armed == true ) &&
+                                   ( class_c_obj->rx_armed_frequency == RX_SESSION_PARAM_CURRENT->rx_frequency ) &&
+                                   ( class_c_obj->rx_armed_data_rate == RX_SESSION_PARAM_CURRENT->rx_data_rate );
+    class_c_obj->rx_armed           = false;
+    class_c_obj->rx_armed_frequency = RX_SESSION_PARAM_CURRENT->rx_frequency;
+    class_c_obj->rx_armed_data_rate = RX_SESSION_PARAM_CURRENT->rx_data_rate;
+
+    rp_task_t rp_task             = { 0 };
+    rp_task.hook_id               = class_c_obj->class_c_id4rp;
+    rp_task.state                 = RP_TASK_STATE_ASAP;
+    rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( );
+    rp_task.duration_time_ms      = LR1MAC_RCX_MIN_DURATION_MS;
+    rp_task.launch_task_callbacks = lr1mac_class_c_rx_launch_callback_for_rp;
 
     if( rp_radio_params.pkt_type == RAL_PKT_TYPE_LORA )
     {
-        rp_task.type                  = RP_TASK_TYPE_RX_LORA;
-        rp_task.launch_task_callbacks = lr1_stack_mac_rx_lora_launch_callback_for_rp;
+        rp_task.type = RP_TASK_TYPE_RX_LORA;
     }
     else
     {
-        rp_task.type                  = RP_TASK_TYPE_RX_FSK;
-        rp_task.launch_task_callbacks = lr1_stack_mac_rx_gfsk_launch_callback_for_rp;
+        rp_task.type = RP_TASK_TYPE_RX_FSK;
     }
 
     if( rp_task_enqueue( class_c_obj->rp, &rp_task, class_c_obj->rx_payload, 255, &rp_radio_params ) !=
@@ -301,6 +313,22 @@ static void lr1mac_class_c_rp_callback( lr1mac_class_c_t* class_c_obj )
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "%s\n", __func__ );
 
     rp_status_t rp_status = class_c_obj->rp->status[class_c_obj->class_c_id4rp];
+
+    if( class_c_obj->started == true )
+    {
+        // Start of the deaf period, ended when the next continuous reception is launched on the radio
+        class_c_obj->rx_stopped = true;
+        if( ( rp_status == RP_STATUS_RX_PACKET ) || ( rp_status == RP_STATUS_RX_CRC_ERROR ) ||
+            ( rp_status == RP_STATUS_RX_TIMEOUT ) )
+        {
+            class_c_obj->rx_stopped_timestamp_ms = class_c_obj->rp->irq_timestamp_ms[class_c_obj->class_c_id4rp];
+        }
+        else
+        {
+            class_c_obj->rx_stopped_timestamp_ms = smtc_modem_hal_get_time_in_ms( );
+        }
+    }
+
     if( rp_status == RP_STATUS_RX_PACKET )
     {
         SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "--> RP_STATUS_RX_PACKET\n" );
@@ -317,6 +345,11 @@ static void lr1mac_class_c_rp_callback( lr1mac_class_c_t* class_c_obj )
     }
 }
 
+void lr1mac_class_c_get_stats( const lr1mac_class_c_t* class_c_obj, lr1mac_class_c_stats_t* stats )
+{
+    *stats = class_c_obj->stats;
+}
+
 void lr1mac_class_c_mac_rp_callback( lr1mac_class_c_t* class_c_obj )
 {
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "%s\n", __func__ );
@@ -460,6 +493,9 @@ smtc_multicast_config_rc_t lr1mac_class_c_multicast_start_session( lr1mac_class_
         rp_task_abort( class_c_obj->rp, class_c_obj->class_c_id4rp );
     }
 
+    // The reception goes on without a relaunch when the parameters are shared, the group is addressed right away
+    lr1mac_class_c_rx_session_index_update( class_c_obj );
+
     return SMTC_MC_RC_OK;
 }
 
@@ -502,6 +538,10 @@ smtc_multicast_config_rc_t lr1mac_class_c_multicast_stop_session( lr1mac_class_c
     {
         // At least 1 multicast session is still active, do nothing
     }
+
+    // Frames of the stopped group are no longer accepted, even if the reception goes on for the other groups
+    lr1mac_class_c_rx_session_index_update( class_c_obj );
+
     return SMTC_MC_RC_OK;
 }
 
@@ -543,6 +583,52 @@ smtc_multicast_config_rc_t lr1mac_class_c_multicast_get_session_status( lr1mac_c
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static void lr1mac_class_c_rx_launch_callback_for_rp( void* rp_void )
+{
+    radio_planner_t*  rp          = ( radio_planner_t* ) rp_void;
+    uint8_t           id          = rp->radio_task_id;
+    lr1mac_class_c_t* class_c_obj = ( lr1mac_class_c_t* ) rp->hooks[id];
+
+    if( ( class_c_obj->rx_reuse_config == true ) && ( rp_is_radio_configured_by( rp, id ) == true ) )
+    {
+        // The radio kept the RxC configuration while sleeping, only the previous irq have to be cleared
+        smtc_modem_hal_assert( ral_clear_irq_status( &( rp->radio->ral ), RAL_IRQ_ALL ) == RAL_STATUS_OK );
+        smtc_modem_hal_start_radio_tcxo( );
+        smtc_modem_hal_assert( ral_set_rx( &( rp->radio->ral ), rp->radio_params[id].rx.timeout_in_ms ) ==
+                               RAL_STATUS_OK );
+        rp_stats_set_rx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+        class_c_obj->stats.nb_rx_fast_start++;
+    }
+    else if( rp->radio_params[id].pkt_type == RAL_PKT_TYPE_LORA )
+    {
+        lr1_stack_mac_rx_lora_launch_callback_for_rp( rp_void );
+    }
+    else
+    {
+        lr1_stack_mac_rx_gfsk_launch_callback_for_rp( rp_void );
+    }
+    class_c_obj->rx_armed = true;
+    class_c_obj->stats.nb_rx_start++;
+
+    if( class_c_obj->rx_stopped == true )
+    {
+        uint32_t deaf_time_ms = smtc_modem_hal_get_time_in_ms( ) - class_c_obj->rx_stopped_timestamp_ms;
+
+        class_c_obj->stats.deaf_time_ms += deaf_time_ms;
+        if( deaf_time_ms > class_c_obj->stats.deaf_time_max_ms )
+        {
+            class_c_obj->stats.deaf_time_max_ms = deaf_time_ms;
+        }
+        class_c_obj->rx_stopped = false;
+    }
+}
+
+static void lr1mac_class_c_rx_session_index_update( lr1mac_class_c_t* class_c_obj )
+{
+    lr1mac_rx_session_index_build( &class_c_obj->rx_session_index_by_addr, class_c_obj->rx_session_param,
+                                   LR1MAC_NUMBER_OF_RXC_SESSION );
+}
+
 static int lr1mac_class_c_mac_downlink_check_under_it( lr1mac_class_c_t* class_c_obj )
 {
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "%s\n", __func__ );
@@ -564,26 +650,39 @@ static int lr1mac_class_c_mac_downlink_check_under_it( lr1mac_class_c_t* class_c
         uint32_t dev_addr_tmp = class_c_obj->rx_payload[1] + ( class_c_obj->rx_payload[2] << 8 ) +
                                 ( class_c_obj->rx_payload[3] << 16 ) + ( class_c_obj->rx_payload[4] << 24 );
 
-        for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_RXC_SESSION; i++ )
-        {
-            if( ( dev_addr_tmp == class_c_obj->rx_session_param[i]->dev_addr ) &&
-                ( class_c_obj->rx_session_param[i]->enabled == true ) )
-            {
-                class_c_obj->rx_session_index = i;
-                break;
-            }
-        }
+        rx_session_type_t session =
+            lr1mac_rx_session_index_find( &class_c_obj->rx_session_index_by_addr, dev_addr_tmp );
 
-        if( class_c_obj->rx_session_index >= LR1MAC_NUMBER_OF_RXC_SESSION )
+        // The index may be rebuilt while the frame is checked, the session must still be enabled
+        if( ( session >= LR1MAC_NUMBER_OF_RXC_SESSION ) ||
+            ( class_c_obj->rx_session_param[session]->enabled == false ) )
         {
             status += ERRORLORAWAN;
-            class_c_obj->rx_session_index = RX_SESSION_COUNT;
-            for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_RXC_SESSION; i++ )
+            class_c_obj->stats.nb_rx_foreign++;
+            SMTC_MODEM_HAL_TRACE_INFO( " BAD DevAddr = %x for RX Frame\n", dev_addr_tmp );
+        }
+        else if( class_c_obj->rx_payload_size >= FHDROFFSET )
+        {
+            // Drop replayed frames before any crypto, the full FCnt check is done by the decode
+            uint32_t fcnt_dwn     = ( session == RX_SESSION_UNICAST ) ? class_c_obj->lr1_mac->fcnt_dwn
+                                                                      : class_c_obj->rx_session_param[session]->fcnt_dwn;
+            uint16_t fcnt_dwn_tmp = class_c_obj->rx_payload[6] + ( class_c_obj->rx_payload[7] << 8 );
+
+            if( ( fcnt_dwn != 0xFFFFFFFF ) && ( fcnt_dwn_tmp == ( fcnt_dwn & 0x0000FFFF ) ) )
             {
-                SMTC_MODEM_HAL_TRACE_INFO( " BAD DevAddr = %x for RX Frame and %x \n \n",
-                                           class_c_obj->rx_session_param[i]->dev_addr, dev_addr_tmp );
+                status += ERRORLORAWAN;
+                class_c_obj->stats.nb_rx_rejected[session]++;
+                SMTC_MODEM_HAL_TRACE_INFO( " Replayed FCnt = %u for RX Frame\n", fcnt_dwn_tmp );
+            }
+            else
+            {
+                class_c_obj->rx_session_index = session;
             }
         }
+        else
+        {
+            class_c_obj->rx_session_index = session;
+        }
     }
 
     if( status != OKLORAWAN )
@@ -657,8 +756,14 @@ static rx_packet_type_t lr1mac_class_c_mac_rx_frame_decode( lr1mac_class_c_t* cl
             status = ERRORLORAWAN;
         }
     }
+    if( status != OKLORAWAN )
+    {
+        class_c_obj->stats.nb_rx_rejected[class_c_obj->rx_session_index]++;
+    }
     if( status == OKLORAWAN )
     {
+        class_c_obj->stats.nb_rx_accepted[class_c_obj->rx_session_index]++;
+
         // Set FPending bit in stack
         // !!!! SHALL NOT USED IN CLASS C
         // class_c_obj->lr1_mac->rx_fpending_bit_current = ( class_c_obj->rx_fctrl >> 4 ) & 0x01;
@@ -71,6 +71,20 @@ extern "C" {
  * --- PUBLIC TYPES ------------------------------------------------------------
  */
 
+/**
+ * @brief Class C continuous reception statistics
+ */
+typedef struct lr1mac_class_c_stats_s
+{
+    uint32_t nb_rx_start;       // Number of continuous reception starts
+    uint32_t nb_rx_fast_start;  // Number of starts which reused the radio configuration left by the previous one
+    uint32_t deaf_time_ms;      // Cumulated time without continuous reception while class C is started
+    uint32_t deaf_time_max_ms;  // Longest time without continuous reception while class C is started
+    uint32_t nb_rx_foreign;     // Number of frames dropped because no session listens to their DevAddr
+    uint32_t nb_rx_accepted[RX_SESSION_COUNT];  // Number of frames accepted per session
+    uint32_t nb_rx_rejected[RX_SESSION_COUNT];  // Number of frames of a session dropped on FCnt or MIC
+} lr1mac_class_c_stats_t;
+
 typedef struct lr1mac_class_c_s
 {
     bool             enabled;        // Service is enabled/disabled
@@ -94,6 +108,7 @@ typedef struct lr1mac_class_c_s
     // Contains All Rx Session, Unicast and Multicast
     lr1mac_rx_session_param_t  rx_session_param_unicast;
     lr1mac_rx_session_param_t* rx_session_param[LR1MAC_NUMBER_OF_RXC_SESSION];
+    lr1mac_rx_session_index_t  rx_session_index_by_addr;  // Enabled sessions at launch, looked up under IT
 
     rx_packet_type_t valid_rx_packet;
     uint8_t          tx_ack_bit;
@@ -107,6 +122,15 @@ typedef struct lr1mac_class_c_s
 
     user_rx_packet_type_t available_app_packet;
 
+    // Radio configuration of the last continuous reception, reused while no other task has used the radio
+    bool     rx_armed;            // Radio has been configured for rx_armed_frequency and rx_armed_data_rate
+    bool     rx_reuse_config;     // Next launch targets the same configuration as the armed one
+    uint32_t rx_armed_frequency;
+    uint8_t  rx_armed_data_rate;
+
+    bool                   rx_stopped;               // Continuous reception ended and not yet restarted
+    uint32_t               rx_stopped_timestamp_ms;  // End time of the last continuous reception
+    lr1mac_class_c_stats_t stats;
 } lr1mac_class_c_t;
 
 /*
@@ -154,6 +178,14 @@ void lr1mac_class_c_stop( lr1mac_class_c_t* class_c_obj );
  */
 void lr1mac_class_c_start( lr1mac_class_c_t* class_c_obj );
 
+/**
+ * @brief Get the class C continuous reception statistics
+ *
+ * @param class_c_obj
+ * @param [out] stats
+ */
+void lr1mac_class_c_get_stats( const lr1mac_class_c_t* class_c_obj, lr1mac_class_c_stats_t* stats );
+
 /**
  * @brief Callback called by radio planner on interrupt
  *
@@ -159,13 +159,17 @@ void lr1mac_core_init( lr1_stack_mac_t* lr1_mac_obj, smtc_real_t* real, smtc_lbt
 
     load_devnonce_reset( lr1_mac_obj );
 
+    // A device reset while joining keeps backing off, a fleet rebooting together does not join in lockstep
+    lr1_mac_obj->next_time_to_join_seconds =
+        smtc_modem_hal_get_time_in_s( ) + smtc_join_scheduler_get_backoff_s( &lr1_mac_obj->join_scheduler );
+
     // Initialize here adr_ack_limit_init and adr_ack_delay_init which are real dependant and must be updated after the
     // real is initialized and not reinit after the join accept
     lr1_mac_obj->adr_ack_limit_init = smtc_real_get_adr_ack_limit( lr1_mac_obj->real );
     lr1_mac_obj->adr_ack_delay_init = smtc_real_get_adr_ack_delay( lr1_mac_obj->real );
 
     lr1_mac_obj->nb_of_reset += 1;  // increment reset counter when lr1mac_core_init is called, reset is saved when
-                                    // devnonce is save (after a tx join)
+                                    // devnonce is save (before a tx join starting a DevNonce block, or a join accept)
     SMTC_MODEM_HAL_TRACE_PRINTF( " DevNonce = %d\n", lr1_mac_obj->dev_nonce );
     SMTC_MODEM_HAL_TRACE_PRINTF( " JoinNonce = 0x%02x %02x %02x, NetID = 0x%02x %02x %02x\n",
                                  lr1_mac_obj->join_nonce[0], lr1_mac_obj->join_nonce[1], lr1_mac_obj->join_nonce[2],
@@ -283,8 +287,7 @@ lr1mac_states_t lr1mac_core_process( lr1_stack_mac_t* lr1_mac_obj )
 
             if( lr1_mac_obj->join_status == JOINING )
             {
-                // save devnonce after the end of TX
-                save_devnonce_rst( lr1_mac_obj );
+                smtc_join_scheduler_on_join_request( &lr1_mac_obj->join_scheduler, lr1_mac_obj->tx_data_rate );
             }
             lr1_stack_mac_rx_timer_configure( lr1_mac_obj, RX1 );
             lr1_stack_mac_update_tx_done( lr1_mac_obj );
@@ -423,6 +426,12 @@ status_lorawan_t lr1mac_core_join( lr1_stack_mac_t* lr1_mac_obj, uint32_t target
     }
 
     lr1_stack_mac_join_request_build( lr1_mac_obj );
+    // save devnonce before the join request is sent, once per block of DevNonces, so that a reset during the TX does
+    // not reuse it
+    if( smtc_join_scheduler_reserve_devnonce( &lr1_mac_obj->join_scheduler, lr1_mac_obj->dev_nonce ) == true )
+    {
+        save_devnonce_rst( lr1_mac_obj );
+    }
     lr1_mac_obj->rx1_delay_s   = smtc_real_get_rx1_join_delay( lr1_mac_obj->real );
     lr1_mac_obj->rx2_data_rate = smtc_real_get_rx2_join_dr( lr1_mac_obj->real );
 
@@ -566,6 +575,9 @@ status_lorawan_t lr1mac_core_payload_send( lr1_stack_mac_t* lr1_mac_obj, uint8_t
         SMTC_MODEM_HAL_TRACE_ERROR( "LP STATE NOT EQUAL TO IDLE\n" );
         return ERRORLORAWAN;
     }
+    // Before the channel is chosen, the datarate only changes if the payload still fits
+    lr1_stack_lr_fhss_select_dr( lr1_mac_obj, size_in );
+
     // Decrement duty cycle before check the available DTC
     smtc_duty_cycle_update( lr1_mac_obj->dtc_obj );
     if( smtc_real_get_next_channel( lr1_mac_obj->real, lr1_mac_obj->dtc_obj, lr1_mac_obj->tx_data_rate,
@@ -768,6 +780,23 @@ uint16_t lr1mac_core_devnonce_get( lr1_stack_mac_t* lr1_mac_obj )
     return lr1_mac_obj->dev_nonce;
 }
 
+status_lorawan_t lr1mac_core_join_stats_get( lr1_stack_mac_t* lr1_mac_obj, uint8_t datarate, uint16_t* nb_attempts,
+                                             uint16_t* nb_accepts )
+{
+    if( datarate >= SMTC_JOIN_SCHEDULER_NB_DR )
+    {
+        return ERRORLORAWAN;
+    }
+    *nb_attempts = lr1_mac_obj->join_scheduler.nb_attempts[datarate];
+    *nb_accepts  = lr1_mac_obj->join_scheduler.nb_accepts[datarate];
+    return OKLORAWAN;
+}
+
+uint16_t lr1mac_core_join_nb_failed_get( lr1_stack_mac_t* lr1_mac_obj )
+{
+    return lr1_mac_obj->join_scheduler.nb_failed;
+}
+
 int16_t lr1mac_core_last_snr_get( lr1_stack_mac_t* lr1_mac_obj )
 {
     return lr1_mac_obj->rx_metadata.rx_snr;
@@ -1166,6 +1195,7 @@ static void lr1mac_mac_update( lr1_stack_mac_t* lr1_mac_obj )
             lr1_mac_obj->adr_mode_select = lr1_mac_obj->adr_mode_select_tmp;
             smtc_real_set_dr_distribution( lr1_mac_obj->real, lr1_mac_obj->adr_mode_select_tmp, &lr1_mac_obj->nb_trans,
                                            lr1_mac_obj->adr_custom );
+            smtc_join_scheduler_on_join_accept( &lr1_mac_obj->join_scheduler, lr1_mac_obj->tx_data_rate );
             save_devnonce_rst( lr1_mac_obj );
         }
         else
@@ -1235,8 +1265,10 @@ static void save_devnonce_rst( const lr1_stack_mac_t* lr1_mac_obj )
 {
     lr1_counter_context_t ctx = { 0 };
 
-    ctx.devnonce = lr1_mac_obj->dev_nonce;
-    ctx.nb_reset = lr1_mac_obj->nb_of_reset;
+    // DevNonces up to the end of the reserved block may have been sent, the next boot starts after it
+    ctx.devnonce       = lr1_mac_obj->join_scheduler.devnonce_reserved;
+    ctx.nb_reset       = lr1_mac_obj->nb_of_reset;
+    ctx.join_nb_failed = lr1_mac_obj->join_scheduler.nb_failed;
     memcpy( ctx.join_nonce, lr1_mac_obj->join_nonce, sizeof( ctx.join_nonce ) );
     ctx.crc = lr1mac_utilities_crc( ( uint8_t* ) &ctx, sizeof( ctx ) - 4 );
 
@@ -1256,6 +1288,9 @@ static void load_devnonce_reset( lr1_stack_mac_t* lr1_mac_obj )
         lr1_mac_obj->dev_nonce   = ctx.devnonce;
         lr1_mac_obj->nb_of_reset = ctx.nb_reset;
         memcpy( lr1_mac_obj->join_nonce, ctx.join_nonce, sizeof( lr1_mac_obj->join_nonce ) );
+        smtc_join_scheduler_restore( &lr1_mac_obj->join_scheduler, ctx.devnonce,
+                                     ( uint16_t )( ( ctx.join_nb_failed > UINT16_MAX ) ? UINT16_MAX
+                                                                                       : ctx.join_nb_failed ) );
     }
     else
     {
@@ -1267,6 +1302,7 @@ static void load_devnonce_reset( lr1_stack_mac_t* lr1_mac_obj )
         uint32_t num = smtc_modem_hal_get_random_nb_in_range( 0, 0x7fff );
         lr1_mac_obj->dev_nonce   = num;
         lr1_mac_obj->nb_of_reset = 0;
+        smtc_join_scheduler_restore( &lr1_mac_obj->join_scheduler, lr1_mac_obj->dev_nonce, 0 );
 #else
 #error "Invalid LBM_CUSTOM value"
 #endif
@@ -1304,6 +1340,7 @@ static void try_recover_nvm( lr1_stack_mac_t* lr1_mac_obj )
         lr1_mac_obj->adr_custom[0]     = old_save_fmt.adr_custom;
         lr1_mac_obj->nb_of_reset       = old_save_fmt.nb_reset;
         lr1_mac_obj->real->region_type = ( smtc_real_region_types_t ) old_save_fmt.region_type;
+        smtc_join_scheduler_restore( &lr1_mac_obj->join_scheduler, lr1_mac_obj->dev_nonce, 0 );
 
         save_devnonce_rst( lr1_mac_obj );
         lr1mac_core_context_save( lr1_mac_obj );  // to save new number of reset
@@ -261,6 +261,26 @@ uint16_t lr1mac_core_nb_reset_get( lr1_stack_mac_t* lr1_mac_obj );
  */
 uint16_t lr1mac_core_devnonce_get( lr1_stack_mac_t* lr1_mac_obj );
 
+/**
+ * @brief Get the join requests sent and the join accepts received at a datarate since reset
+ *
+ * @param lr1_mac_obj
+ * @param datarate
+ * @param nb_attempts
+ * @param nb_accepts
+ * @return status_lorawan_t ERRORLORAWAN if datarate is out of range
+ */
+status_lorawan_t lr1mac_core_join_stats_get( lr1_stack_mac_t* lr1_mac_obj, uint8_t datarate, uint16_t* nb_attempts,
+                                             uint16_t* nb_accepts );
+
+/**
+ * @brief Get the join requests sent since the last join accept, they set the join back-off window
+ *
+ * @param lr1_mac_obj
+ * @return uint16_t
+ */
+uint16_t lr1mac_core_join_nb_failed_get( lr1_stack_mac_t* lr1_mac_obj );
+
 /**
  * @brief Returns the join state
  *
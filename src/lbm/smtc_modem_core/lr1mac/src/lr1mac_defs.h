@@ -97,7 +97,7 @@ extern "C" {
 #define GFSK_CRC_SEED                   (0x1D0F)
 #define GFSK_CRC_POLYNOMIAL             (0x1021)
 
-#define SMTC_LR1MAC_DEVNONCE_SAVE_PERIOD ( 1 )
+#define SMTC_LR1MAC_DEVNONCE_SAVE_PERIOD ( 16 )  // DevNonces reserved by each write of the counter context
 
 #define LR1MAC_DEVICE_TIME_DELAY_TO_BE_NO_SYNC (4233600UL)  // 49 days -> 49×24×60×60
 
@@ -246,12 +246,26 @@ typedef enum cid_from_device_e
     NB_MAC_CMD_ANS
 } cid_from_device_t;
 
+// Size of the mac commands sent by the network, 0 for an unknown command
+static const uint8_t lr1mac_cmd_mac_req_size[NB_MAC_CMD_REQ] = {
+    [LINK_CHECK_ANS] = LINK_CHECK_ANS_SIZE,         [LINK_ADR_REQ] = LINK_ADR_REQ_SIZE,
+    [DUTY_CYCLE_REQ] = DUTY_CYCLE_REQ_SIZE,         [RXPARRAM_SETUP_REQ] = RXPARRAM_SETUP_REQ_SIZE,
+    [DEV_STATUS_REQ] = DEV_STATUS_REQ_SIZE,         [NEW_CHANNEL_REQ] = NEW_CHANNEL_REQ_SIZE,
+    [RXTIMING_SETUP_REQ] = RXTIMING_SETUP_REQ_SIZE, [TXPARAM_SETUP_REQ] = TXPARAM_SETUP_REQ_SIZE,
+    [DL_CHANNEL_REQ] = DL_CHANNEL_REQ_SIZE,         [DEVICE_TIME_ANS] = DEVICE_TIME_ANS_SIZE,
+    [PING_SLOT_INFO_ANS] = PING_SLOT_INFO_ANS_SIZE, [PING_SLOT_CHANNEL_REQ] = PING_SLOT_CHANNEL_REQ_SIZE,
+    [BEACON_FREQ_REQ] = BEACON_FREQ_REQ_SIZE,
+};
+
+// Size of the mac commands sent by the device, 0 for an unknown command
 static const uint8_t lr1mac_cmd_mac_ans_size[NB_MAC_CMD_ANS] = {
-    [LINK_CHECK_ANS] = LINK_CHECK_ANS_SIZE,         [LINK_ADR_ANS] = LINK_ADR_ANS_SIZE,
-    [DUTY_CYCLE_ANS] = DUTY_CYCLE_ANS_SIZE,         [RXPARRAM_SETUP_ANS] = RXPARRAM_SETUP_ANS_SIZE,
-    [DEV_STATUS_ANS] = DEV_STATUS_ANS_SIZE,         [NEW_CHANNEL_ANS] = NEW_CHANNEL_ANS_SIZE,
-    [RXTIMING_SETUP_ANS] = RXTIMING_SETUP_ANS_SIZE, [TXPARAM_SETUP_ANS] = TXPARAM_SETUP_ANS_SIZE,
-    [DL_CHANNEL_ANS] = DL_CHANNEL_ANS_SIZE,
+    [LINK_CHECK_REQ] = LINK_CHECK_REQ_SIZE,           [LINK_ADR_ANS] = LINK_ADR_ANS_SIZE,
+    [DUTY_CYCLE_ANS] = DUTY_CYCLE_ANS_SIZE,           [RXPARRAM_SETUP_ANS] = RXPARRAM_SETUP_ANS_SIZE,
+    [DEV_STATUS_ANS] = DEV_STATUS_ANS_SIZE,           [NEW_CHANNEL_ANS] = NEW_CHANNEL_ANS_SIZE,
+    [RXTIMING_SETUP_ANS] = RXTIMING_SETUP_ANS_SIZE,   [TXPARAM_SETUP_ANS] = TXPARAM_SETUP_ANS_SIZE,
+    [DL_CHANNEL_ANS] = DL_CHANNEL_ANS_SIZE,           [DEVICE_TIME_REQ] = DEVICE_TIME_REQ_SIZE,
+    [PING_SLOT_INFO_REQ] = PING_SLOT_INFO_REQ_SIZE,   [PING_SLOT_CHANNEL_ANS] = PING_SLOT_CHANNEL_ANS_SIZE,
+    [BEACON_FREQ_ANS] = BEACON_FREQ_ANS_SIZE,
 };
 
 typedef enum lr1mac_bandwidth_e
@@ -462,6 +476,16 @@ typedef struct lr1mac_rx_session_param_s
     bool                                         waiting_beacon_to_start;
 } lr1mac_rx_session_param_t;
 
+/**
+ * @brief DevAddr index of the enabled rx sessions, sorted by DevAddr then by session
+ */
+typedef struct lr1mac_rx_session_index_s
+{
+    uint8_t           nb_sessions;
+    uint32_t          dev_addr[RX_SESSION_COUNT];
+    rx_session_type_t session[RX_SESSION_COUNT];
+} lr1mac_rx_session_index_t;
+
 /********************************************************************************/
 /*                    Mac Context and counter Context                           */
 /********************************************************************************/
@@ -483,8 +507,9 @@ typedef struct lr1_counter_context_s
     uint16_t devnonce;
     uint32_t nb_reset;
     uint8_t  join_nonce[6];
-    uint32_t rfu[3];  // bytes reserved for future used
-    uint32_t crc;     // !! crc MUST be the last field of the structure !!
+    uint32_t join_nb_failed;  // Join requests sent since the last join accept, was rfu[0]
+    uint32_t rfu[2];          // bytes reserved for future used
+    uint32_t crc;             // !! crc MUST be the last field of the structure !!
 } lr1_counter_context_t;
 
 typedef enum cf_list_type
@@ -285,22 +285,118 @@ status_lorawan_t lr1mac_fcnt_dwn_accept( uint16_t fcnt_dwn_tmp, uint32_t* fcnt_l
 
 uint8_t lr1_stack_mac_cmd_ans_cut( uint8_t* nwk_ans, uint8_t nwk_ans_size_in, uint8_t max_allowed_size )
 {
-    uint8_t* p_tmp = nwk_ans;
-    uint8_t* p     = nwk_ans;
+    uint8_t size_out = 0;
+    uint8_t index    = 0;
 
-    while( p_tmp - nwk_ans < MIN( nwk_ans_size_in, max_allowed_size ) )
+    while( index < nwk_ans_size_in )
     {
-        p_tmp += lr1mac_cmd_mac_ans_size[nwk_ans[p_tmp - nwk_ans]];
+        if( ( nwk_ans[index] >= NB_MAC_CMD_ANS ) || ( lr1mac_cmd_mac_ans_size[nwk_ans[index]] == 0 ) )
+        {
+            break;  // Unknown answer, the following ones can't be delimited
+        }
+        uint8_t group_size = lr1mac_cmd_mac_ans_size[nwk_ans[index]];
+
+        if( nwk_ans[index] == LINK_ADR_ANS )
+        {
+            while( ( ( index + group_size ) < nwk_ans_size_in ) && ( nwk_ans[index + group_size] == LINK_ADR_ANS ) )
+            {
+                group_size += LINK_ADR_ANS_SIZE;
+            }
+        }
+        if( ( index + group_size ) > nwk_ans_size_in )
+        {
+            break;
+        }
+
+        if( ( size_out + group_size ) <= max_allowed_size )
+        {
+            // size_out <= index: forward copy in place is safe
+            memcpy1( &nwk_ans[size_out], &nwk_ans[index], group_size );
+            size_out += group_size;
+        }
+        index += group_size;
+    }
+
+    return size_out;  // New payload size
+}
+
+void lr1mac_rx_session_index_build( lr1mac_rx_session_index_t*        index,
+                                    lr1mac_rx_session_param_t* const* rx_session_param, uint8_t nb_sessions )
+{
+    index->nb_sessions = 0;
+    for( uint8_t i = 0; ( i < nb_sessions ) && ( i < RX_SESSION_COUNT ); i++ )
+    {
+        if( ( rx_session_param[i] == NULL ) || ( rx_session_param[i]->enabled == false ) )
+        {
+            continue;
+        }
+
+        // Insertion sort, sessions come in increasing order so equal addresses keep it
+        uint8_t pos = index->nb_sessions;
+        while( ( pos > 0 ) && ( index->dev_addr[pos - 1] > rx_session_param[i]->dev_addr ) )
+        {
+            index->dev_addr[pos] = index->dev_addr[pos - 1];
+            index->session[pos]  = index->session[pos - 1];
+            pos--;
+        }
+        index->dev_addr[pos] = rx_session_param[i]->dev_addr;
+        index->session[pos]  = ( rx_session_type_t ) i;
+        index->nb_sessions++;
+    }
+}
 
-        if( ( p_tmp - nwk_ans ) <= max_allowed_size )
+rx_session_type_t lr1mac_rx_session_index_find( const lr1mac_rx_session_index_t* index, uint32_t dev_addr )
+{
+    // Lower bound binary search
+    uint8_t low  = 0;
+    uint8_t high = index->nb_sessions;
+    while( low < high )
+    {
+        uint8_t mid = ( low + high ) / 2;
+        if( index->dev_addr[mid] < dev_addr )
         {
-            p = p_tmp;
+            low = mid + 1;
         }
         else
         {
+            high = mid;
+        }
+    }
+
+    if( ( low < index->nb_sessions ) && ( index->dev_addr[low] == dev_addr ) )
+    {
+        return index->session[low];
+    }
+    return RX_SESSION_COUNT;
+}
+
+uint8_t lr1_stack_mac_cmd_block_check( const uint8_t* nwk_payload, uint8_t* nwk_payload_size )
+{
+    uint16_t ans_size = 0;
+    uint8_t  index    = 0;
+
+    while( index < *nwk_payload_size )
+    {
+        uint8_t cmd_identifier = nwk_payload[index];
+        if( ( cmd_identifier >= NB_MAC_CMD_REQ ) || ( lr1mac_cmd_mac_req_size[cmd_identifier] == 0 ) )
+        {
+            SMTC_MODEM_HAL_TRACE_PRINTF( " Unknown mac command %02x\n", cmd_identifier );
             break;
         }
+        if( ( index + lr1mac_cmd_mac_req_size[cmd_identifier] ) > *nwk_payload_size )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "Truncated mac command %02x\n", cmd_identifier );
+            break;
+        }
+        // Answers sent by the network are not answered, requests are answered with the same command identifier
+        if( ( cmd_identifier != LINK_CHECK_ANS ) && ( cmd_identifier != DEVICE_TIME_ANS ) &&
+            ( cmd_identifier != PING_SLOT_INFO_ANS ) )
+        {
+            ans_size += lr1mac_cmd_mac_ans_size[cmd_identifier];
+        }
+        index += lr1mac_cmd_mac_req_size[cmd_identifier];
     }
+    *nwk_payload_size = index;
 
-    return p - nwk_ans;  // New payload size
+    return ( ans_size > 0xFF ) ? 0xFF : ( uint8_t ) ans_size;
 }
\ No newline at end of file
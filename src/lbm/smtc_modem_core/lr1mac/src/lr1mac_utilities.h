@@ -174,9 +174,26 @@ int lr1mac_rx_fhdr_extract( uint8_t* rx_payload, uint8_t rx_payload_size, uint8_
  */
 status_lorawan_t lr1mac_fcnt_dwn_accept( uint16_t fcnt_dwn_tmp, uint32_t* fcnt_lorawan );
 
+/*!
+ * \brief Build the DevAddr index of the enabled rx sessions
+ *
+ */
+void lr1mac_rx_session_index_build( lr1mac_rx_session_index_t*        index,
+                                    lr1mac_rx_session_param_t* const* rx_session_param, uint8_t nb_sessions );
+
+/*!
+ * \brief Find the rx session of a DevAddr, the lowest session wins when several share it
+ *
+ * \return The session, RX_SESSION_COUNT if the DevAddr is not listened to
+ */
+rx_session_type_t lr1mac_rx_session_index_find( const lr1mac_rx_session_index_t* index, uint32_t dev_addr );
+
 /**
  * @brief if the mac command answer is bigger than the allowed payload size, the payload is cut
  *
+ * @remark Answers are kept in order with a first fit: an answer which does not fit is dropped but the following
+ * smaller ones are still packed. The LinkADRAns answering a same LinkADRReq block are kept or dropped together
+ *
  * @param nwk_ans
  * @param nwk_ans_size_in
  * @param max_allowed_size
@@ -184,6 +201,18 @@ status_lorawan_t lr1mac_fcnt_dwn_accept( uint16_t fcnt_dwn_tmp, uint32_t* fcnt_l
  */
 uint8_t lr1_stack_mac_cmd_ans_cut( uint8_t* nwk_ans, uint8_t nwk_ans_size_in, uint8_t max_allowed_size );
 
+/**
+ * @brief Delimit all the mac commands of a block sent by the network before any of them is applied
+ *
+ * @remark The block is shortened to the last complete known command because the commands following an unknown or
+ * truncated one can't be delimited
+ *
+ * @param nwk_payload
+ * @param nwk_payload_size [in,out] block size, shortened to the delimited commands
+ * @return uint8_t size of the answers generated by the block, saturated to 0xFF
+ */
+uint8_t lr1_stack_mac_cmd_block_check( const uint8_t* nwk_payload, uint8_t* nwk_payload_size );
+
 #ifdef __cplusplus
 }
 #endif
@@ -291,6 +291,17 @@ bool smtc_duty_cycle_is_toa_accepted( smtc_dtc_t* dtc_obj, uint32_t freq_hz, uin
     return true;
 }
 
+uint32_t smtc_duty_cycle_get_band_budget_ms( smtc_dtc_t* dtc_obj, uint32_t freq_hz )
+{
+    if( ( dtc_obj->enabled != SMTC_DTC_ENABLED ) || ( dtc_obj->number_of_bands == 0 ) )
+    {
+        return UINT32_MAX;
+    }
+
+    uint8_t band = smtc_duty_cycle_get_band( dtc_obj, freq_hz );
+    return SMTC_DTC_PERIOD_MS / dtc_obj->bands[band].duty_cycle_regulation;
+}
+
 int32_t smtc_duty_cycle_band_get_available_toa_ms( smtc_dtc_t* dtc_obj, uint8_t band )
 {
     if( ( dtc_obj->enabled != SMTC_DTC_ENABLED ) || ( dtc_obj->number_of_bands == 0 ) )
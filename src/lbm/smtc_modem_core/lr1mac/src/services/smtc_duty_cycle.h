@@ -187,6 +187,15 @@ void smtc_duty_cycle_update( smtc_dtc_t* dtc_obj );
  */
 bool smtc_duty_cycle_is_toa_accepted( smtc_dtc_t* dtc_obj, uint32_t freq_hz, uint32_t toa_ms );
 
+/**
+ * @brief Get the Time On Air allowed over a whole period on the band of a frequency
+ *
+ * @param dtc_obj                   Contains the duty cycle context
+ * @param freq_hz                   Frequency in the band
+ * @return uint32_t                 milliseconds, UINT32_MAX if the duty cycle is not enforced
+ */
+uint32_t smtc_duty_cycle_get_band_budget_ms( smtc_dtc_t* dtc_obj, uint32_t freq_hz );
+
 /**
  * @brief Get Time On Air available in a band
  *
@@ -0,0 +1,150 @@
+/*!
+ * \file      smtc_join_scheduler.c
+ *
+ * \brief     Join request back-off, DevNonce reservation and join statistics
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_join_scheduler.h"
+#include "lbm/smtc_modem_hal/smtc_modem_hal.h"
+
+#include <string.h>  //for memset
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_join_scheduler_init( smtc_join_scheduler_t* join_scheduler, uint16_t devnonce_block )
+{
+    memset( join_scheduler, 0, sizeof( smtc_join_scheduler_t ) );
+    join_scheduler->devnonce_block = ( devnonce_block > 0 ) ? devnonce_block : 1;
+}
+
+void smtc_join_scheduler_restore( smtc_join_scheduler_t* join_scheduler, uint16_t devnonce_reserved,
+                                  uint16_t nb_failed )
+{
+    join_scheduler->devnonce_reserved = devnonce_reserved;
+    join_scheduler->nb_failed         = nb_failed;
+}
+
+bool smtc_join_scheduler_reserve_devnonce( smtc_join_scheduler_t* join_scheduler, uint16_t dev_nonce )
+{
+    // The DevNonce only grows, it saturates at 0xFFFF
+    if( dev_nonce > join_scheduler->devnonce_reserved )
+    {
+        uint32_t reserved = ( uint32_t ) dev_nonce + join_scheduler->devnonce_block - 1;
+
+        join_scheduler->devnonce_reserved = ( uint16_t )( ( reserved > UINT16_MAX ) ? UINT16_MAX : reserved );
+        return true;
+    }
+    return false;
+}
+
+void smtc_join_scheduler_on_join_request( smtc_join_scheduler_t* join_scheduler, uint8_t datarate )
+{
+    if( datarate < SMTC_JOIN_SCHEDULER_NB_DR )
+    {
+        if( join_scheduler->nb_attempts[datarate] < UINT16_MAX )
+        {
+            join_scheduler->nb_attempts[datarate]++;
+        }
+    }
+    if( join_scheduler->nb_failed < UINT16_MAX )
+    {
+        join_scheduler->nb_failed++;
+    }
+}
+
+void smtc_join_scheduler_on_join_accept( smtc_join_scheduler_t* join_scheduler, uint8_t datarate )
+{
+    if( ( datarate < SMTC_JOIN_SCHEDULER_NB_DR ) && ( join_scheduler->nb_accepts[datarate] < UINT16_MAX ) )
+    {
+        join_scheduler->nb_accepts[datarate]++;
+    }
+    join_scheduler->nb_failed = 0;
+}
+
+uint32_t smtc_join_scheduler_get_backoff_s( const smtc_join_scheduler_t* join_scheduler )
+{
+    uint32_t window_s = SMTC_JOIN_SCHEDULER_BASE_WINDOW_S;
+
+    if( join_scheduler->nb_failed == 0 )
+    {
+        return 0;
+    }
+    for( uint16_t i = 1; ( i < join_scheduler->nb_failed ) && ( window_s < SMTC_JOIN_SCHEDULER_MAX_WINDOW_S ); i++ )
+    {
+        window_s <<= 1;
+    }
+    if( window_s > SMTC_JOIN_SCHEDULER_MAX_WINDOW_S )
+    {
+        window_s = SMTC_JOIN_SCHEDULER_MAX_WINDOW_S;
+    }
+    return smtc_modem_hal_get_random_nb_in_range( 0, window_s );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,148 @@
+/*!
+ * \file      smtc_join_scheduler.h
+ *
+ * \brief     Join request back-off, DevNonce reservation and join statistics
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SMTC_JOIN_SCHEDULER_H__
+#define __SMTC_JOIN_SCHEDULER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+// clang-format off
+#define SMTC_JOIN_SCHEDULER_NB_DR           ( 16 )
+#define SMTC_JOIN_SCHEDULER_BASE_WINDOW_S   ( 16 )    // Back-off window after the first failed join request
+#define SMTC_JOIN_SCHEDULER_MAX_WINDOW_S    ( 3600 )  // The window doubles on each failure up to this value
+// clang-format on
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Join scheduler context, nb_failed and devnonce_reserved are stored with the DevNonce
+ */
+typedef struct smtc_join_scheduler_s
+{
+    uint16_t devnonce_block;     // DevNonces reserved by each context write
+    uint16_t devnonce_reserved;  // Last DevNonce covered by the context in flash
+    uint16_t nb_failed;          // Join requests sent since the last join accept
+    uint16_t nb_attempts[SMTC_JOIN_SCHEDULER_NB_DR];  // Join requests sent since reset, per datarate
+    uint16_t nb_accepts[SMTC_JOIN_SCHEDULER_NB_DR];   // Join accepts received since reset, per datarate
+} smtc_join_scheduler_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Join scheduler initialization
+ *
+ * @param join_scheduler  Contains the join scheduler context
+ * @param devnonce_block  DevNonces reserved by each context write, at least 1
+ */
+void smtc_join_scheduler_init( smtc_join_scheduler_t* join_scheduler, uint16_t devnonce_block );
+
+/**
+ * @brief Restore the state stored with the DevNonce
+ *
+ * @param join_scheduler     Contains the join scheduler context
+ * @param devnonce_reserved  DevNonce read from the context, the next join request uses the following one
+ * @param nb_failed          Join requests sent since the last join accept
+ */
+void smtc_join_scheduler_restore( smtc_join_scheduler_t* join_scheduler, uint16_t devnonce_reserved,
+                                  uint16_t nb_failed );
+
+/**
+ * @brief Check that the DevNonce of a join request is covered by the stored context, before it is sent
+ *
+ * @param join_scheduler  Contains the join scheduler context
+ * @param dev_nonce       DevNonce of the join request
+ * @return true if dev_nonce is out of the reserved block, a new block is reserved and the context must be stored
+ *         before the join request is sent
+ */
+bool smtc_join_scheduler_reserve_devnonce( smtc_join_scheduler_t* join_scheduler, uint16_t dev_nonce );
+
+/**
+ * @brief Record a join request sent
+ *
+ * @param join_scheduler  Contains the join scheduler context
+ * @param datarate        Datarate of the join request
+ */
+void smtc_join_scheduler_on_join_request( smtc_join_scheduler_t* join_scheduler, uint8_t datarate );
+
+/**
+ * @brief Record a join accept, the back-off starts again from the first window
+ *
+ * @param join_scheduler  Contains the join scheduler context
+ * @param datarate        Datarate of the join request that was accepted
+ */
+void smtc_join_scheduler_on_join_accept( smtc_join_scheduler_t* join_scheduler, uint8_t datarate );
+
+/**
+ * @brief Get the random back-off before the next join request
+ *
+ * @remark The delay is drawn in a window doubling with each failed join request, devices that lost the network
+ *         together spread their join requests instead of sending them in lockstep
+ *
+ * @param join_scheduler  Contains the join scheduler context
+ * @return uint32_t       Delay in seconds, 0 if no join request failed
+ */
+uint32_t smtc_join_scheduler_get_backoff_s( const smtc_join_scheduler_t* join_scheduler );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_JOIN_SCHEDULER_H__
+
+/* --- EOF ------------------------------------------------------------------ */
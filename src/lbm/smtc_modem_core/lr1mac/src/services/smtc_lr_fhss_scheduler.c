@@ -0,0 +1,194 @@
+/*!
+ * \file      smtc_lr_fhss_scheduler.c
+ *
+ * \brief     LR-FHSS uplink policy, datarate choice
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_lr_fhss_scheduler.h"
+
+#include <string.h>  //for memset
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#define SMTC_LR_FHSS_SCHEDULER_AVERAGE_SHIFT ( 3 )           // Delivery rate averaged over about 8 answers
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Add the outcome of an expected answer to the delivery rate of a datarate
+ *
+ * @param scheduler Contains the LR-FHSS scheduler context
+ * @param datarate  Datarate of the uplink
+ * @param delivered The answer was received
+ */
+static void smtc_lr_fhss_scheduler_add_delivery( smtc_lr_fhss_scheduler_t* scheduler, uint8_t datarate,
+                                                 bool delivered );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_lr_fhss_scheduler_init( smtc_lr_fhss_scheduler_t* scheduler )
+{
+    memset( scheduler, 0, sizeof( smtc_lr_fhss_scheduler_t ) );
+}
+
+void smtc_lr_fhss_scheduler_reset_stats( smtc_lr_fhss_scheduler_t* scheduler )
+{
+    scheduler->pending_ack        = false;
+    scheduler->pending_link_check = false;
+    scheduler->margin_valid       = false;
+    memset( scheduler->delivery_rate, 0, sizeof( scheduler->delivery_rate ) );
+    memset( scheduler->nb_tracked, 0, sizeof( scheduler->nb_tracked ) );
+}
+
+void smtc_lr_fhss_scheduler_on_uplink( smtc_lr_fhss_scheduler_t* scheduler, uint8_t datarate, bool confirmed,
+                                       bool link_check )
+{
+    if( scheduler->margin_valid == true )
+    {
+        scheduler->margin_age++;
+        if( scheduler->margin_age > SMTC_LR_FHSS_SCHEDULER_MARGIN_MAX_AGE )
+        {
+            scheduler->margin_valid = false;
+        }
+    }
+    scheduler->pending_dr         = datarate;
+    scheduler->pending_ack        = confirmed;
+    scheduler->pending_link_check = link_check;
+}
+
+void smtc_lr_fhss_scheduler_on_downlink( smtc_lr_fhss_scheduler_t* scheduler, bool ack_received, bool link_check_ans,
+                                         uint8_t margin_db, bool robust )
+{
+    if( ( scheduler->pending_ack == false ) && ( scheduler->pending_link_check == false ) )
+    {
+        return;
+    }
+
+    smtc_lr_fhss_scheduler_add_delivery(
+        scheduler, scheduler->pending_dr,
+        ( ( scheduler->pending_ack == true ) && ( ack_received == true ) ) ||
+            ( ( scheduler->pending_link_check == true ) && ( link_check_ans == true ) ) );
+
+    if( ( scheduler->pending_link_check == true ) && ( link_check_ans == true ) )
+    {
+        // A CR 1/3 uplink is received with a few more dB than a CR 2/3 one would be
+        int16_t margin = ( int16_t ) margin_db - ( ( robust == true ) ? SMTC_LR_FHSS_SCHEDULER_CR_GAIN_DB : 0 );
+
+        scheduler->margin_db    = ( int8_t )( ( margin > INT8_MAX ) ? INT8_MAX : margin );
+        scheduler->margin_age   = 0;
+        scheduler->margin_valid = true;
+    }
+    scheduler->pending_ack        = false;
+    scheduler->pending_link_check = false;
+}
+
+uint8_t smtc_lr_fhss_scheduler_select_dr( const smtc_lr_fhss_scheduler_t* scheduler, uint8_t datarate,
+                                          uint8_t robust_dr, uint8_t fast_dr )
+{
+    if( ( fast_dr < SMTC_LR_FHSS_SCHEDULER_NB_DR ) &&
+        ( scheduler->nb_tracked[fast_dr] >= SMTC_LR_FHSS_SCHEDULER_MIN_TRACKED ) &&
+        ( scheduler->delivery_rate[fast_dr] < SMTC_LR_FHSS_SCHEDULER_DELIVERY_MIN ) )
+    {
+        return robust_dr;
+    }
+    if( scheduler->margin_valid == true )
+    {
+        return ( scheduler->margin_db >= SMTC_LR_FHSS_SCHEDULER_MARGIN_DB ) ? fast_dr : robust_dr;
+    }
+    return datarate;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void smtc_lr_fhss_scheduler_add_delivery( smtc_lr_fhss_scheduler_t* scheduler, uint8_t datarate,
+                                                 bool delivered )
+{
+    if( datarate >= SMTC_LR_FHSS_SCHEDULER_NB_DR )
+    {
+        return;
+    }
+
+    int16_t sample = ( delivered == true ) ? 100 : 0;
+    int16_t rate   = scheduler->delivery_rate[datarate];
+
+    if( scheduler->nb_tracked[datarate] == 0 )
+    {
+        rate = sample;
+    }
+    else
+    {
+        // Rounded away from zero so that the average keeps moving on a run of identical outcomes
+        int16_t delta = sample - rate;
+        delta += ( delta > 0 ) ? ( 1 << ( SMTC_LR_FHSS_SCHEDULER_AVERAGE_SHIFT - 1 ) )
+                               : -( 1 << ( SMTC_LR_FHSS_SCHEDULER_AVERAGE_SHIFT - 1 ) );
+        rate += delta / ( 1 << SMTC_LR_FHSS_SCHEDULER_AVERAGE_SHIFT );
+    }
+    scheduler->delivery_rate[datarate] = ( uint8_t ) rate;
+    if( scheduler->nb_tracked[datarate] < UINT8_MAX )
+    {
+        scheduler->nb_tracked[datarate]++;
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
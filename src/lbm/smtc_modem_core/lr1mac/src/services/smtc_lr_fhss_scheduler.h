@@ -0,0 +1,153 @@
+/*!
+ * \file      smtc_lr_fhss_scheduler.h
+ *
+ * \brief     LR-FHSS uplink policy, datarate choice
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SMTC_LR_FHSS_SCHEDULER_H__
+#define __SMTC_LR_FHSS_SCHEDULER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+// clang-format off
+#define SMTC_LR_FHSS_SCHEDULER_NB_DR            ( 16 )
+#define SMTC_LR_FHSS_SCHEDULER_MIN_TRACKED      ( 4 )   // Answers expected before a delivery rate is trusted
+#define SMTC_LR_FHSS_SCHEDULER_DELIVERY_MIN     ( 80 )  // Delivery rate in percent below which CR 2/3 is avoided
+#define SMTC_LR_FHSS_SCHEDULER_MARGIN_DB        ( 6 )   // Link margin required by CR 2/3
+#define SMTC_LR_FHSS_SCHEDULER_CR_GAIN_DB       ( 3 )   // Sensitivity of CR 1/3 over CR 2/3
+#define SMTC_LR_FHSS_SCHEDULER_MARGIN_MAX_AGE   ( 32 )  // LR-FHSS uplinks after which a margin is dropped
+// clang-format on
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief LR-FHSS uplink policy context
+ */
+typedef struct smtc_lr_fhss_scheduler_s
+{
+    bool     dr_policy_enabled;   // Choose between the coding rates of a bandwidth
+    bool     pending_ack;         // The last LR-FHSS uplink was confirmed
+    bool     pending_link_check;  // The last LR-FHSS uplink carried a LinkCheckReq
+    uint8_t  pending_dr;
+    bool     margin_valid;
+    int8_t   margin_db;   // Last link check margin, as seen by a CR 2/3 datarate
+    uint8_t  margin_age;  // LR-FHSS uplinks sent since the margin was received
+    uint8_t  delivery_rate[SMTC_LR_FHSS_SCHEDULER_NB_DR];  // Percent, moving average of the answers expected
+    uint8_t  nb_tracked[SMTC_LR_FHSS_SCHEDULER_NB_DR];     // Answers expected, saturated to 255
+} smtc_lr_fhss_scheduler_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief LR-FHSS scheduler initialization, the datarate policy is disabled
+ *
+ * @param scheduler Contains the LR-FHSS scheduler context
+ */
+void smtc_lr_fhss_scheduler_init( smtc_lr_fhss_scheduler_t* scheduler );
+
+/**
+ * @brief Drop the margin and the delivery rates, the datarates they refer to are no longer valid
+ *
+ * @param scheduler Contains the LR-FHSS scheduler context
+ */
+void smtc_lr_fhss_scheduler_reset_stats( smtc_lr_fhss_scheduler_t* scheduler );
+
+/**
+ * @brief Record an LR-FHSS uplink, an answer is expected if it is confirmed or carries a LinkCheckReq
+ *
+ * @param scheduler   Contains the LR-FHSS scheduler context
+ * @param datarate    Datarate of the uplink
+ * @param confirmed   The uplink is confirmed
+ * @param link_check  The uplink carries a LinkCheckReq
+ */
+void smtc_lr_fhss_scheduler_on_uplink( smtc_lr_fhss_scheduler_t* scheduler, uint8_t datarate, bool confirmed,
+                                       bool link_check );
+
+/**
+ * @brief Record the outcome of the receive windows of the last LR-FHSS uplink
+ *
+ * @param scheduler         Contains the LR-FHSS scheduler context
+ * @param ack_received      The network acknowledged the uplink
+ * @param link_check_ans    The network answered the LinkCheckReq
+ * @param margin_db         Margin of the LinkCheckAns
+ * @param robust            The uplink used a CR 1/3 datarate
+ */
+void smtc_lr_fhss_scheduler_on_downlink( smtc_lr_fhss_scheduler_t* scheduler, bool ack_received, bool link_check_ans,
+                                         uint8_t margin_db, bool robust );
+
+/**
+ * @brief Choose between the CR 1/3 and the CR 2/3 datarates of a bandwidth
+ *
+ * @remark The CR 2/3 datarate halves the airtime, it is used while the link margin allows it and its delivery rate
+ *         holds. Lost frames, from fading or from collisions, bring the uplinks back to CR 1/3. Without margin nor
+ *         delivery rate, datarate is kept
+ *
+ * @param scheduler   Contains the LR-FHSS scheduler context
+ * @param datarate    Datarate drawn for the next uplink
+ * @param robust_dr   CR 1/3 datarate of the bandwidth
+ * @param fast_dr     CR 2/3 datarate of the bandwidth
+ * @return uint8_t    Datarate of the next uplink
+ */
+uint8_t smtc_lr_fhss_scheduler_select_dr( const smtc_lr_fhss_scheduler_t* scheduler, uint8_t datarate,
+                                          uint8_t robust_dr, uint8_t fast_dr );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_LR_FHSS_SCHEDULER_H__
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,204 @@
+/*!
+ * \file      smtc_toa_cache.c
+ *
+ * \brief     Time on air of the recent uplink configurations
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_toa_cache.h"
+#include "lbm/smtc_modem_core/lr1mac/src/smtc_real/src/smtc_real.h"
+#include "lbm/smtc_modem_core/smtc_ralf/src/ralf_defs.h"
+#include "lbm/smtc_modem_core/modem_config/smtc_modem_hal_dbg_trace.h"
+#include "lbm/smtc_modem_hal/smtc_modem_hal.h"
+
+#include <string.h>  //for memset
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Get the entry a configuration is stored in
+ *
+ * @param region_type   Region of the uplink
+ * @param datarate      Datarate of the uplink
+ * @param payload_size  Size of the uplink payload
+ * @return uint8_t      Entry index
+ */
+static uint8_t smtc_toa_cache_get_index( uint8_t region_type, uint8_t datarate, uint8_t payload_size );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_toa_cache_init( smtc_toa_cache_t* toa_cache )
+{
+    memset( toa_cache, 0, sizeof( smtc_toa_cache_t ) );
+}
+
+bool smtc_toa_cache_get( const smtc_toa_cache_t* toa_cache, uint8_t region_type, uint8_t datarate,
+                         uint8_t payload_size, uint32_t* toa_ms )
+{
+    const smtc_toa_cache_entry_t* entry =
+        &toa_cache->entries[smtc_toa_cache_get_index( region_type, datarate, payload_size )];
+
+    if( ( entry->valid == false ) || ( entry->region_type != region_type ) || ( entry->datarate != datarate ) ||
+        ( entry->payload_size != payload_size ) )
+    {
+        return false;
+    }
+    *toa_ms = entry->toa_ms;
+    return true;
+}
+
+void smtc_toa_cache_set( smtc_toa_cache_t* toa_cache, uint8_t region_type, uint8_t datarate, uint8_t payload_size,
+                         uint32_t toa_ms )
+{
+    smtc_toa_cache_entry_t* entry =
+        &toa_cache->entries[smtc_toa_cache_get_index( region_type, datarate, payload_size )];
+
+    entry->valid        = true;
+    entry->region_type  = region_type;
+    entry->datarate     = datarate;
+    entry->payload_size = payload_size;
+    entry->toa_ms       = toa_ms;
+}
+
+uint32_t smtc_toa_cache_compute( smtc_real_t* real, const ral_t* ral, uint8_t datarate, uint8_t payload_size )
+{
+    uint32_t toa = 0;
+
+    modulation_type_t tx_modulation_type = smtc_real_get_modulation_type_from_datarate( real, datarate );
+
+    if( tx_modulation_type == LORA )
+    {
+        uint8_t            tx_sf;
+        lr1mac_bandwidth_t tx_bw;
+        smtc_real_lora_dr_to_sf_bw( real, datarate, &tx_sf, &tx_bw );
+
+        ralf_params_lora_t lora_param;
+        memset( &lora_param, 0, sizeof( ralf_params_lora_t ) );
+
+        lora_param.mod_params.sf   = ( ral_lora_sf_t ) tx_sf;
+        lora_param.mod_params.bw   = ( ral_lora_bw_t ) tx_bw;
+        lora_param.mod_params.cr   = smtc_real_get_coding_rate( real );
+        lora_param.mod_params.ldro = ral_compute_lora_ldro( lora_param.mod_params.sf, lora_param.mod_params.bw );
+
+        lora_param.pkt_params.crc_is_on            = true;
+        lora_param.pkt_params.invert_iq_is_on      = false;
+        lora_param.pkt_params.pld_len_in_bytes     = payload_size;
+        lora_param.pkt_params.preamble_len_in_symb = smtc_real_get_preamble_len( real, lora_param.mod_params.sf );
+        lora_param.pkt_params.header_type          = RAL_LORA_PKT_EXPLICIT;
+
+        toa = ral_get_lora_time_on_air_in_ms( ral, &lora_param.pkt_params, &lora_param.mod_params );
+    }
+    else if( tx_modulation_type == FSK )
+    {
+        uint8_t tx_bitrate;
+        smtc_real_fsk_dr_to_bitrate( real, datarate, &tx_bitrate );
+
+        ralf_params_gfsk_t gfsk_param;
+        memset( &gfsk_param, 0, sizeof( ralf_params_gfsk_t ) );
+
+        gfsk_param.mod_params.fdev_in_hz            = 25000;
+        gfsk_param.mod_params.br_in_bps             = tx_bitrate * 1000;
+        gfsk_param.mod_params.bw_dsb_in_hz          = 100000;
+        gfsk_param.pkt_params.pld_len_in_bytes      = payload_size;
+        gfsk_param.pkt_params.preamble_len_in_bits  = 40;
+        gfsk_param.pkt_params.header_type           = RAL_GFSK_PKT_VAR_LEN;
+        gfsk_param.pkt_params.sync_word_len_in_bits = 24;
+        gfsk_param.pkt_params.dc_free               = RAL_GFSK_DC_FREE_WHITENING;
+        gfsk_param.pkt_params.crc_type              = RAL_GFSK_CRC_2_BYTES_INV;
+
+        toa = ral_get_gfsk_time_on_air_in_ms( ral, &gfsk_param.pkt_params, &gfsk_param.mod_params );
+    }
+    else if( tx_modulation_type == LR_FHSS )
+    {
+        lr_fhss_v1_cr_t tx_cr;
+        lr_fhss_v1_bw_t tx_bw;
+        smtc_real_lr_fhss_dr_to_cr_bw( real, datarate, &tx_cr, &tx_bw );
+
+        ralf_params_lr_fhss_t lr_fhss_param;
+        memset( &lr_fhss_param, 0, sizeof( ralf_params_lr_fhss_t ) );
+
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.cr             = tx_cr;
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.enable_hopping = true;
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.header_count   = smtc_real_lr_fhss_get_header_count( tx_cr );
+
+        ral_lr_fhss_get_time_on_air_in_ms( ral, &lr_fhss_param.ral_lr_fhss_params, payload_size, &toa );
+    }
+    else
+    {
+        smtc_modem_hal_lr1mac_panic( "TX MODULATION NOT SUPPORTED\n" );
+    }
+    return toa;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint8_t smtc_toa_cache_get_index( uint8_t region_type, uint8_t datarate, uint8_t payload_size )
+{
+    // An application usually sends a few payload sizes at the datarates chosen by the ADR, spread both over the
+    // entries so that they don't evict each other
+    return ( uint8_t )( ( payload_size + ( datarate * 5 ) + ( region_type * 3 ) ) & ( SMTC_TOA_CACHE_SIZE - 1 ) );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
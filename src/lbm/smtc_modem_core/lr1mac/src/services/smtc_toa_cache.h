@@ -0,0 +1,142 @@
+/*!
+ * \file      smtc_toa_cache.h
+ *
+ * \brief     Time on air of the recent uplink configurations
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SMTC_TOA_CACHE_H__
+#define __SMTC_TOA_CACHE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "lbm/smtc_modem_core/lr1mac/src/smtc_real/src/smtc_real_defs.h"
+#include "lbm/smtc_modem_core/smtc_ral/src/ral.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+// clang-format off
+#define SMTC_TOA_CACHE_SIZE         ( 16 )  // Power of 2, entries are indexed by a hash of the key
+// clang-format on
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief One time on air, the region, the datarate and the payload size set every radio parameter of an uplink
+ */
+typedef struct smtc_toa_cache_entry_s
+{
+    bool     valid;
+    uint8_t  region_type;
+    uint8_t  datarate;
+    uint8_t  payload_size;
+    uint32_t toa_ms;
+} smtc_toa_cache_entry_t;
+
+typedef struct smtc_toa_cache_s
+{
+    smtc_toa_cache_entry_t entries[SMTC_TOA_CACHE_SIZE];
+} smtc_toa_cache_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Time on air cache initialization, every entry is dropped
+ *
+ * @param toa_cache Contains the time on air cache context
+ */
+void smtc_toa_cache_init( smtc_toa_cache_t* toa_cache );
+
+/**
+ * @brief Look up the time on air of an uplink configuration
+ *
+ * @param toa_cache     Contains the time on air cache context
+ * @param region_type   Region of the uplink
+ * @param datarate      Datarate of the uplink
+ * @param payload_size  Size of the uplink payload
+ * @param toa_ms        Time on air in milliseconds, only written on a hit
+ * @return true if the configuration is in the cache
+ */
+bool smtc_toa_cache_get( const smtc_toa_cache_t* toa_cache, uint8_t region_type, uint8_t datarate,
+                         uint8_t payload_size, uint32_t* toa_ms );
+
+/**
+ * @brief Store the time on air of an uplink configuration, it replaces the configuration sharing its entry
+ *
+ * @param toa_cache     Contains the time on air cache context
+ * @param region_type   Region of the uplink
+ * @param datarate      Datarate of the uplink
+ * @param payload_size  Size of the uplink payload
+ * @param toa_ms        Time on air in milliseconds
+ */
+void smtc_toa_cache_set( smtc_toa_cache_t* toa_cache, uint8_t region_type, uint8_t datarate, uint8_t payload_size,
+                         uint32_t toa_ms );
+
+/**
+ * @brief Compute the time on air of an uplink configuration, with the radio parameters the region sets for it
+ *
+ * @param real          Region of the uplink
+ * @param ral           Radio abstraction layer, only its time on air formulas are used
+ * @param datarate      Datarate of the uplink
+ * @param payload_size  Size of the uplink payload
+ * @return uint32_t     Time on air in milliseconds
+ */
+uint32_t smtc_toa_cache_compute( smtc_real_t* real, const ral_t* ral, uint8_t datarate, uint8_t payload_size );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_TOA_CACHE_H__
+
+/* --- EOF ------------------------------------------------------------------ */
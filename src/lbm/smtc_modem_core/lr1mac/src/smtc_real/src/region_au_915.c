@@ -61,6 +61,7 @@
 
 #define snapshot_channel_tx_mask real->region.au915.snapshot_channel_tx_mask
 #define snapshot_bank_tx_mask real->region.au915.snapshot_bank_tx_mask
+#define dr_channel_cache real->region.au915.dr_channel_cache
 
 /*
  * -----------------------------------------------------------------------------
@@ -162,6 +163,7 @@ void region_au_915_init( smtc_real_t* real )
     memset1( &snapshot_channel_tx_mask[0], 0xFF, BANK_MAX_AU915 );
 
     snapshot_bank_tx_mask = 0;
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
 }
 
 void region_au_915_config( smtc_real_t* real )
@@ -207,6 +209,8 @@ void region_au_915_config( smtc_real_t* real )
                                      ( ( i % 8 ) == 7 ) ? "---\n" : "" );
     }
 
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
+
     // Enable select channels
     memset1( &unwrapped_channel_mask[0], 0x00, 8 );
     memset1( &unwrapped_channel_mask[region_sub_band - 1], 0xFF, 1 );
@@ -293,7 +297,9 @@ status_lorawan_t region_au_915_get_join_next_channel( smtc_real_t* real, uint8_t
 {
     au_915_channels_bank_t bank_tmp_cnt = 0;
     uint8_t                active_channel_nb;
-    uint8_t                active_channel_index[NUMBER_OF_TX_CHANNEL_AU_915];
+    smtc_real_bitset_t     active_channel;
+    smtc_real_bitset_t     enabled_channel;
+    uint8_t                bank_offset;
     do
     {
         if( snapshot_bank_tx_mask > BANK_8_500_AU915 )
@@ -307,16 +313,12 @@ status_lorawan_t region_au_915_get_join_next_channel( smtc_real_t* real, uint8_t
             snapshot_channel_tx_mask[snapshot_bank_tx_mask] = channel_index_enabled[snapshot_bank_tx_mask];
         }
 
-        active_channel_nb = 0;
-        for( uint8_t i = snapshot_bank_tx_mask * 8; i < ( ( snapshot_bank_tx_mask * 8 ) + 8 ); i++ )
-        {
-            if( ( SMTC_GET_BIT8( snapshot_channel_tx_mask, i ) == CHANNEL_ENABLED ) &&
-                ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) )
-            {
-                active_channel_index[active_channel_nb] = i;
-                active_channel_nb++;
-            }
-        }
+        smtc_real_bitset_from_bytes( &active_channel, &snapshot_channel_tx_mask[snapshot_bank_tx_mask], 8 );
+        smtc_real_bitset_from_bytes( &enabled_channel, &channel_index_enabled[snapshot_bank_tx_mask], 8 );
+        smtc_real_bitset_and( &active_channel, &enabled_channel );
+        active_channel_nb = smtc_real_bitset_count( &active_channel );
+        bank_offset       = snapshot_bank_tx_mask * 8;
+
         snapshot_bank_tx_mask++;
         bank_tmp_cnt++;
     } while( ( active_channel_nb == 0 ) && ( bank_tmp_cnt < BANK_MAX_AU915 ) );
@@ -327,17 +329,16 @@ status_lorawan_t region_au_915_get_join_next_channel( smtc_real_t* real, uint8_t
         return ERRORLORAWAN;
     }
 
-    uint8_t temp        = 0xFF;
-    uint8_t channel_idx = 0;
-    if( snapshot_bank_tx_mask > BANK_8_500_AU915 )
+    uint8_t temp = 0;
+    if( snapshot_bank_tx_mask <= BANK_8_500_AU915 )
     {
-        // active_channel_index[0] contains the first available 500KHz channel
-        channel_idx = active_channel_index[0];
+        temp = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
     }
-    else
+    // the first available 500KHz channel is used, otherwise a random 125KHz channel of the bank
+    uint8_t channel_idx = smtc_real_bitset_get_nth( &active_channel, temp );
+    if( channel_idx != SMTC_REAL_BITSET_INVALID_INDEX )
     {
-        temp        = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
-        channel_idx = active_channel_index[temp];
+        channel_idx += bank_offset;
     }
 
     if( channel_idx >= NUMBER_OF_TX_CHANNEL_AU_915 )
@@ -414,25 +415,25 @@ status_lorawan_t region_au_915_get_next_channel( smtc_real_t* real, uint8_t tx_d
         region_au_915_init_after_join_snapshot_channel_mask( real, tx_data_rate, *out_tx_frequency );
     }
 
-    uint8_t active_channel_nb = 0;
-    uint8_t active_channel_index[NUMBER_OF_TX_CHANNEL_AU_915];
-    for( uint8_t i = 0; i < NUMBER_OF_TX_CHANNEL_AU_915; i++ )
-    {
-        if( ( SMTC_GET_BIT8( snapshot_channel_tx_mask, i ) == CHANNEL_ENABLED ) &&
-            ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) &&
-            ( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 ) )
-        {
-            active_channel_index[active_channel_nb] = i;
-            active_channel_nb++;
-        }
-    }
+    // Intersect the snapshot, the enabled channels and the channels supporting the datarate
+    smtc_real_bitset_t active_channel;
+    smtc_real_bitset_t enabled_channel;
+    smtc_real_bitset_from_bytes( &active_channel, snapshot_channel_tx_mask, NUMBER_OF_TX_CHANNEL_AU_915 );
+    smtc_real_bitset_from_bytes( &enabled_channel, channel_index_enabled, NUMBER_OF_TX_CHANNEL_AU_915 );
+    smtc_real_bitset_and( &active_channel, &enabled_channel );
+    smtc_real_bitset_and( &active_channel,
+                          smtc_real_bitset_dr_cache_get( &dr_channel_cache, dr_bitfield_tx_channel,
+                                                         NUMBER_OF_TX_CHANNEL_AU_915, tx_data_rate ) );
+
+    uint8_t active_channel_nb = smtc_real_bitset_count( &active_channel );
     if( active_channel_nb == 0 )
     {
         smtc_modem_hal_lr1mac_panic( "NO CHANNELS AVAILABLE\n" );
     }
 
+    // Select the n-th active channel
     uint8_t temp        = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
-    uint8_t channel_idx = active_channel_index[temp];
+    uint8_t channel_idx = smtc_real_bitset_get_nth( &active_channel, temp );
     if( channel_idx >= NUMBER_OF_TX_CHANNEL_AU_915 )
     {
         SMTC_MODEM_HAL_TRACE_PRINTF( "INVALID CHANNEL  active channel = %d and random channel = %d \n",
@@ -672,6 +673,8 @@ void region_au_915_enable_all_channels_with_valid_freq( smtc_real_t* real )
 
         dr_bitfield_tx_channel[i] = DEFAULT_TX_DR_500_BIT_FIELD_AU_915;
     }
+
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
 }
 
 modulation_type_t region_au_915_get_modulation_type_from_datarate( uint8_t datarate )
@@ -57,6 +57,7 @@
 #define unwrapped_channel_mask real->region.cn470.unwrapped_channel_mask
 #define activated_by_join_channel real->region.cn470.activated_by_join_channel
 #define activated_channel_plan real->region.cn470.activated_channel_plan
+#define dr_channel_cache real->region.cn470.dr_channel_cache
 
 /*
  * -----------------------------------------------------------------------------
@@ -154,6 +155,8 @@ void region_cn_470_init( smtc_real_t* real )
 
     // Enable all unwrapped channels
     memset1( &unwrapped_channel_mask[0], 0xFF, BANK_MAX_CN470 );
+
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
 }
 
 void region_cn_470_config( smtc_real_t* real )
@@ -186,6 +189,8 @@ void region_cn_470_config( smtc_real_t* real )
         }
 #endif
     }
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
+
 #if defined( HYBRID_CN470_MONO_CHANNEL )
     if( err == true )
     {
@@ -281,6 +286,8 @@ void region_cn_470_config_session( smtc_real_t* real )
         break;
     }
 
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
+
 #if defined( HYBRID_CN470_MONO_CHANNEL )
     if( err == true )
     {
@@ -293,31 +300,27 @@ status_lorawan_t region_cn_470_get_join_next_channel( smtc_real_t* real, uint8_t
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
                                                       uint32_t* out_rx2_frequency )
 {
-    uint8_t active_channel_nb = 0;
-    uint8_t active_channel_index[NUMBER_OF_TX_CHANNEL_CN_470];
-
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    // Only the channels of the common join table are candidates
+    uint8_t nb_join_channel = sizeof( common_join_channel_cn_470 ) / sizeof( common_join_channel_cn_470[0] );
+    if( nb_join_channel > real_const.const_number_of_tx_channel )
     {
-        // Channel must be enabled and frequency not 0
-        if( ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) &&
-            ( common_join_channel_cn_470[i][0] != 0 ) )
-        {
-            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 )
-            {
-                active_channel_index[active_channel_nb] = i;
-                active_channel_nb++;
-            }
-        }
+        nb_join_channel = real_const.const_number_of_tx_channel;
     }
 
+    smtc_real_bitset_t active_channel;
+    smtc_real_bitset_from_bytes( &active_channel, channel_index_enabled, nb_join_channel );
+    smtc_real_bitset_and( &active_channel,
+                          smtc_real_bitset_dr_cache_get( &dr_channel_cache, dr_bitfield_tx_channel,
+                                                         real_const.const_number_of_tx_channel, tx_data_rate ) );
+
+    uint8_t active_channel_nb = smtc_real_bitset_count( &active_channel );
     if( active_channel_nb == 0 )
     {
         SMTC_MODEM_HAL_TRACE_WARNING( "NO CHANNELS AVAILABLE \n" );
         return ERRORLORAWAN;
     }
     uint8_t temp        = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
-    uint8_t channel_idx = 0;
-    channel_idx         = active_channel_index[temp];
+    uint8_t channel_idx = smtc_real_bitset_get_nth( &active_channel, temp );
     if( channel_idx >= real_const.const_number_of_tx_channel )
     {
         SMTC_MODEM_HAL_TRACE_PRINTF( "INVALID CHANNEL  active channel = %d and random channel = %d \n",
@@ -339,29 +342,20 @@ status_lorawan_t region_cn_470_get_join_next_channel( smtc_real_t* real, uint8_t
 status_lorawan_t region_cn_470_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
                                                  uint32_t* out_rx1_frequency )
 {
-    uint8_t active_channel_nb = 0;
-    uint8_t active_channel_index[NUMBER_OF_TX_CHANNEL_CN_470];
-
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
-    {
-        if( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED )
-        {
-            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 )
-            {
-                active_channel_index[active_channel_nb] = i;
-                active_channel_nb++;
-            }
-        }
-    }
+    smtc_real_bitset_t active_channel;
+    smtc_real_bitset_from_bytes( &active_channel, channel_index_enabled, real_const.const_number_of_tx_channel );
+    smtc_real_bitset_and( &active_channel,
+                          smtc_real_bitset_dr_cache_get( &dr_channel_cache, dr_bitfield_tx_channel,
+                                                         real_const.const_number_of_tx_channel, tx_data_rate ) );
 
+    uint8_t active_channel_nb = smtc_real_bitset_count( &active_channel );
     if( active_channel_nb == 0 )
     {
         SMTC_MODEM_HAL_TRACE_WARNING( "NO CHANNELS AVAILABLE \n" );
         return ERRORLORAWAN;
     }
     uint8_t temp        = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
-    uint8_t channel_idx = 0;
-    channel_idx         = active_channel_index[temp];
+    uint8_t channel_idx = smtc_real_bitset_get_nth( &active_channel, temp );
     if( channel_idx >= real_const.const_number_of_tx_channel )
     {
         SMTC_MODEM_HAL_TRACE_PRINTF( "INVALID CHANNEL  active channel = %d and random channel = %d \n",
@@ -505,6 +499,8 @@ void region_cn_470_enable_all_channels_with_valid_freq( smtc_real_t* real )
         dr_bitfield_tx_channel[i] = DEFAULT_TX_DR_BIT_FIELD_CN_470;
     }
 #endif
+
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
 }
 
 modulation_type_t region_cn_470_get_modulation_type_from_datarate( uint8_t datarate )
@@ -48,6 +48,7 @@ extern "C" {
 #include <stdbool.h>
 
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_defs.h"
+#include "smtc_real_bitset.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -205,6 +206,7 @@ typedef struct region_cn470_context_s
     uint8_t                   unwrapped_channel_mask[BANK_MAX_CN470];
     uint8_t                   activated_by_join_channel;  // Channel used to join
     channel_plan_type_cn470_t activated_channel_plan;
+    smtc_real_bitset_dr_cache_t dr_channel_cache;  // Channels supporting the last requested datarate
 
 } region_cn470_context_t;
 
@@ -57,6 +57,7 @@
 #define unwrapped_channel_mask real->region.cn470_rp_1_0.unwrapped_channel_mask
 
 #define snapshot_bank_tx_mask real->region.cn470_rp_1_0.snapshot_bank_tx_mask
+#define dr_channel_cache real->region.cn470_rp_1_0.dr_channel_cache
 // Private region_cn_470_rp_1_0 utilities declaration
 //
 
@@ -149,6 +150,7 @@ void region_cn_470_rp_1_0_init( smtc_real_t* real )
     memset1( &unwrapped_channel_mask[0], 0xFF, BANK_MAX_CN470_RP_1_0 );
 
     snapshot_bank_tx_mask = BANK_0_125_CN470_RP_1_0;
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
 }
 
 void region_cn_470_rp_1_0_config( smtc_real_t* real )
@@ -165,6 +167,8 @@ void region_cn_470_rp_1_0_config( smtc_real_t* real )
                                      region_cn_470_rp_1_0_get_tx_frequency_channel( real, i ),
                                      dr_bitfield_tx_channel[i], ( ( i % 8 ) == 7 ) ? "---\n" : "" );
     }
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
+
 #if MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON
     // Rx 500 kHz channels
     for( uint8_t i = 0; i < real_const.const_number_of_rx_channel; i++ )
@@ -202,9 +206,15 @@ status_lorawan_t region_cn_470_rp_1_0_get_join_next_channel( smtc_real_t* real,
     return OKLORAWAN;
 #endif
 
+    smtc_real_bitset_t enabled_channel;
+    smtc_real_bitset_from_bytes( &enabled_channel, channel_index_enabled, real_const.const_number_of_tx_channel );
+    smtc_real_bitset_and( &enabled_channel,
+                          smtc_real_bitset_dr_cache_get( &dr_channel_cache, dr_bitfield_tx_channel,
+                                                         real_const.const_number_of_tx_channel, tx_data_rate ) );
+
     cn_470_rp_1_0_channels_bank_t bank_tmp_cnt = 0;
     uint8_t                       active_channel_nb;
-    uint8_t                       active_channel_index[NUMBER_OF_TX_CHANNEL_CN_470_RP_1_0];
+    smtc_real_bitset_t            active_channel;
     do
     {
         if( snapshot_bank_tx_mask >= BANK_MAX_CN470_RP_1_0 )
@@ -212,16 +222,13 @@ status_lorawan_t region_cn_470_rp_1_0_get_join_next_channel( smtc_real_t* real,
             snapshot_bank_tx_mask = BANK_0_125_CN470_RP_1_0;
         }
 
-        active_channel_nb = 0;
-        for( uint8_t i = snapshot_bank_tx_mask * 8; i < ( ( snapshot_bank_tx_mask * 8 ) + 8 ); i++ )
-        {
-            if( ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) &&
-                ( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 ) )
-            {
-                active_channel_index[active_channel_nb] = i;
-                active_channel_nb++;
-            }
-        }
+        // Keep only the 8 channels of the current bank
+        uint8_t bank_word = snapshot_bank_tx_mask / 4;
+        memset1( ( uint8_t* ) &active_channel, 0, sizeof( active_channel ) );
+        active_channel.word[bank_word] =
+            enabled_channel.word[bank_word] & ( ( uint32_t ) 0xFF << ( ( snapshot_bank_tx_mask % 4 ) * 8 ) );
+        active_channel_nb = smtc_real_bitset_count( &active_channel );
+
         snapshot_bank_tx_mask++;
         bank_tmp_cnt++;
     } while( ( active_channel_nb == 0 ) && ( bank_tmp_cnt < BANK_MAX_CN470_RP_1_0 ) );
@@ -232,11 +239,8 @@ status_lorawan_t region_cn_470_rp_1_0_get_join_next_channel( smtc_real_t* real,
         return ERRORLORAWAN;
     }
 
-    uint8_t temp        = 0xFF;
-    uint8_t channel_idx = 0;
-
-    temp        = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
-    channel_idx = active_channel_index[temp];
+    uint8_t temp        = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
+    uint8_t channel_idx = smtc_real_bitset_get_nth( &active_channel, temp );
 
     if( channel_idx >= real_const.const_number_of_tx_channel )
     {
@@ -276,29 +280,20 @@ status_lorawan_t region_cn_470_rp_1_0_get_next_channel( smtc_real_t* real, uint8
 
     return OKLORAWAN;
 #endif
-    uint8_t active_channel_nb = 0;
-    uint8_t active_channel_index[NUMBER_OF_TX_CHANNEL_CN_470_RP_1_0];
-
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
-    {
-        if( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED )
-        {
-            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 )
-            {
-                active_channel_index[active_channel_nb] = i;
-                active_channel_nb++;
-            }
-        }
-    }
+    smtc_real_bitset_t active_channel;
+    smtc_real_bitset_from_bytes( &active_channel, channel_index_enabled, real_const.const_number_of_tx_channel );
+    smtc_real_bitset_and( &active_channel,
+                          smtc_real_bitset_dr_cache_get( &dr_channel_cache, dr_bitfield_tx_channel,
+                                                         real_const.const_number_of_tx_channel, tx_data_rate ) );
 
+    uint8_t active_channel_nb = smtc_real_bitset_count( &active_channel );
     if( active_channel_nb == 0 )
     {
         SMTC_MODEM_HAL_TRACE_WARNING( "NO CHANNELS AVAILABLE \n" );
         return ERRORLORAWAN;
     }
     uint8_t temp        = ( smtc_modem_hal_get_random_nb_in_range( 0, ( active_channel_nb - 1 ) ) ) % active_channel_nb;
-    uint8_t channel_idx = 0;
-    channel_idx         = active_channel_index[temp];
+    uint8_t channel_idx = smtc_real_bitset_get_nth( &active_channel, temp );
     if( channel_idx >= real_const.const_number_of_tx_channel )
     {
         SMTC_MODEM_HAL_TRACE_PRINTF( "INVALID CHANNEL  active channel = %d and random channel = %d \n",
@@ -378,6 +373,8 @@ void region_cn_470_rp_1_0_enable_all_channels_with_valid_freq( smtc_real_t* real
         SMTC_PUT_BIT8( channel_index_enabled, i, CHANNEL_ENABLED );
         dr_bitfield_tx_channel[i] = DEFAULT_TX_DR_BIT_FIELD_CN_470_RP_1_0;
     }
+
+    smtc_real_bitset_dr_cache_invalidate( &dr_channel_cache );
 }
 
 modulation_type_t region_cn_470_rp_1_0_get_modulation_type_from_datarate( uint8_t datarate )
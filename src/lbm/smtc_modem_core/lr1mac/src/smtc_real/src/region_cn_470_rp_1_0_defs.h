@@ -48,6 +48,7 @@ extern "C" {
 #include <stdbool.h>
 
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_defs.h"
+#include "smtc_real_bitset.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -253,6 +254,7 @@ typedef struct region_cn470_rp_1_0_context_s
     uint8_t  unwrapped_channel_mask[BANK_MAX_CN470_RP_1_0];
 
     cn_470_rp_1_0_channels_bank_t snapshot_bank_tx_mask;
+    smtc_real_bitset_dr_cache_t dr_channel_cache;  // Channels supporting the last requested datarate
 } region_cn470_rp_1_0_context_t;
 
 /*
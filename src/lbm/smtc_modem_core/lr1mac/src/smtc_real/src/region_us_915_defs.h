@@ -48,6 +48,7 @@ extern "C" {
 #include <stdbool.h>
 
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_defs.h"
+#include "smtc_real_bitset.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -161,6 +162,7 @@ typedef struct region_us915_context_s
     uint8_t  first_ch_mask_received;
 
     us_915_channels_bank_t snapshot_bank_tx_mask;
+    smtc_real_bitset_dr_cache_t dr_channel_cache;  // Channels supporting the last requested datarate
 
 } region_us915_context_t;
 
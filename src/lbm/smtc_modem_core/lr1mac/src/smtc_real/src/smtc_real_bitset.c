@@ -0,0 +1,154 @@
+/**
+ * \file      smtc_real_bitset.c
+ *
+ * \brief     Word based channel bitset used by large channel plan regions
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include "smtc_real_bitset.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define SMTC_REAL_BITSET_POPCOUNT( x ) ( ( uint8_t ) __builtin_popcount( x ) )
+#define SMTC_REAL_BITSET_CTZ( x ) ( ( uint8_t ) __builtin_ctz( x ) )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_real_bitset_from_bytes( smtc_real_bitset_t* bitset, const uint8_t* bytes, uint8_t nb_channel )
+{
+    if( nb_channel > SMTC_REAL_BITSET_MAX_CHANNEL )
+    {
+        nb_channel = SMTC_REAL_BITSET_MAX_CHANNEL;
+    }
+
+    for( uint8_t i = 0; i < SMTC_REAL_BITSET_NB_WORDS; i++ )
+    {
+        bitset->word[i] = 0;
+    }
+    for( uint8_t i = 0; i < ( ( nb_channel + 7 ) / 8 ); i++ )
+    {
+        bitset->word[i / 4] |= ( uint32_t ) bytes[i] << ( ( i % 4 ) * 8 );
+    }
+
+    // Clear the bits above the last channel of a partial word
+    if( ( nb_channel % 32 ) != 0 )
+    {
+        bitset->word[nb_channel / 32] &= ( ( uint32_t ) 1 << ( nb_channel % 32 ) ) - 1;
+    }
+}
+
+void smtc_real_bitset_and( smtc_real_bitset_t* bitset, const smtc_real_bitset_t* other )
+{
+    for( uint8_t i = 0; i < SMTC_REAL_BITSET_NB_WORDS; i++ )
+    {
+        bitset->word[i] &= other->word[i];
+    }
+}
+
+uint8_t smtc_real_bitset_count( const smtc_real_bitset_t* bitset )
+{
+    uint8_t count = 0;
+    for( uint8_t i = 0; i < SMTC_REAL_BITSET_NB_WORDS; i++ )
+    {
+        count += SMTC_REAL_BITSET_POPCOUNT( bitset->word[i] );
+    }
+    return count;
+}
+
+uint8_t smtc_real_bitset_get_nth( const smtc_real_bitset_t* bitset, uint8_t n )
+{
+    for( uint8_t i = 0; i < SMTC_REAL_BITSET_NB_WORDS; i++ )
+    {
+        uint32_t word  = bitset->word[i];
+        uint8_t  count = SMTC_REAL_BITSET_POPCOUNT( word );
+        if( n >= count )
+        {
+            n -= count;
+            continue;
+        }
+
+        // Skip the whole bytes before the n-th bit, then the remaining lower bits of its byte
+        uint8_t index = i * 32;
+        count         = SMTC_REAL_BITSET_POPCOUNT( word & 0xFF );
+        while( n >= count )
+        {
+            n -= count;
+            word >>= 8;
+            index += 8;
+            count = SMTC_REAL_BITSET_POPCOUNT( word & 0xFF );
+        }
+        for( ; n > 0; n-- )
+        {
+            word &= word - 1;
+        }
+        return index + SMTC_REAL_BITSET_CTZ( word );
+    }
+    return SMTC_REAL_BITSET_INVALID_INDEX;
+}
+
+void smtc_real_bitset_dr_cache_invalidate( smtc_real_bitset_dr_cache_t* cache )
+{
+    cache->dr = SMTC_REAL_BITSET_INVALID_INDEX;
+}
+
+const smtc_real_bitset_t* smtc_real_bitset_dr_cache_get( smtc_real_bitset_dr_cache_t* cache,
+                                                         const uint16_t* dr_bitfield, uint8_t nb_channel, uint8_t dr )
+{
+    if( cache->dr != dr )
+    {
+        if( nb_channel > SMTC_REAL_BITSET_MAX_CHANNEL )
+        {
+            nb_channel = SMTC_REAL_BITSET_MAX_CHANNEL;
+        }
+        for( uint8_t i = 0; i < SMTC_REAL_BITSET_NB_WORDS; i++ )
+        {
+            cache->mask.word[i] = 0;
+        }
+        for( uint8_t i = 0; i < nb_channel; i++ )
+        {
+            cache->mask.word[i / 32] |= ( uint32_t ) ( ( dr_bitfield[i] >> dr ) & 0x01 ) << ( i % 32 );
+        }
+        cache->dr = dr;
+    }
+    return &cache->mask;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
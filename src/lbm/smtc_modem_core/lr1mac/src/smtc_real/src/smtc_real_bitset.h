@@ -0,0 +1,156 @@
+/**
+ * \file      smtc_real_bitset.h
+ *
+ * \brief     Word based channel bitset used by large channel plan regions
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SMTC_REAL_BITSET_H
+#define SMTC_REAL_BITSET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/**
+ * @brief Number of 32 bits words of a channel bitset, enough for the 96 channels of the largest channel plan
+ */
+#define SMTC_REAL_BITSET_NB_WORDS ( 3 )
+/**
+ * @brief Maximum number of channels of a channel bitset
+ */
+#define SMTC_REAL_BITSET_MAX_CHANNEL ( SMTC_REAL_BITSET_NB_WORDS * 32 )
+/**
+ * @brief Returned channel index when no channel is found in the bitset
+ */
+#define SMTC_REAL_BITSET_INVALID_INDEX ( 0xFF )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Channel bitset, bit i of word i / 32 is channel i
+ */
+typedef struct smtc_real_bitset_s
+{
+    uint32_t word[SMTC_REAL_BITSET_NB_WORDS];
+} smtc_real_bitset_t;
+
+/**
+ * @brief Cache of the channels supporting a datarate
+ * @remark the region datarate bitfields only change when the channel plan is configured, the cache must be
+ * invalidated each time they are written
+ */
+typedef struct smtc_real_bitset_dr_cache_s
+{
+    smtc_real_bitset_t mask;  //!< channels supporting the cached datarate
+    uint8_t            dr;    //!< cached datarate, SMTC_REAL_BITSET_INVALID_INDEX when the cache is empty
+} smtc_real_bitset_dr_cache_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Build a channel bitset from a region byte bank mask
+ *
+ * @param [out] bitset    Channel bitset
+ * @param [in] bytes      Byte bank mask, bit i % 8 of byte i / 8 is channel i
+ * @param [in] nb_channel Number of channels in the mask, bits above are cleared
+ */
+void smtc_real_bitset_from_bytes( smtc_real_bitset_t* bitset, const uint8_t* bytes, uint8_t nb_channel );
+
+/**
+ * @brief Intersect two channel bitsets
+ *
+ * @param [in,out] bitset Channel bitset, keeps only the channels also set in other
+ * @param [in] other      Channel bitset
+ */
+void smtc_real_bitset_and( smtc_real_bitset_t* bitset, const smtc_real_bitset_t* other );
+
+/**
+ * @brief Count the channels set in a bitset
+ *
+ * @param [in] bitset Channel bitset
+ * @return uint8_t    Number of channels set
+ */
+uint8_t smtc_real_bitset_count( const smtc_real_bitset_t* bitset );
+
+/**
+ * @brief Get the index of the n-th channel set in a bitset
+ *
+ * @param [in] bitset Channel bitset
+ * @param [in] n      Rank of the channel, starting at 0
+ * @return uint8_t    Channel index, SMTC_REAL_BITSET_INVALID_INDEX if less than n + 1 channels are set
+ */
+uint8_t smtc_real_bitset_get_nth( const smtc_real_bitset_t* bitset, uint8_t n );
+
+/**
+ * @brief Invalidate a datarate cache
+ *
+ * @param [out] cache Datarate cache
+ */
+void smtc_real_bitset_dr_cache_invalidate( smtc_real_bitset_dr_cache_t* cache );
+
+/**
+ * @brief Get the channels supporting a datarate, the bitset is only rebuilt when the datarate changes
+ *
+ * @param [in,out] cache     Datarate cache
+ * @param [in] dr_bitfield   Region datarate bitfield of each channel
+ * @param [in] nb_channel    Number of channels of the region
+ * @param [in] dr            Datarate
+ * @return const smtc_real_bitset_t* Channels supporting the datarate
+ */
+const smtc_real_bitset_t* smtc_real_bitset_dr_cache_get( smtc_real_bitset_dr_cache_t* cache,
+                                                         const uint16_t* dr_bitfield, uint8_t nb_channel, uint8_t dr );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SMTC_REAL_BITSET_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -232,6 +232,8 @@ static smtc_modem_return_code_t smtc_modem_set_dm_status_with_rate( const uint8_
 
 static bool is_modem_connected( );
 
+static smtc_modem_energy_consumer_t energy_consumer_of_hook( uint8_t hook_id );
+
 static smtc_modem_return_code_t smtc_modem_send_empty_tx( uint8_t f_port, bool f_port_present, bool confirmed );
 
 static smtc_modem_return_code_t smtc_modem_send_tx( uint8_t f_port, bool confirmed, const uint8_t* payload,
@@ -449,6 +451,14 @@ smtc_modem_return_code_t smtc_modem_get_event( smtc_modem_event_t* event, uint8_
             break;
         }
 #endif  // SMTC_D2D
+        case SMTC_MODEM_EVENT_ENERGY_GOVERNOR:
+            event->event_data.energy_governor.level =
+                ( smtc_modem_energy_governor_level_t ) get_modem_event_status( event->event_type );
+            break;
+        case SMTC_MODEM_EVENT_RANGING:
+            event->event_data.ranging.status =
+                ( smtc_modem_event_ranging_status_t ) get_modem_event_status( event->event_type );
+            break;
         case SMTC_MODEM_EVENT_MIDDLEWARE_1:
         case SMTC_MODEM_EVENT_MIDDLEWARE_2:
         case SMTC_MODEM_EVENT_MIDDLEWARE_3:
@@ -821,6 +831,51 @@ smtc_modem_return_code_t smtc_modem_time_get_sync_invalid_delay_s( uint32_t* syn
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_time_get_drift( int32_t* drift_ppb, uint32_t* uncertainty_ppb )
+{
+#if defined( ADD_SMTC_ALC_SYNC )
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( drift_ppb );
+    RETURN_INVALID_IF_NULL( uncertainty_ppb );
+
+    smtc_modem_return_code_t return_code = SMTC_MODEM_RC_OK;
+
+    if( clock_sync_get_drift( &( smtc_modem_services_ctx.clock_sync_ctx ), drift_ppb, uncertainty_ppb ) == false )
+    {
+        return_code = SMTC_MODEM_RC_NO_TIME;
+    }
+
+    return return_code;
+#else   //  ADD_SMTC_ALC_SYNC
+    return SMTC_MODEM_RC_FAIL;
+#endif  //  ADD_SMTC_ALC_SYNC
+}
+
+smtc_modem_return_code_t smtc_modem_time_set_sync_max_error_ms( uint32_t max_error_ms )
+{
+#if defined( ADD_SMTC_ALC_SYNC )
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    clock_sync_set_max_time_error_ms( &( smtc_modem_services_ctx.clock_sync_ctx ), max_error_ms );
+    return SMTC_MODEM_RC_OK;
+#else   //  ADD_SMTC_ALC_SYNC
+    return SMTC_MODEM_RC_FAIL;
+#endif  //  ADD_SMTC_ALC_SYNC
+}
+
+smtc_modem_return_code_t smtc_modem_time_get_sync_max_error_ms( uint32_t* max_error_ms )
+{
+#if defined( ADD_SMTC_ALC_SYNC )
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( max_error_ms );
+
+    *max_error_ms = clock_sync_get_max_time_error_ms( &( smtc_modem_services_ctx.clock_sync_ctx ) );
+    return SMTC_MODEM_RC_OK;
+#else   //  ADD_SMTC_ALC_SYNC
+    return SMTC_MODEM_RC_FAIL;
+#endif  //  ADD_SMTC_ALC_SYNC
+}
+
 smtc_modem_return_code_t smtc_modem_get_status( uint8_t stack_id, smtc_modem_status_mask_t* status_mask )
 {
     UNUSED( stack_id );
@@ -1042,6 +1097,104 @@ smtc_modem_return_code_t smtc_modem_set_class( uint8_t stack_id, smtc_modem_clas
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_class_c_get_stats( uint8_t stack_id, smtc_modem_class_c_stats_t* stats )
+{
+    UNUSED( stack_id );
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( stats );
+
+    lr1mac_class_c_stats_t class_c_stats;
+    lorawan_api_class_c_get_stats( &class_c_stats );
+
+    stats->nb_rx_start      = class_c_stats.nb_rx_start;
+    stats->nb_rx_fast_start = class_c_stats.nb_rx_fast_start;
+    stats->deaf_time_ms     = class_c_stats.deaf_time_ms;
+    stats->deaf_time_max_ms = class_c_stats.deaf_time_max_ms;
+    stats->nb_rx_foreign    = class_c_stats.nb_rx_foreign;
+
+    // sessions not compiled in (no multicast) are reported as 0
+    _Static_assert( RX_SESSION_COUNT <= SMTC_MODEM_RX_SESSION_COUNT, "too many rx sessions for the modem statistics" );
+    memset( stats->nb_rx_accepted, 0, sizeof( stats->nb_rx_accepted ) );
+    memset( stats->nb_rx_rejected, 0, sizeof( stats->nb_rx_rejected ) );
+    for( uint8_t i = 0; i < RX_SESSION_COUNT; i++ )
+    {
+        stats->nb_rx_accepted[i] = class_c_stats.nb_rx_accepted[i];
+        stats->nb_rx_rejected[i] = class_c_stats.nb_rx_rejected[i];
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_get_energy_stats( smtc_modem_energy_consumer_t consumer,
+                                                      smtc_modem_energy_stats_t*   stats )
+{
+    RETURN_INVALID_IF_NULL( stats );
+    if( consumer >= SMTC_MODEM_ENERGY_CONSUMER_NUMBER )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    rp_energy_t energy;
+    uint64_t    charge_ua_ms[RP_ENERGY_CATEGORY_NUMBER] = { 0 };
+
+    rp_get_energy( &modem_radio_planner, &energy );
+
+    memset( stats, 0, sizeof( smtc_modem_energy_stats_t ) );
+    for( uint8_t hook_id = 0; hook_id < RP_NB_HOOKS; hook_id++ )
+    {
+        if( energy_consumer_of_hook( hook_id ) != consumer )
+        {
+            continue;
+        }
+        stats->tx_time_ms += energy.time_ms[hook_id][RP_ENERGY_TX];
+        stats->rx_time_ms += energy.time_ms[hook_id][RP_ENERGY_RX];
+        for( uint8_t i = 0; i < RP_ENERGY_CATEGORY_NUMBER; i++ )
+        {
+            charge_ua_ms[i] += energy.charge_ua_ms[hook_id][i];
+        }
+    }
+
+    // 1 uAh is 3600000 uA.ms
+    stats->tx_charge_uah   = ( uint32_t ) ( charge_ua_ms[RP_ENERGY_TX] / 3600000 );
+    stats->rx_charge_uah   = ( uint32_t ) ( charge_ua_ms[RP_ENERGY_RX] / 3600000 );
+    stats->scan_charge_uah = ( uint32_t ) ( charge_ua_ms[RP_ENERGY_SCAN] / 3600000 );
+    stats->cpu_charge_uah  = ( uint32_t ) ( charge_ua_ms[RP_ENERGY_CPU] / 3600000 );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_reset_energy_stats( void )
+{
+    rp_reset_energy( &modem_radio_planner );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_set_energy_budget( uint32_t budget_uah, uint32_t period_s )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    modem_context_set_energy_budget( budget_uah, period_s );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_get_energy_governor_status( smtc_modem_energy_governor_status_t* status )
+{
+    RETURN_INVALID_IF_NULL( status );
+
+    energy_governor_t eg;
+    modem_context_get_energy_governor( &eg );
+
+    // Activities are declared in the same order by the governor
+    status->level         = ( smtc_modem_energy_governor_level_t ) energy_governor_get_level( &eg );
+    status->budget_uah    = eg.budget_uah;
+    status->period_s      = eg.period_s;
+    status->period_left_s = eg.period_s - ( smtc_modem_hal_get_time_in_s( ) - eg.period_start_s );
+    status->remaining_uah = energy_governor_get_remaining_uah( &eg );
+    for( uint8_t i = 0; i < SMTC_MODEM_ENERGY_ACTIVITY_NUMBER; i++ )
+    {
+        status->spent_uah[i] = energy_governor_get_spent_uah( &eg, ( energy_governor_activity_t ) i );
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_multicast_set_grp_config( uint8_t stack_id, smtc_modem_mc_grp_id_t mc_grp_id,
                                                               uint32_t      mc_grp_addr,
                                                               const uint8_t mc_nwk_skey[SMTC_MODEM_KEY_LENGTH],
@@ -1585,6 +1738,14 @@ smtc_modem_return_code_t smtc_modem_dm_set_info_fields( const uint8_t* dm_fields
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_dm_set_info_changes_only( bool enable, uint8_t full_refresh_period )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    modem_context_set_dm_changes_only( enable, full_refresh_period );
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_dm_request_single_uplink( const uint8_t* dm_fields_payload,
                                                               uint8_t        dm_field_length )
 {
@@ -1667,6 +1828,32 @@ smtc_modem_return_code_t smtc_modem_leave_network( uint8_t stack_id )
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_get_join_stats( uint8_t stack_id, uint8_t datarate, uint16_t* nb_attempts,
+                                                    uint16_t* nb_accepts )
+{
+    UNUSED( stack_id );
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( nb_attempts );
+    RETURN_INVALID_IF_NULL( nb_accepts );
+
+    if( lorawan_api_join_stats_get( datarate, nb_attempts, nb_accepts ) != OKLORAWAN )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "%s call but datarate %d is not valid\n", __func__, datarate );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_get_join_nb_failed( uint8_t stack_id, uint16_t* nb_failed )
+{
+    UNUSED( stack_id );
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( nb_failed );
+
+    *nb_failed = lorawan_api_join_nb_failed_get( );
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_suspend_radio_communications( bool suspend )
 {
     RETURN_BUSY_IF_TEST_MODE( );
@@ -2241,6 +2428,56 @@ smtc_modem_return_code_t smtc_modem_rp_abort_user_radio_access_task( uint8_t use
 #endif  // !LR1110_MODEM_E
 }
 
+smtc_modem_return_code_t smtc_modem_rp_add_user_radio_access_charge( uint8_t user_task_id, uint32_t scan_charge_uah,
+                                                                     uint32_t cpu_charge_uah )
+{
+#if !defined( LR1110_MODEM_E )
+    uint8_t hook_id;
+    switch( user_task_id )
+    {
+    case SMTC_MODEM_RP_TASK_ID0:
+        hook_id = RP_HOOK_ID_USER_SUSPEND_0;
+        break;
+    case SMTC_MODEM_RP_TASK_ID1:
+        hook_id = RP_HOOK_ID_USER_SUSPEND_1;
+        break;
+    case SMTC_MODEM_RP_TASK_ID2:
+        hook_id = RP_HOOK_ID_USER_SUSPEND_2;
+        break;
+    default:
+        return SMTC_MODEM_RC_INVALID;
+        break;
+    }
+    rp_energy_add_charge( &modem_radio_planner, hook_id, RP_ENERGY_SCAN, scan_charge_uah );
+    rp_energy_add_charge( &modem_radio_planner, hook_id, RP_ENERGY_CPU, cpu_charge_uah );
+    return SMTC_MODEM_RC_OK;
+#else   // !LR1110_MODEM_E
+    return SMTC_MODEM_RC_FAIL;
+#endif  // !LR1110_MODEM_E
+}
+
+smtc_modem_return_code_t smtc_modem_energy_governor_add_scan_charge( smtc_modem_energy_activity_t activity,
+                                                                     uint32_t                     charge_uah )
+{
+    if( ( activity != SMTC_MODEM_ENERGY_ACTIVITY_GNSS ) && ( activity != SMTC_MODEM_ENERGY_ACTIVITY_WIFI ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    modem_context_energy_governor_add_charge( ( energy_governor_activity_t ) activity, charge_uah );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_energy_governor_get_scan_delay( uint32_t delay_s, uint32_t* governed_delay_s )
+{
+    RETURN_INVALID_IF_NULL( governed_delay_s );
+
+    energy_governor_t eg;
+    modem_context_get_energy_governor( &eg );
+
+    *governed_delay_s = energy_governor_get_scan_delay_s( &eg, delay_s, smtc_modem_hal_get_time_in_s( ) );
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_rp_add_user_radio_access_task( smtc_modem_rp_task_t* rp_task )
 {
 #if !defined( LR1110_MODEM_E )
@@ -2451,6 +2688,40 @@ smtc_modem_return_code_t smtc_modem_get_nb_trans( uint8_t stack_id, uint8_t* nb_
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_set_lr_fhss_dr_policy( uint8_t stack_id, bool enabled )
+{
+    UNUSED( stack_id );
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    lorawan_api_lr_fhss_dr_policy_set( enabled );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_get_lr_fhss_dr_policy( uint8_t stack_id, bool* enabled )
+{
+    UNUSED( stack_id );
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( enabled );
+
+    *enabled = lorawan_api_lr_fhss_dr_policy_get( );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_get_lr_fhss_delivery_rate( uint8_t stack_id, uint8_t datarate,
+                                                               uint8_t* delivery_rate, uint8_t* nb_tracked )
+{
+    UNUSED( stack_id );
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( delivery_rate );
+    RETURN_INVALID_IF_NULL( nb_tracked );
+
+    if( lorawan_api_lr_fhss_delivery_rate_get( datarate, delivery_rate, nb_tracked ) != OKLORAWAN )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_set_crystal_error_ppm( uint32_t crystal_error_ppm )
 {
     RETURN_BUSY_IF_TEST_MODE( );
@@ -2530,6 +2801,26 @@ smtc_modem_return_code_t smtc_modem_class_b_get_ping_slot_periodicity(
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_class_b_get_drift_stats( uint8_t                           stack_id,
+                                                             smtc_modem_class_b_drift_stats_t* drift_stats )
+{
+    UNUSED( stack_id );
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( drift_stats );
+
+    smtc_beacon_drift_stats_t stats;
+    lorawan_api_beacon_get_drift_stats( &stats );
+
+    drift_stats->drift_ppb          = stats.drift_ppb;
+    drift_stats->uncertainty_ppb    = stats.uncertainty_ppb;
+    drift_stats->nb_samples         = stats.nb_samples;
+    drift_stats->is_valid           = stats.is_valid;
+    drift_stats->crystal_error_ppm  = stats.crystal_error_ppm;
+    drift_stats->nb_rx_windows      = stats.nb_rx_windows;
+    drift_stats->rx_window_saved_ms = stats.rx_window_saved_ms;
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_d2d_class_b_request_uplink( uint8_t stack_id, smtc_modem_mc_grp_id_t mc_grp_id,
                                                                 smtc_modem_d2d_class_b_uplink_config_t* d2d_config,
                                                                 uint8_t fport, const uint8_t* payload,
@@ -2992,6 +3283,35 @@ static bool is_modem_connected( )
     return ( ret );
 }
 
+static smtc_modem_energy_consumer_t energy_consumer_of_hook( uint8_t hook_id )
+{
+    switch( hook_id )
+    {
+    case RP_HOOK_ID_CLASS_B_BEACON:
+#if defined( SMTC_D2D )
+    case RP_HOOK_ID_CLASS_B_D2D:
+#endif  // SMTC_D2D
+    case RP_HOOK_ID_CLASS_B_PING_SLOT:
+        return SMTC_MODEM_ENERGY_CLASS_B;
+    case RP_HOOK_ID_CLASS_C:
+        return SMTC_MODEM_ENERGY_CLASS_C;
+#if !defined( LR1110_MODEM_E )
+    case RP_HOOK_ID_USER_SUSPEND_0:
+        return SMTC_MODEM_ENERGY_USER_TASK_0;
+    case RP_HOOK_ID_USER_SUSPEND_1:
+        return SMTC_MODEM_ENERGY_USER_TASK_1;
+    case RP_HOOK_ID_USER_SUSPEND_2:
+        return SMTC_MODEM_ENERGY_USER_TASK_2;
+#endif  // !LR1110_MODEM_E
+#if defined( LR11XX_TRANSCEIVER )
+    case RP_HOOK_ID_RANGING:
+        return SMTC_MODEM_ENERGY_RANGING;
+#endif  // LR11XX_TRANSCEIVER
+    default:
+        return SMTC_MODEM_ENERGY_MODEM;
+    }
+}
+
 static smtc_modem_return_code_t smtc_modem_send_empty_tx( uint8_t f_port, bool f_port_present, bool confirmed )
 {
     smtc_modem_return_code_t return_code = SMTC_MODEM_RC_OK;
@@ -0,0 +1,646 @@
+/*!
+ * \file      smtc_modem_ranging.c
+ *
+ * \brief     device to device ranging service of the LR11XX
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // memset
+
+#if defined( LR11XX_TRANSCEIVER )
+
+#include "lbm/smtc_modem_api/smtc_basic_modem_lr11xx_api_extension.h"
+#include "lbm/smtc_modem_api/smtc_modem_api.h"
+
+#include "lbm/smtc_modem_core/modem_config/smtc_modem_hal_dbg_trace.h"
+#include "lbm/smtc_modem_core/radio_planner/src/radio_planner.h"
+#include "lbm/smtc_modem_core/device_management/modem_context.h"
+#include "lbm/smtc_modem_core/lorawan_api/lorawan_api.h"
+#include "lbm/smtc_modem_core/lr1mac/src/lr1mac_utilities.h"
+#include "lbm/smtc_modem_core/lr1mac/src/services/smtc_duty_cycle.h"
+#include "lbm/smtc_modem_core/lr1mac/src/smtc_real/src/smtc_real.h"
+#include "lbm/smtc_modem_core/modem_services/ranging_filter.h"
+#include "lbm/smtc_modem_hal/smtc_modem_hal.h"
+
+#include "lbm/smtc_modem_core/smtc_ralf/src/ralf.h"
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_radio.h"
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_ranging.h"
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_system.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define MODEM_RANGING_SF_MIN ( 5 )
+#define MODEM_RANGING_SF_MAX ( 12 )
+#define MODEM_RANGING_NB_SF ( MODEM_RANGING_SF_MAX - MODEM_RANGING_SF_MIN + 1 )
+#define MODEM_RANGING_RESPONSE_NB_SYMBOLS ( 15 )  // Recommended by the driver, balances accuracy and consumption
+#define MODEM_RANGING_PREAMBLE_LENGTH ( 12 )
+#define MODEM_RANGING_REQUEST_LENGTH ( 10 )
+#define MODEM_RANGING_SYNC_WORD ( 0x12 )  // Private network, gateways do not demodulate the exchanges
+#define MODEM_RANGING_EXCHANGE_MARGIN_MS ( 10 )
+#define MODEM_RANGING_DEFAULT_ADDRESS ( 0x00000019 )  // Transceiver reset value
+#define MODEM_RANGING_DEFER_MIN_MS ( SMTC_DTC_SECONDS_BY_UNIT * 1000 )  // Duty cycle history resolution
+#define MODEM_RANGING_DEFER_DURATION_MS ( 1 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+/* clang-format off */
+/*!
+ * \brief   Conversion table for BandWidth
+ */
+static const ral_lora_bw_t modem_ranging_bw_convert[SMTC_MODEM_RANGING_BW_COUNT] = {
+    [SMTC_MODEM_RANGING_BW_125_KHZ] = RAL_LORA_BW_125_KHZ,
+    [SMTC_MODEM_RANGING_BW_250_KHZ] = RAL_LORA_BW_250_KHZ,
+    [SMTC_MODEM_RANGING_BW_500_KHZ] = RAL_LORA_BW_500_KHZ,
+};
+
+/*!
+ * \brief   Conversion table for BandWidth, driver values used by the calibration and the distance conversion
+ */
+static const lr11xx_radio_lora_bw_t modem_ranging_lr11xx_bw_convert[SMTC_MODEM_RANGING_BW_COUNT] = {
+    [SMTC_MODEM_RANGING_BW_125_KHZ] = LR11XX_RADIO_LORA_BW_125,
+    [SMTC_MODEM_RANGING_BW_250_KHZ] = LR11XX_RADIO_LORA_BW_250,
+    [SMTC_MODEM_RANGING_BW_500_KHZ] = LR11XX_RADIO_LORA_BW_500,
+};
+/* clang-format on */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*!
+ * \typedef modem_ranging_t
+ * \brief   Ranging session context
+ */
+typedef struct modem_ranging_s
+{
+    radio_planner_t*            rp;
+    lr1_stack_mac_t*            lr1_mac;        //!< Region and duty cycle shared with the LoRaWAN stack
+    bool                        running;
+    bool                        deferred;       //!< The task enqueued only waits for the duty cycle
+    smtc_modem_ranging_params_t params;
+    smtc_modem_ranging_role_t   role;           //!< Role of the round in progress
+    uint16_t                    round;
+    uint32_t                    packet_toa_ms;  //!< Time on air of a request, a response has the same
+    uint32_t                    exchange_ms;    //!< Longest duration of an exchange
+    uint32_t                    window_end_ms;  //!< End of the listening window of a subordinate round
+    uint32_t                    address;        //!< Answered in subordinate role
+    uint8_t                     check_length;
+    ranging_filter_t            filter;         //!< Exchanges of a manager round
+    uint8_t                     nb_responses;   //!< Requests answered in a subordinate round
+    uint8_t                     nb_discarded;   //!< Requests to another address in a subordinate round
+    bool                        result_valid;
+    smtc_modem_ranging_result_t result;         //!< Last finished round
+    uint32_t calibration[SMTC_MODEM_RANGING_BW_COUNT][MODEM_RANGING_NB_SF];  //!< 0 for the recommended value
+} modem_ranging_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static modem_ranging_t modem_ranging = {
+    .address      = MODEM_RANGING_DEFAULT_ADDRESS,
+    .check_length = 4,
+};
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief   Callback of the ranging hook, accounts the exchange and runs the next one
+ * \retval [in]    context*                   - modem_ranging_t
+ */
+static void modem_ranging_rp_callback( void* context );
+
+/*!
+ * \brief   Callback to start an exchange by Radio Planner
+ * \retval [in]    rp_void*                   - radio planner context
+ */
+static void modem_ranging_launch_callback_for_rp( void* rp_void );
+
+/*!
+ * \brief   Fill the LoRa parameters of the session
+ */
+static void modem_ranging_set_lora_params( ralf_params_lora_t* lora_param );
+
+/*!
+ * \brief   Delay indicator of the session spreading factor and bandwidth, calibrated or recommended
+ */
+static uint32_t modem_ranging_get_delay_indicator( void );
+
+/*!
+ * \brief   Enqueue the next exchange of the round, or finish the round
+ */
+static void modem_ranging_next( void );
+
+/*!
+ * \brief   Enqueue an exchange, lasting up to timeout_ms
+ */
+static void modem_ranging_enqueue( uint32_t timeout_ms );
+
+/*!
+ * \brief   Report the round, then start the next one if any
+ */
+static void modem_ranging_end_round( void );
+
+/*!
+ * \brief   Reset the round statistics and enqueue its first exchange, or wait until the band duty cycle allows it
+ */
+static void modem_ranging_start_round( void );
+
+/*!
+ * \brief   Enqueue a task which does not use the radio, its end checks the duty cycle again
+ */
+static void modem_ranging_defer( uint32_t delay_ms );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+smtc_modem_return_code_t smtc_modem_ranging_set_address( uint32_t address, uint8_t check_length )
+{
+    if( ( check_length < 1 ) || ( check_length > 4 ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    modem_ranging.address      = address;
+    modem_ranging.check_length = check_length;
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_ranging_set_calibration( uint8_t sf, smtc_modem_ranging_bw_t bw,
+                                                             uint32_t delay_indicator )
+{
+    if( ( sf < MODEM_RANGING_SF_MIN ) || ( sf > MODEM_RANGING_SF_MAX ) || ( bw >= SMTC_MODEM_RANGING_BW_COUNT ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    modem_ranging.calibration[bw][sf - MODEM_RANGING_SF_MIN] = delay_indicator;
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_ranging_start( const smtc_modem_ranging_params_t* params )
+{
+    uint32_t delay_indicator;
+
+    if( params == NULL )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( ( modem_get_test_mode_status( ) == true ) || ( modem_ranging.running == true ) )
+    {
+        return SMTC_MODEM_RC_BUSY;
+    }
+    if( ( params->sf < MODEM_RANGING_SF_MIN ) || ( params->sf > MODEM_RANGING_SF_MAX ) ||
+        ( params->bw >= SMTC_MODEM_RANGING_BW_COUNT ) || ( params->nb_exchanges == 0 ) ||
+        ( params->nb_exchanges > SMTC_MODEM_RANGING_MAX_EXCHANGES ) || ( params->nb_rounds == 0 ) ||
+        ( params->first_role > SMTC_MODEM_RANGING_ROLE_SUBORDINATE ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( lr11xx_ranging_get_recommended_rx_tx_delay_indicator( modem_ranging_lr11xx_bw_convert[params->bw],
+                                                              ( lr11xx_radio_lora_sf_t ) params->sf,
+                                                              &delay_indicator ) != LR11XX_STATUS_OK )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    // The exchanges follow the regional rules of the LoRaWAN stack
+    lr1_stack_mac_t* lr1_mac = lorawan_api_stack_mac_get( );
+    if( smtc_real_is_frequency_valid( lr1_mac->real, params->rf_freq_in_hz ) != OKLORAWAN )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    modem_ranging.rp           = modem_context_get_modem_rp( );
+    modem_ranging.lr1_mac      = lr1_mac;
+    modem_ranging.params       = *params;
+    modem_ranging.role         = params->first_role;
+    modem_ranging.round        = 0;
+    modem_ranging.deferred     = false;
+    modem_ranging.result_valid = false;
+
+    // The request and the response have the same length
+    ralf_params_lora_t lora_param;
+    modem_ranging_set_lora_params( &lora_param );
+    modem_ranging.packet_toa_ms = ral_get_lora_time_on_air_in_ms( &( modem_ranging.rp->radio->ral ),
+                                                                  &lora_param.pkt_params, &lora_param.mod_params );
+    modem_ranging.exchange_ms = ( 2 * modem_ranging.packet_toa_ms ) + MODEM_RANGING_EXCHANGE_MARGIN_MS;
+
+    // A round which does not fit in the band budget would wait forever
+    if( ( params->nb_exchanges * modem_ranging.packet_toa_ms ) >
+        smtc_duty_cycle_get_band_budget_ms( lr1_mac->dtc_obj, params->rf_freq_in_hz ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    rp_release_hook( modem_ranging.rp, RP_HOOK_ID_RANGING );
+    rp_hook_init( modem_ranging.rp, RP_HOOK_ID_RANGING, modem_ranging_rp_callback, &modem_ranging );
+
+    SMTC_MODEM_HAL_TRACE_INFO( "Ranging start, exchange %u ms\n", modem_ranging.exchange_ms );
+    modem_ranging.running = true;
+    modem_ranging_start_round( );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_ranging_stop( void )
+{
+    if( modem_ranging.running == true )
+    {
+        modem_ranging.running = false;
+        rp_task_abort( modem_ranging.rp, RP_HOOK_ID_RANGING );
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_ranging_get_result( bool* running, smtc_modem_ranging_result_t* result )
+{
+    if( ( running == NULL ) || ( result == NULL ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    *running = modem_ranging.running;
+    if( modem_ranging.result_valid == false )
+    {
+        return SMTC_MODEM_RC_FAIL;
+    }
+    *result = modem_ranging.result;
+    return SMTC_MODEM_RC_OK;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void modem_ranging_rp_callback( void* context )
+{
+    modem_ranging_t*         ranging = ( modem_ranging_t* ) context;
+    const ral_t*             ral     = &( ranging->rp->radio->ral );
+    lr11xx_system_irq_mask_t irq     = LR11XX_SYSTEM_IRQ_NONE;
+    int32_t                  distance_m;
+    int16_t                  rssi_dbm;
+    uint32_t                 irq_timestamp_ms;
+    rp_status_t              rp_status;
+
+    rp_get_status( ranging->rp, RP_HOOK_ID_RANGING, &irq_timestamp_ms, &rp_status );
+
+    // Nothing ran on the radio, the duty cycle of the round is checked again
+    if( ranging->deferred == true )
+    {
+        ranging->deferred = false;
+        if( ranging->running == true )
+        {
+            modem_ranging_start_round( );
+        }
+        return;
+    }
+
+    // Left awake by the radio planner unless the exchange was preempted, the results are read before sleeping
+    if( rp_status != RP_STATUS_TASK_ABORTED )
+    {
+        smtc_modem_hal_assert( lr11xx_system_get_and_clear_irq_status( ral->context, &irq ) == LR11XX_STATUS_OK );
+        if( ( irq & LR11XX_SYSTEM_IRQ_RANGING_EXCH_VALID ) != 0 )
+        {
+            uint8_t raw[LR11XX_RANGING_RESULT_LENGTH];
+
+            smtc_modem_hal_assert( lr11xx_ranging_get_raw_result( ral->context, LR11XX_RANGING_RESULT_TYPE_RAW, raw ) ==
+                                   LR11XX_STATUS_OK );
+            distance_m =
+                lr11xx_ranging_distance_raw_to_meter( modem_ranging_lr11xx_bw_convert[ranging->params.bw], raw );
+            smtc_modem_hal_assert( lr11xx_ranging_get_raw_result( ral->context, LR11XX_RANGING_RESULT_TYPE_RSSI,
+                                                                  raw ) == LR11XX_STATUS_OK );
+            rssi_dbm = -( int16_t )( raw[3] >> 1 );
+        }
+        smtc_modem_hal_assert( ral_set_standby( ral, RAL_STANDBY_CFG_RC ) == RAL_STATUS_OK );
+        smtc_modem_hal_assert( ral_set_sleep( ral, true ) == RAL_STATUS_OK );
+    }
+
+    if( ranging->running == false )
+    {
+        return;
+    }
+
+    // A preempted exchange is not accounted, it is run again. Each request or response sent is charged to the band
+    smtc_duty_cycle_update( ranging->lr1_mac->dtc_obj );
+    if( ( rp_status != RP_STATUS_TASK_ABORTED ) && ( ranging->role == SMTC_MODEM_RANGING_ROLE_MANAGER ) )
+    {
+        smtc_duty_cycle_sum( ranging->lr1_mac->dtc_obj, ranging->params.rf_freq_in_hz, ranging->packet_toa_ms );
+        if( ( irq & LR11XX_SYSTEM_IRQ_RANGING_EXCH_VALID ) != 0 )
+        {
+            ranging_filter_add_sample( &ranging->filter, distance_m, rssi_dbm );
+        }
+        else
+        {
+            ranging_filter_add_failure( &ranging->filter );
+        }
+    }
+    else if( rp_status != RP_STATUS_TASK_ABORTED )
+    {
+        if( ( irq & LR11XX_SYSTEM_IRQ_RANGING_RESP_DONE ) != 0 )
+        {
+            smtc_duty_cycle_sum( ranging->lr1_mac->dtc_obj, ranging->params.rf_freq_in_hz, ranging->packet_toa_ms );
+            if( ranging->nb_responses < UINT8_MAX )
+            {
+                ranging->nb_responses++;
+            }
+        }
+        if( ( ( irq & LR11XX_SYSTEM_IRQ_RANGING_REQ_DISCARDED ) != 0 ) && ( ranging->nb_discarded < UINT8_MAX ) )
+        {
+            ranging->nb_discarded++;
+        }
+    }
+    modem_ranging_next( );
+}
+
+static void modem_ranging_launch_callback_for_rp( void* rp_void )
+{
+    radio_planner_t*          rp         = ( radio_planner_t* ) rp_void;
+    uint8_t                   id         = rp->radio_task_id;
+    const ral_t*              ral        = &( rp->radio->ral );
+    const ralf_params_lora_t* lora_param = &( rp->radio_params[id].tx.lora );
+    lr11xx_system_irq_mask_t  irq_mask;
+
+    // Ended at once, the hook callback checks the duty cycle again
+    if( modem_ranging.deferred == true )
+    {
+        rp_radio_irq_callback( rp_void );
+        return;
+    }
+
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_assert( ralf_setup_lora( rp->radio, lora_param ) == RAL_STATUS_OK );
+
+    // The ranging packet type keeps the LoRa modulation, which is set again once the type is changed
+    smtc_modem_hal_assert( lr11xx_radio_set_pkt_type( ral->context, LR11XX_RADIO_PKT_TYPE_RANGING ) ==
+                           LR11XX_STATUS_OK );
+    smtc_modem_hal_assert( ral_set_lora_mod_params( ral, &lora_param->mod_params ) == RAL_STATUS_OK );
+    smtc_modem_hal_assert( ral_set_lora_pkt_params( ral, &lora_param->pkt_params ) == RAL_STATUS_OK );
+    smtc_modem_hal_assert( ral_set_lora_sync_word( ral, lora_param->sync_word ) == RAL_STATUS_OK );
+    smtc_modem_hal_assert( lr11xx_ranging_set_parameters( ral->context, MODEM_RANGING_RESPONSE_NB_SYMBOLS ) ==
+                           LR11XX_STATUS_OK );
+    smtc_modem_hal_assert( lr11xx_ranging_set_rx_tx_delay_indicator(
+                               ral->context, modem_ranging_get_delay_indicator( ) ) == LR11XX_STATUS_OK );
+    smtc_modem_hal_assert( lr11xx_system_clear_irq_status( ral->context, LR11XX_SYSTEM_IRQ_ALL_MASK ) ==
+                           LR11XX_STATUS_OK );
+
+    if( modem_ranging.role == SMTC_MODEM_RANGING_ROLE_MANAGER )
+    {
+        irq_mask = LR11XX_SYSTEM_IRQ_RANGING_EXCH_VALID | LR11XX_SYSTEM_IRQ_RANGING_TIMEOUT | LR11XX_SYSTEM_IRQ_TIMEOUT;
+        smtc_modem_hal_assert( lr11xx_ranging_set_request_address( ral->context, modem_ranging.params.peer_address ) ==
+                               LR11XX_STATUS_OK );
+        smtc_modem_hal_assert( lr11xx_system_set_dio_irq_params( ral->context, irq_mask, LR11XX_SYSTEM_IRQ_NONE ) ==
+                               LR11XX_STATUS_OK );
+        smtc_modem_hal_assert( lr11xx_radio_set_tx( ral->context, rp->radio_params[id].rx.timeout_in_ms ) ==
+                               LR11XX_STATUS_OK );
+    }
+    else
+    {
+        irq_mask = LR11XX_SYSTEM_IRQ_RANGING_RESP_DONE | LR11XX_SYSTEM_IRQ_RANGING_REQ_DISCARDED |
+                   LR11XX_SYSTEM_IRQ_TIMEOUT;
+        smtc_modem_hal_assert( lr11xx_ranging_set_address( ral->context, modem_ranging.address,
+                                                           modem_ranging.check_length ) == LR11XX_STATUS_OK );
+        smtc_modem_hal_assert( lr11xx_system_set_dio_irq_params( ral->context, irq_mask, LR11XX_SYSTEM_IRQ_NONE ) ==
+                               LR11XX_STATUS_OK );
+        smtc_modem_hal_assert( lr11xx_radio_set_rx( ral->context, rp->radio_params[id].rx.timeout_in_ms ) ==
+                               LR11XX_STATUS_OK );
+    }
+}
+
+static void modem_ranging_set_lora_params( ralf_params_lora_t* lora_param )
+{
+    memset( lora_param, 0, sizeof( ralf_params_lora_t ) );
+
+    lora_param->rf_freq_in_hz     = modem_ranging.params.rf_freq_in_hz;
+    lora_param->output_pwr_in_dbm = modem_ranging.params.output_pwr_in_dbm;
+    lora_param->sync_word         = MODEM_RANGING_SYNC_WORD;
+
+    lora_param->mod_params.sf   = ( ral_lora_sf_t ) modem_ranging.params.sf;
+    lora_param->mod_params.bw   = modem_ranging_bw_convert[modem_ranging.params.bw];
+    lora_param->mod_params.cr   = RAL_LORA_CR_4_5;
+    lora_param->mod_params.ldro = ral_compute_lora_ldro( lora_param->mod_params.sf, lora_param->mod_params.bw );
+
+    lora_param->pkt_params.preamble_len_in_symb = MODEM_RANGING_PREAMBLE_LENGTH;
+    lora_param->pkt_params.header_type          = RAL_LORA_PKT_EXPLICIT;
+    lora_param->pkt_params.pld_len_in_bytes     = MODEM_RANGING_REQUEST_LENGTH;
+    lora_param->pkt_params.crc_is_on            = true;
+    lora_param->pkt_params.invert_iq_is_on      = false;
+}
+
+static uint32_t modem_ranging_get_delay_indicator( void )
+{
+    uint32_t delay_indicator =
+        modem_ranging.calibration[modem_ranging.params.bw][modem_ranging.params.sf - MODEM_RANGING_SF_MIN];
+
+    if( delay_indicator == 0 )
+    {
+        // The combination is checked when the session starts
+        lr11xx_ranging_get_recommended_rx_tx_delay_indicator( modem_ranging_lr11xx_bw_convert[modem_ranging.params.bw],
+                                                              ( lr11xx_radio_lora_sf_t ) modem_ranging.params.sf,
+                                                              &delay_indicator );
+    }
+    return delay_indicator;
+}
+
+static void modem_ranging_next( void )
+{
+    if( modem_ranging.role == SMTC_MODEM_RANGING_ROLE_MANAGER )
+    {
+        if( ranging_filter_get_nb_exchanges( &modem_ranging.filter ) < modem_ranging.params.nb_exchanges )
+        {
+            modem_ranging_enqueue( modem_ranging.exchange_ms );
+        }
+        else
+        {
+            modem_ranging_end_round( );
+        }
+    }
+    else
+    {
+        // Listen again for the rest of the window, if an exchange still fits in it
+        int32_t remaining_ms = ( int32_t )( modem_ranging.window_end_ms - smtc_modem_hal_get_time_in_ms( ) );
+        if( remaining_ms > ( int32_t ) modem_ranging.exchange_ms )
+        {
+            modem_ranging_enqueue( ( uint32_t ) remaining_ms );
+        }
+        else
+        {
+            modem_ranging_end_round( );
+        }
+    }
+}
+
+static void modem_ranging_enqueue( uint32_t timeout_ms )
+{
+    rp_radio_params_t  radio_params;
+    rp_task_t          rp_task;
+    ralf_params_lora_t lora_param;
+    memset( &radio_params, 0, sizeof( rp_radio_params_t ) );
+    memset( &rp_task, 0, sizeof( rp_task_t ) );
+
+    modem_ranging_set_lora_params( &lora_param );
+    radio_params.pkt_type         = RAL_PKT_TYPE_LORA;
+    radio_params.tx.lora          = lora_param;
+    radio_params.rx.lora          = lora_param;  // for the energy accounting
+    radio_params.rx.timeout_in_ms = timeout_ms;
+
+    // Lower priority than the LoRaWAN stack, which preempts the exchange when it needs the radio
+    rp_task.hook_id               = RP_HOOK_ID_RANGING;
+    rp_task.type                  = RP_TASK_TYPE_RANGING;
+    rp_task.state                 = RP_TASK_STATE_ASAP;
+    rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( );
+    rp_task.duration_time_ms      = timeout_ms;
+    rp_task.launch_task_callbacks = modem_ranging_launch_callback_for_rp;
+
+    if( rp_task_enqueue( modem_ranging.rp, &rp_task, NULL, 0, &radio_params ) != RP_HOOK_STATUS_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Radio planner hook %d is busy \n", rp_task.hook_id );
+        modem_ranging.running = false;
+    }
+}
+
+static void modem_ranging_end_round( void )
+{
+    smtc_modem_ranging_result_t* result = &modem_ranging.result;
+
+    memset( result, 0, sizeof( smtc_modem_ranging_result_t ) );
+    result->role  = modem_ranging.role;
+    result->round = modem_ranging.round;
+    if( modem_ranging.role == SMTC_MODEM_RANGING_ROLE_MANAGER )
+    {
+        ranging_filter_result_t filtered;
+
+        ranging_filter_get_result( &modem_ranging.filter, &filtered );
+        result->distance_m   = filtered.distance_m;
+        result->deviation_m  = filtered.deviation_m;
+        result->rssi_dbm     = filtered.rssi_dbm;
+        result->nb_exchanges = filtered.nb_exchanges;
+        result->nb_answered  = filtered.nb_samples;
+        result->nb_kept      = filtered.nb_kept;
+        result->quality      = filtered.quality;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Ranging round %u: %d m, deviation %u m, %u/%u kept\n", result->round,
+                                     result->distance_m, result->deviation_m, result->nb_kept, result->nb_exchanges );
+    }
+    else
+    {
+        result->nb_responses = modem_ranging.nb_responses;
+        result->nb_discarded = modem_ranging.nb_discarded;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Ranging round %u: %u answered, %u discarded\n", result->round,
+                                     result->nb_responses, result->nb_discarded );
+    }
+    modem_ranging.result_valid = true;
+    increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_RANGING,
+                                      ( modem_ranging.role == SMTC_MODEM_RANGING_ROLE_MANAGER )
+                                          ? SMTC_MODEM_EVENT_RANGING_MANAGER_DONE
+                                          : SMTC_MODEM_EVENT_RANGING_SUBORDINATE_DONE );
+
+    modem_ranging.round++;
+    if( modem_ranging.round >= modem_ranging.params.nb_rounds )
+    {
+        modem_ranging.running = false;
+        return;
+    }
+    if( modem_ranging.params.alternate == true )
+    {
+        modem_ranging.role = ( modem_ranging.role == SMTC_MODEM_RANGING_ROLE_MANAGER )
+                                 ? SMTC_MODEM_RANGING_ROLE_SUBORDINATE
+                                 : SMTC_MODEM_RANGING_ROLE_MANAGER;
+    }
+    modem_ranging_start_round( );
+}
+
+static void modem_ranging_start_round( void )
+{
+    smtc_dtc_t* dtc_obj = modem_ranging.lr1_mac->dtc_obj;
+    uint32_t    freq_hz = modem_ranging.params.rf_freq_in_hz;
+
+    // The whole round is checked, so that a round is not cut by the duty cycle once started
+    smtc_duty_cycle_update( dtc_obj );
+    if( smtc_duty_cycle_is_toa_accepted( dtc_obj, freq_hz, modem_ranging.params.nb_exchanges *
+                                                               modem_ranging.packet_toa_ms ) == false )
+    {
+        int32_t wait_ms = smtc_duty_cycle_get_next_free_time_ms( dtc_obj, 1, &freq_hz );
+        modem_ranging_defer( ( uint32_t ) MAX( wait_ms, ( int32_t ) MODEM_RANGING_DEFER_MIN_MS ) );
+        return;
+    }
+
+    ranging_filter_init( &modem_ranging.filter );
+    modem_ranging.nb_responses = 0;
+    modem_ranging.nb_discarded = 0;
+
+    // Twice a manager round, so that the peer fits its round in the window even if it started a bit later
+    modem_ranging.window_end_ms =
+        smtc_modem_hal_get_time_in_ms( ) + ( 2 * modem_ranging.params.nb_exchanges * modem_ranging.exchange_ms );
+    modem_ranging_next( );
+}
+
+static void modem_ranging_defer( uint32_t delay_ms )
+{
+    rp_radio_params_t radio_params;
+    rp_task_t         rp_task;
+    memset( &radio_params, 0, sizeof( rp_radio_params_t ) );
+    memset( &rp_task, 0, sizeof( rp_task_t ) );
+
+    rp_task.hook_id               = RP_HOOK_ID_RANGING;
+    rp_task.type                  = RP_TASK_TYPE_RANGING;
+    rp_task.state                 = RP_TASK_STATE_SCHEDULE;
+    rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( ) + delay_ms;
+    rp_task.duration_time_ms      = MODEM_RANGING_DEFER_DURATION_MS;
+    rp_task.launch_task_callbacks = modem_ranging_launch_callback_for_rp;
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Ranging round %u deferred %u ms by the duty cycle\n", modem_ranging.round, delay_ms );
+    modem_ranging.deferred = true;
+    if( rp_task_enqueue( modem_ranging.rp, &rp_task, NULL, 0, &radio_params ) != RP_HOOK_STATUS_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Radio planner hook %d is busy \n", rp_task.hook_id );
+        modem_ranging.deferred = false;
+        modem_ranging.running  = false;
+    }
+}
+
+#endif  // LR11XX_TRANSCEIVER
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -50,6 +50,7 @@
 #include "lbm/smtc_modem_core/device_management/modem_context.h"
 #include "lbm/smtc_modem_core/lr1mac/src/lr1mac_core.h"
 #include "lbm/smtc_modem_core/lr1mac/src/smtc_real/src/smtc_real.h"
+#include "lbm/smtc_modem_core/modem_services/per_test.h"
 #include "lbm/smtc_modem_hal/smtc_modem_hal.h"
 
 #include "lbm/smtc_modem_core/smtc_ralf/src/ralf.h"
@@ -70,6 +71,13 @@
  * --- PRIVATE MACROS-----------------------------------------------------------
  */
 
+#define MODEM_TEST_SURVEY_NB_BINS ( 24 )
+#define MODEM_TEST_SURVEY_BIN_WIDTH_DB ( 4 )
+#define MODEM_TEST_SURVEY_BIN_MIN_DBM ( -140 )  // Lower edge of the first bin, lower samples go to it
+#define MODEM_TEST_SURVEY_SAMPLE_PERIOD_MS ( 10 )  // One radio planner task per sample
+#define MODEM_TEST_SURVEY_NO_CHANNEL ( 0xFF )
+#define MODEM_TEST_PER_MIN_DELAY_MS ( 20 )  // Between a tx done and the next frame when the interval is too short
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -149,6 +157,59 @@ typedef struct modem_test_context
     bool             random_payload;      //!< True in case of random payload
 } modem_test_context_t;
 
+#if defined( ADD_SMTC_TEST_SURVEY )
+/*!
+ * \typedef modem_test_survey_channel_t
+ * \brief   Spectrum survey statistics of one channel
+ */
+typedef struct modem_test_survey_channel_s
+{
+    uint32_t frequency_hz;
+    uint32_t nb_samples;
+    uint32_t nb_busy_samples;
+    int16_t  rssi_min_dbm;
+    int16_t  rssi_max_dbm;
+    uint16_t histogram[MODEM_TEST_SURVEY_NB_BINS];  //!< Halved when a bin saturates, keeps the distribution
+} modem_test_survey_channel_t;
+
+/*!
+ * \typedef modem_test_survey_t
+ * \brief   Spectrum survey context
+ */
+typedef struct modem_test_survey_s
+{
+    bool                        running;
+    uint8_t                     nb_channels;
+    uint8_t                     channel_index;     //!< Channel being listened to
+    uint8_t                     rx_channel_index;  //!< Channel the radio was left receiving on between two samples
+    bool                        dwell_over;        //!< Last sample of the channel taken
+    uint16_t                    dwell_time_ms;
+    uint16_t                    nb_sweeps;       //!< Requested sweeps, 0 until stopped
+    uint16_t                    nb_sweeps_done;
+    int16_t                     busy_threshold_dbm;
+    uint32_t                    bw_hz;
+    uint32_t                    channel_start_ms;  //!< Start of the dwell time on the current channel
+    uint32_t                    next_sample_ms;
+    modem_test_survey_channel_t channels[SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS];
+} modem_test_survey_t;
+#endif  //  ADD_SMTC_TEST_SURVEY
+
+/*!
+ * \typedef modem_test_per_t
+ * \brief   Packet error rate test context
+ */
+typedef struct modem_test_per_s
+{
+    bool          running;
+    bool          is_tx;           //!< Transmitter or receiver side
+    uint8_t       payload_length;  //!< Frame length of the transmitter
+    uint32_t      interval_ms;     //!< Time between the start of two frames of the transmitter
+    uint32_t      next_start_ms;   //!< Start of the next frame of the transmitter
+    uint32_t      nb_rx_frames;    //!< Frames heard by the receiver, whatever their state
+    per_test_tx_t tx;
+    per_test_rx_t rx;
+} modem_test_per_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -156,9 +217,19 @@ typedef struct modem_test_context
 
 #if defined( LR1110_MODEM_E )
 modem_test_context_t modem_test_context;
+modem_test_per_t     modem_test_per;
 #else
 static modem_test_context_t modem_test_context;
+static modem_test_per_t     modem_test_per;
+#endif
+
+#if defined( ADD_SMTC_TEST_SURVEY )
+#if defined( LR1110_MODEM_E )
+modem_test_survey_t modem_test_survey;
+#else
+static modem_test_survey_t modem_test_survey;
 #endif
+#endif  //  ADD_SMTC_TEST_SURVEY
 
 /*
  * -----------------------------------------------------------------------------
@@ -190,6 +261,64 @@ void modem_test_rx_callback( modem_test_context_t* context );
  */
 void test_mode_cw_callback_for_rp( void* rp_void );
 
+#if defined( ADD_SMTC_TEST_SURVEY )
+/*!
+ * \brief   Callback for test survey, moves to the next channel once the dwell time is over
+ * \retval [out]    context*                  - modem_test_context_t
+ */
+void modem_test_survey_callback( modem_test_context_t* context );
+
+/*!
+ * \brief   Callback to take one rssi sample of the current survey channel by Radio Planner
+ * \retval [in]    rp_void*                   - radio planner context
+ */
+void modem_test_survey_launch_callback_for_rp( void* rp_void );
+
+/*!
+ * \brief   Enqueue the next sampling task of the current survey channel
+ */
+static void modem_test_survey_enqueue( void );
+
+/*!
+ * \brief   Add a rssi sample to a survey channel
+ */
+static void modem_test_survey_add_sample( modem_test_survey_channel_t* channel, int16_t rssi_dbm );
+
+/*!
+ * \brief   Rssi under which percent of the samples of a survey channel fall
+ */
+static int16_t modem_test_survey_get_percentile( const modem_test_survey_channel_t* channel, uint8_t percent );
+#endif  //  ADD_SMTC_TEST_SURVEY
+
+/*!
+ * \brief   Callback for test per transmitter, sends the next frame
+ * \retval [out]    context*                  - modem_test_context_t
+ */
+void modem_test_per_tx_callback( modem_test_context_t* context );
+
+/*!
+ * \brief   Callback for test per receiver, accounts the frame and listens again
+ * \retval [out]    context*                  - modem_test_context_t
+ */
+void modem_test_per_rx_callback( modem_test_context_t* context );
+
+/*!
+ * \brief   Check the test per radio settings and fill the LoRa parameters from them
+ */
+static smtc_modem_return_code_t modem_test_per_set_lora_params( ralf_params_lora_t* lora_param, uint32_t frequency_hz,
+                                                                smtc_modem_test_sf_t sf, smtc_modem_test_bw_t bw,
+                                                                smtc_modem_test_cr_t cr );
+
+/*!
+ * \brief   Build the next frame of the test per transmitter and enqueue it
+ */
+static void modem_test_per_tx_enqueue( rp_radio_params_t* radio_params );
+
+/*!
+ * \brief   Enqueue the listening task of the test per receiver
+ */
+static void modem_test_per_rx_enqueue( rp_radio_params_t* radio_params );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -259,6 +388,10 @@ smtc_modem_return_code_t smtc_modem_test_nop( void )
         SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
         return SMTC_MODEM_RC_INVALID;
     }
+#if defined( ADD_SMTC_TEST_SURVEY )
+    modem_test_survey.running = false;
+#endif  //  ADD_SMTC_TEST_SURVEY
+    modem_test_per.running = false;
     rp_task_abort( modem_test_context.rp, modem_test_context.hook_id );
     smtc_modem_test_radio_reset( );
     return SMTC_MODEM_RC_OK;
@@ -666,6 +799,321 @@ smtc_modem_return_code_t smtc_modem_test_get_rssi( int8_t* rssi )
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_test_survey_start( const uint32_t* frequencies_hz, uint8_t nb_frequencies,
+                                                       smtc_modem_test_bw_t bw, uint16_t dwell_time_ms,
+                                                       uint16_t nb_sweeps, int16_t busy_threshold_dbm )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+#if defined( ADD_SMTC_TEST_SURVEY )
+    if( bw >= SMTC_MODEM_TEST_BW_COUNT )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid bw %d\n", bw );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( dwell_time_ms == 0 )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid dwell time\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    uint32_t region_frequencies[SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS];
+    if( frequencies_hz == NULL )
+    {
+        if( smtc_real_get_current_enabled_frequency_list( modem_test_context.lr1_mac_obj->real, &nb_frequencies,
+                                                          region_frequencies,
+                                                          SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS ) == false )
+        {
+            SMTC_MODEM_HAL_TRACE_ERROR( "Too many channels in region\n" );
+            return SMTC_MODEM_RC_FAIL;
+        }
+        frequencies_hz = region_frequencies;
+    }
+    if( ( nb_frequencies == 0 ) || ( nb_frequencies > SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS ) )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid number of channels %u\n", nb_frequencies );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    for( uint8_t i = 0; i < nb_frequencies; i++ )
+    {
+        if( smtc_real_is_frequency_valid( modem_test_context.lr1_mac_obj->real, frequencies_hz[i] ) != OKLORAWAN )
+        {
+            SMTC_MODEM_HAL_TRACE_ERROR( "Invalid Frequency %u\n", frequencies_hz[i] );
+            return SMTC_MODEM_RC_INVALID;
+        }
+    }
+
+    if( smtc_modem_test_nop( ) != SMTC_MODEM_RC_OK )
+    {
+        return SMTC_MODEM_RC_FAIL;
+    }
+
+    memset( &modem_test_survey, 0, sizeof( modem_test_survey_t ) );
+    for( uint8_t i = 0; i < nb_frequencies; i++ )
+    {
+        modem_test_survey.channels[i].frequency_hz = frequencies_hz[i];
+        modem_test_survey.channels[i].rssi_min_dbm = INT16_MAX;
+        modem_test_survey.channels[i].rssi_max_dbm = INT16_MIN;
+    }
+    modem_test_survey.nb_channels        = nb_frequencies;
+    modem_test_survey.dwell_time_ms      = dwell_time_ms;
+    modem_test_survey.nb_sweeps          = nb_sweeps;
+    modem_test_survey.busy_threshold_dbm = busy_threshold_dbm;
+    // Same measurement filter as smtc_modem_test_rssi
+    modem_test_survey.bw_hz            = ( modem_test_bw_helper[bw] > 467000 ) ? 467000 : modem_test_bw_helper[bw];
+    modem_test_survey.channel_start_ms = smtc_modem_hal_get_time_in_ms( );
+    modem_test_survey.next_sample_ms   = modem_test_survey.channel_start_ms;
+    modem_test_survey.rx_channel_index = MODEM_TEST_SURVEY_NO_CHANNEL;
+    modem_test_survey.running          = true;
+
+    rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
+    rp_hook_init( modem_test_context.rp, modem_test_context.hook_id,
+                  ( void ( * )( void* ) )( modem_test_survey_callback ), &modem_test_context );
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Survey - %u channels, %u ms each\n", nb_frequencies, dwell_time_ms );
+    modem_test_survey_enqueue( );
+
+    return SMTC_MODEM_RC_OK;
+#else   //  ADD_SMTC_TEST_SURVEY
+    UNUSED( frequencies_hz );
+    UNUSED( nb_frequencies );
+    UNUSED( bw );
+    UNUSED( dwell_time_ms );
+    UNUSED( nb_sweeps );
+    UNUSED( busy_threshold_dbm );
+    return SMTC_MODEM_RC_FAIL;
+#endif  //  ADD_SMTC_TEST_SURVEY
+}
+
+smtc_modem_return_code_t smtc_modem_test_survey_get_status( bool* running, uint8_t* nb_channels,
+                                                            uint16_t* nb_sweeps_done )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+#if defined( ADD_SMTC_TEST_SURVEY )
+    if( ( running == NULL ) || ( nb_channels == NULL ) || ( nb_sweeps_done == NULL ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    *running        = modem_test_survey.running;
+    *nb_channels    = modem_test_survey.nb_channels;
+    *nb_sweeps_done = modem_test_survey.nb_sweeps_done;
+    return SMTC_MODEM_RC_OK;
+#else   //  ADD_SMTC_TEST_SURVEY
+    UNUSED( running );
+    UNUSED( nb_channels );
+    UNUSED( nb_sweeps_done );
+    return SMTC_MODEM_RC_FAIL;
+#endif  //  ADD_SMTC_TEST_SURVEY
+}
+
+smtc_modem_return_code_t smtc_modem_test_survey_get_result( uint8_t index, smtc_modem_test_survey_result_t* result )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+#if defined( ADD_SMTC_TEST_SURVEY )
+    if( ( result == NULL ) || ( index >= modem_test_survey.nb_channels ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    const modem_test_survey_channel_t* channel = &modem_test_survey.channels[index];
+
+    memset( result, 0, sizeof( smtc_modem_test_survey_result_t ) );
+    result->frequency_hz = channel->frequency_hz;
+    result->nb_samples   = channel->nb_samples;
+    if( channel->nb_samples == 0 )
+    {
+        return SMTC_MODEM_RC_OK;
+    }
+
+    result->rssi_min_dbm       = channel->rssi_min_dbm;
+    result->rssi_max_dbm       = channel->rssi_max_dbm;
+    result->rssi_median_dbm    = modem_test_survey_get_percentile( channel, 50 );
+    result->rssi_p90_dbm       = modem_test_survey_get_percentile( channel, 90 );
+    result->rssi_p99_dbm       = modem_test_survey_get_percentile( channel, 99 );
+    result->busy_ratio_percent = ( uint8_t )( ( ( uint64_t ) channel->nb_busy_samples * 100 ) / channel->nb_samples );
+    return SMTC_MODEM_RC_OK;
+#else   //  ADD_SMTC_TEST_SURVEY
+    UNUSED( index );
+    UNUSED( result );
+    return SMTC_MODEM_RC_FAIL;
+#endif  //  ADD_SMTC_TEST_SURVEY
+}
+
+smtc_modem_return_code_t smtc_modem_test_per_tx_start( uint32_t frequency_hz, smtc_modem_test_sf_t sf,
+                                                       smtc_modem_test_bw_t bw, smtc_modem_test_cr_t cr,
+                                                       uint8_t payload_length, uint16_t nb_frames, uint32_t interval_ms,
+                                                       int8_t power_start_dbm, int8_t power_stop_dbm,
+                                                       int8_t power_step_db )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( payload_length < PER_TEST_FRAME_MIN_LENGTH )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid length %u\n", payload_length );
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    rp_radio_params_t rp_radio_params = { 0 };
+    rp_radio_params.pkt_type          = RAL_PKT_TYPE_LORA;
+
+    smtc_modem_return_code_t return_code =
+        modem_test_per_set_lora_params( &rp_radio_params.tx.lora, frequency_hz, sf, bw, cr );
+    if( return_code != SMTC_MODEM_RC_OK )
+    {
+        return return_code;
+    }
+    rp_radio_params.tx.lora.pkt_params.pld_len_in_bytes = payload_length;
+
+    if( smtc_modem_test_nop( ) != SMTC_MODEM_RC_OK )
+    {
+        return SMTC_MODEM_RC_FAIL;
+    }
+
+    memset( &modem_test_per, 0, sizeof( modem_test_per_t ) );
+    if( per_test_tx_init( &modem_test_per.tx, nb_frames, power_start_dbm, power_stop_dbm, power_step_db ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid power sweep %d to %d by %d\n", power_start_dbm, power_stop_dbm,
+                                    power_step_db );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    modem_test_per.is_tx          = true;
+    modem_test_per.payload_length = payload_length;
+    modem_test_per.interval_ms    = interval_ms;
+    modem_test_per.next_start_ms  = smtc_modem_hal_get_time_in_ms( );
+    modem_test_per.running        = true;
+
+    rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
+    rp_hook_init( modem_test_context.rp, modem_test_context.hook_id,
+                  ( void ( * )( void* ) )( modem_test_per_tx_callback ), &modem_test_context );
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "PER Tx - Freq:%u, %u steps of %u frames\n", frequency_hz,
+                                 modem_test_per.tx.nb_steps, nb_frames );
+    modem_test_per_tx_enqueue( &rp_radio_params );
+
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_test_per_rx_start( uint32_t frequency_hz, smtc_modem_test_sf_t sf,
+                                                       smtc_modem_test_bw_t bw, smtc_modem_test_cr_t cr )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    rp_radio_params_t rp_radio_params = { 0 };
+    rp_radio_params.pkt_type          = RAL_PKT_TYPE_LORA;
+    rp_radio_params.rx.timeout_in_ms  = RAL_RX_TIMEOUT_CONTINUOUS_MODE;
+
+    smtc_modem_return_code_t return_code =
+        modem_test_per_set_lora_params( &rp_radio_params.rx.lora, frequency_hz, sf, bw, cr );
+    if( return_code != SMTC_MODEM_RC_OK )
+    {
+        return return_code;
+    }
+    rp_radio_params.rx.lora.pkt_params.pld_len_in_bytes = 255;
+
+    if( smtc_modem_test_nop( ) != SMTC_MODEM_RC_OK )
+    {
+        return SMTC_MODEM_RC_FAIL;
+    }
+
+    memset( &modem_test_per, 0, sizeof( modem_test_per_t ) );
+    per_test_rx_init( &modem_test_per.rx );
+    modem_test_per.running = true;
+
+    rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
+    rp_hook_init( modem_test_context.rp, modem_test_context.hook_id,
+                  ( void ( * )( void* ) )( modem_test_per_rx_callback ), &modem_test_context );
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "PER Rx - Freq:%u\n", frequency_hz );
+    modem_test_per_rx_enqueue( &rp_radio_params );
+
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_test_per_get_status( bool* running, uint8_t* nb_steps, uint32_t* nb_frames )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( ( running == NULL ) || ( nb_steps == NULL ) || ( nb_frames == NULL ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    *running = modem_test_per.running;
+    if( modem_test_per.is_tx == true )
+    {
+        *nb_steps  = modem_test_per.tx.nb_steps;
+        *nb_frames = per_test_tx_get_nb_built( &modem_test_per.tx );
+    }
+    else
+    {
+        *nb_steps  = modem_test_per.rx.nb_steps;
+        *nb_frames = modem_test_per.nb_rx_frames;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_test_per_get_result( uint8_t step, smtc_modem_test_per_result_t* result )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( ( result == NULL ) || ( modem_test_per.is_tx == true ) || ( step >= modem_test_per.rx.nb_steps ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    const per_test_rx_t*   rx      = &modem_test_per.rx;
+    const per_test_step_t* rx_step = &rx->steps[step];
+
+    memset( result, 0, sizeof( smtc_modem_test_per_result_t ) );
+    result->power_dbm     = per_test_rx_get_power_dbm( rx, step );
+    result->nb_frames     = rx->nb_frames;
+    result->nb_received   = rx_step->nb_received;
+    result->nb_lost       = per_test_rx_get_nb_lost( rx, step );
+    result->nb_duplicated = rx_step->nb_duplicated;
+    result->nb_corrupted  = rx_step->nb_corrupted;
+    if( rx_step->nb_received == 0 )
+    {
+        return SMTC_MODEM_RC_OK;
+    }
+
+    result->rssi_min_dbm    = rx_step->rssi.min;
+    result->rssi_max_dbm    = rx_step->rssi.max;
+    result->rssi_mean_dbm   = per_test_get_mean( &rx_step->rssi );
+    result->rssi_median_dbm = per_test_get_rssi_percentile( rx_step, 50 );
+    result->rssi_p10_dbm    = per_test_get_rssi_percentile( rx_step, 10 );
+    result->snr_min_db      = rx_step->snr.min;
+    result->snr_max_db      = rx_step->snr.max;
+    result->snr_mean_db     = per_test_get_mean( &rx_step->snr );
+    result->snr_median_db   = per_test_get_snr_percentile( rx_step, 50 );
+    result->snr_p10_db      = per_test_get_snr_percentile( rx_step, 10 );
+    return SMTC_MODEM_RC_OK;
+}
+
 void modem_test_set_rssi( int16_t rssi )
 {
     modem_test_context.rssi = rssi;
@@ -690,6 +1138,8 @@ smtc_modem_return_code_t smtc_modem_test_radio_reset( void )
     {
         return SMTC_MODEM_RC_FAIL;
     }
+    // Radio configuration has been lost, it cannot be reused by the next task
+    rp_invalidate_radio_config( modem_test_context.rp );
 
     smtc_modem_hal_stop_radio_tcxo( );
 
@@ -906,4 +1356,357 @@ void test_mode_cw_callback_for_rp( void* rp_void )
     smtc_modem_hal_assert( ral_set_tx_cw( &( rp->radio->ral ) ) == RAL_STATUS_OK );
 }
 
+#if defined( ADD_SMTC_TEST_SURVEY )
+void modem_test_survey_callback( modem_test_context_t* context )
+{
+    smtc_modem_hal_reload_wdog( );
+
+    if( ( modem_test_survey.running == false ) ||
+        ( context->rp->status[context->hook_id] != RP_STATUS_LBT_FREE_CHANNEL ) )
+    {
+        modem_test_survey.running = false;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Survey stopped\n" );
+        return;
+    }
+
+    uint32_t now = smtc_modem_hal_get_time_in_ms( );
+    if( modem_test_survey.dwell_over == true )
+    {
+        modem_test_survey.channel_index++;
+        if( modem_test_survey.channel_index >= modem_test_survey.nb_channels )
+        {
+            modem_test_survey.channel_index = 0;
+            modem_test_survey.nb_sweeps_done++;
+            SMTC_MODEM_HAL_TRACE_PRINTF( "Survey sweep %u done\n", modem_test_survey.nb_sweeps_done );
+
+            if( ( modem_test_survey.nb_sweeps != 0 ) &&
+                ( modem_test_survey.nb_sweeps_done >= modem_test_survey.nb_sweeps ) )
+            {
+                modem_test_survey.running = false;
+                return;
+            }
+        }
+        modem_test_survey.channel_start_ms = now;
+        modem_test_survey.next_sample_ms   = now;
+    }
+
+    modem_test_survey_enqueue( );
+}
+
+void modem_test_survey_launch_callback_for_rp( void* rp_void )
+{
+    radio_planner_t*             rp      = ( radio_planner_t* ) rp_void;
+    uint8_t                      id      = rp->radio_task_id;
+    modem_test_survey_channel_t* channel = &modem_test_survey.channels[modem_test_survey.channel_index];
+    int16_t                      rssi_tmp;
+
+    // The radio is set up once per channel dwell, it keeps receiving between the samples of the channel
+    if( ( rp_is_radio_configured_by( rp, id ) == false ) ||
+        ( modem_test_survey.rx_channel_index != modem_test_survey.channel_index ) )
+    {
+        smtc_modem_hal_start_radio_tcxo( );
+        smtc_modem_hal_assert( ral_set_standby( &( rp->radio->ral ), RAL_STANDBY_CFG_RC ) == RAL_STATUS_OK );
+        smtc_modem_hal_assert( ral_set_pkt_type( &( rp->radio->ral ), rp->radio_params[id].pkt_type ) ==
+                               RAL_STATUS_OK );
+        smtc_modem_hal_assert( ral_set_rf_freq( &( rp->radio->ral ), rp->radio_params[id].rx.gfsk.rf_freq_in_hz ) ==
+                               RAL_STATUS_OK );
+        smtc_modem_hal_assert( ral_set_gfsk_mod_params( &( rp->radio->ral ),
+                                                        &rp->radio_params[id].rx.gfsk.mod_params ) == RAL_STATUS_OK );
+        smtc_modem_hal_assert( ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_NONE ) == RAL_STATUS_OK );
+        smtc_modem_hal_assert( ral_set_rx( &( rp->radio->ral ), RAL_RX_TIMEOUT_CONTINUOUS_MODE ) == RAL_STATUS_OK );
+        modem_test_survey.rx_channel_index = modem_test_survey.channel_index;
+
+        // Only the rssi settling time is spent here, as in the LBT. The radio planner timer paces the samples
+        uint32_t rssi_valid_time = smtc_modem_hal_get_time_in_ms( ) + LAP_OF_TIME_TO_GET_A_RSSI_VALID;
+        while( ( int32_t )( rssi_valid_time - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
+        {  // delay LAP_OF_TIME_TO_GET_A_RSSI_VALID ms
+        }
+    }
+    smtc_modem_hal_assert( ral_get_rssi_inst( &( rp->radio->ral ), &rssi_tmp ) == RAL_STATUS_OK );
+    modem_test_survey_add_sample( channel, rssi_tmp );
+
+    // The radio is put to sleep once the dwell on the channel is over
+    uint32_t dwell_ms            = smtc_modem_hal_get_time_in_ms( ) - modem_test_survey.channel_start_ms;
+    modem_test_survey.dwell_over = ( int32_t ) dwell_ms >= ( int32_t ) modem_test_survey.dwell_time_ms;
+    if( modem_test_survey.dwell_over == false )
+    {
+        rp_keep_radio_on( rp );
+    }
+    else
+    {
+        modem_test_survey.rx_channel_index = MODEM_TEST_SURVEY_NO_CHANNEL;
+    }
+
+    rp->status[id] = RP_STATUS_LBT_FREE_CHANNEL;
+    rp_radio_irq_callback( rp_void );
+}
+
+static void modem_test_survey_enqueue( void )
+{
+    ralf_params_gfsk_t gfsk_param;
+    rp_radio_params_t  radio_params;
+    rp_task_t          rp_task;
+    memset( &gfsk_param, 0, sizeof( ralf_params_gfsk_t ) );
+    memset( &radio_params, 0, sizeof( rp_radio_params_t ) );
+    memset( &rp_task, 0, sizeof( rp_task_t ) );
+
+    // Same receiver settings as the LBT
+    gfsk_param.dc_free_is_on           = true;
+    gfsk_param.rf_freq_in_hz           = modem_test_survey.channels[modem_test_survey.channel_index].frequency_hz;
+    gfsk_param.mod_params.br_in_bps    = modem_test_survey.bw_hz >> 1;
+    gfsk_param.mod_params.bw_dsb_in_hz = modem_test_survey.bw_hz;
+    gfsk_param.mod_params.pulse_shape  = RAL_GFSK_PULSE_SHAPE_BT_1;
+    gfsk_param.mod_params.fdev_in_hz   = modem_test_survey.bw_hz >> 2;
+
+    radio_params.pkt_type         = RAL_PKT_TYPE_GFSK;
+    radio_params.rx.gfsk          = gfsk_param;
+    radio_params.rx.timeout_in_ms = LAP_OF_TIME_TO_GET_A_RSSI_VALID + 1;
+
+    rp_task.hook_id               = modem_test_context.hook_id;
+    rp_task.type                  = RP_TASK_TYPE_LBT;
+    rp_task.duration_time_ms      = radio_params.rx.timeout_in_ms;
+    rp_task.launch_task_callbacks = modem_test_survey_launch_callback_for_rp;
+
+    // A late sample is taken as soon as possible and the pace resumes from it
+    uint32_t now = smtc_modem_hal_get_time_in_ms( );
+    if( ( int32_t )( modem_test_survey.next_sample_ms - now ) > 0 )
+    {
+        rp_task.state         = RP_TASK_STATE_SCHEDULE;
+        rp_task.start_time_ms = modem_test_survey.next_sample_ms;
+    }
+    else
+    {
+        rp_task.state                    = RP_TASK_STATE_ASAP;
+        rp_task.start_time_ms            = now;
+        modem_test_survey.next_sample_ms = now;
+    }
+    modem_test_survey.next_sample_ms += MODEM_TEST_SURVEY_SAMPLE_PERIOD_MS;
+
+    if( rp_task_enqueue( modem_test_context.rp, &rp_task, NULL, 0, &radio_params ) != RP_HOOK_STATUS_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Radio planner hook %d is busy \n", rp_task.hook_id );
+        modem_test_survey.running = false;
+    }
+}
+
+static void modem_test_survey_add_sample( modem_test_survey_channel_t* channel, int16_t rssi_dbm )
+{
+    channel->nb_samples++;
+    if( rssi_dbm >= modem_test_survey.busy_threshold_dbm )
+    {
+        channel->nb_busy_samples++;
+    }
+    if( rssi_dbm < channel->rssi_min_dbm )
+    {
+        channel->rssi_min_dbm = rssi_dbm;
+    }
+    if( rssi_dbm > channel->rssi_max_dbm )
+    {
+        channel->rssi_max_dbm = rssi_dbm;
+    }
+
+    int32_t bin = ( ( int32_t ) rssi_dbm - MODEM_TEST_SURVEY_BIN_MIN_DBM ) / MODEM_TEST_SURVEY_BIN_WIDTH_DB;
+    if( bin < 0 )
+    {
+        bin = 0;
+    }
+    else if( bin >= MODEM_TEST_SURVEY_NB_BINS )
+    {
+        bin = MODEM_TEST_SURVEY_NB_BINS - 1;
+    }
+
+    if( channel->histogram[bin] == UINT16_MAX )
+    {
+        for( uint8_t i = 0; i < MODEM_TEST_SURVEY_NB_BINS; i++ )
+        {
+            channel->histogram[i] >>= 1;
+        }
+    }
+    channel->histogram[bin]++;
+}
+
+static int16_t modem_test_survey_get_percentile( const modem_test_survey_channel_t* channel, uint8_t percent )
+{
+    uint32_t total = 0;
+    for( uint8_t i = 0; i < MODEM_TEST_SURVEY_NB_BINS; i++ )
+    {
+        total += channel->histogram[i];
+    }
+
+    uint32_t target = ( total * percent + 99 ) / 100;
+    uint32_t count  = 0;
+    uint8_t  bin    = 0;
+    for( ; bin < MODEM_TEST_SURVEY_NB_BINS - 1; bin++ )
+    {
+        count += channel->histogram[bin];
+        if( count >= target )
+        {
+            break;
+        }
+    }
+
+    // Middle of the bin, within the observed range
+    int16_t rssi_dbm =
+        MODEM_TEST_SURVEY_BIN_MIN_DBM + bin * MODEM_TEST_SURVEY_BIN_WIDTH_DB + MODEM_TEST_SURVEY_BIN_WIDTH_DB / 2;
+    if( rssi_dbm < channel->rssi_min_dbm )
+    {
+        rssi_dbm = channel->rssi_min_dbm;
+    }
+    if( rssi_dbm > channel->rssi_max_dbm )
+    {
+        rssi_dbm = channel->rssi_max_dbm;
+    }
+    return rssi_dbm;
+}
+#endif  //  ADD_SMTC_TEST_SURVEY
+
+void modem_test_per_tx_callback( modem_test_context_t* context )
+{
+    smtc_modem_hal_reload_wdog( );
+
+    if( ( modem_test_per.running == false ) || ( context->rp->status[context->hook_id] == RP_STATUS_TASK_ABORTED ) )
+    {
+        modem_test_per.running = false;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "PER Tx stopped\n" );
+        return;
+    }
+
+    rp_radio_params_t radio_params = context->rp->radio_params[context->hook_id];
+    modem_test_per_tx_enqueue( &radio_params );
+}
+
+void modem_test_per_rx_callback( modem_test_context_t* context )
+{
+    smtc_modem_hal_reload_wdog( );
+    rp_status_t rp_status = context->rp->status[context->hook_id];
+
+    if( ( modem_test_per.running == false ) || ( rp_status == RP_STATUS_TASK_ABORTED ) )
+    {
+        modem_test_per.running = false;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "PER Rx stopped\n" );
+        return;
+    }
+
+    rp_radio_params_t radio_params = context->rp->radio_params[context->hook_id];
+
+    if( rp_status == RP_STATUS_RX_PACKET )
+    {
+        modem_test_per.nb_rx_frames++;
+        per_test_rx_add_frame( &modem_test_per.rx, context->tx_rx_payload, context->rp->payload_size[context->hook_id],
+                               radio_params.rx.lora_pkt_status.rssi_pkt_in_dbm,
+                               radio_params.rx.lora_pkt_status.snr_pkt_in_db );
+    }
+    else if( rp_status == RP_STATUS_RX_CRC_ERROR )
+    {
+        modem_test_per.nb_rx_frames++;
+        per_test_rx_add_crc_error( &modem_test_per.rx );
+    }
+
+    modem_test_per_rx_enqueue( &radio_params );
+}
+
+static smtc_modem_return_code_t modem_test_per_set_lora_params( ralf_params_lora_t* lora_param, uint32_t frequency_hz,
+                                                                smtc_modem_test_sf_t sf, smtc_modem_test_bw_t bw,
+                                                                smtc_modem_test_cr_t cr )
+{
+    if( smtc_real_is_frequency_valid( modem_test_context.lr1_mac_obj->real, frequency_hz ) != OKLORAWAN )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid Frequency %u\n", frequency_hz );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( ( sf == SMTC_MODEM_TEST_FSK ) || ( sf >= SMTC_MODEM_TEST_LORA_SF_COUNT ) )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid sf %d\n", sf );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( bw >= SMTC_MODEM_TEST_BW_COUNT )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid bw %d\n", bw );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( cr >= SMTC_MODEM_TEST_CR_COUNT )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid cr %d\n", cr );
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    memset( lora_param, 0, sizeof( ralf_params_lora_t ) );
+
+    // Both sides use the same settings, unlike smtc_modem_test_rx_continuous that listens to downlinks
+    lora_param->rf_freq_in_hz = frequency_hz;
+    lora_param->sync_word     = smtc_real_get_sync_word( modem_test_context.lr1_mac_obj->real );
+
+    lora_param->pkt_params.preamble_len_in_symb =
+        smtc_real_get_preamble_len( modem_test_context.lr1_mac_obj->real, modem_test_sf_convert[sf] );
+    lora_param->pkt_params.header_type     = RAL_LORA_PKT_EXPLICIT;
+    lora_param->pkt_params.crc_is_on       = true;
+    lora_param->pkt_params.invert_iq_is_on = false;
+
+    lora_param->mod_params.sf   = ( ral_lora_sf_t ) modem_test_sf_convert[sf];
+    lora_param->mod_params.bw   = ( ral_lora_bw_t ) modem_test_bw_convert[bw];
+    lora_param->mod_params.cr   = ( ral_lora_cr_t ) modem_test_cr_convert[cr];
+    lora_param->mod_params.ldro = ral_compute_lora_ldro( lora_param->mod_params.sf, lora_param->mod_params.bw );
+
+    return SMTC_MODEM_RC_OK;
+}
+
+static void modem_test_per_tx_enqueue( rp_radio_params_t* radio_params )
+{
+    int8_t power_dbm;
+    if( per_test_tx_get_next( &modem_test_per.tx, modem_test_context.tx_rx_payload, modem_test_per.payload_length,
+                              &power_dbm ) == false )
+    {
+        modem_test_per.running = false;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "PER Tx done\n" );
+        return;
+    }
+    radio_params->tx.lora.output_pwr_in_dbm = power_dbm;
+
+    // Frames are paced from start to start, a late frame is sent as soon as possible and the pace resumes from it
+    uint32_t now = smtc_modem_hal_get_time_in_ms( );
+    if( ( int32_t )( modem_test_per.next_start_ms - now ) < MODEM_TEST_PER_MIN_DELAY_MS )
+    {
+        modem_test_per.next_start_ms = now + MODEM_TEST_PER_MIN_DELAY_MS;
+    }
+
+    rp_task_t rp_task = { 0 };
+
+    rp_task.hook_id               = modem_test_context.hook_id;
+    rp_task.state                 = RP_TASK_STATE_SCHEDULE;
+    rp_task.start_time_ms         = modem_test_per.next_start_ms;
+    rp_task.type                  = RP_TASK_TYPE_TX_LORA;
+    rp_task.launch_task_callbacks = lr1_stack_mac_tx_lora_launch_callback_for_rp;
+    rp_task.duration_time_ms      = ral_get_lora_time_on_air_in_ms( &( modem_test_context.rp->radio->ral ),
+                                                                   &( radio_params->tx.lora.pkt_params ),
+                                                                   &( radio_params->tx.lora.mod_params ) );
+
+    modem_test_per.next_start_ms += modem_test_per.interval_ms;
+
+    if( rp_task_enqueue( modem_test_context.rp, &rp_task, modem_test_context.tx_rx_payload,
+                         modem_test_per.payload_length, radio_params ) != RP_HOOK_STATUS_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Radio planner hook %d is busy \n", rp_task.hook_id );
+        modem_test_per.running = false;
+    }
+}
+
+static void modem_test_per_rx_enqueue( rp_radio_params_t* radio_params )
+{
+    rp_task_t rp_task = { 0 };
+
+    rp_task.hook_id               = modem_test_context.hook_id;
+    rp_task.state                 = RP_TASK_STATE_ASAP;
+    rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( ) + 20;
+    rp_task.duration_time_ms      = 2000;  // toa;
+    rp_task.type                  = RP_TASK_TYPE_RX_LORA;
+    rp_task.launch_task_callbacks = lr1_stack_mac_rx_lora_launch_callback_for_rp;
+
+    if( rp_task_enqueue( modem_test_context.rp, &rp_task, modem_test_context.tx_rx_payload,
+                         radio_params->rx.lora.pkt_params.pld_len_in_bytes, radio_params ) != RP_HOOK_STATUS_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Radio planner hook %d is busy \n", rp_task.hook_id );
+        modem_test_per.running = false;
+    }
+}
+
 /* --- EOF ------------------------------------------------------------------ */
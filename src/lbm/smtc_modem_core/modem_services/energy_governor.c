@@ -0,0 +1,237 @@
+/*!
+ * \file      energy_governor.c
+ *
+ * \brief     Per-period energy budget and the degradation policy applied when it runs out
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>
+
+#include "energy_governor.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+static uint64_t energy_governor_get_total_ua_ms( const energy_governor_t* eg );
+
+static energy_governor_level_t energy_governor_compute_level( const energy_governor_t* eg );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void energy_governor_init( energy_governor_t* eg )
+{
+    memset( eg, 0, sizeof( energy_governor_t ) );
+    eg->period_s = ENERGY_GOVERNOR_DEFAULT_PERIOD_S;
+    eg->level    = ENERGY_GOVERNOR_LEVEL_NORMAL;
+}
+
+void energy_governor_set_budget( energy_governor_t* eg, uint32_t budget_uah, uint32_t period_s, uint32_t now_s )
+{
+    eg->budget_uah     = budget_uah;
+    eg->period_s       = ( period_s == 0 ) ? ENERGY_GOVERNOR_DEFAULT_PERIOD_S : period_s;
+    eg->period_start_s = now_s;
+    memset( eg->spent_ua_ms, 0, sizeof( eg->spent_ua_ms ) );
+}
+
+void energy_governor_add_charge( energy_governor_t* eg, energy_governor_activity_t activity, uint64_t charge_ua_ms )
+{
+    if( activity < ENERGY_GOVERNOR_ACTIVITY_NUMBER )
+    {
+        eg->spent_ua_ms[activity] += charge_ua_ms;
+    }
+}
+
+bool energy_governor_update( energy_governor_t* eg, uint32_t now_s )
+{
+    uint32_t elapsed_s = now_s - eg->period_start_s;
+
+    if( elapsed_s >= eg->period_s )
+    {
+        // Periods are aligned on the first one, a long sleep skips the periods it covers
+        eg->period_start_s += elapsed_s - ( elapsed_s % eg->period_s );
+        memset( eg->spent_ua_ms, 0, sizeof( eg->spent_ua_ms ) );
+    }
+
+    energy_governor_level_t level = energy_governor_compute_level( eg );
+    if( level == eg->level )
+    {
+        return false;
+    }
+    eg->level = level;
+    return true;
+}
+
+energy_governor_level_t energy_governor_get_level( const energy_governor_t* eg )
+{
+    return eg->level;
+}
+
+uint32_t energy_governor_get_spent_uah( const energy_governor_t* eg, energy_governor_activity_t activity )
+{
+    if( activity >= ENERGY_GOVERNOR_ACTIVITY_NUMBER )
+    {
+        return 0;
+    }
+    return ( uint32_t ) ( eg->spent_ua_ms[activity] / ENERGY_GOVERNOR_UA_MS_PER_UAH );
+}
+
+uint32_t energy_governor_get_remaining_uah( const energy_governor_t* eg )
+{
+    uint64_t spent_uah = energy_governor_get_total_ua_ms( eg ) / ENERGY_GOVERNOR_UA_MS_PER_UAH;
+
+    if( spent_uah >= eg->budget_uah )
+    {
+        return 0;
+    }
+    return eg->budget_uah - ( uint32_t ) spent_uah;
+}
+
+uint32_t energy_governor_get_scan_delay_s( const energy_governor_t* eg, uint32_t delay_s, uint32_t now_s )
+{
+    uint64_t governed_delay_s = delay_s;
+
+    switch( eg->level )
+    {
+    case ENERGY_GOVERNOR_LEVEL_SAVING:
+        governed_delay_s *= ENERGY_GOVERNOR_SAVING_SCAN_DELAY_FACTOR;
+        break;
+    case ENERGY_GOVERNOR_LEVEL_CRITICAL:
+        governed_delay_s *= ENERGY_GOVERNOR_CRITICAL_SCAN_DELAY_FACTOR;
+        if( governed_delay_s < ENERGY_GOVERNOR_CRITICAL_MIN_SCAN_DELAY_S )
+        {
+            governed_delay_s = ENERGY_GOVERNOR_CRITICAL_MIN_SCAN_DELAY_S;
+        }
+        break;
+    case ENERGY_GOVERNOR_LEVEL_EXHAUSTED:
+    {
+        // Nothing is left before the budget is renewed
+        uint32_t period_left_s = eg->period_s - ( now_s - eg->period_start_s );
+        if( governed_delay_s < period_left_s )
+        {
+            governed_delay_s = period_left_s;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    return ( governed_delay_s > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) governed_delay_s;
+}
+
+uint8_t energy_governor_get_nb_trans( const energy_governor_t* eg, uint8_t nb_trans )
+{
+    switch( eg->level )
+    {
+    case ENERGY_GOVERNOR_LEVEL_SAVING:
+        nb_trans = ( nb_trans + 1 ) / 2;
+        break;
+    case ENERGY_GOVERNOR_LEVEL_CRITICAL:
+    case ENERGY_GOVERNOR_LEVEL_EXHAUSTED:
+        nb_trans = 1;
+        break;
+    default:
+        break;
+    }
+    return ( nb_trans == 0 ) ? 1 : nb_trans;
+}
+
+bool energy_governor_is_optional_allowed( const energy_governor_t* eg )
+{
+    return eg->level == ENERGY_GOVERNOR_LEVEL_NORMAL;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint64_t energy_governor_get_total_ua_ms( const energy_governor_t* eg )
+{
+    uint64_t total_ua_ms = 0;
+
+    for( uint8_t i = 0; i < ENERGY_GOVERNOR_ACTIVITY_NUMBER; i++ )
+    {
+        total_ua_ms += eg->spent_ua_ms[i];
+    }
+    return total_ua_ms;
+}
+
+static energy_governor_level_t energy_governor_compute_level( const energy_governor_t* eg )
+{
+    if( eg->budget_uah == 0 )
+    {
+        return ENERGY_GOVERNOR_LEVEL_NORMAL;
+    }
+
+    uint64_t budget_ua_ms = ( uint64_t ) eg->budget_uah * ENERGY_GOVERNOR_UA_MS_PER_UAH;
+    uint64_t spent_ua_ms  = energy_governor_get_total_ua_ms( eg );
+
+    if( spent_ua_ms >= budget_ua_ms )
+    {
+        return ENERGY_GOVERNOR_LEVEL_EXHAUSTED;
+    }
+    if( ( spent_ua_ms * 1000 ) >= ( budget_ua_ms * ENERGY_GOVERNOR_CRITICAL_PER_MILLE ) )
+    {
+        return ENERGY_GOVERNOR_LEVEL_CRITICAL;
+    }
+    if( ( spent_ua_ms * 1000 ) >= ( budget_ua_ms * ENERGY_GOVERNOR_SAVING_PER_MILLE ) )
+    {
+        return ENERGY_GOVERNOR_LEVEL_SAVING;
+    }
+    return ENERGY_GOVERNOR_LEVEL_NORMAL;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
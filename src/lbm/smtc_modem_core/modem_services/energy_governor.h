@@ -0,0 +1,206 @@
+/*!
+ * \file      energy_governor.h
+ *
+ * \brief     Per-period energy budget and the degradation policy applied when it runs out
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ENERGY_GOVERNOR_H__
+#define __ENERGY_GOVERNOR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+// clang-format off
+#define ENERGY_GOVERNOR_DEFAULT_PERIOD_S                  ( 86400UL )  // one day
+#define ENERGY_GOVERNOR_SAVING_PER_MILLE                  ( 500 )      // budget share spent before saving
+#define ENERGY_GOVERNOR_CRITICAL_PER_MILLE                ( 800 )      // budget share spent before critical
+#define ENERGY_GOVERNOR_SAVING_SCAN_DELAY_FACTOR          ( 2 )
+#define ENERGY_GOVERNOR_CRITICAL_SCAN_DELAY_FACTOR        ( 4 )
+#define ENERGY_GOVERNOR_CRITICAL_MIN_SCAN_DELAY_S         ( 300 )      // a critical scan is never immediate
+#define ENERGY_GOVERNOR_UA_MS_PER_UAH                     ( 3600000ULL )
+// clang-format on
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Activities the budget is spent on
+ */
+typedef enum energy_governor_activity_e
+{
+    ENERGY_GOVERNOR_ACTIVITY_UPLINK,
+    ENERGY_GOVERNOR_ACTIVITY_DOWNLINK,
+    ENERGY_GOVERNOR_ACTIVITY_GNSS,
+    ENERGY_GOVERNOR_ACTIVITY_WIFI,
+    ENERGY_GOVERNOR_ACTIVITY_NUMBER
+} energy_governor_activity_t;
+
+/**
+ * @brief Degradation levels, from the share of the budget spent in the current period
+ */
+typedef enum energy_governor_level_e
+{
+    ENERGY_GOVERNOR_LEVEL_NORMAL,     // below ENERGY_GOVERNOR_SAVING_PER_MILLE, or no budget set
+    ENERGY_GOVERNOR_LEVEL_SAVING,     // scans stretched, retransmissions halved, optional reports skipped
+    ENERGY_GOVERNOR_LEVEL_CRITICAL,   // scans stretched further, a single transmission per uplink
+    ENERGY_GOVERNOR_LEVEL_EXHAUSTED,  // scans deferred to the next period
+} energy_governor_level_t;
+
+/**
+ * @brief Governor state - don't modify it
+ */
+typedef struct energy_governor_s
+{
+    uint32_t                budget_uah;  // 0 when the governor is disabled
+    uint32_t                period_s;
+    uint32_t                period_start_s;
+    uint64_t                spent_ua_ms[ENERGY_GOVERNOR_ACTIVITY_NUMBER];
+    energy_governor_level_t level;
+} energy_governor_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Init the governor, disabled until a budget is set
+ *
+ * @param eg Governor
+ */
+void energy_governor_init( energy_governor_t* eg );
+
+/**
+ * @brief Set the budget and start a new period, the spend is cleared
+ *
+ * @param eg          Governor
+ * @param budget_uah  Charge allowed per period in µAh, 0 disables the governor
+ * @param period_s    Period length in seconds, 0 selects ENERGY_GOVERNOR_DEFAULT_PERIOD_S
+ * @param now_s       Current time in seconds
+ */
+void energy_governor_set_budget( energy_governor_t* eg, uint32_t budget_uah, uint32_t period_s, uint32_t now_s );
+
+/**
+ * @brief Account a charge to an activity, the level is only re-evaluated by energy_governor_update
+ *
+ * @param eg            Governor
+ * @param activity      Activity the charge is spent on
+ * @param charge_ua_ms  Charge in µA.ms
+ */
+void energy_governor_add_charge( energy_governor_t* eg, energy_governor_activity_t activity, uint64_t charge_ua_ms );
+
+/**
+ * @brief Start a new period when the current one is over and re-evaluate the level
+ *
+ * @param eg    Governor
+ * @param now_s Current time in seconds
+ * @return true if the level changed
+ */
+bool energy_governor_update( energy_governor_t* eg, uint32_t now_s );
+
+/**
+ * @brief Get the level computed by the last energy_governor_update
+ *
+ * @param eg Governor
+ * @return energy_governor_level_t
+ */
+energy_governor_level_t energy_governor_get_level( const energy_governor_t* eg );
+
+/**
+ * @brief Get the charge spent by an activity in the current period
+ *
+ * @param eg        Governor
+ * @param activity  Activity
+ * @return uint32_t Charge in µAh
+ */
+uint32_t energy_governor_get_spent_uah( const energy_governor_t* eg, energy_governor_activity_t activity );
+
+/**
+ * @brief Get the charge left in the current period
+ *
+ * @param eg        Governor
+ * @return uint32_t Charge in µAh, 0 once exhausted or when the governor is disabled
+ */
+uint32_t energy_governor_get_remaining_uah( const energy_governor_t* eg );
+
+/**
+ * @brief Stretch the delay before a scan according to the level
+ *
+ * @param eg        Governor
+ * @param delay_s   Delay requested by the application
+ * @param now_s     Current time in seconds
+ * @return uint32_t Delay to apply
+ */
+uint32_t energy_governor_get_scan_delay_s( const energy_governor_t* eg, uint32_t delay_s, uint32_t now_s );
+
+/**
+ * @brief Reduce the number of transmissions of an uplink according to the level
+ *
+ * @param eg        Governor
+ * @param nb_trans  Number of transmissions configured
+ * @return uint8_t  Number of transmissions to apply, never 0
+ */
+uint8_t energy_governor_get_nb_trans( const energy_governor_t* eg, uint8_t nb_trans );
+
+/**
+ * @brief Tell whether optional traffic, like periodic reports, may still be sent
+ *
+ * @param eg Governor
+ * @return bool
+ */
+bool energy_governor_is_optional_allowed( const energy_governor_t* eg );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __ENERGY_GOVERNOR_H__
+
+/* --- EOF ------------------------------------------------------------------ */
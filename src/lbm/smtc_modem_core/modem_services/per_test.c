@@ -0,0 +1,390 @@
+/*!
+ * \file      per_test.c
+ *
+ * \brief     Packet error rate bench: sequence-numbered test frames and the receiver statistics
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>
+
+#include "per_test.h"
+#include "modem_utilities.h"  // for crc
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+// Frame layout, multi-byte fields are big endian, the crc covers everything before it
+#define PER_TEST_FRAME_MAGIC_INDEX ( 0 )
+#define PER_TEST_FRAME_NB_STEPS_INDEX ( 1 )
+#define PER_TEST_FRAME_STEP_INDEX ( 2 )
+#define PER_TEST_FRAME_POWER_START_INDEX ( 3 )
+#define PER_TEST_FRAME_POWER_STEP_INDEX ( 4 )
+#define PER_TEST_FRAME_NB_FRAMES_INDEX ( 5 )
+#define PER_TEST_FRAME_SEQ_INDEX ( 7 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+static bool per_test_is_seq_received( per_test_step_t* step, uint16_t seq );
+
+static void per_test_distribution_init( per_test_distribution_t* distribution );
+
+static void per_test_distribution_add( per_test_distribution_t* distribution, int16_t value, int16_t bin_min,
+                                       int16_t bin_width );
+
+static int16_t per_test_distribution_get_percentile( const per_test_distribution_t* distribution, int16_t bin_min,
+                                                     int16_t bin_width, uint8_t percent );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+bool per_test_tx_init( per_test_tx_t* tx, uint16_t nb_frames, int8_t power_start_dbm, int8_t power_stop_dbm,
+                       int8_t power_step_db )
+{
+    memset( tx, 0, sizeof( per_test_tx_t ) );
+
+    if( nb_frames == 0 )
+    {
+        return false;
+    }
+
+    int16_t span_db  = ( int16_t ) power_stop_dbm - power_start_dbm;
+    int16_t nb_steps = 1;
+    if( power_step_db == 0 )
+    {
+        if( span_db != 0 )
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if( ( span_db != 0 ) && ( ( span_db < 0 ) != ( power_step_db < 0 ) ) )
+        {
+            return false;
+        }
+        nb_steps += span_db / power_step_db;
+    }
+    if( nb_steps > PER_TEST_MAX_STEPS )
+    {
+        return false;
+    }
+
+    tx->nb_frames       = nb_frames;
+    tx->nb_steps        = ( uint8_t ) nb_steps;
+    tx->power_start_dbm = power_start_dbm;
+    tx->power_step_db   = power_step_db;
+    return true;
+}
+
+bool per_test_tx_get_next( per_test_tx_t* tx, uint8_t* buffer, uint8_t length, int8_t* power_dbm )
+{
+    if( ( tx->step >= tx->nb_steps ) || ( length < PER_TEST_FRAME_MIN_LENGTH ) )
+    {
+        return false;
+    }
+
+    buffer[PER_TEST_FRAME_MAGIC_INDEX]         = PER_TEST_FRAME_MAGIC;
+    buffer[PER_TEST_FRAME_NB_STEPS_INDEX]      = tx->nb_steps;
+    buffer[PER_TEST_FRAME_STEP_INDEX]          = tx->step;
+    buffer[PER_TEST_FRAME_POWER_START_INDEX]   = ( uint8_t ) tx->power_start_dbm;
+    buffer[PER_TEST_FRAME_POWER_STEP_INDEX]    = ( uint8_t ) tx->power_step_db;
+    buffer[PER_TEST_FRAME_NB_FRAMES_INDEX]     = ( uint8_t )( tx->nb_frames >> 8 );
+    buffer[PER_TEST_FRAME_NB_FRAMES_INDEX + 1] = ( uint8_t ) tx->nb_frames;
+    buffer[PER_TEST_FRAME_SEQ_INDEX]           = ( uint8_t )( tx->seq >> 8 );
+    buffer[PER_TEST_FRAME_SEQ_INDEX + 1]       = ( uint8_t ) tx->seq;
+
+    // Filler differs from frame to frame so that the crc also covers bit patterns of the payload
+    for( uint8_t i = PER_TEST_FRAME_HEADER_LENGTH; i < length - 4; i++ )
+    {
+        buffer[i] = ( uint8_t )( tx->seq * 7 + tx->step * 29 + i * 13 );
+    }
+
+    uint32_t frame_crc = crc( buffer, length - 4 );
+    buffer[length - 4] = ( uint8_t )( frame_crc >> 24 );
+    buffer[length - 3] = ( uint8_t )( frame_crc >> 16 );
+    buffer[length - 2] = ( uint8_t )( frame_crc >> 8 );
+    buffer[length - 1] = ( uint8_t ) frame_crc;
+
+    *power_dbm = ( int8_t )( tx->power_start_dbm + tx->step * tx->power_step_db );
+
+    tx->seq++;
+    if( tx->seq >= tx->nb_frames )
+    {
+        tx->seq = 0;
+        tx->step++;
+    }
+    return true;
+}
+
+uint32_t per_test_tx_get_nb_built( const per_test_tx_t* tx )
+{
+    return ( uint32_t ) tx->step * tx->nb_frames + tx->seq;
+}
+
+void per_test_rx_init( per_test_rx_t* rx )
+{
+    memset( rx, 0, sizeof( per_test_rx_t ) );
+    for( uint8_t i = 0; i < PER_TEST_MAX_STEPS; i++ )
+    {
+        per_test_distribution_init( &rx->steps[i].rssi );
+        per_test_distribution_init( &rx->steps[i].snr );
+    }
+}
+
+per_test_frame_status_t per_test_rx_add_frame( per_test_rx_t* rx, const uint8_t* buffer, uint8_t length,
+                                               int16_t rssi_dbm, int16_t snr_db )
+{
+    if( ( length < PER_TEST_FRAME_MIN_LENGTH ) || ( buffer[PER_TEST_FRAME_MAGIC_INDEX] != PER_TEST_FRAME_MAGIC ) )
+    {
+        rx->nb_foreign++;
+        return PER_TEST_FRAME_FOREIGN;
+    }
+
+    uint32_t frame_crc = ( ( uint32_t ) buffer[length - 4] << 24 ) | ( ( uint32_t ) buffer[length - 3] << 16 ) |
+                         ( ( uint32_t ) buffer[length - 2] << 8 ) | buffer[length - 1];
+    uint8_t  nb_steps  = buffer[PER_TEST_FRAME_NB_STEPS_INDEX];
+    uint8_t  step      = buffer[PER_TEST_FRAME_STEP_INDEX];
+    uint16_t nb_frames = ( ( uint16_t ) buffer[PER_TEST_FRAME_NB_FRAMES_INDEX] << 8 ) |
+                         buffer[PER_TEST_FRAME_NB_FRAMES_INDEX + 1];
+    uint16_t seq       = ( ( uint16_t ) buffer[PER_TEST_FRAME_SEQ_INDEX] << 8 ) | buffer[PER_TEST_FRAME_SEQ_INDEX + 1];
+
+    if( ( frame_crc != crc( buffer, length - 4 ) ) || ( nb_steps > PER_TEST_MAX_STEPS ) || ( step >= nb_steps ) ||
+        ( seq >= nb_frames ) )
+    {
+        per_test_rx_add_crc_error( rx );
+        return PER_TEST_FRAME_CORRUPTED;
+    }
+
+    if( rx->plan_known == false )
+    {
+        rx->plan_known      = true;
+        rx->nb_steps        = nb_steps;
+        rx->nb_frames       = nb_frames;
+        rx->power_start_dbm = ( int8_t ) buffer[PER_TEST_FRAME_POWER_START_INDEX];
+        rx->power_step_db   = ( int8_t ) buffer[PER_TEST_FRAME_POWER_STEP_INDEX];
+    }
+    else if( ( nb_steps != rx->nb_steps ) || ( nb_frames != rx->nb_frames ) )
+    {
+        // Valid frame of another bench, its statistics would not add up with ours
+        rx->nb_foreign++;
+        return PER_TEST_FRAME_FOREIGN;
+    }
+
+    if( per_test_is_seq_received( &rx->steps[step], seq ) == true )
+    {
+        if( rx->steps[step].nb_duplicated < UINT16_MAX )
+        {
+            rx->steps[step].nb_duplicated++;
+        }
+        return PER_TEST_FRAME_DUPLICATED;
+    }
+
+    rx->step = step;
+    rx->steps[step].nb_received++;
+    per_test_distribution_add( &rx->steps[step].rssi, rssi_dbm, PER_TEST_RSSI_BIN_MIN_DBM, PER_TEST_RSSI_BIN_WIDTH_DB );
+    per_test_distribution_add( &rx->steps[step].snr, snr_db, PER_TEST_SNR_BIN_MIN_DB, PER_TEST_SNR_BIN_WIDTH_DB );
+    return PER_TEST_FRAME_VALID;
+}
+
+void per_test_rx_add_crc_error( per_test_rx_t* rx )
+{
+    // The step of a broken frame cannot be trusted, the receiver is most likely still on the last valid one
+    if( rx->steps[rx->step].nb_corrupted < UINT16_MAX )
+    {
+        rx->steps[rx->step].nb_corrupted++;
+    }
+}
+
+uint16_t per_test_rx_get_nb_lost( const per_test_rx_t* rx, uint8_t step )
+{
+    if( ( rx->plan_known == false ) || ( step >= rx->nb_steps ) )
+    {
+        return 0;
+    }
+    return rx->nb_frames - rx->steps[step].nb_received;
+}
+
+int8_t per_test_rx_get_power_dbm( const per_test_rx_t* rx, uint8_t step )
+{
+    return ( int8_t )( rx->power_start_dbm + step * rx->power_step_db );
+}
+
+int16_t per_test_get_rssi_percentile( const per_test_step_t* step, uint8_t percent )
+{
+    return per_test_distribution_get_percentile( &step->rssi, PER_TEST_RSSI_BIN_MIN_DBM, PER_TEST_RSSI_BIN_WIDTH_DB,
+                                                 percent );
+}
+
+int16_t per_test_get_snr_percentile( const per_test_step_t* step, uint8_t percent )
+{
+    return per_test_distribution_get_percentile( &step->snr, PER_TEST_SNR_BIN_MIN_DB, PER_TEST_SNR_BIN_WIDTH_DB,
+                                                 percent );
+}
+
+int16_t per_test_get_mean( const per_test_distribution_t* distribution )
+{
+    if( distribution->nb_samples == 0 )
+    {
+        return 0;
+    }
+    return ( int16_t )( distribution->sum / distribution->nb_samples );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static bool per_test_is_seq_received( per_test_step_t* step, uint16_t seq )
+{
+    if( step->nb_received == 0 )
+    {
+        step->highest_seq = seq;
+        step->seq_window  = 1;
+        return false;
+    }
+
+    if( seq > step->highest_seq )
+    {
+        uint16_t shift    = seq - step->highest_seq;
+        step->seq_window  = ( shift < PER_TEST_DUPLICATE_WINDOW ) ? ( step->seq_window << shift ) | 1 : 1;
+        step->highest_seq = seq;
+        return false;
+    }
+
+    uint16_t age = step->highest_seq - seq;
+    if( age >= PER_TEST_DUPLICATE_WINDOW )
+    {
+        // The transmitter never goes back, a frame this old can only be a replay
+        return true;
+    }
+    if( ( step->seq_window & ( 1UL << age ) ) != 0 )
+    {
+        return true;
+    }
+    step->seq_window |= ( 1UL << age );
+    return false;
+}
+
+static void per_test_distribution_init( per_test_distribution_t* distribution )
+{
+    memset( distribution, 0, sizeof( per_test_distribution_t ) );
+    distribution->min = INT16_MAX;
+    distribution->max = INT16_MIN;
+}
+
+static void per_test_distribution_add( per_test_distribution_t* distribution, int16_t value, int16_t bin_min,
+                                       int16_t bin_width )
+{
+    distribution->nb_samples++;
+    distribution->sum += value;
+    if( value < distribution->min )
+    {
+        distribution->min = value;
+    }
+    if( value > distribution->max )
+    {
+        distribution->max = value;
+    }
+
+    int32_t bin = ( ( int32_t ) value - bin_min ) / bin_width;
+    if( bin < 0 )
+    {
+        bin = 0;
+    }
+    else if( bin >= PER_TEST_NB_BINS )
+    {
+        bin = PER_TEST_NB_BINS - 1;
+    }
+    distribution->histogram[bin]++;
+}
+
+static int16_t per_test_distribution_get_percentile( const per_test_distribution_t* distribution, int16_t bin_min,
+                                                     int16_t bin_width, uint8_t percent )
+{
+    if( distribution->nb_samples == 0 )
+    {
+        return 0;
+    }
+
+    uint32_t total = 0;
+    for( uint8_t i = 0; i < PER_TEST_NB_BINS; i++ )
+    {
+        total += distribution->histogram[i];
+    }
+
+    uint32_t target = ( total * percent + 99 ) / 100;
+    uint32_t count  = 0;
+    uint8_t  bin    = 0;
+    for( ; bin < PER_TEST_NB_BINS - 1; bin++ )
+    {
+        count += distribution->histogram[bin];
+        if( count >= target )
+        {
+            break;
+        }
+    }
+
+    // Middle of the bin, within the observed range
+    int16_t value = bin_min + bin * bin_width + bin_width / 2;
+    if( value < distribution->min )
+    {
+        value = distribution->min;
+    }
+    if( value > distribution->max )
+    {
+        value = distribution->max;
+    }
+    return value;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
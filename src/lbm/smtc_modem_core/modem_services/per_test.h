@@ -0,0 +1,255 @@
+/*!
+ * \file      per_test.h
+ *
+ * \brief     Packet error rate bench: sequence-numbered test frames and the receiver statistics
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PER_TEST_H__
+#define __PER_TEST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+// clang-format off
+#define PER_TEST_MAX_STEPS              ( 16 )    // power levels of a sweep
+#define PER_TEST_FRAME_HEADER_LENGTH    ( 9 )
+#define PER_TEST_FRAME_MIN_LENGTH       ( PER_TEST_FRAME_HEADER_LENGTH + 4 )  // header and crc
+#define PER_TEST_FRAME_MAGIC            ( 0xB5 )
+#define PER_TEST_DUPLICATE_WINDOW       ( 32 )    // sequence numbers remembered behind the highest one
+#define PER_TEST_NB_BINS                ( 36 )    // rssi from -140 to +4 dBm, the whole receiver range
+#define PER_TEST_RSSI_BIN_MIN_DBM       ( -140 )  // lower edge of the first bin, lower values go to it
+#define PER_TEST_RSSI_BIN_WIDTH_DB      ( 4 )
+#define PER_TEST_SNR_BIN_MIN_DB         ( -24 )
+#define PER_TEST_SNR_BIN_WIDTH_DB       ( 2 )
+// clang-format on
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Outcome of a received frame
+ */
+typedef enum per_test_frame_status_e
+{
+    PER_TEST_FRAME_VALID,       // first reception of a sequence number
+    PER_TEST_FRAME_DUPLICATED,  // sequence number already received
+    PER_TEST_FRAME_CORRUPTED,   // test frame whose check fails, or a radio crc error
+    PER_TEST_FRAME_FOREIGN,     // not a test frame
+} per_test_frame_status_t;
+
+/**
+ * @brief Transmitter state - don't modify it
+ */
+typedef struct per_test_tx_s
+{
+    uint16_t nb_frames;        // per step
+    uint8_t  nb_steps;
+    int8_t   power_start_dbm;
+    int8_t   power_step_db;
+    uint8_t  step;             // step of the next frame
+    uint16_t seq;              // sequence number of the next frame
+} per_test_tx_t;
+
+/**
+ * @brief Distribution of a per-frame measurement
+ */
+typedef struct per_test_distribution_s
+{
+    uint16_t nb_samples;
+    int16_t  min;
+    int16_t  max;
+    int32_t  sum;
+    uint16_t histogram[PER_TEST_NB_BINS];
+} per_test_distribution_t;
+
+/**
+ * @brief Receiver statistics of one step - don't modify it
+ */
+typedef struct per_test_step_s
+{
+    uint16_t                nb_received;    // valid frames
+    uint16_t                nb_duplicated;
+    uint16_t                nb_corrupted;
+    uint16_t                highest_seq;
+    uint32_t                seq_window;     // bit n set when highest_seq - n was received
+    per_test_distribution_t rssi;
+    per_test_distribution_t snr;
+} per_test_step_t;
+
+/**
+ * @brief Receiver state - don't modify it
+ */
+typedef struct per_test_rx_s
+{
+    bool            plan_known;       // a valid frame told the transmitter plan
+    uint16_t        nb_frames;        // per step, from the plan
+    uint8_t         nb_steps;         // from the plan
+    int8_t          power_start_dbm;  // from the plan
+    int8_t          power_step_db;    // from the plan
+    uint8_t         step;             // step of the last valid frame, corrupted frames are charged to it
+    uint32_t        nb_foreign;
+    per_test_step_t steps[PER_TEST_MAX_STEPS];
+} per_test_rx_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Init a transmitter sending nb_frames at each power from power_start_dbm to power_stop_dbm
+ *
+ * @param tx               Transmitter
+ * @param nb_frames        Frames per step
+ * @param power_start_dbm  Power of the first step
+ * @param power_stop_dbm   Power of the last step, reached or not overshot
+ * @param power_step_db    Power change between two steps, 0 when start and stop are equal
+ * @return false if the plan is invalid or has more than PER_TEST_MAX_STEPS steps
+ */
+bool per_test_tx_init( per_test_tx_t* tx, uint16_t nb_frames, int8_t power_start_dbm, int8_t power_stop_dbm,
+                       int8_t power_step_db );
+
+/**
+ * @brief Build the next frame of the plan
+ *
+ * @param tx         Transmitter
+ * @param buffer     Frame buffer
+ * @param length     Frame length, at least PER_TEST_FRAME_MIN_LENGTH
+ * @param power_dbm  Power to send the frame at
+ * @return false once all the frames are built
+ */
+bool per_test_tx_get_next( per_test_tx_t* tx, uint8_t* buffer, uint8_t length, int8_t* power_dbm );
+
+/**
+ * @brief Get the number of frames built so far
+ *
+ * @param tx Transmitter
+ * @return uint32_t
+ */
+uint32_t per_test_tx_get_nb_built( const per_test_tx_t* tx );
+
+/**
+ * @brief Init a receiver, the plan is learnt from the first valid frame
+ *
+ * @param rx Receiver
+ */
+void per_test_rx_init( per_test_rx_t* rx );
+
+/**
+ * @brief Account a received frame
+ *
+ * @param rx        Receiver
+ * @param buffer    Frame
+ * @param length    Frame length
+ * @param rssi_dbm  Packet rssi
+ * @param snr_db    Packet snr
+ * @return per_test_frame_status_t
+ */
+per_test_frame_status_t per_test_rx_add_frame( per_test_rx_t* rx, const uint8_t* buffer, uint8_t length,
+                                               int16_t rssi_dbm, int16_t snr_db );
+
+/**
+ * @brief Account a frame dropped by the radio on a crc or header error
+ *
+ * @param rx Receiver
+ */
+void per_test_rx_add_crc_error( per_test_rx_t* rx );
+
+/**
+ * @brief Get the number of frames of a step that were never received valid
+ *
+ * @param rx    Receiver
+ * @param step  Step index
+ * @return uint16_t 0 until the plan is known
+ */
+uint16_t per_test_rx_get_nb_lost( const per_test_rx_t* rx, uint8_t step );
+
+/**
+ * @brief Get the power a step was sent at
+ *
+ * @param rx    Receiver
+ * @param step  Step index
+ * @return int8_t
+ */
+int8_t per_test_rx_get_power_dbm( const per_test_rx_t* rx, uint8_t step );
+
+/**
+ * @brief Get the packet rssi under which percent of the valid frames of a step fall
+ *
+ * @param step     Step statistics
+ * @param percent  Percentile
+ * @return int16_t Middle of the bin, within the observed range, 0 without frames
+ */
+int16_t per_test_get_rssi_percentile( const per_test_step_t* step, uint8_t percent );
+
+/**
+ * @brief Get the packet snr under which percent of the valid frames of a step fall
+ *
+ * @param step     Step statistics
+ * @param percent  Percentile
+ * @return int16_t Middle of the bin, within the observed range, 0 without frames
+ */
+int16_t per_test_get_snr_percentile( const per_test_step_t* step, uint8_t percent );
+
+/**
+ * @brief Get the mean of a distribution
+ *
+ * @param distribution  Distribution
+ * @return int16_t 0 without samples
+ */
+int16_t per_test_get_mean( const per_test_distribution_t* distribution );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __PER_TEST_H__
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,179 @@
+/*!
+ * \file      ranging_filter.c
+ *
+ * \brief     Ranging exchanges of a round: outlier rejection and averaging
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>
+
+#include "ranging_filter.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+static int32_t ranging_filter_get_median( int32_t* values, uint8_t nb_values );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void ranging_filter_init( ranging_filter_t* filter )
+{
+    memset( filter, 0, sizeof( ranging_filter_t ) );
+}
+
+bool ranging_filter_add_sample( ranging_filter_t* filter, int32_t distance_m, int16_t rssi_dbm )
+{
+    if( filter->nb_exchanges >= RANGING_FILTER_MAX_SAMPLES )
+    {
+        return false;
+    }
+    filter->distance_m[filter->nb_samples] = distance_m;
+    filter->rssi_dbm[filter->nb_samples]   = rssi_dbm;
+    filter->nb_samples++;
+    filter->nb_exchanges++;
+    return true;
+}
+
+bool ranging_filter_add_failure( ranging_filter_t* filter )
+{
+    if( filter->nb_exchanges >= RANGING_FILTER_MAX_SAMPLES )
+    {
+        return false;
+    }
+    filter->nb_exchanges++;
+    return true;
+}
+
+uint8_t ranging_filter_get_nb_exchanges( const ranging_filter_t* filter )
+{
+    return filter->nb_exchanges;
+}
+
+bool ranging_filter_get_result( const ranging_filter_t* filter, ranging_filter_result_t* result )
+{
+    int32_t work[RANGING_FILTER_MAX_SAMPLES];
+
+    memset( result, 0, sizeof( ranging_filter_result_t ) );
+    result->nb_exchanges = filter->nb_exchanges;
+    result->nb_samples   = filter->nb_samples;
+    if( filter->nb_samples == 0 )
+    {
+        return false;
+    }
+
+    memcpy( work, filter->distance_m, filter->nb_samples * sizeof( int32_t ) );
+    const int32_t median = ranging_filter_get_median( work, filter->nb_samples );
+
+    for( uint8_t i = 0; i < filter->nb_samples; i++ )
+    {
+        int32_t diff = filter->distance_m[i] - median;
+        work[i]      = ( diff < 0 ) ? -diff : diff;
+    }
+    result->deviation_m = ( uint32_t ) ranging_filter_get_median( work, filter->nb_samples );
+
+    uint32_t limit_m = ( result->deviation_m > RANGING_FILTER_MIN_DEVIATION_M ) ? result->deviation_m
+                                                                                : RANGING_FILTER_MIN_DEVIATION_M;
+    limit_m *= RANGING_FILTER_OUTLIER_FACTOR;
+
+    int64_t distance_sum = 0;
+    int32_t rssi_sum     = 0;
+    for( uint8_t i = 0; i < filter->nb_samples; i++ )
+    {
+        int32_t diff = filter->distance_m[i] - median;
+        if( ( uint32_t )( ( diff < 0 ) ? -diff : diff ) <= limit_m )
+        {
+            distance_sum += filter->distance_m[i];
+            rssi_sum += filter->rssi_dbm[i];
+            result->nb_kept++;
+        }
+    }
+
+    // Half of the samples at least are within one deviation of the median, so some are always kept
+    result->distance_m = ( int32_t )( distance_sum / result->nb_kept );
+    result->rssi_dbm   = ( int16_t )( rssi_sum / result->nb_kept );
+    result->quality    = ( uint8_t )( ( ( uint16_t ) result->nb_kept * 100 ) / filter->nb_exchanges );
+    return true;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static int32_t ranging_filter_get_median( int32_t* values, uint8_t nb_values )
+{
+    // Insertion sort, a round holds a few tens of samples
+    for( uint8_t i = 1; i < nb_values; i++ )
+    {
+        int32_t value = values[i];
+        uint8_t j     = i;
+        while( ( j > 0 ) && ( values[j - 1] > value ) )
+        {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = value;
+    }
+
+    if( ( nb_values & 1 ) != 0 )
+    {
+        return values[nb_values / 2];
+    }
+    // Halved separately so that the sum cannot overflow
+    return ( values[nb_values / 2 - 1] / 2 ) + ( values[nb_values / 2] / 2 ) +
+           ( ( values[nb_values / 2 - 1] % 2 ) + ( values[nb_values / 2] % 2 ) ) / 2;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,150 @@
+/*!
+ * \file      ranging_filter.h
+ *
+ * \brief     Ranging exchanges of a round: outlier rejection and averaging
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __RANGING_FILTER_H__
+#define __RANGING_FILTER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+// clang-format off
+#define RANGING_FILTER_MAX_SAMPLES      ( 32 )
+#define RANGING_FILTER_OUTLIER_FACTOR   ( 3 )   // samples further than this many deviations from the median are dropped
+#define RANGING_FILTER_MIN_DEVIATION_M  ( 2 )   // deviation floor, keeps close samples when most are identical
+// clang-format on
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Exchanges of a round - don't modify it
+ */
+typedef struct ranging_filter_s
+{
+    uint8_t nb_exchanges;  // attempted, answered or not
+    uint8_t nb_samples;    // answered
+    int32_t distance_m[RANGING_FILTER_MAX_SAMPLES];
+    int16_t rssi_dbm[RANGING_FILTER_MAX_SAMPLES];
+} ranging_filter_t;
+
+/**
+ * @brief Filtered result of a round
+ */
+typedef struct ranging_filter_result_s
+{
+    int32_t  distance_m;    // mean of the samples kept
+    uint32_t deviation_m;   // median absolute deviation of all the samples
+    int16_t  rssi_dbm;      // mean of the samples kept
+    uint8_t  nb_exchanges;
+    uint8_t  nb_samples;
+    uint8_t  nb_kept;
+    uint8_t  quality;       // nb_kept over nb_exchanges, in percent
+} ranging_filter_result_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Start a new round
+ *
+ * @param filter Filter
+ */
+void ranging_filter_init( ranging_filter_t* filter );
+
+/**
+ * @brief Account an answered exchange
+ *
+ * @param filter      Filter
+ * @param distance_m  Measured distance, calibrated
+ * @param rssi_dbm    Ranging rssi
+ * @return false if RANGING_FILTER_MAX_SAMPLES exchanges are already accounted
+ */
+bool ranging_filter_add_sample( ranging_filter_t* filter, int32_t distance_m, int16_t rssi_dbm );
+
+/**
+ * @brief Account an exchange the peer did not answer
+ *
+ * @param filter Filter
+ * @return false if RANGING_FILTER_MAX_SAMPLES exchanges are already accounted
+ */
+bool ranging_filter_add_failure( ranging_filter_t* filter );
+
+/**
+ * @brief Get the number of exchanges accounted
+ *
+ * @param filter Filter
+ * @return uint8_t
+ */
+uint8_t ranging_filter_get_nb_exchanges( const ranging_filter_t* filter );
+
+/**
+ * @brief Reject the outliers and average the remaining samples
+ *
+ * @remark A sample is kept when it is within RANGING_FILTER_OUTLIER_FACTOR median absolute deviations of the
+ * median, the deviation being at least RANGING_FILTER_MIN_DEVIATION_M
+ *
+ * @param filter  Filter
+ * @param result  Result, counters are filled even without samples
+ * @return false if no exchange was answered
+ */
+bool ranging_filter_get_result( const ranging_filter_t* filter, ranging_filter_result_t* result );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __RANGING_FILTER_H__
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -68,6 +68,11 @@
 
 #define CLOCK_SYNC_ALC_UPDATED_DELAY_S 3
 
+/**
+ * @brief Maximum delay between two corrections to compute their offset difference with the 32-bit ms rtc
+ */
+#define CLOCK_SYNC_DRIFT_MAX_GAP_S ( 4000000UL )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -84,6 +89,37 @@
  */
 void clock_sync_reset( clock_sync_ctx_t* ctx );
 
+/**
+ * @brief Forget all the corrections used by the drift estimator
+ *
+ * @param [in] ctx Clock sync pointer context
+ */
+static void clock_sync_drift_reset( clock_sync_ctx_t* ctx );
+
+/**
+ * @brief Add the last network correction to the drift estimator, if not already done, and update the estimation
+ *
+ * @param [in] ctx Clock sync pointer context
+ */
+static void clock_sync_drift_update( clock_sync_ctx_t* ctx );
+
+/**
+ * @brief Extrapolate a gps time from the last correction with the estimated drift
+ *
+ * @param [in]     ctx                Clock sync pointer context
+ * @param [in,out] gps_time_in_s      Gps time in second
+ * @param [in,out] fractional_second  Fractional second in ms
+ */
+static void clock_sync_drift_apply( clock_sync_ctx_t* ctx, uint32_t* gps_time_in_s, uint32_t* fractional_second );
+
+/**
+ * @brief Get the sync interval, stretched while the predicted time error stays below max_time_error_ms
+ *
+ * @param [in] ctx Clock sync pointer context
+ * @return uint32_t Interval in second
+ */
+static uint32_t clock_sync_get_adaptive_interval_second( clock_sync_ctx_t* ctx );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -104,6 +140,9 @@ void clock_sync_init( clock_sync_ctx_t* ctx, alc_sync_ctx_t* alc_ctx )
     ctx->fractional_second   = 0;
 
     ctx->alc_ctx = alc_ctx;
+
+    ctx->max_time_error_ms = 0;
+    clock_sync_drift_reset( ctx );
 }
 
 void clock_sync_set_enabled( clock_sync_ctx_t* ctx, bool enable, clock_sync_service_t sync_service )
@@ -177,6 +216,8 @@ void clock_sync_callback( clock_sync_ctx_t* ctx, uint32_t rx_timestamp_s )
         }
         else
         {
+            clock_sync_drift_update( ctx );
+
             if( ctx->sync_service_type == CLOCK_SYNC_ALC )
             {
                 // in case ALCSYNC is the selected service check if no downlink happened
@@ -201,7 +242,7 @@ void clock_sync_callback( clock_sync_ctx_t* ctx, uint32_t rx_timestamp_s )
 
             if( clock_sync_get_interval_second( ctx ) > 0 )
             {
-                interval_s = clock_sync_get_interval_second( ctx );
+                interval_s = clock_sync_get_adaptive_interval_second( ctx );
             }
         }
     }
@@ -259,11 +300,20 @@ bool clock_sync_get_gps_time_second( clock_sync_ctx_t* ctx, uint32_t* gps_time_i
         }
         else
         {
-            ret            = clock_sync_is_time_valid( ctx );
-            *gps_time_in_s = alc_sync_get_gps_time_second( ctx->alc_ctx );
-            // No fractional second feature is available in alcsync service
-            *fractional_second = 0;
+            // gps time of a single rtc sample shifted by the synchronised offset, the ms rtc is extended with the s rtc
+            // so that the sub-second part stays consistent with the seconds, also across a 32-bit ms wrap
+            uint32_t rtc_s  = smtc_modem_hal_get_time_in_s( );
+            uint32_t rtc_ms = smtc_modem_hal_get_time_in_ms( );
+            int64_t  gps_ms = ( ( int64_t ) rtc_s * 1000 ) + ( uint32_t )( rtc_ms - ( rtc_s * 1000 ) ) +
+                             ( ( int64_t ) alc_sync_get_time_correction_second( ctx->alc_ctx ) +
+                               smtc_modem_hal_get_time_compensation_in_s( ) ) *
+                                 1000;
+
+            ret                = clock_sync_is_time_valid( ctx );
+            *gps_time_in_s     = ( uint32_t )( gps_ms / 1000 );
+            *fractional_second = ( uint32_t )( gps_ms % 1000 );
         }
+        clock_sync_drift_apply( ctx, gps_time_in_s, fractional_second );
     }
 
     return ret;
@@ -271,6 +321,9 @@ bool clock_sync_get_gps_time_second( clock_sync_ctx_t* ctx, uint32_t* gps_time_i
 
 void clock_sync_set_gps_time( clock_sync_ctx_t* ctx, uint32_t gps_time_s )
 {
+    // a manual time is not a network correction, previous corrections can't be compared to the next ones
+    clock_sync_drift_reset( ctx );
+
     if( ctx->sync_service_type == CLOCK_SYNC_MAC )
     {
         ctx->seconds_since_epoch         = gps_time_s;
@@ -338,6 +391,8 @@ bool clock_sync_is_time_valid( clock_sync_ctx_t* ctx )
 
 void clock_sync_set_sync_lost( clock_sync_ctx_t* ctx )
 {
+    clock_sync_drift_reset( ctx );
+
     if( ctx->sync_service_type == CLOCK_SYNC_MAC )
     {
         ctx->sync_status                 = CLOCK_SYNC_NO_SYNC;
@@ -519,6 +574,23 @@ clock_sync_ret_t clock_sync_request( clock_sync_ctx_t* ctx )
     return ret;
 }
 
+bool clock_sync_get_drift( clock_sync_ctx_t* ctx, int32_t* drift_ppb, uint32_t* uncertainty_ppb )
+{
+    *drift_ppb       = ctx->drift_ppb;
+    *uncertainty_ppb = ctx->drift_uncertainty_ppb;
+    return ( ctx->drift_nb_samples >= CLOCK_SYNC_DRIFT_MIN_SAMPLES );
+}
+
+void clock_sync_set_max_time_error_ms( clock_sync_ctx_t* ctx, uint32_t max_time_error_ms )
+{
+    ctx->max_time_error_ms = max_time_error_ms;
+}
+
+uint32_t clock_sync_get_max_time_error_ms( clock_sync_ctx_t* ctx )
+{
+    return ctx->max_time_error_ms;
+}
+
 #if defined( CLOCK_SYNC_GPS_EPOCH_CONVERT )
 void clock_sync_convert_gps_epoch_to_unix_epoch( uint32_t gps_epoch )
 {
@@ -547,6 +619,176 @@ void clock_sync_reset( clock_sync_ctx_t* ctx )
     ctx->sync_status         = CLOCK_SYNC_NO_SYNC;
     ctx->seconds_since_epoch = 0;
     ctx->fractional_second   = 0;
+
+    clock_sync_drift_reset( ctx );
+}
+
+static void clock_sync_drift_reset( clock_sync_ctx_t* ctx )
+{
+    ctx->drift_nb_samples      = 0;
+    ctx->drift_last_index      = 0;
+    ctx->drift_ppb             = 0;
+    ctx->drift_uncertainty_ppb = 0;
+}
+
+static void clock_sync_drift_update( clock_sync_ctx_t* ctx )
+{
+    uint32_t sample_rtc_s;
+    uint32_t resolution_ms;
+    int64_t  gps_ms;
+    uint32_t rtc_ms;
+
+    // Take the gps and rtc time of the same instant, from the last correction
+    if( ctx->sync_service_type == CLOCK_SYNC_MAC )
+    {
+        uint32_t gps_s;
+        uint32_t fractional_ms;
+
+        sample_rtc_s  = lorawan_api_get_timestamp_last_device_time_ans_s( );
+        resolution_ms = CLOCK_SYNC_MAC_RESOLUTION_MS;
+        rtc_ms        = smtc_modem_hal_get_time_in_ms( );
+        lorawan_api_convert_rtc_to_gps_epoch_time( rtc_ms, &gps_s, &fractional_ms );
+        gps_ms = ( ( int64_t ) gps_s * 1000 ) + fractional_ms;
+    }
+    else
+    {
+        uint32_t rtc_s = smtc_modem_services_get_time_s( );
+
+        sample_rtc_s  = alc_sync_get_timestamp_last_correction_s( ctx->alc_ctx );
+        resolution_ms = CLOCK_SYNC_ALC_RESOLUTION_MS;
+        rtc_ms        = rtc_s * 1000;
+        gps_ms        = ( ( int64_t ) rtc_s + alc_sync_get_time_correction_second( ctx->alc_ctx ) ) * 1000;
+    }
+
+    if( sample_rtc_s == 0 )
+    {
+        return;
+    }
+
+    int32_t offset_ms = 0;
+    if( ctx->drift_nb_samples > 0 )
+    {
+        uint32_t last_sample_rtc_s = ctx->drift_sample_rtc_s[ctx->drift_last_index];
+        if( sample_rtc_s == last_sample_rtc_s )
+        {
+            // No new correction since last update
+            return;
+        }
+        if( ( sample_rtc_s - last_sample_rtc_s ) > CLOCK_SYNC_DRIFT_MAX_GAP_S )
+        {
+            clock_sync_drift_reset( ctx );
+        }
+        else
+        {
+            // Offsets are accumulated differences, the 32-bit ms rtc may have wrapped since last correction
+            offset_ms = ctx->drift_sample_offset_ms[ctx->drift_last_index] +
+                        ( int32_t )( ( gps_ms - ctx->drift_last_gps_ms ) -
+                                     ( int64_t )( uint32_t )( rtc_ms - ctx->drift_last_rtc_ms ) );
+        }
+    }
+    ctx->drift_last_gps_ms = gps_ms;
+    ctx->drift_last_rtc_ms = rtc_ms;
+
+    if( ctx->drift_nb_samples > 0 )
+    {
+        ctx->drift_last_index = ( ctx->drift_last_index + 1 ) % CLOCK_SYNC_DRIFT_NB_SAMPLES;
+    }
+    ctx->drift_sample_rtc_s[ctx->drift_last_index]     = sample_rtc_s;
+    ctx->drift_sample_offset_ms[ctx->drift_last_index] = offset_ms;
+    if( ctx->drift_nb_samples < CLOCK_SYNC_DRIFT_NB_SAMPLES )
+    {
+        ctx->drift_nb_samples++;
+    }
+
+    if( ctx->drift_nb_samples < 2 )
+    {
+        return;
+    }
+
+    // Least square fit of the offset against the rtc, relative to the last correction
+    int64_t n      = ctx->drift_nb_samples;
+    int64_t sum_x  = 0;
+    int64_t sum_y  = 0;
+    int64_t sum_xx = 0;
+    int64_t sum_xy = 0;
+    int32_t span_s = 0;
+
+    for( uint8_t i = 0; i < ctx->drift_nb_samples; i++ )
+    {
+        int64_t x = ( int32_t )( ctx->drift_sample_rtc_s[i] - sample_rtc_s );
+        int64_t y = ctx->drift_sample_offset_ms[i] - offset_ms;
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+        span_s = MAX( span_s, ( int32_t ) -x );
+    }
+
+    int64_t sxx = ( n * sum_xx ) - ( sum_x * sum_x );
+    int64_t sxy = ( n * sum_xy ) - ( sum_x * sum_y );
+    if( ( span_s <= 0 ) || ( ( sxx / 100 ) == 0 ) )
+    {
+        return;
+    }
+
+    // ms per s to ppb, split to keep the products in range
+    int64_t drift_ppb = ( sxy * 10000 ) / ( sxx / 100 );
+    int64_t intercept = ( ( sum_y * 1000000 ) - ( drift_ppb * sum_x ) ) / ( n * 1000000 );
+
+    int64_t max_residual_ms = 0;
+    for( uint8_t i = 0; i < ctx->drift_nb_samples; i++ )
+    {
+        int64_t x        = ( int32_t )( ctx->drift_sample_rtc_s[i] - sample_rtc_s );
+        int64_t y        = ctx->drift_sample_offset_ms[i] - offset_ms;
+        int64_t residual = y - ( ( ( drift_ppb * x ) / 1000000 ) + intercept );
+        max_residual_ms  = MAX( max_residual_ms, ABS( residual ) );
+    }
+
+    ctx->drift_ppb = ( int32_t ) drift_ppb;
+    ctx->drift_uncertainty_ppb =
+        MAX( ( uint32_t )( ( ( max_residual_ms + resolution_ms ) * 1000000 ) / span_s ),
+             CLOCK_SYNC_DRIFT_MIN_UNCERTAINTY_PPB );
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Clock sync drift %d ppb +/- %u ppb (%u corrections)\n", ctx->drift_ppb,
+                                 ctx->drift_uncertainty_ppb, ctx->drift_nb_samples );
+}
+
+static void clock_sync_drift_apply( clock_sync_ctx_t* ctx, uint32_t* gps_time_in_s, uint32_t* fractional_second )
+{
+    if( ctx->drift_nb_samples < CLOCK_SYNC_DRIFT_MIN_SAMPLES )
+    {
+        return;
+    }
+
+    uint32_t elapsed_s = smtc_modem_hal_get_time_in_s( ) - ctx->drift_sample_rtc_s[ctx->drift_last_index];
+    int64_t  gps_ms    = ( ( int64_t ) *gps_time_in_s * 1000 ) + *fractional_second +
+                     ( ( ( int64_t ) ctx->drift_ppb * elapsed_s ) / 1000000 );
+
+    *gps_time_in_s     = ( uint32_t )( gps_ms / 1000 );
+    *fractional_second = ( uint32_t )( gps_ms % 1000 );
+}
+
+static uint32_t clock_sync_get_adaptive_interval_second( clock_sync_ctx_t* ctx )
+{
+    uint32_t interval_s = clock_sync_get_interval_second( ctx );
+    uint32_t resolution_ms =
+        ( ctx->sync_service_type == CLOCK_SYNC_MAC ) ? CLOCK_SYNC_MAC_RESOLUTION_MS : CLOCK_SYNC_ALC_RESOLUTION_MS;
+
+    if( ( ctx->max_time_error_ms <= resolution_ms ) || ( ctx->drift_nb_samples < CLOCK_SYNC_DRIFT_MIN_SAMPLES ) )
+    {
+        return interval_s;
+    }
+
+    // Predicted error grows with the uncertainty of the drift once it is compensated
+    uint32_t uncertainty_ppb = MAX( ctx->drift_uncertainty_ppb, CLOCK_SYNC_DRIFT_MIN_UNCERTAINTY_PPB );
+    uint64_t stretched_s = ( ( uint64_t )( ctx->max_time_error_ms - resolution_ms ) * 1000000 ) / uncertainty_ppb;
+
+    if( stretched_s > interval_s )
+    {
+        interval_s = ( stretched_s > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) stretched_s;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Clock sync interval stretched to %u s\n", interval_s );
+    }
+    return interval_s;
 }
 
 /* --- EOF ------------------------------------------------------------------ */
@@ -73,6 +73,12 @@ extern "C" {
 #define CLOCK_SYNC_PERIOD_RETRY                           ( 129600 )  // 36 hours
 
 
+#define CLOCK_SYNC_DRIFT_NB_SAMPLES                       ( 4 )       // corrections kept to estimate the rtc drift
+#define CLOCK_SYNC_DRIFT_MIN_SAMPLES                      ( 3 )       // corrections needed before the drift is used
+#define CLOCK_SYNC_DRIFT_MIN_UNCERTAINTY_PPB              ( 500 )     // floor of the drift uncertainty (0.5 ppm)
+#define CLOCK_SYNC_MAC_RESOLUTION_MS                      ( 4 )       // DeviceTimeAns fractional second is 1/256 s
+#define CLOCK_SYNC_ALC_RESOLUTION_MS                      ( 500 )     // AppTimeAns correction is rounded to 1 s
+
 #if defined( CLOCK_SYNC_GPS_EPOCH_CONVERT )
 #define CLOCK_SYNC_LEAP_SECOND                            ( -18 )
 #define CLOCK_SYNC_UNIX_GPS_EPOCH_OFFSET                  ( 315964800UL ) // 00:00:00, Sunday 6 th of January 1980 (start of the GPS epoch)
@@ -125,6 +131,17 @@ typedef struct clock_sync_ctx_s
 
     alc_sync_ctx_t* alc_ctx;
 
+    // Drift estimator, offsets are the gps minus rtc time at each network correction, relative to the first one
+    uint32_t drift_sample_rtc_s[CLOCK_SYNC_DRIFT_NB_SAMPLES];
+    int32_t  drift_sample_offset_ms[CLOCK_SYNC_DRIFT_NB_SAMPLES];
+    uint8_t  drift_nb_samples;
+    uint8_t  drift_last_index;
+    int64_t  drift_last_gps_ms;
+    uint32_t drift_last_rtc_ms;
+    int32_t  drift_ppb;
+    uint32_t drift_uncertainty_ppb;
+    uint32_t max_time_error_ms;  // 0: sync interval is not stretched
+
 } clock_sync_ctx_t;
 
 /*
@@ -303,6 +320,38 @@ uint32_t clock_sync_get_time_left_connection_lost( clock_sync_ctx_t* ctx );
  */
 clock_sync_ret_t clock_sync_request( clock_sync_ctx_t* ctx );
 
+/**
+ * @brief Get the rtc drift estimated over the successive network time corrections
+ *
+ * @remark A positive drift means the rtc is slow compared to the gps time
+ *
+ * @param [in]  ctx                 Clock sync pointer context
+ * @param [out] drift_ppb           Estimated drift in part per billion
+ * @param [out] uncertainty_ppb     Uncertainty of the estimated drift in part per billion
+ * @return true                     Enough corrections were received to estimate the drift
+ * @return false                    Drift is not estimated yet
+ */
+bool clock_sync_get_drift( clock_sync_ctx_t* ctx, int32_t* drift_ppb, uint32_t* uncertainty_ppb );
+
+/**
+ * @brief Set the maximum predicted time error allowed when stretching the sync interval
+ *
+ * @remark Once the drift is estimated, the interval between two time requests is stretched beyond the configured one
+ *         as long as the predicted error stays below this bound. 0 disables the stretching.
+ *
+ * @param [in] ctx                  Clock sync pointer context
+ * @param [in] max_time_error_ms    Maximum predicted time error in milliseconds
+ */
+void clock_sync_set_max_time_error_ms( clock_sync_ctx_t* ctx, uint32_t max_time_error_ms );
+
+/**
+ * @brief Get the maximum predicted time error allowed when stretching the sync interval
+ *
+ * @param [in] ctx                  Clock sync pointer context
+ * @return uint32_t                 Maximum predicted time error in milliseconds
+ */
+uint32_t clock_sync_get_max_time_error_ms( clock_sync_ctx_t* ctx );
+
 #if defined( CLOCK_SYNC_GPS_EPOCH_CONVERT )
 void clock_sync_convert_gps_epoch_to_unix_epoch( uint32_t gps_epoch );
 #endif
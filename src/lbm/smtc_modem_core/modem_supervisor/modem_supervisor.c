@@ -83,6 +83,7 @@
 #define MODEM_MAX_TIME 0x1FFFFF
 #define CALL_LR1MAC_PERIOD_MS 400
 #define MODEM_MAX_ALARM_S 0x7FFFFFFF
+#define MODEM_TASK_WDOG_DEADLINE_MS 3600000UL  // a task may wait for the duty cycle between its retransmissions
 
 #ifndef MODEM_MIN_RANDOM_DELAY_MS
 #define MODEM_MIN_RANDOM_DELAY_MS 200
@@ -315,7 +316,13 @@ void modem_supervisor_init_task( void )
         task_manager.modem_task[i].priority = TASK_FINISH;
         task_manager.modem_task[i].id       = ( task_id_t ) i;
     }
-    task_manager.next_task_id = IDLE_TASK;
+    task_manager.next_task_id    = IDLE_TASK;
+    task_manager.current_task_id = IDLE_TASK;
+}
+
+task_id_t modem_supervisor_get_current_task_id( void )
+{
+    return task_manager.current_task_id;
 }
 
 eTask_priority modem_supervisor_get_task_priority( task_id_t id )
@@ -366,6 +373,8 @@ eTask_valid_t modem_supervisor_add_task( smodem_task* task )
 void modem_supervisor_launch_task( task_id_t id )
 {
     status_lorawan_t send_status = ERRORLORAWAN;
+
+    task_manager.current_task_id = id;
     switch( id )
     {
     case JOIN_TASK:
@@ -457,6 +466,7 @@ void modem_supervisor_launch_task( task_id_t id )
                 }
                 else
                 {
+                    modem_context_discard_dm_report( );
                     SMTC_MODEM_HAL_TRACE_WARNING( "Periodic DM can't be send! internal code: %x\n", send_status );
                 }
             }
@@ -464,9 +474,25 @@ void modem_supervisor_launch_task( task_id_t id )
             {
                 if( ( get_modem_dm_interval_second( ) > 0 ) && ( modem_get_dm_info_bitfield_periodic( ) > 0 ) )
                 {
+                    energy_governor_t eg;
+                    modem_context_get_energy_governor( &eg );
+                    if( energy_governor_is_optional_allowed( &eg ) == false )
+                    {
+                        // nothing is staged, the next report carries the changes
+                        SMTC_MODEM_HAL_TRACE_PRINTF( "Periodic DM skipped, energy budget\n" );
+                        break;
+                    }
+
                     is_pending_dm_status_payload_periodic =
                         dm_status_payload( payload, &payload_length, max_payload, DM_INFO_PERIODIC );
 
+                    if( payload_length == 0 )
+                    {
+                        // changes only mode: no field has changed since the last report
+                        SMTC_MODEM_HAL_TRACE_PRINTF( "Periodic DM skipped, no change\n" );
+                        break;
+                    }
+
                     send_status =
                         lorawan_api_payload_send( get_modem_dm_port( ), true, payload, payload_length, UNCONF_DATA_UP,
                                                   smtc_modem_hal_get_time_in_ms( ) + MODEM_TASK_DELAY_MS );
@@ -478,6 +504,7 @@ void modem_supervisor_launch_task( task_id_t id )
                     }
                     else
                     {
+                        modem_context_discard_dm_report( );
                         SMTC_MODEM_HAL_TRACE_WARNING( "Periodic DM can't be send! internal code: %x\n", send_status );
                     }
                 }
@@ -741,6 +768,16 @@ void modem_supervisor_launch_task( task_id_t id )
     if( send_status == OKLORAWAN )
     {
         decrement_dm_retrieve_pending_dl( );
+
+        energy_governor_t eg;
+        modem_context_get_energy_governor( &eg );
+        lorawan_api_nb_trans_cpt_limit( energy_governor_get_nb_trans( &eg, lorawan_api_nb_trans_get( ) ) );
+    }
+
+    // the engine releases the watchdog client once the stack is idle again
+    if( lorawan_api_state_get( ) != LWPSTATE_IDLE )
+    {
+        smtc_modem_hal_wdog_heartbeat( WDOG_CLIENT_SUPERVISOR, MODEM_TASK_WDOG_DEADLINE_MS );
     }
 
     modem_supervisor_remove_task( id );
@@ -763,6 +800,7 @@ void modem_supervisor_update_task( task_id_t id )
 
             // reset dm tag number to prevent using wrong id
             modem_context_reset_dm_tag_number( );
+            modem_context_reset_dm_report_tracking( );
 
 #if defined( ADD_SMTC_ALC_SYNC )
             // If clock sync service activated => initiate a new request
@@ -800,6 +838,8 @@ void modem_supervisor_update_task( task_id_t id )
         }
         break;
     case DM_TASK:
+        // staged fields are discarded on send failure, what remains has been transmitted
+        modem_context_commit_dm_report( );
 
         if( get_modem_dm_interval_second( ) > 0 )
         {
@@ -1064,6 +1104,12 @@ uint32_t modem_supervisor_engine( void )
         }
     }
 
+    // charge the radio activity since the last call to the energy budget
+    modem_context_energy_governor_update( );
+
+    // keep the hal temperature reading fresh from the main loop, the class b beacon task reads it under interrupt
+    smtc_modem_hal_get_temperature( );
+
     // case Lorawan stack already in use
     LpState = lorawan_api_state_get( );
 
@@ -1072,6 +1118,7 @@ uint32_t modem_supervisor_engine( void )
         LpState = lorawan_api_process( );
         return ( CALL_LR1MAC_PERIOD_MS );
     }
+    smtc_modem_hal_wdog_release( WDOG_CLIENT_SUPERVISOR );
 
     backoff_mobile_static( );
     check_class_b_to_generate_event( );
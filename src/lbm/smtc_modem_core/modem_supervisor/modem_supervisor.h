@@ -211,6 +211,13 @@ void init_task( void );
 
 eTask_priority modem_supervisor_get_task_priority( task_id_t id );
 
+/*!
+ * \brief   Get the last task launched by the supervisor
+ * \remark  Used to record the modem state in the crash log
+ * \retval task_id_t IDLE_TASK if no task has been launched yet
+ */
+task_id_t modem_supervisor_get_current_task_id( void );
+
 /*!
  * \brief   Remove a task in supervisor
  * \param [in]  id   - Task id
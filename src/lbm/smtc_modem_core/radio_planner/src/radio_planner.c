@@ -210,9 +210,12 @@ void rp_init( radio_planner_t* rp, const ralf_t* radio )
     rp->priority_task.type  = RP_TASK_TYPE_NONE;
     rp->priority_task.state = RP_TASK_STATE_FINISHED;
     rp_stats_init( &rp->stats );
+    rp_energy_init( &rp->energy );
 
-    rp->next_state_status = RP_STATUS_NO_MORE_TASK_SCHEDULE;
-    rp->margin_delay      = RP_MARGIN_DELAY;
+    rp->next_state_status    = RP_STATUS_NO_MORE_TASK_SCHEDULE;
+    rp->margin_delay         = RP_MARGIN_DELAY;
+    rp->radio_config_hook_id = RP_NB_HOOKS;
+    rp->radio_kept_on        = false;
 }
 
 rp_hook_status_t rp_hook_init( radio_planner_t* rp, const uint8_t id, void ( *callback )( void* context ), void* hook )
@@ -388,6 +391,51 @@ rp_stats_t rp_get_stats( const radio_planner_t* rp )
     return rp->stats;
 }
 
+void rp_get_energy( const radio_planner_t* rp, rp_energy_t* energy )
+{
+    // Updated from the radio irq
+    rp_hal_critical_section_begin( );
+    *energy = rp->energy;
+    rp_hal_critical_section_end( );
+}
+
+void rp_reset_energy( radio_planner_t* rp )
+{
+    rp_hal_critical_section_begin( );
+    rp_energy_init( &rp->energy );
+    rp_hal_critical_section_end( );
+}
+
+void rp_energy_add_charge( radio_planner_t* rp, const uint8_t hook_id, const rp_energy_category_t category,
+                           const uint32_t charge_uah )
+{
+    if( ( hook_id >= RP_NB_HOOKS ) || ( category >= RP_ENERGY_CATEGORY_NUMBER ) )
+    {
+        smtc_modem_hal_mcu_panic( );
+        return;
+    }
+
+    rp_hal_critical_section_begin( );
+    rp_energy_update( &rp->energy, hook_id, category, 0, ( uint64_t ) charge_uah * 3600000 );
+    rp_hal_critical_section_end( );
+}
+
+bool rp_is_radio_configured_by( const radio_planner_t* rp, const uint8_t hook_id )
+{
+    return ( hook_id < RP_NB_HOOKS ) && ( rp->radio_config_hook_id == hook_id );
+}
+
+void rp_keep_radio_on( radio_planner_t* rp )
+{
+    rp->radio_kept_on = true;
+}
+
+void rp_invalidate_radio_config( radio_planner_t* rp )
+{
+    rp->radio_config_hook_id = RP_NB_HOOKS;
+    rp->radio_kept_on        = false;
+}
+
 void rp_radio_irq( radio_planner_t* rp )
 {
     if( rp->tasks[rp->radio_task_id].state < RP_TASK_STATE_ABORTED )
@@ -425,7 +473,11 @@ void rp_radio_irq( radio_planner_t* rp )
         // Have to call rp_task_free before rp_hook_callback because the callback can enqueued a task and so call the
         // arbiter
         rp_task_free( rp, &rp->tasks[rp->radio_task_id] );
-        smtc_modem_hal_assert( ral_set_sleep( &( rp->radio->ral ), true ) == RAL_STATUS_OK );
+        // The ranging results are read by the hook, which puts the radio to sleep afterwards
+        if( ( rp->tasks[rp->radio_task_id].type != RP_TASK_TYPE_RANGING ) && ( rp->radio_kept_on == false ) )
+        {
+            smtc_modem_hal_assert( ral_set_sleep( &( rp->radio->ral ), true ) == RAL_STATUS_OK );
+        }
         rp_hook_callback( rp, rp->radio_task_id );
 
         rp_task_call_aborted( rp );
@@ -613,8 +665,9 @@ static void rp_irq_get_status( radio_planner_t* rp, const uint8_t hook_id )
 {
     ral_irq_t radio_irq = 0;
 
+    // Ranging interrupts have no ral equivalent, the ranging service reads them itself
     if( ( rp->tasks[hook_id].type == RP_TASK_TYPE_LBT ) || ( rp->tasks[hook_id].type == RP_TASK_TYPE_WIFI_SNIFF ) ||
-        ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_SNIFF ) )
+        ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_SNIFF ) || ( rp->tasks[hook_id].type == RP_TASK_TYPE_RANGING ) )
     {
         return;
     }
@@ -721,7 +774,17 @@ static void rp_task_launch_current( radio_planner_t* rp )
     else
     {
         rp_task_print( rp, &rp->tasks[id] );
+        rp->launch_timestamp_ms[id] = rp_hal_get_time_in_ms( );
+        // A radio left running by another hook is stopped before it is configured again
+        if( ( rp->radio_kept_on == true ) && ( rp->radio_config_hook_id != id ) )
+        {
+            smtc_modem_hal_assert( ral_set_standby( &( rp->radio->ral ), RAL_STANDBY_CFG_RC ) == RAL_STATUS_OK );
+            smtc_modem_hal_assert( ral_set_sleep( &( rp->radio->ral ), true ) == RAL_STATUS_OK );
+        }
+        rp->radio_kept_on = false;
         rp->tasks[id].launch_task_callbacks( ( void* ) rp );
+        // Updated after the launch so that the callback can still check if the radio was left configured for it
+        rp->radio_config_hook_id = id;
     }
 }
 
@@ -908,12 +971,16 @@ static void rp_task_call_aborted( radio_planner_t* rp )
 
 void rp_radio_irq_callback( void* obj )
 {
+    rp_hal_wdog_heartbeat( RP_IRQ_WDOG_DEADLINE_MS );
     rp_radio_irq( ( radio_planner_t* ) obj );
+    rp_hal_wdog_release( );
 }
 
 static void rp_timer_irq_callback( void* obj )
 {
+    rp_hal_wdog_heartbeat( RP_IRQ_WDOG_DEADLINE_MS );
     rp_timer_irq( ( radio_planner_t* ) obj );
+    rp_hal_wdog_release( );
 }
 
 static void rp_hook_callback( radio_planner_t* rp, uint8_t id )
@@ -965,6 +1032,9 @@ static void rp_task_print( const radio_planner_t* rp, const rp_task_t* task )
     case RP_TASK_TYPE_CAD_TO_RX:
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( " TASK_CAD_TO_RX " );
         break;
+    case RP_TASK_TYPE_RANGING:
+        SMTC_MODEM_HAL_RP_TRACE_PRINTF( " TASK_RANGING " );
+        break;
     case RP_TASK_TYPE_NONE:
     case RP_TASK_TYPE_GNSS_SNIFF:
     case RP_TASK_TYPE_WIFI_SNIFF:
@@ -981,67 +1051,58 @@ static void rp_task_print( const radio_planner_t* rp, const rp_task_t* task )
 
 static void rp_consumption_statistics_updated( radio_planner_t* rp, const uint8_t hook_id, const uint32_t time )
 {
-    uint32_t micro_ampere_radio = 0, micro_ampere_process = 0;
-    uint32_t radio_t = 0, process_t = 0;
+    uint32_t             micro_ampere_radio = 0;
+    rp_energy_category_t category           = RP_ENERGY_CATEGORY_NUMBER;
 
+    // Currents come from the radio driver, calibrated by the board support package
     if( rp->tasks[hook_id].type == RP_TASK_TYPE_RX_LORA )
     {
         ral_get_lora_rx_consumption_in_ua( &( rp->radio->ral ), rp->radio_params[hook_id].rx.lora.mod_params.bw, false,
                                            &micro_ampere_radio );
+        category = RP_ENERGY_RX;
     }
-    else if( rp->tasks[hook_id].type == RP_TASK_TYPE_RX_FSK )
+    else if( ( rp->tasks[hook_id].type == RP_TASK_TYPE_RX_FSK ) || ( rp->tasks[hook_id].type == RP_TASK_TYPE_LBT ) )
     {
         ral_get_gfsk_rx_consumption_in_ua( &( rp->radio->ral ), rp->radio_params[hook_id].rx.gfsk.mod_params.br_in_bps,
                                            rp->radio_params[hook_id].rx.gfsk.mod_params.bw_dsb_in_hz, false,
                                            &micro_ampere_radio );
+        category = RP_ENERGY_RX;
     }
     else if( rp->tasks[hook_id].type == RP_TASK_TYPE_TX_LORA )
     {
         ral_get_tx_consumption_in_ua( &( rp->radio->ral ), rp->radio_params[hook_id].tx.lora.output_pwr_in_dbm,
                                       rp->radio_params[hook_id].tx.lora.rf_freq_in_hz, &micro_ampere_radio );
+        category = RP_ENERGY_TX;
     }
     else if( rp->tasks[hook_id].type == RP_TASK_TYPE_TX_FSK )
     {
         ral_get_tx_consumption_in_ua( &( rp->radio->ral ), rp->radio_params[hook_id].tx.gfsk.output_pwr_in_dbm,
                                       rp->radio_params[hook_id].tx.gfsk.rf_freq_in_hz, &micro_ampere_radio );
+        category = RP_ENERGY_TX;
     }
-    // else if( rp->tasks[hook_id].type == RP_TASK_TYPE_TX_LR_FHSS )  // TODO uncomment when LR-FHSS consumption will be
-    // developed
-    // {
-    //     ral_get_tx_consumption_in_ua( &( rp->radio->ral ), rp->radio_params[hook_id].tx.lr_fhss.output_pwr_in_dbm,
-    //                                   rp->radio_params[hook_id].tx.lr_fhss.ral_lr_fhss_params.rf_freq_in_hz,
-    //                                   &micro_ampere_radio );
-    // }
-#if defined( LR1110_MODEM_E ) && defined( _MODEM_E_GNSS_ENABLE )
-    else if( ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_SNIFF ) ||
-             ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_RSSI ) )
+    else if( rp->tasks[hook_id].type == RP_TASK_TYPE_TX_LR_FHSS )
     {
-        rp_hal_get_gnss_conso_us( &radio_t, &process_t );
-        micro_ampere_radio   = 10000;
-        micro_ampere_process = 5000;
+        // The Tx current only depends on the power amplifier setup, not on the modulation
+        ral_get_tx_consumption_in_ua( &( rp->radio->ral ), rp->radio_params[hook_id].tx.lr_fhss.output_pwr_in_dbm,
+                                      rp->radio_params[hook_id].tx.lr_fhss.ral_lr_fhss_params.center_frequency_in_hz,
+                                      &micro_ampere_radio );
+        category = RP_ENERGY_TX;
     }
-#endif  // LR1110_MODEM_E && _MODEM_E_GNSS_ENABLE
-
-#if defined( LR1110_MODEM_E ) && defined( _MODEM_E_WIFI_ENABLE )
-    else if( ( rp->tasks[hook_id].type == RP_TASK_TYPE_WIFI_SNIFF ) ||
-             ( rp->tasks[hook_id].type == RP_TASK_TYPE_WIFI_RSSI ) )
+    else if( rp->tasks[hook_id].type == RP_TASK_TYPE_RANGING )
     {
-        rp_hal_get_wifi_conso_us( &radio_t, &process_t );
-        micro_ampere_radio   = 11000;
-        micro_ampere_process = 3000;
+        // Both roles spend most of an exchange waiting for the peer
+        ral_get_lora_rx_consumption_in_ua( &( rp->radio->ral ), rp->radio_params[hook_id].rx.lora.mod_params.bw, false,
+                                           &micro_ampere_radio );
+        category = RP_ENERGY_RX;
     }
-#endif  // LR1110_MODEM_E && _MODEM_E_WIFI_ENABLE
+    // GNSS and Wi-Fi scans are charged by their owner with rp_energy_add_charge, from the transceiver timings
 
-    if( ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_SNIFF ) ||
-        ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_RSSI ) ||
-        ( rp->tasks[hook_id].type == RP_TASK_TYPE_WIFI_SNIFF ) ||
-        ( rp->tasks[hook_id].type == RP_TASK_TYPE_WIFI_RSSI ) )
+    if( category != RP_ENERGY_CATEGORY_NUMBER )
     {
-        rp_stats_sniff_update( &rp->stats, time, radio_t, process_t, hook_id, micro_ampere_radio,
-                               micro_ampere_process );
-    }
-    else
-    {
-        rp_stats_update( &rp->stats, time, hook_id, micro_ampere_radio );
+        // Measured from the launch, so that the tasks which don't update the stats timestamps are accounted too
+        uint32_t duration_ms = time - rp->launch_timestamp_ms[hook_id];
+        rp_energy_update( &rp->energy, hook_id, category, duration_ms, ( uint64_t ) duration_ms * micro_ampere_radio );
     }
+
+    rp_stats_update( &rp->stats, time, hook_id, micro_ampere_radio );
 }
@@ -84,7 +84,9 @@ typedef struct radio_planner_s
     ral_irq_t         raw_radio_irq[RP_NB_HOOKS];
     uint32_t          irq_timestamp_ms[RP_NB_HOOKS];
     uint32_t          irq_timestamp_100us[RP_NB_HOOKS];
+    uint32_t          launch_timestamp_ms[RP_NB_HOOKS];
     rp_stats_t        stats;
+    rp_energy_t       energy;
     uint8_t           hook_to_execute;
     uint32_t          hook_to_execute_time_ms;
     uint8_t           radio_task_id;
@@ -96,6 +98,8 @@ typedef struct radio_planner_s
     rp_next_state_status_t next_state_status;
     const ralf_t*          radio;
     uint32_t               margin_delay;
+    uint8_t                radio_config_hook_id;  // Hook which has configured the radio last, RP_NB_HOOKS if unknown
+    bool                   radio_kept_on;         // Radio left running by the hook of the last task
 } radio_planner_t;
 
 /*
@@ -153,6 +157,34 @@ rp_hook_status_t rp_task_abort( radio_planner_t* rp, const uint8_t hook_id );
  */
 rp_stats_t rp_get_stats( const radio_planner_t* rp );
 
+/*!
+ * Copy the energy accounting of all hooks
+ *
+ * \param [in]  rp     Radio planner data structure
+ * \param [out] energy Charge and radio time per hook since the last reset
+ */
+void rp_get_energy( const radio_planner_t* rp, rp_energy_t* energy );
+
+/*!
+ * Clear the energy accounting of all hooks
+ *
+ * \param [in] rp Radio planner data structure
+ */
+void rp_reset_energy( radio_planner_t* rp );
+
+/*!
+ * Add a charge measured outside of the radio planner to a hook
+ *
+ * \remark Used for GNSS and Wi-Fi scans run from a user task: the transceiver reports their charge once done
+ *
+ * \param [in] rp         Radio planner data structure
+ * \param [in] hook_id    Hook id
+ * \param [in] category   Charge category
+ * \param [in] charge_uah Charge in uAh
+ */
+void rp_energy_add_charge( radio_planner_t* rp, const uint8_t hook_id, const rp_energy_category_t category,
+                           const uint32_t charge_uah );
+
 /*!
  *
  */
@@ -161,6 +193,35 @@ void rp_get_status( const radio_planner_t* rp, const uint8_t id, uint32_t* irq_t
  *
  */
 void rp_get_and_clear_raw_radio_irq( radio_planner_t* rp, const uint8_t id, ral_irq_t* raw_radio_irq );
+
+/*!
+ * Check if the radio still holds the configuration set by a hook
+ *
+ * \remark To be called from a launch callback: the radio configuration is kept while the radio is sleeping, so a
+ *          hook which was the last one to use the radio can skip the radio setup
+ *
+ * \param [in] rp      Radio planner data structure
+ * \param [in] hook_id Hook id
+ * \retval bool        true if no other hook has been launched on the radio since the last task of this hook
+ */
+bool rp_is_radio_configured_by( const radio_planner_t* rp, const uint8_t hook_id );
+
+/*!
+ * Leave the radio running at the end of the current task instead of putting it to sleep
+ *
+ * \remark To be called from a launch callback. The next task of the same hook finds the radio as it was left, see
+ *          rp_is_radio_configured_by. The radio is put to sleep before the task of another hook is launched
+ *
+ * \param [in] rp      Radio planner data structure
+ */
+void rp_keep_radio_on( radio_planner_t* rp );
+
+/*!
+ * Invalidate the radio configuration, next launched task has to fully configure the radio
+ *
+ * \param [in] rp      Radio planner data structure
+ */
+void rp_invalidate_radio_config( radio_planner_t* rp );
 #ifdef __cplusplus
 }
 #endif
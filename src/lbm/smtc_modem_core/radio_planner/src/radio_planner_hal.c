@@ -115,6 +115,16 @@ void rp_hal_irq_clear_pending( void )
     smtc_modem_hal_radio_irq_clear_pending( );
 }
 
+void rp_hal_wdog_heartbeat( uint32_t deadline_ms )
+{
+    smtc_modem_hal_wdog_heartbeat( WDOG_CLIENT_RADIO_PLANNER, deadline_ms );
+}
+
+void rp_hal_wdog_release( void )
+{
+    smtc_modem_hal_wdog_release( WDOG_CLIENT_RADIO_PLANNER );
+}
+
 #if defined( LR1110_MODEM_E ) && defined( _MODEM_E_GNSS_ENABLE )
 void rp_hal_get_gnss_conso_us( uint32_t* p_radio_t, uint32_t* p_arc_process_t )
 {
@@ -111,6 +111,18 @@ uint32_t rp_hal_get_radio_irq_timestamp_in_100us( void );
  */
 void rp_hal_irq_clear_pending( void );
 
+/**
+ * @brief Arm the watchdog client of the radio planner
+ *
+ * @param [in] deadline_ms Longest time before rp_hal_wdog_release
+ */
+void rp_hal_wdog_heartbeat( uint32_t deadline_ms );
+
+/**
+ * @brief Release the watchdog client of the radio planner
+ */
+void rp_hal_wdog_release( void );
+
 #if defined( LR1110_MODEM_E ) && defined( _MODEM_E_GNSS_ENABLE )
 /*!
  *
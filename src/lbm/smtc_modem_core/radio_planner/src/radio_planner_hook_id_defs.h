@@ -75,6 +75,9 @@ enum RP_HOOK_ID_DEF
 #if !defined( LR1110_MODEM_E )
     RP_HOOK_ID_USER_SUSPEND_2,
 #endif  // !LR1110_MODEM_E
+#if defined( LR11XX_TRANSCEIVER )
+    RP_HOOK_ID_RANGING,
+#endif  // LR11XX_TRANSCEIVER
     RP_HOOK_ID_CLASS_C,
     RP_HOOK_ID_MAX
 };
@@ -92,6 +92,27 @@ typedef struct rp_stats_s
     uint32_t rp_error;
 } rp_stats_t;
 
+/*!
+ * Charge categories of the energy accounting
+ */
+typedef enum rp_energy_category_e
+{
+    RP_ENERGY_TX,    //!< Radio transmitting
+    RP_ENERGY_RX,    //!< Radio receiving or listening
+    RP_ENERGY_SCAN,  //!< Radio acquisition of a GNSS or Wi-Fi scan
+    RP_ENERGY_CPU,   //!< Transceiver processing of a GNSS or Wi-Fi scan
+    RP_ENERGY_CATEGORY_NUMBER,
+} rp_energy_category_t;
+
+/*!
+ * Charge per hook and category, kept in uA.ms so that short tasks are not truncated away
+ */
+typedef struct rp_energy_s
+{
+    uint64_t charge_ua_ms[RP_NB_HOOKS][RP_ENERGY_CATEGORY_NUMBER];
+    uint32_t time_ms[RP_NB_HOOKS][RP_ENERGY_CATEGORY_NUMBER];
+} rp_energy_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -176,25 +197,19 @@ static inline void rp_stats_update( rp_stats_t* rp_stats, uint32_t timestamp, ui
 /*!
  *
  */
-static inline void rp_stats_sniff_update( rp_stats_t* rp_stats, uint32_t timestamp, uint32_t time_radio,
-                                          uint32_t time_proc, uint8_t hook_id, uint32_t ma_radio, uint32_t ma_proc )
+static inline void rp_energy_init( rp_energy_t* rp_energy )
 {
-    uint32_t computed_time        = 0;
-    uint32_t computed_consumption = 0;
-
-    computed_time = timestamp - rp_stats->none_timestamp;
-    // SMTC_MODEM_HAL_TRACE_WARNING( "stat %d %d\n", time_radio/1000, time_proc/1000 );
-    // SMTC_MODEM_HAL_TRACE_WARNING( "stat %d \n", computed_time);
-    rp_stats->none_consumption_ms[hook_id] += computed_time;
-    rp_stats->none_total_consumption_ms += computed_time;
-
-    computed_consumption = ( time_radio / 1000 * ma_radio ) + ( time_proc / 1000 * ma_proc );
-    rp_stats->none_consumption_ma[hook_id] += ( computed_consumption / 1000 );
-    rp_stats->none_total_consumption_ma += ( computed_consumption / 1000 );
+    memset( rp_energy, 0, sizeof( rp_energy_t ) );
+}
 
-    rp_stats->tx_timestamp   = 0;
-    rp_stats->rx_timestamp   = 0;
-    rp_stats->none_timestamp = 0;
+/*!
+ *
+ */
+static inline void rp_energy_update( rp_energy_t* rp_energy, uint8_t hook_id, rp_energy_category_t category,
+                                     uint32_t time_ms, uint64_t charge_ua_ms )
+{
+    rp_energy->time_ms[hook_id][category] += time_ms;
+    rp_energy->charge_ua_ms[hook_id][category] += charge_ua_ms;
 }
 
 #if defined( RP_STAT_PRINT_ENBALE )
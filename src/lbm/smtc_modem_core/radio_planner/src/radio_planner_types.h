@@ -101,6 +101,11 @@ extern "C" {
  */
 #define RP_TASK_RE_SCHEDULE_OFFSET_TIME             2000  // for 2 seconds
 
+/*!
+ * Longest radio or timer interrupt processing, hook callbacks included
+ */
+#define RP_IRQ_WDOG_DEADLINE_MS                     1000
+
 // clang-format on
 
 /*
@@ -159,6 +164,7 @@ typedef enum rp_task_types_e
     RP_TASK_TYPE_GNSS_RSSI,
     RP_TASK_TYPE_WIFI_RSSI,
     RP_TASK_TYPE_LBT,
+    RP_TASK_TYPE_RANGING,
     RP_TASK_TYPE_USER,
     RP_TASK_TYPE_NONE,
 } rp_task_types_t;
@@ -58,6 +58,10 @@ extern "C" {
  */
 #define ALM_UPDATE_UPLINK_PAYLOAD_LENGTH 8
 
+#define ALM_UPDATE_BLOCK_SIZE 20                         // size of one satellite almanac block in a DAS downlink
+#define ALM_UPDATE_NB_BLOCKS 128                         // satellite ids tracked locally
+#define ALM_UPDATE_BLOCK_MAX_AGE_S ( 30UL * 24 * 3600 )  // age beyond which a block is considered stale
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -75,6 +79,20 @@ typedef enum almanac_update_return_code_e
     ALMANAC_ERROR,
 } almanac_update_return_code_t;
 
+/**
+ * @brief Almanac update engine statistics
+ *
+ * @struct almanac_update_stats_t
+ */
+typedef struct almanac_update_stats_s
+{
+    uint16_t nb_blocks_known;    //!< Satellite blocks whose content is tracked locally
+    uint16_t nb_blocks_pushed;   //!< Satellite blocks pushed to the lr11xx since last reset
+    uint16_t nb_blocks_skipped;  //!< Satellite blocks received again with the same content, not pushed
+    uint16_t nb_status_reads;    //!< Number of gnss context status read from the lr11xx
+    bool     is_verified;        //!< true if the status has been read back since the last push
+} almanac_update_stats_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -94,7 +112,8 @@ almanac_update_return_code_t almanac_update_create_uplink_payload( const void* l
 
 /**
  * @brief This function parse and process the payload that has been sent by DAS for Almanac update service
- * @remark This function make a direct access to lr11xx radio
+ * @remark This function make a direct access to lr11xx radio. The first downlink of a session reads the lr11xx global
+ * almanac crc: the blocks already pushed are only skipped if it is still the one verified by the last session.
 
  * @param [in] lr11xx_context lr11xx implementation context
  * @param [in] payload payload received from DAS
@@ -106,6 +125,39 @@ almanac_update_return_code_t almanac_update_create_uplink_payload( const void* l
 almanac_update_return_code_t almanac_update_process_downlink_payload( const void* lr11xx_context, uint8_t* payload,
                                                                       uint8_t payload_len );
 
+/**
+ * @brief Read back the gnss context status once a sequence of almanac downlinks has been pushed, ends the session
+ * @remark This function make a direct access to lr11xx radio. The status is cached until the next push, so that
+ * status uplinks built in between do not access the radio.
+ *
+ * @param [in] lr11xx_context lr11xx implementation context
+ * @param [out] almanac_crc global almanac crc reported by the lr11xx
+ *
+ * @return Almanac service operation status, ALMANAC_ERROR if the status can't be read or reports an error
+ */
+almanac_update_return_code_t almanac_update_verify( const void* lr11xx_context, uint32_t* almanac_crc );
+
+/**
+ * @brief Forget the locally tracked almanac blocks, next received blocks are all pushed to the lr11xx
+ */
+void almanac_update_invalidate( void );
+
+/**
+ * @brief Get the satellite blocks that are unknown or older than ALM_UPDATE_BLOCK_MAX_AGE_S
+ *
+ * @param [out] stale_bitmap one bit per satellite id, bit (id % 8) of byte (id / 8)
+ *
+ * @return Number of stale blocks
+ */
+uint8_t almanac_update_get_stale_blocks( uint8_t stale_bitmap[ALM_UPDATE_NB_BLOCKS / 8] );
+
+/**
+ * @brief Get the almanac update engine statistics
+ *
+ * @param [out] stats statistics
+ */
+void almanac_update_get_stats( almanac_update_stats_t* stats );
+
 #ifdef __cplusplus
 }
 #endif
@@ -56,21 +56,78 @@
  * --- PRIVATE CONSTANTS -------------------------------------------------------
  */
 #define SERVICE_LR11XX_GNSS_CONTEXT_STATUS_LENGTH 9
+#define SERVICE_LR11XX_GNSS_ERROR_CODE_INDEX 7  // error code in the 4 msb of this byte of the context status
+#define ALM_UPDATE_SECONDS_PER_DAY ( 24UL * 3600 )
+#define ALM_UPDATE_SESSION_GAP_S ( 3600 )  // a downlink this long after the previous one starts a new session
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
+/**
+ * @brief Local knowledge of a satellite almanac block
+ */
+typedef struct almanac_update_block_s
+{
+    uint16_t crc;  // crc16 of the block last pushed
+    uint16_t day;  // day of the last push since services time origin, plus one (0: block unknown)
+} almanac_update_block_t;
+
+typedef struct almanac_update_ctx_s
+{
+    almanac_update_block_t blocks[ALM_UPDATE_NB_BLOCKS];
+    uint8_t                status_payload[ALM_UPDATE_UPLINK_PAYLOAD_LENGTH];
+    bool                   is_status_valid;  // status_payload reflects the lr11xx content
+    bool                   is_crc_verified;  // verified_crc is the lr11xx global crc matching the blocks table
+    uint32_t               verified_crc;     // global almanac crc read back at the end of the last session
+    bool                   is_session_open;  // downlinks received since the last verification
+    uint32_t               last_downlink_s;  // time of the last downlink of the session
+    almanac_update_stats_t stats;
+} almanac_update_ctx_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+static almanac_update_ctx_t almanac_update_ctx;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+/**
+ * @brief Compute the crc16 (ccitt) of an almanac block
+ *
+ * @param [in] block block to compute
+ * @return uint16_t crc
+ */
+static uint16_t almanac_update_block_crc( const uint8_t* block );
+
+/**
+ * @brief Read the gnss context status from the lr11xx and cache it
+ *
+ * @param [in] lr11xx_context lr11xx implementation context
+ * @return Almanac service operation status
+ */
+static almanac_update_return_code_t almanac_update_read_status( const void* lr11xx_context );
+
+/**
+ * @brief Get the global almanac crc of the cached gnss context status
+ *
+ * @return uint32_t global almanac crc
+ */
+static uint32_t almanac_update_status_crc( void );
+
+/**
+ * @brief At the first downlink of a session, drop the blocks table if the lr11xx almanac is no longer the one verified
+ * at the end of the last session (written by another path in between, such as a full almanac update)
+ *
+ * @param [in] lr11xx_context lr11xx implementation context
+ */
+static void almanac_update_check_session_start( const void* lr11xx_context );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -78,15 +135,16 @@
 
 almanac_update_return_code_t almanac_update_create_uplink_payload( const void* lr11xx_context, uint8_t payload[8] )
 {
-    uint8_t local_buff[SERVICE_LR11XX_GNSS_CONTEXT_STATUS_LENGTH];
-    // ask lr11xx to get gnss context status
-    if( smtc_modem_services_lr11xx_gnss_get_context_status( lr11xx_context, local_buff ) != MODEM_SERVICES_RADIO_OK )
+    // only access the lr11xx if something has been pushed since the last read
+    if( almanac_update_ctx.is_status_valid == false )
     {
-        return ALMANAC_ERROR;
+        if( almanac_update_read_status( lr11xx_context ) != ALMANAC_OK )
+        {
+            return ALMANAC_ERROR;
+        }
     }
 
-    // Do not take hte first byte from the lr11xx response
-    memcpy( payload, &local_buff[1], SERVICE_LR11XX_GNSS_CONTEXT_STATUS_LENGTH - 1 );
+    memcpy( payload, almanac_update_ctx.status_payload, ALM_UPDATE_UPLINK_PAYLOAD_LENGTH );
 
     return ALMANAC_OK;
 }
@@ -94,18 +152,222 @@ almanac_update_return_code_t almanac_update_create_uplink_payload( const void* l
 almanac_update_return_code_t almanac_update_process_downlink_payload( const void* lr11xx_context, uint8_t* payload,
                                                                       uint8_t payload_len )
 {
-    // take buffer received from DAS and push it to lr11xx removing the first 2 bytes (upcount, updelay)
-    if( smtc_modem_services_lr11xx_gnss_push_dmc_msg( lr11xx_context, &payload[2], payload_len - 2 ) !=
-        MODEM_SERVICES_RADIO_OK )
+    if( payload_len < 3 )
     {
         return ALMANAC_ERROR;
     }
+
+    almanac_update_check_session_start( lr11xx_context );
+
+    // take buffer received from DAS removing the first 2 bytes (upcount, updelay): opcode followed by the blocks
+    uint8_t* msg        = &payload[2];
+    uint8_t  msg_len    = payload_len - 2;
+    uint8_t  blocks_len = msg_len - 1;
+
+    if( ( blocks_len == 0 ) || ( ( blocks_len % ALM_UPDATE_BLOCK_SIZE ) != 0 ) )
+    {
+        // unknown layout, push it as is without tracking
+        almanac_update_ctx.is_status_valid = false;
+        if( smtc_modem_services_lr11xx_gnss_push_dmc_msg( lr11xx_context, msg, msg_len ) != MODEM_SERVICES_RADIO_OK )
+        {
+            return ALMANAC_ERROR;
+        }
+        return ALMANAC_OK;
+    }
+
+    // Rebuild the message in place with only the blocks that differ from what has already been pushed
+    uint16_t day     = ( uint16_t )( smtc_modem_services_get_time_s( ) / ALM_UPDATE_SECONDS_PER_DAY ) + 1;
+    uint8_t  out_len = 1;
+
+    for( uint8_t offset = 1; offset < msg_len; offset += ALM_UPDATE_BLOCK_SIZE )
+    {
+        uint8_t  sv_id = msg[offset];
+        uint16_t crc   = almanac_update_block_crc( &msg[offset] );
+
+        if( sv_id < ALM_UPDATE_NB_BLOCKS )
+        {
+            almanac_update_block_t* block = &almanac_update_ctx.blocks[sv_id];
+            if( ( block->day != 0 ) && ( block->crc == crc ) )
+            {
+                block->day = day;  // content confirmed current by the DAS
+                almanac_update_ctx.stats.nb_blocks_skipped++;
+                continue;
+            }
+            block->crc = crc;
+            block->day = day;
+        }
+        // ids outside the tracked range, such as the header block (date and global crc), are always pushed
+        if( out_len != offset )
+        {
+            memmove( &msg[out_len], &msg[offset], ALM_UPDATE_BLOCK_SIZE );
+        }
+        out_len += ALM_UPDATE_BLOCK_SIZE;
+    }
+
+    if( out_len == 1 )
+    {
+        LOG_INFO( "Almanac update: all blocks already current\n" );
+        return ALMANAC_OK;
+    }
+
+    almanac_update_ctx.is_status_valid = false;
+    almanac_update_ctx.stats.nb_blocks_pushed += ( out_len - 1 ) / ALM_UPDATE_BLOCK_SIZE;
+
+    if( smtc_modem_services_lr11xx_gnss_push_dmc_msg( lr11xx_context, msg, out_len ) != MODEM_SERVICES_RADIO_OK )
+    {
+        // blocks of this message are not known to be in the lr11xx
+        for( uint8_t offset = 1; offset < out_len; offset += ALM_UPDATE_BLOCK_SIZE )
+        {
+            if( msg[offset] < ALM_UPDATE_NB_BLOCKS )
+            {
+                almanac_update_ctx.blocks[msg[offset]].day = 0;
+            }
+        }
+        return ALMANAC_ERROR;
+    }
+
+    LOG_INFO( "Almanac update: %u blocks pushed\n", ( out_len - 1 ) / ALM_UPDATE_BLOCK_SIZE );
     return ALMANAC_OK;
 }
 
+almanac_update_return_code_t almanac_update_verify( const void* lr11xx_context, uint32_t* almanac_crc )
+{
+    if( ( almanac_update_ctx.is_status_valid == false ) &&
+        ( almanac_update_read_status( lr11xx_context ) != ALMANAC_OK ) )
+    {
+        return ALMANAC_ERROR;
+    }
+
+    *almanac_crc                       = almanac_update_status_crc( );
+    almanac_update_ctx.is_session_open = false;
+
+    if( ( almanac_update_ctx.status_payload[SERVICE_LR11XX_GNSS_ERROR_CODE_INDEX - 1] >> 4 ) != 0 )
+    {
+        // the lr11xx rejected part of the update, local tracking can't be trusted anymore
+        almanac_update_invalidate( );
+        return ALMANAC_ERROR;
+    }
+
+    // the blocks table now describes the almanac with this crc
+    almanac_update_ctx.verified_crc    = *almanac_crc;
+    almanac_update_ctx.is_crc_verified = true;
+
+    return ALMANAC_OK;
+}
+
+void almanac_update_invalidate( void )
+{
+    memset( almanac_update_ctx.blocks, 0, sizeof( almanac_update_ctx.blocks ) );
+    almanac_update_ctx.is_crc_verified = false;
+}
+
+uint8_t almanac_update_get_stale_blocks( uint8_t stale_bitmap[ALM_UPDATE_NB_BLOCKS / 8] )
+{
+    uint16_t today    = ( uint16_t )( smtc_modem_services_get_time_s( ) / ALM_UPDATE_SECONDS_PER_DAY ) + 1;
+    uint16_t max_days = ALM_UPDATE_BLOCK_MAX_AGE_S / ALM_UPDATE_SECONDS_PER_DAY;
+    uint8_t  nb_stale = 0;
+
+    memset( stale_bitmap, 0, ALM_UPDATE_NB_BLOCKS / 8 );
+    for( uint8_t sv_id = 0; sv_id < ALM_UPDATE_NB_BLOCKS; sv_id++ )
+    {
+        uint16_t day = almanac_update_ctx.blocks[sv_id].day;
+        if( ( day == 0 ) || ( ( uint16_t )( today - day ) > max_days ) )
+        {
+            stale_bitmap[sv_id / 8] |= ( 1 << ( sv_id % 8 ) );
+            nb_stale++;
+        }
+    }
+    return nb_stale;
+}
+
+void almanac_update_get_stats( almanac_update_stats_t* stats )
+{
+    *stats                 = almanac_update_ctx.stats;
+    stats->nb_blocks_known = 0;
+    for( uint8_t sv_id = 0; sv_id < ALM_UPDATE_NB_BLOCKS; sv_id++ )
+    {
+        if( almanac_update_ctx.blocks[sv_id].day != 0 )
+        {
+            stats->nb_blocks_known++;
+        }
+    }
+    stats->is_verified = almanac_update_ctx.is_status_valid;
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static uint16_t almanac_update_block_crc( const uint8_t* block )
+{
+    uint16_t crc = 0xFFFF;
+
+    for( uint8_t i = 0; i < ALM_UPDATE_BLOCK_SIZE; i++ )
+    {
+        crc ^= ( uint16_t ) block[i] << 8;
+        for( uint8_t bit = 0; bit < 8; bit++ )
+        {
+            crc = ( crc & 0x8000 ) ? ( uint16_t )( ( crc << 1 ) ^ 0x1021 ) : ( uint16_t )( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+static almanac_update_return_code_t almanac_update_read_status( const void* lr11xx_context )
+{
+    uint8_t local_buff[SERVICE_LR11XX_GNSS_CONTEXT_STATUS_LENGTH];
+    // ask lr11xx to get gnss context status
+    if( smtc_modem_services_lr11xx_gnss_get_context_status( lr11xx_context, local_buff ) != MODEM_SERVICES_RADIO_OK )
+    {
+        return ALMANAC_ERROR;
+    }
+    almanac_update_ctx.stats.nb_status_reads++;
+
+    // Do not take the first byte from the lr11xx response
+    memcpy( almanac_update_ctx.status_payload, &local_buff[1], SERVICE_LR11XX_GNSS_CONTEXT_STATUS_LENGTH - 1 );
+    almanac_update_ctx.is_status_valid = true;
+
+    return ALMANAC_OK;
+}
+
+static uint32_t almanac_update_status_crc( void )
+{
+    // global crc is at bytes 2 to 5 of the lr11xx context status, first byte is not cached
+    return ( ( uint32_t ) almanac_update_ctx.status_payload[2] << 0 ) +
+           ( ( uint32_t ) almanac_update_ctx.status_payload[3] << 8 ) +
+           ( ( uint32_t ) almanac_update_ctx.status_payload[4] << 16 ) +
+           ( ( uint32_t ) almanac_update_ctx.status_payload[5] << 24 );
+}
+
+static void almanac_update_check_session_start( const void* lr11xx_context )
+{
+    uint32_t now_s = smtc_modem_services_get_time_s( );
+    bool     is_new_session =
+        ( almanac_update_ctx.is_session_open == false ) ||
+        ( ( now_s - almanac_update_ctx.last_downlink_s ) > ALM_UPDATE_SESSION_GAP_S );  // end of a session was lost
+
+    almanac_update_ctx.is_session_open = true;
+    almanac_update_ctx.last_downlink_s = now_s;
+    if( is_new_session == false )
+    {
+        return;
+    }
+
+    if( almanac_update_ctx.is_crc_verified == false )
+    {
+        // blocks pushed by a session that was never verified may not all be in the lr11xx
+        almanac_update_invalidate( );
+        return;
+    }
+
+    // read the lr11xx crc even if a status is cached, the almanac may have been written since
+    if( ( almanac_update_read_status( lr11xx_context ) != ALMANAC_OK ) ||
+        ( almanac_update_status_crc( ) != almanac_update_ctx.verified_crc ) )
+    {
+        LOG_INFO( "Almanac update: lr11xx almanac changed since the last session, all blocks are pushed\n" );
+        almanac_update_invalidate( );
+    }
+}
+
 /* --- EOF ------------------------------------------------------------------ */
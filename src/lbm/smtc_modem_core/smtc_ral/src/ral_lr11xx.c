@@ -355,6 +355,15 @@ static ral_status_t ral_lr11xx_convert_lora_cad_params_from_ral( const ral_lora_
 static void ral_lr11xx_convert_lr_fhss_params_from_ral( const ral_lr_fhss_params_t* ral_lr_fhss_params,
                                                         lr11xx_lr_fhss_params_t*    radio_lr_fhss_params );
 
+/**
+ * @brief Apply the board calibration to a datasheet current
+ *
+ * @param [in] context                    Chip implementation context
+ * @param [in] is_tx                      True for a Tx current, false for a Rx current
+ * @param [in,out] pwr_consumption_in_ua  The power consumption in micro ampere
+ */
+static void ral_lr11xx_calibrate_consumption( const void* context, const bool is_tx, uint32_t* pwr_consumption_in_ua );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -1179,6 +1188,8 @@ ral_status_t ral_lr11xx_get_tx_consumption_in_ua( const void* context, const int
         return RAL_STATUS_UNKNOWN_VALUE;
     }
 
+    ral_lr11xx_calibrate_consumption( context, true, pwr_consumption_in_ua );
+
     return RAL_STATUS_OK;
 }
 
@@ -1202,6 +1213,8 @@ ral_status_t ral_lr11xx_get_gfsk_rx_consumption_in_ua( const void* context, cons
             ( rx_boosted ) ? LR11XX_GFSK_RX_BOOSTED_CONSUMPTION_LDO : LR11XX_GFSK_RX_CONSUMPTION_LDO;
     }
 
+    ral_lr11xx_calibrate_consumption( context, false, pwr_consumption_in_ua );
+
     return RAL_STATUS_OK;
 }
 
@@ -1224,6 +1237,8 @@ ral_status_t ral_lr11xx_get_lora_rx_consumption_in_ua( const void* context, cons
             ( rx_boosted ) ? LR11XX_LORA_RX_BOOSTED_CONSUMPTION_LDO : LR11XX_LORA_RX_CONSUMPTION_LDO;
     }
 
+    ral_lr11xx_calibrate_consumption( context, false, pwr_consumption_in_ua );
+
     return RAL_STATUS_OK;
 }
 
@@ -1749,4 +1764,17 @@ static void ral_lr11xx_convert_lr_fhss_params_from_ral( const ral_lr_fhss_params
     };
 }
 
+static void ral_lr11xx_calibrate_consumption( const void* context, const bool is_tx, uint32_t* pwr_consumption_in_ua )
+{
+    ral_lr11xx_bsp_consumption_calibration_t calibration;
+
+    ral_lr11xx_bsp_get_consumption_calibration( context, &calibration );
+
+    *pwr_consumption_in_ua =
+        ( uint32_t ) ( ( ( uint64_t ) *pwr_consumption_in_ua *
+                         ( ( is_tx ) ? calibration.tx_gain_per_mille : calibration.rx_gain_per_mille ) ) /
+                       1000 ) +
+        calibration.offset_in_ua;
+}
+
 /* --- EOF ------------------------------------------------------------------ */
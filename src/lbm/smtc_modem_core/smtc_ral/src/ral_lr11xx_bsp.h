@@ -78,6 +78,13 @@ typedef struct ral_lr11xx_bsp_tx_cfg_output_params_s
     int8_t                   chip_output_pwr_in_dbm_expected;
 } ral_lr11xx_bsp_tx_cfg_output_params_t;
 
+typedef struct ral_lr11xx_bsp_consumption_calibration_s
+{
+    uint16_t tx_gain_per_mille;  //!< Tx current measured on the board over the datasheet value, in 1/1000
+    uint16_t rx_gain_per_mille;  //!< Rx current measured on the board over the datasheet value, in 1/1000
+    uint32_t offset_in_ua;       //!< Current drawn around the chip (TCXO, RF switch) while the radio is active
+} ral_lr11xx_bsp_consumption_calibration_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -141,6 +148,17 @@ void ral_lr11xx_bsp_get_crc_state( const void* context, bool* crc_is_activated )
 void ral_lr11xx_bsp_get_rssi_calibration_table( const void* context, const uint32_t freq_in_hz,
                                                 lr11xx_radio_rssi_calibration_table_t* rssi_calibration_table );
 
+/**
+ * Get the current consumption calibration of the board
+ *
+ * @remark Applied to the datasheet currents returned by the ral_lr11xx_get_*_consumption_in_ua functions
+ *
+ * @param [in] context Chip implementation context
+ * @param [out] calibration Pointer to a structure holding the current consumption calibration
+ */
+void ral_lr11xx_bsp_get_consumption_calibration( const void*                               context,
+                                                 ral_lr11xx_bsp_consumption_calibration_t* calibration );
+
 #ifdef __cplusplus
 }
 #endif
@@ -122,6 +122,17 @@ typedef enum
     MODEM_CONTEXT_TYPE_SIZE
 } modem_context_type_t;
 
+/**
+ * @brief Watchdog clients of the modem and its middlewares
+ */
+typedef enum
+{
+    WDOG_CLIENT_SUPERVISOR,
+    WDOG_CLIENT_RADIO_PLANNER,
+    WDOG_CLIENT_GNSS,
+    WDOG_CLIENT_WIFI,
+} modem_wdog_client_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -145,6 +156,24 @@ void smtc_modem_hal_reset_mcu( void );
  */
 void smtc_modem_hal_reload_wdog( void );
 
+/**
+ * @brief Heartbeat of a watchdog client
+ *
+ * @remark The watchdog is only reloaded while every armed client beats again before its deadline. The client stays
+ *         armed until released, the platform records the client which starved the watchdog.
+ *
+ * @param [in] client       Watchdog client
+ * @param [in] deadline_ms  Longest time before the next heartbeat or release of the client
+ */
+void smtc_modem_hal_wdog_heartbeat( const modem_wdog_client_t client, const uint32_t deadline_ms );
+
+/**
+ * @brief Release a watchdog client, an idle client never starves the watchdog
+ *
+ * @param [in] client   Watchdog client
+ */
+void smtc_modem_hal_wdog_release( const modem_wdog_client_t client );
+
 /* ------------ Time management ------------*/
 
 /**
@@ -205,6 +234,16 @@ uint32_t smtc_modem_hal_get_time_in_100us( void );
  */
 uint32_t smtc_modem_hal_get_radio_irq_timestamp_in_100us( void );
 
+/**
+ * @brief Returns the number of cpu cycles since the counter was started
+ *
+ * @remark Only used to profile short code sections, in builds defining LR1MAC_PROFILE_TX_RADIO_START.
+ * The counter is started by the first call and wraps every 67 seconds at 64 MHz.
+ *
+ * @return uint32_t Cpu cycle count
+ */
+uint32_t smtc_modem_hal_get_cpu_cycle_count( void );
+
 /* ------------ Timer management ------------*/
 
 /**
@@ -0,0 +1,354 @@
+/**
+ * @file      gnss_group_codec.c
+ *
+ * @brief     Packing of the NAV messages of a GNSS scan group in a reduced number of uplink frames.
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <string.h>
+
+#include "gnss_group_codec.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#define GNSS_GROUP_CODEC_LAST_FLAG ( 0x80 )
+#define GNSS_GROUP_CODEC_TOKEN_MASK ( 0x1F )
+
+#define GNSS_GROUP_CODEC_DELTA_FLAG ( 0x80 )
+#define GNSS_GROUP_CODEC_SIZE_MASK ( 0x7F )
+
+/* Run-length encoding of the delta: | zero run (1bit) | length - 1 (7bits) | literal bytes if not a zero run | */
+#define GNSS_GROUP_CODEC_RUN_ZERO_FLAG ( 0x80 )
+#define GNSS_GROUP_CODEC_RUN_LENGTH_MAX ( 128 )
+
+/* Shorter zero runs are cheaper kept in a literal run */
+#define GNSS_GROUP_CODEC_RUN_ZERO_MIN ( 2 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * @brief Get a byte of the delta between a NAV message and its reference, the reference is padded with zeros
+ */
+static uint8_t gnss_group_codec_delta( const uint8_t* nav, const uint8_t* ref, uint8_t ref_size, uint8_t index );
+
+/*!
+ * @brief Get the number of consecutive null delta bytes from an index
+ */
+static uint8_t gnss_group_codec_zero_run( const uint8_t* nav, uint8_t nav_size, const uint8_t* ref, uint8_t ref_size,
+                                          uint8_t index );
+
+/*!
+ * @brief Run-length encode the delta between a NAV message and its reference
+ *
+ * @return the encoded size, 0 if it does not fit in size_max bytes
+ */
+static uint8_t gnss_group_codec_delta_encode( const uint8_t* nav, uint8_t nav_size, const uint8_t* ref,
+                                              uint8_t ref_size, uint8_t* out, uint8_t size_max );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void gnss_group_codec_encoder_init( gnss_group_codec_encoder_t* encoder, uint8_t* buffer, uint8_t size_max,
+                                    uint8_t token )
+{
+    encoder->buffer        = buffer;
+    encoder->size_max      = size_max;
+    encoder->size          = GNSS_GROUP_CODEC_HEADER_SIZE;
+    encoder->nb_navs       = 0;
+    encoder->prev_nav      = NULL;
+    encoder->prev_nav_size = 0;
+
+    encoder->buffer[0] = GNSS_GROUP_CODEC_PACKED_FLAG | ( token & GNSS_GROUP_CODEC_TOKEN_MASK );
+    encoder->buffer[1] = 0;
+}
+
+bool gnss_group_codec_encoder_add( gnss_group_codec_encoder_t* encoder, const uint8_t* nav, uint8_t nav_size )
+{
+    uint8_t* entry;
+    uint8_t  space_left;
+    uint8_t  encoded_size = 0;
+
+    if( ( nav_size == 0 ) || ( nav_size > GNSS_GROUP_CODEC_NAV_SIZE_MAX ) ||
+        ( ( encoder->size + 1 ) >= encoder->size_max ) )
+    {
+        return false;
+    }
+
+    entry      = &encoder->buffer[encoder->size];
+    space_left = encoder->size_max - encoder->size - 1;
+
+    /* Delta encoding only pays off if shorter than the NAV itself */
+    if( encoder->prev_nav != NULL )
+    {
+        encoded_size = gnss_group_codec_delta_encode( nav, nav_size, encoder->prev_nav, encoder->prev_nav_size,
+                                                      &entry[1], ( space_left < nav_size ) ? space_left : nav_size - 1 );
+    }
+
+    if( encoded_size != 0 )
+    {
+        entry[0] = GNSS_GROUP_CODEC_DELTA_FLAG | nav_size;
+    }
+    else if( nav_size <= space_left )
+    {
+        entry[0] = nav_size;
+        memcpy( &entry[1], nav, nav_size );
+        encoded_size = nav_size;
+    }
+    else
+    {
+        return false;
+    }
+
+    encoder->size += 1 + encoded_size;
+    encoder->nb_navs += 1;
+    encoder->prev_nav      = nav;
+    encoder->prev_nav_size = nav_size;
+
+    return true;
+}
+
+uint8_t gnss_group_codec_encoder_close( gnss_group_codec_encoder_t* encoder, bool is_last )
+{
+    if( is_last == true )
+    {
+        encoder->buffer[0] |= GNSS_GROUP_CODEC_LAST_FLAG;
+    }
+    encoder->buffer[1] = encoder->nb_navs;
+
+    return encoder->size;
+}
+
+bool gnss_group_codec_is_packed( const uint8_t* frame, uint8_t frame_size )
+{
+    return ( frame_size > GNSS_GROUP_CODEC_HEADER_SIZE ) && ( ( frame[0] & GNSS_GROUP_CODEC_PACKED_FLAG ) != 0 );
+}
+
+bool gnss_group_codec_decoder_init( gnss_group_codec_decoder_t* decoder, const uint8_t* frame, uint8_t frame_size )
+{
+    if( gnss_group_codec_is_packed( frame, frame_size ) == false )
+    {
+        return false;
+    }
+
+    decoder->frame         = frame;
+    decoder->frame_size    = frame_size;
+    decoder->index         = GNSS_GROUP_CODEC_HEADER_SIZE;
+    decoder->nb_navs_left  = frame[1];
+    decoder->prev_nav_size = 0;
+
+    return true;
+}
+
+bool gnss_group_codec_decode_next( gnss_group_codec_decoder_t* decoder, uint8_t* msg, uint8_t* msg_size )
+{
+    const uint8_t* frame = decoder->frame;
+    uint8_t*       nav   = &msg[1];
+    uint8_t        nav_size;
+    uint8_t        entry;
+    uint8_t        i = 0;
+
+    if( ( decoder->nb_navs_left == 0 ) || ( decoder->index >= decoder->frame_size ) )
+    {
+        return false;
+    }
+
+    entry    = frame[decoder->index++];
+    nav_size = entry & GNSS_GROUP_CODEC_SIZE_MASK;
+    if( nav_size == 0 )
+    {
+        return false;
+    }
+
+    if( ( entry & GNSS_GROUP_CODEC_DELTA_FLAG ) == 0 )
+    {
+        if( ( decoder->frame_size - decoder->index ) < nav_size )
+        {
+            return false;
+        }
+        memcpy( nav, &frame[decoder->index], nav_size );
+        decoder->index += nav_size;
+    }
+    else
+    {
+        if( decoder->prev_nav_size == 0 )
+        {
+            return false;
+        }
+
+        while( i < nav_size )
+        {
+            uint8_t run;
+            uint8_t j;
+
+            if( decoder->index >= decoder->frame_size )
+            {
+                return false;
+            }
+            run = ( frame[decoder->index] & ~GNSS_GROUP_CODEC_RUN_ZERO_FLAG ) + 1;
+            if( run > ( nav_size - i ) )
+            {
+                return false;
+            }
+
+            if( ( frame[decoder->index++] & GNSS_GROUP_CODEC_RUN_ZERO_FLAG ) != 0 )
+            {
+                for( j = 0; j < run; j++, i++ )
+                {
+                    nav[i] = ( i < decoder->prev_nav_size ) ? decoder->prev_nav[i] : 0;
+                }
+            }
+            else
+            {
+                if( ( decoder->frame_size - decoder->index ) < run )
+                {
+                    return false;
+                }
+                for( j = 0; j < run; j++, i++ )
+                {
+                    nav[i] = frame[decoder->index++] ^ ( ( i < decoder->prev_nav_size ) ? decoder->prev_nav[i] : 0 );
+                }
+            }
+        }
+    }
+
+    /* Rebuild the single NAV metadata, the last NAV flag is only set on the last NAV of the frame */
+    decoder->nb_navs_left -= 1;
+    msg[0] = frame[0] & GNSS_GROUP_CODEC_TOKEN_MASK;
+    if( ( decoder->nb_navs_left == 0 ) && ( ( frame[0] & GNSS_GROUP_CODEC_LAST_FLAG ) != 0 ) )
+    {
+        msg[0] |= GNSS_GROUP_CODEC_LAST_FLAG;
+    }
+    *msg_size = 1 + nav_size;
+
+    memcpy( decoder->prev_nav, nav, nav_size );
+    decoder->prev_nav_size = nav_size;
+
+    return true;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint8_t gnss_group_codec_delta( const uint8_t* nav, const uint8_t* ref, uint8_t ref_size, uint8_t index )
+{
+    return nav[index] ^ ( ( index < ref_size ) ? ref[index] : 0 );
+}
+
+static uint8_t gnss_group_codec_zero_run( const uint8_t* nav, uint8_t nav_size, const uint8_t* ref, uint8_t ref_size,
+                                          uint8_t index )
+{
+    uint8_t run = 0;
+
+    while( ( ( index + run ) < nav_size ) && ( run < GNSS_GROUP_CODEC_RUN_LENGTH_MAX ) &&
+           ( gnss_group_codec_delta( nav, ref, ref_size, index + run ) == 0 ) )
+    {
+        run++;
+    }
+
+    return run;
+}
+
+static uint8_t gnss_group_codec_delta_encode( const uint8_t* nav, uint8_t nav_size, const uint8_t* ref,
+                                              uint8_t ref_size, uint8_t* out, uint8_t size_max )
+{
+    uint8_t size = 0;
+    uint8_t i    = 0;
+
+    while( i < nav_size )
+    {
+        uint8_t run = gnss_group_codec_zero_run( nav, nav_size, ref, ref_size, i );
+
+        if( ( run >= GNSS_GROUP_CODEC_RUN_ZERO_MIN ) || ( ( i + run ) == nav_size ) )
+        {
+            if( size >= size_max )
+            {
+                return 0;
+            }
+            out[size++] = GNSS_GROUP_CODEC_RUN_ZERO_FLAG | ( run - 1 );
+            i += run;
+        }
+        else
+        {
+            /* Literal run up to the next worthy zero run */
+            uint8_t start = i;
+
+            while( ( i < nav_size ) && ( ( i - start ) < GNSS_GROUP_CODEC_RUN_LENGTH_MAX ) &&
+                   ( gnss_group_codec_zero_run( nav, nav_size, ref, ref_size, i ) < GNSS_GROUP_CODEC_RUN_ZERO_MIN ) )
+            {
+                i++;
+            }
+
+            if( ( size + 1 + ( i - start ) ) > size_max )
+            {
+                return 0;
+            }
+            out[size++] = i - start - 1;
+            for( uint8_t j = start; j < i; j++ )
+            {
+                out[size++] = gnss_group_codec_delta( nav, ref, ref_size, j );
+            }
+        }
+    }
+
+    return size;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
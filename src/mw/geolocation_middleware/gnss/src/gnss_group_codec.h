@@ -0,0 +1,197 @@
+/**
+ * @file      gnss_group_codec.h
+ *
+ * @brief     Packing of the NAV messages of a GNSS scan group in a reduced number of uplink frames.
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GNSS_GROUP_CODEC_H
+#define GNSS_GROUP_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/**
+ * @brief Size of the header of a packed frame: | metadata | number of NAV |
+ */
+#define GNSS_GROUP_CODEC_HEADER_SIZE ( 2 )
+
+/**
+ * @brief Maximum size of a NAV message which can be packed (7 bits)
+ */
+#define GNSS_GROUP_CODEC_NAV_SIZE_MAX ( 127 )
+
+/**
+ * @brief Maximum size of a decoded single NAV message: | metadata | NAV |
+ */
+#define GNSS_GROUP_CODEC_MSG_SIZE_MAX ( 1 + GNSS_GROUP_CODEC_NAV_SIZE_MAX )
+
+/**
+ * @brief Metadata bit indicating a packed frame (RFU bit of the single NAV metadata)
+ */
+#define GNSS_GROUP_CODEC_PACKED_FLAG ( 0x40 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Packed frame under construction
+ */
+typedef struct
+{
+    uint8_t*       buffer;         //!< Frame buffer
+    uint8_t        size_max;       //!< Maximum size of the frame
+    uint8_t        size;           //!< Current size of the frame
+    uint8_t        nb_navs;        //!< Number of NAV messages packed in the frame
+    const uint8_t* prev_nav;       //!< Previous NAV message of the frame, reference of the delta encoding
+    uint8_t        prev_nav_size;  //!< Size of the previous NAV message
+} gnss_group_codec_encoder_t;
+
+/**
+ * @brief Packed frame being decoded
+ */
+typedef struct
+{
+    const uint8_t* frame;                                   //!< Frame to decode
+    uint8_t        frame_size;                              //!< Size of the frame
+    uint8_t        index;                                   //!< Current read index in the frame
+    uint8_t        nb_navs_left;                            //!< Number of NAV messages left to decode
+    uint8_t        prev_nav[GNSS_GROUP_CODEC_NAV_SIZE_MAX];  //!< Previous decoded NAV message
+    uint8_t        prev_nav_size;                           //!< Size of the previous decoded NAV message
+} gnss_group_codec_decoder_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * @brief Start a new packed frame
+ *
+ * The format of a packed frame is: | last NAV (1bit) | packed (1bit) | RFU (1bit) | token (5bits) | nb NAV | NAV... |
+ * with each NAV encoded as: | delta (1bit) | NAV size (7bits) | data |
+ * The first NAV of a frame is always sent as is, so that each frame can be decoded on its own. The following ones are
+ * XOR-ed with the previous NAV and run-length encoded when it makes them shorter.
+ *
+ * @param[out] encoder Encoder to initialize
+ * @param[in] buffer Frame buffer
+ * @param[in] size_max Maximum size of the frame
+ * @param[in] token Scan group identifier
+ */
+void gnss_group_codec_encoder_init( gnss_group_codec_encoder_t* encoder, uint8_t* buffer, uint8_t size_max,
+                                    uint8_t token );
+
+/*!
+ * @brief Add a NAV message to the frame, if it fits in the remaining space
+ *
+ * The NAV buffer must remain valid until the frame is closed, as it is the reference of the next NAV.
+ *
+ * @param[in,out] encoder Encoder of the frame
+ * @param[in] nav NAV message
+ * @param[in] nav_size Size of the NAV message
+ *
+ * @return a boolean set to true if the NAV message has been added, false if there is not enough space left
+ */
+bool gnss_group_codec_encoder_add( gnss_group_codec_encoder_t* encoder, const uint8_t* nav, uint8_t nav_size );
+
+/*!
+ * @brief Close the frame
+ *
+ * @param[in,out] encoder Encoder of the frame
+ * @param[in] is_last Indicates if the frame contains the last NAV of the scan group
+ *
+ * @return the size of the frame
+ */
+uint8_t gnss_group_codec_encoder_close( gnss_group_codec_encoder_t* encoder, bool is_last );
+
+/*!
+ * @brief Check if an uplink frame is a packed frame
+ *
+ * @param[in] frame Uplink frame
+ * @param[in] frame_size Size of the frame
+ *
+ * @return a boolean set to true if the frame is packed
+ */
+bool gnss_group_codec_is_packed( const uint8_t* frame, uint8_t frame_size );
+
+/*!
+ * @brief Start decoding a packed frame
+ *
+ * @param[out] decoder Decoder to initialize
+ * @param[in] frame Packed frame
+ * @param[in] frame_size Size of the frame
+ *
+ * @return a boolean set to true if the frame is a packed frame
+ */
+bool gnss_group_codec_decoder_init( gnss_group_codec_decoder_t* decoder, const uint8_t* frame, uint8_t frame_size );
+
+/*!
+ * @brief Decode the next NAV message of a packed frame, as it would have been sent without packing
+ *
+ * The decoded message has the single NAV format expected by the solver: | last NAV (1bit) | RFU (2bits) |
+ * token (5bits) | NAV |
+ *
+ * @param[in,out] decoder Decoder of the frame
+ * @param[out] msg Decoded message, at least GNSS_GROUP_CODEC_MSG_SIZE_MAX bytes
+ * @param[out] msg_size Size of the decoded message
+ *
+ * @return a boolean set to true if a message has been decoded, false if there is none left or the frame is malformed
+ */
+bool gnss_group_codec_decode_next( gnss_group_codec_decoder_t* decoder, uint8_t* msg, uint8_t* msg_size );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // GNSS_GROUP_CODEC_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -95,6 +95,14 @@
  */
 #define GNSS_NB_VISIBLE_SVS_PER_CONSTELLATION_MAX ( 12 )
 
+/**
+ * @brief Age in seconds up to which the cached dopplers of the visible satellites are used
+ *
+ * @remark The doppler of a visible satellite drifts by less than 1Hz/s, so the cached dopplers stay well below the
+ * smallest frequency search space (250Hz) within this age.
+ */
+#define GNSS_VISIBLE_SVS_CACHE_DOPPLER_MAX_AGE_S ( 60 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -110,20 +118,41 @@ typedef struct doppler_offset_s
     int16_t                    doppler_error;   //!< SV doppler error - step of 125Hz (almanac age)
 } doppler_offset_t;
 
+/**
+ * @brief Visible satellites of one constellation, as returned by the LR11xx for a date and an assistance position
+ *
+ * @remark The cache is cleared when the almanac CRC changes, so an entry is keyed on the almanac, the position and the
+ * date it was read for
+ */
+typedef struct gnss_visible_svs_cache_s
+{
+    bool                                     is_valid;        //!< Cache content can be used
+    uint32_t                                 date;            //!< GPS time the satellites were read for
+    lr11xx_gnss_solver_assistance_position_t position;        //!< Assistance position of the cached satellites
+    uint8_t                                  nb_visible_svs;  //!< Number of cached visible satellites
+    uint8_t nb_reported_svs;  //!< Number of visible satellites reported by the LR11xx, may exceed the cache size
+    lr11xx_gnss_visible_satellite_t visible_svs[GNSS_NB_VISIBLE_SVS_PER_CONSTELLATION_MAX];  //!< Visible satellites
+} gnss_visible_svs_cache_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
 /**
- * @brief Array to store current visible satellites for GPS constellation
+ * @brief Cache of the visible satellites for GPS constellation
  */
-static lr11xx_gnss_visible_satellite_t visible_svs_gps[GNSS_NB_VISIBLE_SVS_PER_CONSTELLATION_MAX];
+static gnss_visible_svs_cache_t visible_svs_cache_gps;
 
 /**
- * @brief Array to store current visible satellites for BEIDOU constellation
+ * @brief Cache of the visible satellites for BEIDOU constellation
  */
-static lr11xx_gnss_visible_satellite_t visible_svs_beidou[GNSS_NB_VISIBLE_SVS_PER_CONSTELLATION_MAX];
+static gnss_visible_svs_cache_t visible_svs_cache_beidou;
+
+/**
+ * @brief Almanac CRC last read from the LR11xx, the visible satellites caches are cleared when it changes
+ */
+static uint32_t visible_svs_cache_almanac_crc;
 
 /**
  * @brief Offsets of doppler between theoretical visible satellites and detected satellites
@@ -172,6 +201,51 @@ static inline bool gnss_is_result_to_solver( const uint8_t* buffer, uint8_t buff
  */
 static inline bool gnss_is_result_to_host( const uint8_t* buffer, uint8_t buffer_length );
 
+/*!
+ * @brief Get the visible satellites of a constellation, from the cache if the assistance position did not change and
+ * the cached satellites were read less than max_age_s away from the date
+ *
+ * @param[in] radio_context Chip implementation context
+ * @param[in] date Current GPS time
+ * @param[in] assistance_position Current aiding position
+ * @param[in] constellation GNSS constellation (single constellation mask)
+ * @param[in] max_age_s Largest distance in seconds between date and the date of the cached satellites
+ * @param[in,out] cache Visible satellites cache of the constellation
+ *
+ * @return a boolean: true for success, false otherwise
+ */
+static bool gnss_get_visible_svs( const void* radio_context, const uint32_t date,
+                                  const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                  const lr11xx_gnss_constellation_mask_t constellation, const uint32_t max_age_s,
+                                  gnss_visible_svs_cache_t* cache );
+
+/*!
+ * @brief Check if the cache holds the visible satellites of the assistance position, read close enough to the date
+ *
+ * @param[in] cache Visible satellites cache of a constellation
+ * @param[in] date GPS time
+ * @param[in] assistance_position Aiding position
+ * @param[in] max_age_s Largest distance in seconds between date and the date of the cached satellites
+ *
+ * @return a boolean: true if the cached satellites can be used
+ */
+static bool gnss_visible_svs_cache_hit( const gnss_visible_svs_cache_t* cache, const uint32_t date,
+                                        const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                        const uint32_t                                  max_age_s );
+
+/*!
+ * @brief Select the k-th smallest value of the given values array (quickselect, linear time on average)
+ *
+ * @remark The array is partially reordered: values before index k are lower or equal to the returned value
+ *
+ * @param[in] n Size of the input array
+ * @param[in] x Array containing values
+ * @param[in] k Rank of the value to select, starting at 0
+ *
+ * @return an integer: the k-th smallest value
+ */
+static int select_kth( int n, int x[], int k );
+
 /*!
  * @brief Compute the median value of the given values array
  *
@@ -232,6 +306,14 @@ bool smtc_gnss_get_almanac_crc( const void* radio_context, uint32_t* almanac_crc
 
     *almanac_crc = context_status.global_almanac_crc;
 
+    /* A new almanac has been written (almanac update or full almanac write), the cached satellites are outdated */
+    if( context_status.global_almanac_crc != visible_svs_cache_almanac_crc )
+    {
+        visible_svs_cache_gps.is_valid    = false;
+        visible_svs_cache_beidou.is_valid = false;
+        visible_svs_cache_almanac_crc     = context_status.global_almanac_crc;
+    }
+
     return true;
 }
 
@@ -422,13 +504,10 @@ bool smtc_gnss_get_almanac_update_status( const void* radio_context, const uint3
                                           const lr11xx_gnss_constellation_mask_t          constellations,
                                           bool*                                           almanacs_update_required )
 {
-    lr11xx_status_t status;
-    uint8_t         nb_visible_gps_satellites = 0, nb_visible_beidou_satellites = 0;
-    uint8_t         nb_almanac_old = 0;
-
-    /* Initialize work variables */
-    memset( visible_svs_gps, 0, sizeof visible_svs_gps );
-    memset( visible_svs_beidou, 0, sizeof visible_svs_beidou );
+    uint8_t                                nb_visible_gps_satellites = 0, nb_visible_beidou_satellites = 0;
+    uint8_t                                nb_almanac_old     = 0;
+    const lr11xx_gnss_visible_satellite_t* visible_svs_gps    = visible_svs_cache_gps.visible_svs;
+    const lr11xx_gnss_visible_satellite_t* visible_svs_beidou = visible_svs_cache_beidou.visible_svs;
 
     /* Initialize output status */
     *almanacs_update_required = false;
@@ -436,20 +515,13 @@ bool smtc_gnss_get_almanac_update_status( const void* radio_context, const uint3
     /* Get visible satellites for GPS constellation */
     if( constellations & LR11XX_GNSS_GPS_MASK )
     {
-        status = lr11xx_gnss_get_nb_visible_satellites( radio_context, ( lr11xx_gnss_date_t ) date, assistance_position,
-                                                        LR11XX_GNSS_GPS_MASK, &nb_visible_gps_satellites );
-        if( status != LR11XX_STATUS_OK )
-        {
-            MW_DBG_TRACE_ERROR( "Failed to get number of visible GPS satellites\n" );
-            return false;
-        }
-
-        status = lr11xx_gnss_get_visible_satellites( radio_context, nb_visible_gps_satellites, visible_svs_gps );
-        if( status != LR11XX_STATUS_OK )
+        if( gnss_get_visible_svs( radio_context, date, assistance_position, LR11XX_GNSS_GPS_MASK,
+                                  GNSS_VISIBLE_SVS_CACHE_COUNT_MAX_AGE_S, &visible_svs_cache_gps ) == false )
         {
-            MW_DBG_TRACE_ERROR( "Failed to get visible GPS satellites info\n" );
+            MW_DBG_TRACE_ERROR( "Failed to get visible GPS satellites\n" );
             return false;
         }
+        nb_visible_gps_satellites = visible_svs_cache_gps.nb_visible_svs;
 
         /* Debug prints */
 #if GNSS_HELPERS_DBG_TRACE == GNSS_HELPERS_FEATURE_ON
@@ -476,20 +548,13 @@ bool smtc_gnss_get_almanac_update_status( const void* radio_context, const uint3
     /* Get visible satellites for BEIDOU constellation */
     if( constellations & LR11XX_GNSS_BEIDOU_MASK )
     {
-        status = lr11xx_gnss_get_nb_visible_satellites( radio_context, ( lr11xx_gnss_date_t ) date, assistance_position,
-                                                        LR11XX_GNSS_BEIDOU_MASK, &nb_visible_beidou_satellites );
-        if( status != LR11XX_STATUS_OK )
+        if( gnss_get_visible_svs( radio_context, date, assistance_position, LR11XX_GNSS_BEIDOU_MASK,
+                                  GNSS_VISIBLE_SVS_CACHE_COUNT_MAX_AGE_S, &visible_svs_cache_beidou ) == false )
         {
-            MW_DBG_TRACE_ERROR( "Failed to get number of visible BEIDOU satellites\n" );
-            return false;
-        }
-
-        status = lr11xx_gnss_get_visible_satellites( radio_context, nb_visible_beidou_satellites, visible_svs_beidou );
-        if( status != LR11XX_STATUS_OK )
-        {
-            MW_DBG_TRACE_ERROR( "Failed to get visible BEIDOU satellites info\n" );
+            MW_DBG_TRACE_ERROR( "Failed to get visible BEIDOU satellites\n" );
             return false;
         }
+        nb_visible_beidou_satellites = visible_svs_cache_beidou.nb_visible_svs;
 
         /* Debug prints */
 #if GNSS_HELPERS_DBG_TRACE == GNSS_HELPERS_FEATURE_ON
@@ -538,20 +603,52 @@ bool smtc_gnss_get_almanac_update_status( const void* radio_context, const uint3
     return true;
 }
 
+bool smtc_gnss_get_nb_visible_svs( const void* radio_context, const uint32_t date,
+                                   const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                   const lr11xx_gnss_constellation_mask_t constellations, const uint32_t max_age_s,
+                                   uint8_t* nb_visible_svs )
+{
+    const lr11xx_gnss_constellation_mask_t constellation_list[] = { LR11XX_GNSS_GPS_MASK, LR11XX_GNSS_BEIDOU_MASK };
+
+    *nb_visible_svs = 0;
+
+    for( uint8_t i = 0; i < sizeof( constellation_list ) / sizeof( constellation_list[0] ); i++ )
+    {
+        if( ( constellations & constellation_list[i] ) == 0 )
+        {
+            continue;
+        }
+
+        /* No SPI request if the satellites were read for a close date, the read ones are kept for the next scans */
+        gnss_visible_svs_cache_t* cache =
+            ( constellation_list[i] == LR11XX_GNSS_GPS_MASK ) ? &visible_svs_cache_gps : &visible_svs_cache_beidou;
+        if( gnss_get_visible_svs( radio_context, date, assistance_position, constellation_list[i], max_age_s,
+                                  cache ) != true )
+        {
+            MW_DBG_TRACE_ERROR( "Failed to get number of visible satellites\n" );
+            return false;
+        }
+        *nb_visible_svs += cache->nb_reported_svs;
+    }
+
+    GNSS_HELPERS_TRACE_PRINTF( "date:%u - %u visible satellites predicted\n", date, *nb_visible_svs );
+
+    return true;
+}
+
 bool smtc_gnss_get_doppler_error( const void* radio_context, const uint32_t date,
                                   const lr11xx_gnss_solver_assistance_position_t* assistance_position,
                                   const lr11xx_gnss_constellation_mask_t constellations, const uint8_t nb_detected_sv,
                                   const lr11xx_gnss_detected_satellite_t* detected_sv_info, bool* doppler_error )
 {
-    lr11xx_status_t status;
-    uint8_t         nb_visible_gps_satellites, nb_visible_beidou_satellites;
+    lr11xx_status_t                        status;
+    uint8_t                                nb_visible_gps_satellites, nb_visible_beidou_satellites;
+    const lr11xx_gnss_visible_satellite_t* visible_svs_gps    = visible_svs_cache_gps.visible_svs;
+    const lr11xx_gnss_visible_satellite_t* visible_svs_beidou = visible_svs_cache_beidou.visible_svs;
 
-    /* Initialize work variables */
+    /* Initialize work variables, only the offsets of the detected satellites are used */
     doppler_offsets_for_median_size = 0;
-    memset( doppler_offsets_for_median, 0, sizeof doppler_offsets_for_median );
-    memset( doppler_offsets, 0, sizeof doppler_offsets );
-    memset( visible_svs_gps, 0, sizeof visible_svs_gps );
-    memset( visible_svs_beidou, 0, sizeof visible_svs_beidou );
+    memset( doppler_offsets, 0, nb_detected_sv * sizeof( doppler_offset_t ) );
 
     /* Initialize output status */
     *doppler_error = false;
@@ -562,39 +659,25 @@ bool smtc_gnss_get_doppler_error( const void* radio_context, const uint32_t date
     /* Get visible satellites for GPS constellation */
     if( constellations & LR11XX_GNSS_GPS_MASK )
     {
-        status = lr11xx_gnss_get_nb_visible_satellites( radio_context, ( lr11xx_gnss_date_t ) date, assistance_position,
-                                                        LR11XX_GNSS_GPS_MASK, &nb_visible_gps_satellites );
-        if( status != LR11XX_STATUS_OK )
+        if( gnss_get_visible_svs( radio_context, date, assistance_position, LR11XX_GNSS_GPS_MASK,
+                                  GNSS_VISIBLE_SVS_CACHE_DOPPLER_MAX_AGE_S, &visible_svs_cache_gps ) == false )
         {
-            MW_DBG_TRACE_ERROR( "Failed to get number of visible GPS satellites\n" );
-            return false;
-        }
-
-        status = lr11xx_gnss_get_visible_satellites( radio_context, nb_visible_gps_satellites, visible_svs_gps );
-        if( status != LR11XX_STATUS_OK )
-        {
-            MW_DBG_TRACE_ERROR( "Failed to get visible GPS satellites info\n" );
+            MW_DBG_TRACE_ERROR( "Failed to get visible GPS satellites\n" );
             return false;
         }
+        nb_visible_gps_satellites = visible_svs_cache_gps.nb_visible_svs;
     }
 
     /* Get visible satellites for BEIDOU constellation */
     if( constellations & LR11XX_GNSS_BEIDOU_MASK )
     {
-        status = lr11xx_gnss_get_nb_visible_satellites( radio_context, ( lr11xx_gnss_date_t ) date, assistance_position,
-                                                        LR11XX_GNSS_BEIDOU_MASK, &nb_visible_beidou_satellites );
-        if( status != LR11XX_STATUS_OK )
-        {
-            MW_DBG_TRACE_ERROR( "Failed to get number of visible BEIDOU satellites\n" );
-            return false;
-        }
-
-        status = lr11xx_gnss_get_visible_satellites( radio_context, nb_visible_beidou_satellites, visible_svs_beidou );
-        if( status != LR11XX_STATUS_OK )
+        if( gnss_get_visible_svs( radio_context, date, assistance_position, LR11XX_GNSS_BEIDOU_MASK,
+                                  GNSS_VISIBLE_SVS_CACHE_DOPPLER_MAX_AGE_S, &visible_svs_cache_beidou ) == false )
         {
-            MW_DBG_TRACE_ERROR( "Failed to get visible BEIDOU satellites info\n" );
+            MW_DBG_TRACE_ERROR( "Failed to get visible BEIDOU satellites\n" );
             return false;
         }
+        nb_visible_beidou_satellites = visible_svs_cache_beidou.nb_visible_svs;
     }
 
     /* Compute the offset between the detected doppler and the theoretical doppler of visible SVs */
@@ -758,14 +841,29 @@ bool smtc_gnss_get_doppler_error( const void* radio_context, const uint32_t date
 }
 
 bool smtc_gnss_get_power_consumption( const void* radio_context, uint32_t* power_consumption_uah )
+{
+    uint32_t radio_uah;
+    uint32_t computation_uah;
+    bool     ret;
+
+    ret                    = smtc_gnss_get_power_consumption_split( radio_context, &radio_uah, &computation_uah );
+    *power_consumption_uah = radio_uah + computation_uah;
+
+    return ret;
+}
+
+bool smtc_gnss_get_power_consumption_split( const void* radio_context, uint32_t* radio_uah, uint32_t* computation_uah )
 {
     lr11xx_status_t                  status;
     lr11xx_gnss_timings_t            timings;
+    lr11xx_gnss_timings_t            radio_timings;
     lr11xx_gnss_constellation_mask_t constellation_used;
     lr11xx_system_reg_mode_t         reg_mode;
+    uint32_t                         power_consumption_uah;
 
     /* Initialize output values, in case this function returns with an error */
-    *power_consumption_uah = 0;
+    *radio_uah       = 0;
+    *computation_uah = 0;
 
     status = lr11xx_gnss_get_timings( radio_context, &timings );
     if( status != LR11XX_STATUS_OK )
@@ -782,7 +880,17 @@ bool smtc_gnss_get_power_consumption( const void* radio_context, uint32_t* power
     }
 
     mw_bsp_get_lr11xx_reg_mode( radio_context, &reg_mode );
-    *power_consumption_uah = lr11xx_gnss_get_consumption( reg_mode, timings, constellation_used );
+    power_consumption_uah = lr11xx_gnss_get_consumption( reg_mode, timings, constellation_used );
+
+    /* The computation part is what remains once the radio acquisition alone is accounted */
+    radio_timings.radio_ms       = timings.radio_ms;
+    radio_timings.computation_ms = 0;
+    *radio_uah = lr11xx_gnss_get_consumption( reg_mode, radio_timings, constellation_used );
+    if( *radio_uah > power_consumption_uah )
+    {
+        *radio_uah = power_consumption_uah;
+    }
+    *computation_uah = power_consumption_uah - *radio_uah;
 
     return true;
 }
@@ -944,35 +1052,133 @@ static inline bool gnss_is_result_to_host( const uint8_t* buffer, uint8_t buffer
     }
 }
 
-static int median( int n, int x[] )
+static bool gnss_get_visible_svs( const void* radio_context, const uint32_t date,
+                                  const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                  const lr11xx_gnss_constellation_mask_t constellation, const uint32_t max_age_s,
+                                  gnss_visible_svs_cache_t* cache )
 {
+    lr11xx_status_t status;
+
+    if( gnss_visible_svs_cache_hit( cache, date, assistance_position, max_age_s ) == true )
+    {
+        GNSS_HELPERS_TRACE_PRINTF( "Visible satellites from cache (constellation:0x%02X)\n", constellation );
+        return true;
+    }
+
+    cache->is_valid = false;
+
+    status = lr11xx_gnss_get_nb_visible_satellites( radio_context, ( lr11xx_gnss_date_t ) date, assistance_position,
+                                                    constellation, &cache->nb_visible_svs );
+    if( status != LR11XX_STATUS_OK )
+    {
+        return false;
+    }
+
+    /* Do not overflow the cache if more satellites than expected are reported */
+    cache->nb_reported_svs = cache->nb_visible_svs;
+    if( cache->nb_visible_svs > GNSS_NB_VISIBLE_SVS_PER_CONSTELLATION_MAX )
+    {
+        cache->nb_visible_svs = GNSS_NB_VISIBLE_SVS_PER_CONSTELLATION_MAX;
+    }
+
+    status = lr11xx_gnss_get_visible_satellites( radio_context, cache->nb_visible_svs, cache->visible_svs );
+    if( status != LR11XX_STATUS_OK )
+    {
+        return false;
+    }
+
+    cache->date     = date;
+    cache->position = *assistance_position;
+    cache->is_valid = true;
+
+    return true;
+}
+
+static bool gnss_visible_svs_cache_hit( const gnss_visible_svs_cache_t* cache, const uint32_t date,
+                                        const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                        const uint32_t                                  max_age_s )
+{
+    /* The date may be before the cached one, when a prediction is made for a later scan */
+    const uint32_t age_s = ( date >= cache->date ) ? ( date - cache->date ) : ( cache->date - date );
+
+    return ( cache->is_valid == true ) && ( age_s < max_age_s ) &&
+           ( cache->position.latitude == assistance_position->latitude ) &&
+           ( cache->position.longitude == assistance_position->longitude );
+}
+
+static int select_kth( int n, int x[], int k )
+{
+    int left  = 0;
+    int right = n - 1;
     int temp;
-    int i, j;
 
-    /* sort the array x in ascending order */
-    for( i = 0; i < n - 1; i++ )
+    while( left < right )
     {
-        for( j = i + 1; j < n; j++ )
+        /* partition x[left..right] around its middle value */
+        int pivot = x[left + ( ( right - left ) / 2 )];
+        int i     = left;
+        int j     = right;
+        while( i <= j )
         {
-            if( x[j] < x[i] )
+            while( x[i] < pivot )
+            {
+                i++;
+            }
+            while( x[j] > pivot )
+            {
+                j--;
+            }
+            if( i <= j )
             {
                 /* swap elements */
                 temp = x[i];
                 x[i] = x[j];
                 x[j] = temp;
+                i++;
+                j--;
             }
         }
+
+        /* continue in the partition holding the k-th value, values between j and i are equal to the pivot */
+        if( k <= j )
+        {
+            right = j;
+        }
+        else if( k >= i )
+        {
+            left = i;
+        }
+        else
+        {
+            break;
+        }
     }
 
+    return x[k];
+}
+
+static int median( int n, int x[] )
+{
+    int upper = select_kth( n, x, n / 2 );
+
     if( n % 2 == 0 )
     {
-        /* if there is an even number of elements, return mean of the two elements in the middle */
-        return ( ( x[n / 2] + x[n / 2 - 1] ) / 2 );
+        /* if there is an even number of elements, return mean of the two elements in the middle, the lower one being
+         * the greatest value before n / 2 once selected */
+        int lower = x[0];
+        for( int i = 1; i < n / 2; i++ )
+        {
+            if( x[i] > lower )
+            {
+                lower = x[i];
+            }
+        }
+        return ( ( upper + lower ) / 2 );
     }
     else
     {
         /* else return the element in the middle */
-        return x[n / 2];
+        return upper;
     }
 }
 
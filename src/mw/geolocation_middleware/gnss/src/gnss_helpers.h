@@ -56,6 +56,14 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Age in seconds up to which the cached visible satellites are used for their number and almanac age
+ *
+ * @remark A satellite stays above the horizon for several hours, so with about 10 visible satellites per constellation
+ * the number changes every 20 to 30 minutes on average: the predictions of scans a few minutes apart share a read.
+ */
+#define GNSS_VISIBLE_SVS_CACHE_COUNT_MAX_AGE_S ( 600 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -116,6 +124,10 @@ bool smtc_gnss_push_solver_msg( const void* radio_context, const uint8_t* payloa
 /*!
  * @brief Get current almanac CRC from LR11xx radio
  *
+ * @remark The visible satellites cache is cleared when the CRC differs from the previous read: the almanac CRC has to
+ * be read after an almanac write and before the next visible satellites request (the scan context read at each scan
+ * launch does it)
+ *
  * @param [in] radio_context Chip implementation context
  * @param [out] almanac_crc Current almanac CRC stored in LR11XX
  *
@@ -181,6 +193,27 @@ bool smtc_gnss_get_almanac_update_status( const void* radio_context, const uint3
                                           const lr11xx_gnss_constellation_mask_t          constellations,
                                           bool*                                           almanacs_update_required );
 
+/*!
+ * @brief Predict the number of visible satellites from the almanac, at a given date
+ *
+ * @remark A constellation whose visible satellites are cached for the position, less than max_age_s away from the
+ * date, is served without SPI request
+ *
+ * @param [in] radio_context Chip implementation context
+ * @param [in] date GPS time of the prediction, can be in the future
+ * @param [in] assistance_position Current aiding position
+ * @param [in] constellations GNSS constellations to be predicted
+ * @param [in] max_age_s Largest distance in seconds between date and the date of usable cached satellites, at most
+ * GNSS_VISIBLE_SVS_CACHE_COUNT_MAX_AGE_S
+ * @param [out] nb_visible_svs Number of visible satellites for all the given constellations
+ *
+ * @return a boolean: true for success, false otherwise
+ */
+bool smtc_gnss_get_nb_visible_svs( const void* radio_context, const uint32_t date,
+                                   const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                   const lr11xx_gnss_constellation_mask_t constellations, const uint32_t max_age_s,
+                                   uint8_t* nb_visible_svs );
+
 /*!
  * @brief Compute doppler error on detected satellites to detect aiding position error (to be used only of almanacs are
  * not too old).
@@ -208,6 +241,17 @@ bool smtc_gnss_get_doppler_error( const void* radio_context, const uint32_t date
  */
 bool smtc_gnss_get_power_consumption( const void* radio_context, uint32_t* power_consumption_uah );
 
+/*!
+ * @brief Get the power consumption of the last scan, split between radio acquisition and computation
+ *
+ * @param [in] radio_context Chip implementation context
+ * @param [out] radio_uah Power consumption of the radio acquisition of the last scan in uAh
+ * @param [out] computation_uah Power consumption of the computation of the last scan in uAh
+ *
+ * @return a boolean: true for success, false otherwise
+ */
+bool smtc_gnss_get_power_consumption_split( const void* radio_context, uint32_t* radio_uah, uint32_t* computation_uah );
+
 /*!
  * @brief Read the current scan context (almanac CRC, aiding position....)
  *
@@ -102,6 +102,16 @@
  */
 #define RP_TASK_GNSS SMTC_MODEM_RP_TASK_ID1
 
+/**
+ * @brief Longest time between the start of a scan and its end, twice the radio planner task duration
+ */
+#define GNSS_SCAN_WDOG_DEADLINE_MS ( 20 * 1000 )
+
+/**
+ * @brief Duration of the task reading the visible satellites prediction of the scheduler, in milliseconds
+ */
+#define GNSS_SCHEDULE_TASK_DURATION_MS ( 200 )
+
 /**
  * @brief LoRaWAN port used for uplinks of the GNSS scan results
  */
@@ -127,6 +137,11 @@
  */
 #define LR11XX_GNSS_SCALING_LONGITUDE 180
 
+/**
+ * @brief Number of candidate scan times evaluated by the predictive scan scheduler
+ */
+#define GNSS_MW_SCHEDULER_NB_CANDIDATES GNSS_SCHEDULER_NB_CANDIDATES_MAX
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -260,6 +275,11 @@ static int nb_scan_aggregate = 0;
  */
 static bool send_bypass = false;
 
+/*!
+ * @brief Indicates if the NAV messages of a scan group are packed in as few uplinks as possible
+ */
+static bool scan_group_packing = false;
+
 /*!
  * @brief User has requested to cancel the scan that was scheduled
  */
@@ -304,6 +324,17 @@ static bool autonomous_scan_for_indoor_check = false;
  */
 static gnss_scan_t scan_results;
 
+/*!
+ * @brief Predictive scan scheduler configuration and state
+ */
+static bool                    scan_scheduler_enabled = false;
+static gnss_scheduler_config_t scan_scheduler_config;
+static gnss_scheduler_stats_t  scan_scheduler_stats;
+static uint8_t                 scan_scheduler_predicted_svs = 0; /* Predicted satellites of the group first scan */
+static bool                      scan_scheduler_done          = false; /* Prediction read by the schedule task */
+static gnss_scheduler_decision_t scan_scheduler_decision      = GNSS_SCHEDULER_SCAN_NOW;
+static uint32_t                  scan_scheduler_delay_s       = 0;
+
 static bool scan_busy = false;
 static bool enable_copy_send_buffer = false;
 
@@ -335,6 +366,32 @@ static smtc_modem_return_code_t gnss_mw_scan_next( uint32_t delay_s );
  */
 static uint32_t gnss_mw_get_next_scan_delay( void );
 
+/*!
+ * @brief Program the prediction of the first scan of the scan group, with the specified delay. Its done callback
+ * queues the scan task at the requested time or postponed, or skips the scan.
+ *
+ * @param [in] delay_s Delay in seconds of the requested scan
+ *
+ * @return the error code as returned by the modem / radio planner
+ */
+static smtc_modem_return_code_t gnss_mw_schedule_next( uint32_t delay_s );
+
+/*!
+ * @brief Interrupt handler signaled by the Radio Planner when the radio is available to read the visible satellites
+ * prediction (WARNING: running under interrupt context)
+ *
+ * @param [in] context Pointer to context given by RP (not used)
+ */
+static void gnss_mw_schedule_rp_task_launch( void* context );
+
+/*!
+ * @brief Interrupt handler signaled by the Radio Planner when the prediction task ends (WARNING: running under
+ * interrupt context)
+ *
+ * @param [in] status IRQ status from RP
+ */
+static void gnss_mw_schedule_rp_task_done( smtc_modem_rp_status_t* status );
+
 /*!
  * @brief Interrupt handler signaled by the Radio Planner when the radio is available and it is time to start the scan
  * (WARNING: running under interrupt context)
@@ -378,6 +435,17 @@ static void gnss_mw_tx_done_callback( void );
  */
 static bool gnss_mw_send_frame( const uint8_t* tx_frame_buffer, const uint8_t tx_frame_buffer_size, uint8_t port );
 
+/*!
+ * @brief Get the next payload to be sent from the scan group queue, packed or not depending on the configured mode
+ *
+ * @param [out] buffer Pointer to the buffer to be sent over the air
+ * @param [out] buffer_size Size of the buffer to be sent
+ * @param [out] nb_scans Number of scan results contained in the buffer
+ *
+ * @return a boolean set to true if a payload is ready to be sent, false if there is no result to be sent
+ */
+static bool gnss_mw_scan_group_pop( uint8_t** buffer, uint8_t* buffer_size, uint8_t* nb_scans );
+
 /*!
  * @brief Add an event to the pending event bitfield, and send all pending events to the application
  *
@@ -431,6 +499,9 @@ mw_return_code_t gnss_mw_init( ralf_t* modem_radio, uint8_t stack_id )
     /* Set modem stack ID */
     modem_stack_id = stack_id;
 
+    /* Reset scan scheduler statistics */
+    memset( &scan_scheduler_stats, 0, sizeof scan_scheduler_stats );
+
     return MW_RC_OK;
 }
 
@@ -487,6 +558,9 @@ mw_return_code_t gnss_mw_scan_start( gnss_mw_mode_t mode, uint32_t start_delay )
         current_scan_type = GNSS_MW_SCAN_TYPE_ASSISTED;
     }
 
+    /* Stretch the scan delay according to the energy budget */
+    smtc_modem_energy_governor_get_scan_delay( start_delay, &start_delay );
+
     /* Initialize new scan group */
     MW_DBG_TRACE_INFO( "New scan group - type:%d - start_delay:%us\n", current_scan_type, start_delay );
     if( current_scan_type != GNSS_MW_SCAN_TYPE_ASSISTED )
@@ -506,8 +580,20 @@ mw_return_code_t gnss_mw_scan_start( gnss_mw_mode_t mode, uint32_t start_delay )
         return MW_RC_FAILED;
     }
 
-    /* Prepare the task for next scan */
-    modem_rc = gnss_mw_scan_next( start_delay );
+    /* The first assisted scan of the group may be postponed or skipped: its visible satellites are predicted by a
+     * short task of its own, the LR11xx is only accessed when the radio planner gives it. The time critical launch
+     * callback of the scan only starts the scan */
+    scan_scheduler_predicted_svs = 0;
+    if( ( scan_scheduler_enabled == true ) && ( autonomous_scan_for_indoor_check == false ) &&
+        ( current_scan_type == GNSS_MW_SCAN_TYPE_ASSISTED ) )
+    {
+        modem_rc = gnss_mw_schedule_next( start_delay );
+    }
+    else
+    {
+        /* Prepare the task for next scan */
+        modem_rc = gnss_mw_scan_next( start_delay );
+    }
     if( modem_rc != SMTC_MODEM_RC_OK )
     {
         return MW_RC_FAILED;
@@ -597,6 +683,7 @@ mw_return_code_t gnss_mw_get_event_data_scan_done( gnss_mw_event_data_scan_done_
             data->scans[i].nav_valid = gnss_scan_group_queue.scans[i].nav_valid;
             data->scans[i].timestamp = gnss_scan_group_queue.scans[i].timestamp;
             data->scans[i].nb_svs    = gnss_scan_group_queue.scans[i].detected_svs;
+            data->scans[i].nb_svs_predicted = gnss_scan_group_queue.scans[i].predicted_svs;
             /* Note: detected_sv is <= GNSS_NB_SVS_MAX */
             for( uint8_t j = 0; j < gnss_scan_group_queue.scans[i].detected_svs; j++ )
             {
@@ -666,6 +753,41 @@ void gnss_mw_send_bypass( bool no_send )
     send_bypass = no_send;
 }
 
+void gnss_mw_scan_group_packing( bool pack )
+{
+    MW_DBG_TRACE_INFO( "GNSS scan: set scan group packing to %s\n", pack ? "TRUE" : "FALSE" );
+
+    /* Set scan group packing current mode */
+    scan_group_packing = pack;
+}
+
+mw_return_code_t gnss_mw_set_scan_scheduler( bool enable, uint32_t window_s, uint8_t min_svs )
+{
+    if( window_s > GNSS_MW_SCHEDULER_WINDOW_MAX_S )
+    {
+        MW_DBG_TRACE_ERROR( "Wrong parameter, scheduler window %us is too large\n", window_s );
+        return MW_RC_FAILED;
+    }
+
+    MW_DBG_TRACE_INFO( "GNSS scan: set scheduler to %s (window:%us, min_svs:%u)\n", enable ? "TRUE" : "FALSE",
+                       window_s, min_svs );
+
+    scan_scheduler_enabled              = enable;
+    scan_scheduler_config.window_s      = window_s;
+    scan_scheduler_config.min_svs       = min_svs;
+    scan_scheduler_config.nb_candidates = ( window_s == 0 ) ? 1 : GNSS_MW_SCHEDULER_NB_CANDIDATES;
+
+    return MW_RC_OK;
+}
+
+void gnss_mw_get_scan_scheduler_stats( gnss_scheduler_stats_t* stats )
+{
+    if( stats != NULL )
+    {
+        *stats = scan_scheduler_stats;
+    }
+}
+
 void gnss_mw_display_results( const gnss_mw_event_data_scan_done_t* data )
 {
     uint8_t i, j;
@@ -678,8 +800,8 @@ void gnss_mw_display_results( const gnss_mw_event_data_scan_done_t* data )
         MW_DBG_TRACE_PRINTF( "-- number of valid scans: %u\n", data->nb_scans_valid );
         for( i = 0; i < data->nb_scans_valid; i++ )
         {
-            MW_DBG_TRACE_PRINTF( "-- scan[%d][%u] (%u SV - %d): ", i, data->scans[i].timestamp, data->scans[i].nb_svs,
-                                 data->scans[i].nav_valid );
+            MW_DBG_TRACE_PRINTF( "-- scan[%d][%u] (%u SV - %d - %u SV predicted): ", i, data->scans[i].timestamp,
+                                 data->scans[i].nb_svs, data->scans[i].nav_valid, data->scans[i].nb_svs_predicted );
             for( j = 0; j < data->scans[i].nav_size; j++ )
             {
                 MW_DBG_TRACE_PRINTF( "%02X", data->scans[i].nav[j] );
@@ -821,6 +943,36 @@ static smtc_modem_return_code_t gnss_mw_scan_next( uint32_t delay_s )
     return modem_rc;
 }
 
+static smtc_modem_return_code_t gnss_mw_schedule_next( uint32_t delay_s )
+{
+    smtc_modem_rp_task_t     rp_task = { 0 };
+    smtc_modem_return_code_t modem_rc;
+    uint32_t                 time_ms, delay_ms;
+
+    time_ms  = smtc_modem_hal_get_time_in_ms( ) + 300; /* 300ms for scheduling delay */
+    delay_ms = delay_s * 1000;
+
+    scan_scheduler_done = false;
+
+    rp_task.type                 = SMTC_MODEM_RP_TASK_STATE_ASAP;
+    rp_task.start_time_ms        = time_ms + delay_ms;
+    rp_task.duration_time_ms     = GNSS_SCHEDULE_TASK_DURATION_MS;
+    rp_task.id                   = RP_TASK_GNSS;
+    rp_task.launch_task_callback = gnss_mw_schedule_rp_task_launch;
+    rp_task.end_task_callback    = gnss_mw_schedule_rp_task_done;
+    modem_rc                     = smtc_modem_rp_add_user_radio_access_task( &rp_task );
+    if( modem_rc == SMTC_MODEM_RC_OK )
+    {
+        GNSS_MW_TIME_CRITICAL_TRACE_PRINTF( "RP_TASK_GNSS - schedule task queued at %u + %u\n", time_ms, delay_ms );
+    }
+    else
+    {
+        MW_DBG_TRACE_ERROR( "RP_TASK_GNSS - failed to queue schedule task (0x%02X)\n", modem_rc );
+    }
+
+    return modem_rc;
+}
+
 static uint32_t gnss_mw_get_next_scan_delay( void )
 {
     if( current_scan_type == GNSS_MW_SCAN_TYPE_ASSISTED )
@@ -848,6 +1000,9 @@ static void gnss_mw_scan_rp_task_launch( void* context )
     
     scan_busy = true;
 
+    /* Released when the task is done */
+    smtc_modem_hal_wdog_heartbeat( WDOG_CLIENT_GNSS, GNSS_SCAN_WDOG_DEADLINE_MS );
+
     MW_DBG_TRACE_PRINTF( "---- internal scan start (%d) ----\n", scan_type );
 
     err = smtc_modem_get_time( &gps_time, &fractional_seconds );
@@ -961,6 +1116,8 @@ void gnss_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
     uint32_t                     time_ms;
     uint32_t                     meas_time;
     uint32_t                     power_consumption_uah;
+    uint32_t                     radio_uah;
+    uint32_t                     computation_uah;
 
     /* -------------------------------------------------------------------------
        WARNING: put the radio back to sleep before exiting this function.
@@ -976,6 +1133,7 @@ void gnss_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
 
     /* GNSS task completed or aborted - first thing to be done */
     smtc_gnss_scan_ended( );
+    smtc_modem_hal_wdog_release( WDOG_CLIENT_GNSS );
 
     if( irq_status == SMTC_RP_RADIO_ABORTED ) /* by RP or by user */
     {
@@ -1030,13 +1188,18 @@ void gnss_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
 
         /* Get scan results from LR1110 */
         memset( &scan_results, 0, sizeof scan_results );
-        scan_results.timestamp = mw_get_gps_time( );
+        scan_results.timestamp     = mw_get_gps_time( );
+        scan_results.predicted_svs = scan_scheduler_predicted_svs;
+        scan_scheduler_predicted_svs = 0;
         scan_results_rc =
             smtc_gnss_get_results( modem_radio_ctx->ral.context, GNSS_RESULT_SIZE_MAX_MODE3, &scan_results.results_size,
                                    &scan_results.results_buffer[GNSS_SCAN_METADATA_SIZE], &scan_results_no_sv );
 
         /* Get scan power consumption and aggregate it to the scan group power consumption */
-        smtc_gnss_get_power_consumption( modem_radio_ctx->ral.context, &power_consumption_uah );
+        smtc_gnss_get_power_consumption_split( modem_radio_ctx->ral.context, &radio_uah, &computation_uah );
+        smtc_modem_rp_add_user_radio_access_charge( RP_TASK_GNSS, radio_uah, computation_uah );
+        smtc_modem_energy_governor_add_scan_charge( SMTC_MODEM_ENERGY_ACTIVITY_GNSS, radio_uah + computation_uah );
+        power_consumption_uah = radio_uah + computation_uah;
         GNSS_MW_TIME_CRITICAL_TRACE_PRINTF( "Scan power consumption: %u uah\n", power_consumption_uah );
         gnss_scan_group_queue.power_consumption_uah += power_consumption_uah;
 
@@ -1045,6 +1208,20 @@ void gnss_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
             /* Get detailed info about the scan */
             smtc_gnss_get_sv_info( modem_radio_ctx->ral.context, GNSS_NB_SVS_MAX, &scan_results.detected_svs,
                                    scan_results.info_svs );
+            /* The next scans of the group are not scheduled, their prediction is read after the scan, from the
+             * visible satellites cache when it is recent enough */
+            if( ( scan_results.predicted_svs == 0 ) && ( scan_scheduler_enabled == true ) &&
+                ( autonomous_scan_for_indoor_check == false ) && ( current_scan_type == GNSS_MW_SCAN_TYPE_ASSISTED ) )
+            {
+                smtc_gnss_get_nb_visible_svs( modem_radio_ctx->ral.context, lr11xx_scan_context.gps_time,
+                                              &current_assistance_position, current_constellations,
+                                              GNSS_VISIBLE_SVS_CACHE_COUNT_MAX_AGE_S, &scan_results.predicted_svs );
+            }
+            if( scan_results.predicted_svs > 0 )
+            {
+                gnss_scheduler_account_scan( &scan_scheduler_stats, scan_results.predicted_svs,
+                                             scan_results.detected_svs );
+            }
 
             if( autonomous_scan_for_indoor_check == true )
             {
@@ -1168,10 +1345,11 @@ void gnss_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
                         /* static variables because there is no copy done by LBM for extended send API */
                         static uint8_t* buffer_to_send;
                         static uint8_t  buffer_to_send_size;
+                        uint8_t         nb_scans_to_send;
 
                         /* Is there any scan to be sent ? */
-                        if( gnss_scan_group_queue_pop( &gnss_scan_group_queue, &buffer_to_send,
-                                                       &buffer_to_send_size ) == false )
+                        if( gnss_mw_scan_group_pop( &buffer_to_send, &buffer_to_send_size, &nb_scans_to_send ) ==
+                            false )
                         {
                             /* No SV detected for this scan group, program an autonomous scan for indoor check / aiding
                              * position check */
@@ -1202,7 +1380,7 @@ void gnss_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
                                     }
                                     else
                                     {
-                                        stat_nb_scans_sent_within_current_scan_group += 1;
+                                        stat_nb_scans_sent_within_current_scan_group += nb_scans_to_send;
                                     }
                                 }
                                 else
@@ -1271,6 +1449,84 @@ void gnss_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
     mw_radio_set_sleep( modem_radio_ctx->ral.context );
 }
 
+static void gnss_mw_schedule_rp_task_launch( void* context )
+{
+    uint32_t                                 gps_time           = 0;
+    uint32_t                                 fractional_seconds = 0;
+    uint32_t                                 almanac_crc;
+    lr11xx_gnss_solver_assistance_position_t aiding_position;
+
+    /* Without time or scan context no prediction, the scan is queued as requested and its launch reports the error */
+    scan_scheduler_decision      = GNSS_SCHEDULER_SCAN_NOW;
+    scan_scheduler_delay_s       = 0;
+    scan_scheduler_predicted_svs = 0;
+
+    /* Reading the almanac CRC also drops the visible satellites cache if a new almanac has been written */
+    if( ( smtc_modem_get_time( &gps_time, &fractional_seconds ) == SMTC_MODEM_RC_OK ) &&
+        ( smtc_gnss_get_scan_context( modem_radio_ctx->ral.context, &aiding_position, &almanac_crc ) == true ) )
+    {
+        if( user_aiding_position_update_received == true )
+        {
+            /* Written to the LR11xx when the scan is launched */
+            aiding_position = user_aiding_position_update;
+        }
+
+        scan_scheduler_decision = gnss_scheduler_schedule(
+            &scan_scheduler_config, modem_radio_ctx->ral.context, gps_time, &aiding_position, current_constellations,
+            &scan_scheduler_delay_s, &scan_scheduler_predicted_svs );
+    }
+    scan_scheduler_done = true;
+
+    /* No radio operation to wait for, the done callback queues the scan */
+    MW_ASSERT_SMTC_MODEM_RC( smtc_modem_rp_abort_user_radio_access_task( RP_TASK_GNSS ) );
+}
+
+static void gnss_mw_schedule_rp_task_done( smtc_modem_rp_status_t* status )
+{
+    /* -------------------------------------------------------------------------
+       WARNING: put the radio back to sleep before exiting this function.
+       ---------------------------------------------------------------------- */
+
+    if( task_cancelled_by_user == true )
+    {
+        MW_DBG_TRACE_WARNING( "RP_TASK_GNSS(%d) - task cancelled by user\n", __LINE__ );
+
+        /* reset cancel request status */
+        task_cancelled_by_user = false;
+
+        /* Send an event to application to notify for error */
+        gnss_mw_send_event( GNSS_MW_EVENT_SCAN_CANCELLED );
+    }
+    else if( scan_scheduler_done == false )
+    {
+        MW_DBG_TRACE_WARNING( "RP_TASK_GNSS(%d) - schedule task aborted by RP\n", __LINE__ );
+
+        /* No prediction, scan as requested */
+        MW_ASSERT_SMTC_MODEM_RC( gnss_mw_scan_next( 0 ) );
+    }
+    else
+    {
+        gnss_scheduler_account_decision( &scan_scheduler_stats, scan_scheduler_decision );
+        MW_DBG_TRACE_INFO( "Scheduler: decision %d, scan in %us (%u SV predicted)\n", scan_scheduler_decision,
+                           scan_scheduler_delay_s, scan_scheduler_predicted_svs );
+
+        if( scan_scheduler_decision == GNSS_SCHEDULER_SCAN_SKIP )
+        {
+            MW_DBG_TRACE_WARNING( "Scan skipped, too few satellites predicted\n" );
+            gnss_mw_send_event( GNSS_MW_EVENT_SCAN_SKIPPED );
+        }
+        else
+        {
+            /* The postponed scan is a later task, it can still be cancelled until it is launched */
+            MW_ASSERT_SMTC_MODEM_RC( gnss_mw_scan_next( scan_scheduler_delay_s ) );
+        }
+    }
+    scan_scheduler_done = false;
+
+    /* Set the radio back to sleep */
+    mw_radio_set_sleep( modem_radio_ctx->ral.context );
+}
+
 static void gnss_mw_prepare_apc_msg( const lr11xx_gnss_solver_assistance_position_t* current_assistance_position,
                                      gnss_scan_t*                                    scan )
 {
@@ -1305,9 +1561,10 @@ static void gnss_mw_tx_done_callback( void )
     /* static variables because there is no copy done by LBM for extended send API */
     static uint8_t* buffer_to_send;
     static uint8_t  buffer_to_send_size;
+    uint8_t         nb_scans_to_send;
 
     /* Get the next scan to be sent from the scan group queue */
-    if( gnss_scan_group_queue_pop( &gnss_scan_group_queue, &buffer_to_send, &buffer_to_send_size ) == true )
+    if( gnss_mw_scan_group_pop( &buffer_to_send, &buffer_to_send_size, &nb_scans_to_send ) == true )
     {
         /* Send uplink */
         if( gnss_mw_send_frame( buffer_to_send, buffer_to_send_size, lorawan_port ) == false )
@@ -1317,7 +1574,7 @@ static void gnss_mw_tx_done_callback( void )
         }
         else
         {
-            stat_nb_scans_sent_within_current_scan_group += 1;
+            stat_nb_scans_sent_within_current_scan_group += nb_scans_to_send;
         }
     }
     else
@@ -1327,6 +1584,28 @@ static void gnss_mw_tx_done_callback( void )
     }
 }
 
+static bool gnss_mw_scan_group_pop( uint8_t** buffer, uint8_t* buffer_size, uint8_t* nb_scans )
+{
+    const uint8_t first_index = gnss_scan_group_queue.next_send_index;
+    uint8_t       tx_max_payload;
+    bool          ready;
+
+    /* The application copy buffers are sized for a single NAV message */
+    if( ( scan_group_packing == true ) && ( enable_copy_send_buffer == false ) )
+    {
+        MW_ASSERT_SMTC_MODEM_RC( smtc_modem_get_next_tx_max_payload( modem_stack_id, &tx_max_payload ) );
+        ready = gnss_scan_group_queue_pop_packed( &gnss_scan_group_queue, tx_max_payload, buffer, buffer_size );
+    }
+    else
+    {
+        ready = gnss_scan_group_queue_pop( &gnss_scan_group_queue, buffer, buffer_size );
+    }
+
+    *nb_scans = gnss_scan_group_queue.next_send_index - first_index;
+
+    return ready;
+}
+
 static bool gnss_mw_send_frame( const uint8_t* tx_frame_buffer, const uint8_t tx_frame_buffer_size, uint8_t port )
 {
     smtc_modem_return_code_t modem_response_code = SMTC_MODEM_RC_OK;
@@ -53,6 +53,7 @@ extern "C" {
 
 #include "gnss_helpers_defs.h"
 #include "gnss_queue_defs.h"
+#include "gnss_scheduler.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -64,6 +65,11 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Maximum scheduling window of the predictive scan scheduler, in seconds
+ */
+#define GNSS_MW_SCHEDULER_WINDOW_MAX_S ( 3600 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -102,6 +108,7 @@ typedef enum
     GNSS_MW_EVENT_ERROR_NO_AIDING_POSITION =
         5,                            //!< Scan operation has failed because the assistance position is not configured
     GNSS_MW_EVENT_ERROR_UNKNOWN = 6,  //!< Scan operation has failed for an unknown reason
+    GNSS_MW_EVENT_SCAN_SKIPPED  = 7,  //!< Scan operation has been skipped, too few satellites predicted (scheduler)
     /* 8 event types max */
 } gnss_mw_event_type_t;
 
@@ -139,6 +146,7 @@ typedef struct
     uint8_t           nav_size;   //!< NAV message size
     bool              nav_valid;  //!< is the NAV message valid (can be used by the solver for a single frame solve)
     uint8_t           nb_svs;     //!< Number of Space Vehicles detected by this scan
+    uint8_t nb_svs_predicted;  //!< Number of visible Space Vehicles predicted for this scan (0 if scheduler disabled)
     gnss_mw_sv_info_t info_svs[GNSS_NB_SVS_MAX];  //!< Information about the SVs detected
 } gnss_mw_event_data_scan_desc_t;
 
@@ -307,6 +315,44 @@ void gnss_mw_scan_aggregate( bool aggregate );
  */
 void gnss_mw_send_bypass( bool no_send );
 
+/**
+ * @brief Pack the NAV messages of a scan group in as few uplinks as the next uplink maximum payload allows.
+ * The NAV messages following the first one of a frame are delta encoded against the previous one. The frames have to
+ * be unpacked with the decoder of gnss_group_codec.h before being forwarded to the solver.
+ *
+ * @param [in] pack Boolean to pack or not the scan group results
+ *
+ * By default it is set to false, meaning that each NAV message is sent in its own uplink
+ */
+void gnss_mw_scan_group_packing( bool pack );
+
+/**
+ * @brief Enable the predictive scan scheduler for all subsequent scan & send sequences (optional)
+ *
+ * When enabled, the number of visible satellites is predicted from the LR11xx almanac and the assistance position
+ * by a short radio planner task at the requested time of the first assisted scan of a scan group, before the scan task
+ * is queued. The scan is moved to the best time within the given window, or
+ * skipped with a GNSS_MW_EVENT_SCAN_SKIPPED event if fewer than min_svs satellites are predicted over the whole window.
+ *
+ * @param [in] enable Boolean to enable or not the scheduler
+ * @param [in] window_s Maximum delay in seconds a scan can be postponed by (0 only allows to skip scans)
+ * @param [in] min_svs Minimum number of predicted visible satellites to scan
+ *
+ * @return Middleware return code as defined in @ref mw_return_code_t
+ * @retval MW_RC_OK         Command executed without errors
+ * @retval MW_RC_FAILED     The window is greater than GNSS_MW_SCHEDULER_WINDOW_MAX_S
+ *
+ * By default it is disabled
+ */
+mw_return_code_t gnss_mw_set_scan_scheduler( bool enable, uint32_t window_s, uint8_t min_svs );
+
+/**
+ * @brief Get the predictive scan scheduler statistics (predicted versus detected satellites, moved and skipped scans)
+ *
+ * @param [out] stats Scheduler statistics since the middleware initialization
+ */
+void gnss_mw_get_scan_scheduler_stats( gnss_scheduler_stats_t* stats );
+
 /**
  * @brief Print the results of the GNSS_MW_EVENT_SCAN_DONE event
  *
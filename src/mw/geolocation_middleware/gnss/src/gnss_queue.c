@@ -259,6 +259,50 @@ bool gnss_scan_group_queue_pop( gnss_scan_group_queue_t* queue, uint8_t** buffer
     return false;
 }
 
+bool gnss_scan_group_queue_pop_packed( gnss_scan_group_queue_t* queue, uint8_t size_max, uint8_t** buffer,
+                                       uint8_t* buffer_size )
+{
+    gnss_group_codec_encoder_t encoder;
+    uint8_t                    index;
+
+    if( ( queue != NULL ) && gnss_scan_group_queue_is_valid( queue ) &&
+        ( queue->next_send_index < queue->nb_scans_valid ) )
+    {
+        if( size_max > GNSS_SCAN_GROUP_PACKED_SIZE_MAX )
+        {
+            size_max = GNSS_SCAN_GROUP_PACKED_SIZE_MAX;
+        }
+
+        gnss_group_codec_encoder_init( &encoder, queue->packed_buffer, size_max, queue->token );
+
+        index = queue->next_send_index;
+        while( ( index < queue->nb_scans_valid ) &&
+               gnss_group_codec_encoder_add( &encoder, &queue->scans[index].results_buffer[GNSS_SCAN_METADATA_SIZE],
+                                             queue->scans[index].results_size ) )
+        {
+            index += 1;
+        }
+
+        /* Packing is only worth it with several NAV messages */
+        if( ( index - queue->next_send_index ) > 1 )
+        {
+            /* Update queue info */
+            queue->next_send_index = index;
+
+            /* Return a pointer to the buffer to be sent, and its size */
+            *buffer      = queue->packed_buffer;
+            *buffer_size = gnss_group_codec_encoder_close( &encoder, index == queue->nb_scans_valid );
+
+            GNSS_QUEUE_TRACE_PRINTF( "%s:\n", __FUNCTION__ );
+            GNSS_QUEUE_PRINT( queue );
+
+            return true;
+        }
+    }
+
+    return gnss_scan_group_queue_pop( queue, buffer, buffer_size );
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
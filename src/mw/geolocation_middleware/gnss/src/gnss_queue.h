@@ -50,6 +50,7 @@ extern "C" {
 #include "gnss_helpers.h"
 #include "gnss_helpers_defs.h"
 #include "gnss_queue_defs.h"
+#include "gnss_group_codec.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -76,6 +77,11 @@ extern "C" {
  */
 #define GNSS_SCAN_SINGLE_NAV_MIN_SV 6
 
+/**
+ * @brief Maximum size of a frame packing several NAV messages of a scan group (maximum LoRaWAN application payload)
+ */
+#define GNSS_SCAN_GROUP_PACKED_SIZE_MAX 242
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -92,6 +98,7 @@ typedef struct
     uint8_t                          results_buffer[GNSS_SCAN_METADATA_SIZE + GNSS_RESULT_SIZE_MAX_MODE3];
     lr11xx_gnss_detected_satellite_t info_svs[GNSS_NB_SVS_MAX];  //!< Information about each SV detected (ID, CNR...)
     bool nav_valid;  //!< Indicates if a single NAV can be used by the solver to get a position */
+    uint8_t predicted_svs;  //!< Number of visible Space Vehicles predicted for the scan (0 if not predicted)
 } gnss_scan_t;
 
 /**
@@ -108,6 +115,7 @@ typedef struct
     uint8_t next_send_index;  //!< Scan index to be sent next
     uint32_t power_consumption_uah;  //!< Power consumption of the complete scan group
     bool     stop;                   //!< Current scan group can be stopped and sent
+    uint8_t  packed_buffer[GNSS_SCAN_GROUP_PACKED_SIZE_MAX];  //!< Frame packing several NAV messages to be sent
 } gnss_scan_group_queue_t;
 
 /*
@@ -193,6 +201,21 @@ void gnss_scan_group_queue_push( gnss_scan_group_queue_t* queue, gnss_scan_t* sc
  */
 bool gnss_scan_group_queue_pop( gnss_scan_group_queue_t* queue, uint8_t** buffer, uint8_t* buffer_size );
 
+/*!
+ * @brief Prepare a payload packing as many of the next scan results as fit in the given size.
+ * The format of the payload is described in gnss_group_codec.h. When a single scan result fits, the payload has the
+ * format of gnss_scan_group_queue_pop() which is shorter.
+ *
+ * @param[in] queue Queue from which the results are popped
+ * @param[in] size_max Maximum size of the payload
+ * @param[out] buffer Pointer to the prepared buffer ready to be sent over the air
+ * @param[out] buffer_size Size of the buffer to be sent
+ *
+ * @return a boolean set to true is a payload is ready to be sent, false if there is no result to be sent
+ */
+bool gnss_scan_group_queue_pop_packed( gnss_scan_group_queue_t* queue, uint8_t size_max, uint8_t** buffer,
+                                       uint8_t* buffer_size );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,150 @@
+/**
+ * @file      gnss_scheduler.c
+ *
+ * @brief     Predictive GNSS scan scheduling from the almanac based visible satellites prediction.
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include "gnss_scheduler.h"
+#include "gnss_helpers.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+uint32_t gnss_scheduler_get_candidate_delay( const gnss_scheduler_config_t* config, uint8_t index )
+{
+    if( ( config->nb_candidates < 2 ) || ( index == 0 ) )
+    {
+        return 0;
+    }
+
+    return ( config->window_s * index ) / ( config->nb_candidates - 1 );
+}
+
+gnss_scheduler_decision_t gnss_scheduler_select( const gnss_scheduler_config_t* config, const uint8_t* predicted_svs,
+                                                 uint8_t* selected_index )
+{
+    uint8_t best_index = 0;
+
+    *selected_index = 0;
+
+    /* Earliest candidate with the highest number of predicted satellites */
+    for( uint8_t i = 1; i < config->nb_candidates; i++ )
+    {
+        if( predicted_svs[i] > predicted_svs[best_index] )
+        {
+            best_index = i;
+        }
+    }
+
+    if( predicted_svs[best_index] < config->min_svs )
+    {
+        return GNSS_SCHEDULER_SCAN_SKIP;
+    }
+
+    /* Do not delay a scan which can already be done for a marginal gain */
+    if( ( predicted_svs[0] >= config->min_svs ) &&
+        ( ( predicted_svs[best_index] - predicted_svs[0] ) < GNSS_SCHEDULER_MIN_GAIN_SVS ) )
+    {
+        return GNSS_SCHEDULER_SCAN_NOW;
+    }
+
+    *selected_index = best_index;
+    return ( best_index == 0 ) ? GNSS_SCHEDULER_SCAN_NOW : GNSS_SCHEDULER_SCAN_POSTPONE;
+}
+
+gnss_scheduler_decision_t gnss_scheduler_schedule( const gnss_scheduler_config_t* config, const void* radio_context,
+                                                   const uint32_t                                  date,
+                                                   const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                                   const lr11xx_gnss_constellation_mask_t constellations,
+                                                   uint32_t* delay_s, uint8_t* predicted_svs )
+{
+    uint8_t                   candidate_svs[GNSS_SCHEDULER_NB_CANDIDATES_MAX];
+    uint8_t                   selected_index;
+    gnss_scheduler_decision_t decision;
+    uint32_t                  max_age_s = GNSS_VISIBLE_SVS_CACHE_COUNT_MAX_AGE_S;
+
+    *delay_s       = 0;
+    *predicted_svs = 0;
+
+    /* Each candidate gets its own prediction, a cached one only if read closer to it than to the other candidates */
+    if( ( config->nb_candidates > 1 ) && ( gnss_scheduler_get_candidate_delay( config, 1 ) / 2 < max_age_s ) )
+    {
+        max_age_s = gnss_scheduler_get_candidate_delay( config, 1 ) / 2;
+    }
+
+    for( uint8_t i = 0; i < config->nb_candidates; i++ )
+    {
+        if( smtc_gnss_get_nb_visible_svs( radio_context, date + gnss_scheduler_get_candidate_delay( config, i ),
+                                          assistance_position, constellations, max_age_s,
+                                          &candidate_svs[i] ) == false )
+        {
+            /* No prediction available, scan as requested */
+            return GNSS_SCHEDULER_SCAN_NOW;
+        }
+    }
+
+    decision = gnss_scheduler_select( config, candidate_svs, &selected_index );
+    if( decision != GNSS_SCHEDULER_SCAN_SKIP )
+    {
+        *delay_s       = gnss_scheduler_get_candidate_delay( config, selected_index );
+        *predicted_svs = candidate_svs[selected_index];
+    }
+
+    return decision;
+}
+
+void gnss_scheduler_account_decision( gnss_scheduler_stats_t* stats, gnss_scheduler_decision_t decision )
+{
+    if( decision == GNSS_SCHEDULER_SCAN_POSTPONE )
+    {
+        stats->nb_scans_postponed += 1;
+    }
+    else if( decision == GNSS_SCHEDULER_SCAN_SKIP )
+    {
+        stats->nb_scans_skipped += 1;
+    }
+}
+
+void gnss_scheduler_account_scan( gnss_scheduler_stats_t* stats, uint8_t predicted_svs, uint8_t detected_svs )
+{
+    stats->nb_scans_predicted += 1;
+    stats->predicted_svs_sum += predicted_svs;
+    stats->detected_svs_sum += detected_svs;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
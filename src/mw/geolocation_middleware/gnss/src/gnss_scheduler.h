@@ -0,0 +1,184 @@
+/**
+ * @file      gnss_scheduler.h
+ *
+ * @brief     Predictive GNSS scan scheduling from the almanac based visible satellites prediction.
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GNSS_SCHEDULER_H
+#define GNSS_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_gnss_types.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/**
+ * @brief Maximum number of candidate scan times evaluated in a scheduling window
+ */
+#define GNSS_SCHEDULER_NB_CANDIDATES_MAX ( 8 )
+
+/**
+ * @brief Minimum gain in predicted satellites to postpone a scan which could be done right away
+ */
+#define GNSS_SCHEDULER_MIN_GAIN_SVS ( 2 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Scheduling decision for a scan
+ */
+typedef enum
+{
+    GNSS_SCHEDULER_SCAN_NOW,       //!< Scan at the requested time
+    GNSS_SCHEDULER_SCAN_POSTPONE,  //!< Scan later in the window, more satellites are predicted
+    GNSS_SCHEDULER_SCAN_SKIP,      //!< Do not scan, too few satellites are predicted in the whole window
+} gnss_scheduler_decision_t;
+
+/**
+ * @brief Configuration of the scan scheduler
+ */
+typedef struct
+{
+    uint32_t window_s;       //!< Maximum delay in seconds a scan can be postponed by
+    uint8_t  nb_candidates;  //!< Number of candidate scan times evenly spread over the window, first one is now
+    uint8_t  min_svs;        //!< Minimum number of predicted satellites to scan
+} gnss_scheduler_config_t;
+
+/**
+ * @brief Scan scheduler statistics, predicted versus detected satellites
+ */
+typedef struct
+{
+    uint32_t nb_scans_predicted;  //!< Number of scans done with a visible satellites prediction
+    uint32_t nb_scans_postponed;  //!< Number of scans moved later in the window
+    uint32_t nb_scans_skipped;    //!< Number of scans skipped for too few predicted satellites
+    uint32_t predicted_svs_sum;   //!< Sum of the predicted satellites of the scans done
+    uint32_t detected_svs_sum;    //!< Sum of the detected satellites of the scans done
+} gnss_scheduler_stats_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * @brief Get the delay of a candidate scan time from the requested scan time
+ *
+ * @param[in] config Scheduler configuration
+ * @param[in] index Candidate index, 0 is the requested scan time
+ *
+ * @return the candidate delay in seconds
+ */
+uint32_t gnss_scheduler_get_candidate_delay( const gnss_scheduler_config_t* config, uint8_t index );
+
+/*!
+ * @brief Select the scan time among the candidates from their predicted number of visible satellites
+ *
+ * The earliest candidate with the highest prediction is selected. The scan is not postponed if the requested time
+ * already has enough satellites and less than GNSS_SCHEDULER_MIN_GAIN_SVS would be gained.
+ *
+ * @param[in] config Scheduler configuration
+ * @param[in] predicted_svs Predicted number of visible satellites of each candidate (config->nb_candidates values)
+ * @param[out] selected_index Index of the selected candidate
+ *
+ * @return the scheduling decision
+ */
+gnss_scheduler_decision_t gnss_scheduler_select( const gnss_scheduler_config_t* config, const uint8_t* predicted_svs,
+                                                 uint8_t* selected_index );
+
+/*!
+ * @brief Predict the visible satellites of each candidate scan time from the LR11xx almanac and select one
+ *
+ * The predictions not in the visible satellites cache are read from the LR11xx: to be called only while the radio
+ * planner gives the radio access (from a radio planner task callback).
+ *
+ * @param[in] config Scheduler configuration
+ * @param[in] radio_context Chip implementation context
+ * @param[in] date GPS time of the requested scan
+ * @param[in] assistance_position Aiding position of the scan
+ * @param[in] constellations GNSS constellations to be scanned
+ * @param[out] delay_s Delay in seconds of the selected candidate from the requested scan time
+ * @param[out] predicted_svs Predicted number of visible satellites of the selected candidate, 0 if not predicted
+ *
+ * @return the scheduling decision, GNSS_SCHEDULER_SCAN_NOW if the prediction could not be read
+ */
+gnss_scheduler_decision_t gnss_scheduler_schedule( const gnss_scheduler_config_t* config, const void* radio_context,
+                                                   const uint32_t                                  date,
+                                                   const lr11xx_gnss_solver_assistance_position_t* assistance_position,
+                                                   const lr11xx_gnss_constellation_mask_t constellations,
+                                                   uint32_t* delay_s, uint8_t* predicted_svs );
+
+/*!
+ * @brief Account a scheduling decision in the statistics
+ *
+ * @param[in,out] stats Scheduler statistics
+ * @param[in] decision Scheduling decision
+ */
+void gnss_scheduler_account_decision( gnss_scheduler_stats_t* stats, gnss_scheduler_decision_t decision );
+
+/*!
+ * @brief Account a completed scan in the statistics
+ *
+ * @param[in,out] stats Scheduler statistics
+ * @param[in] predicted_svs Predicted number of visible satellites for the scan
+ * @param[in] detected_svs Number of satellites detected by the scan
+ */
+void gnss_scheduler_account_scan( gnss_scheduler_stats_t* stats, uint8_t predicted_svs, uint8_t detected_svs );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // GNSS_SCHEDULER_H
+
+/* --- EOF ------------------------------------------------------------------ */
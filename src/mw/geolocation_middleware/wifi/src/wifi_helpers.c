@@ -203,10 +203,29 @@ bool smtc_wifi_get_results( const void* radio_context, wifi_scan_all_result_t* w
 }
 
 bool smtc_wifi_get_power_consumption( const void* radio_context, uint32_t* power_consumption_uah )
+{
+    uint32_t radio_uah;
+    uint32_t demodulation_uah;
+    bool     ret;
+
+    ret                    = smtc_wifi_get_power_consumption_split( radio_context, &radio_uah, &demodulation_uah );
+    *power_consumption_uah = radio_uah + demodulation_uah;
+
+    return ret;
+}
+
+bool smtc_wifi_get_power_consumption_split( const void* radio_context, uint32_t* radio_uah,
+                                            uint32_t* demodulation_uah )
 {
     lr11xx_status_t                  status;
     lr11xx_wifi_cumulative_timings_t timing;
+    lr11xx_wifi_cumulative_timings_t radio_timing;
     lr11xx_system_reg_mode_t         reg_mode;
+    uint32_t                         power_consumption_uah;
+
+    /* Initialize output values, in case this function returns with an error */
+    *radio_uah        = 0;
+    *demodulation_uah = 0;
 
     status = lr11xx_wifi_read_cumulative_timing( radio_context, &timing );
     if( status != LR11XX_STATUS_OK )
@@ -216,10 +235,20 @@ bool smtc_wifi_get_power_consumption( const void* radio_context, uint32_t* power
     }
 
     mw_bsp_get_lr11xx_reg_mode( radio_context, &reg_mode );
-    *power_consumption_uah = ( uint32_t ) lr11xx_wifi_get_consumption( reg_mode, timing );
+    power_consumption_uah = ( uint32_t ) lr11xx_wifi_get_consumption( reg_mode, timing );
+
+    /* The demodulation part is what remains once the radio acquisition alone is accounted */
+    radio_timing                 = timing;
+    radio_timing.demodulation_us = 0;
+    *radio_uah                   = ( uint32_t ) lr11xx_wifi_get_consumption( reg_mode, radio_timing );
+    if( *radio_uah > power_consumption_uah )
+    {
+        *radio_uah = power_consumption_uah;
+    }
+    *demodulation_uah = power_consumption_uah - *radio_uah;
 
     /* Accumulate timings until there is a significant amount of energy consumed */
-    if( *power_consumption_uah > 0 )
+    if( power_consumption_uah > 0 )
     {
         status = lr11xx_wifi_reset_cumulative_timing( radio_context );
         if( status != LR11XX_STATUS_OK )
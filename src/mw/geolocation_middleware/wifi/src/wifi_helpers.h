@@ -111,6 +111,18 @@ void smtc_wifi_scan_ended( void );
  */
 bool smtc_wifi_get_power_consumption( const void* radio_context, uint32_t* power_consumption_uah );
 
+/*!
+ * @brief Get the power consumption of the last scan, split between radio acquisition and demodulation
+ *
+ * @param [in] radio_context Chip implementation context
+ * @param [out] radio_uah Power consumption of the radio acquisition of the last scan in uAh
+ * @param [out] demodulation_uah Power consumption of the software demodulation of the last scan in uAh
+ *
+ * @return a boolean: true for success, false otherwise
+ */
+bool smtc_wifi_get_power_consumption_split( const void* radio_context, uint32_t* radio_uah,
+                                            uint32_t* demodulation_uah );
+
 #ifdef __cplusplus
 }
 #endif
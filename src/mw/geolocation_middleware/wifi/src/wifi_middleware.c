@@ -97,6 +97,11 @@
  */
 #define RP_TASK_WIFI SMTC_MODEM_RP_TASK_ID2
 
+/**
+ * @brief Longest time between the start of a scan and its end, twice the radio planner task duration
+ */
+#define WIFI_SCAN_WDOG_DEADLINE_MS ( 20 * 1000 )
+
 /**
  * @brief LoRaWAN port used for uplinks of the WIFI scan results
  */
@@ -337,6 +342,9 @@ mw_return_code_t wifi_mw_scan_start( uint32_t start_delay )
     wifi_settings.timeout_per_scan    = WIFI_TIMEOUT_PER_SCAN_DEFAULT;
     smtc_wifi_settings_init( &wifi_settings );
 
+    /* Stretch the scan delay according to the energy budget */
+    smtc_modem_energy_governor_get_scan_delay( start_delay, &start_delay );
+
     /* Prepare the task for next scan, add 300ms to avoid schedule a task in the past */
     time_ms = smtc_modem_hal_get_time_in_ms( ) + 300;
 
@@ -549,6 +557,10 @@ static void wifi_mw_scan_rp_task_launch( void* context )
     /* From now, the scan sequence can not be cancelled */
     task_running = true;
     scan_busy = true;
+
+    /* Released when the task is done */
+    smtc_modem_hal_wdog_heartbeat( WDOG_CLIENT_WIFI, WIFI_SCAN_WDOG_DEADLINE_MS );
+
     /* Reset previous results */
     wifi_mw_reset_results( );
 
@@ -583,6 +595,7 @@ void wifi_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
 
     /* WIFI scan completed or aborted - first thing to be done */
     smtc_wifi_scan_ended( );
+    smtc_modem_hal_wdog_release( WDOG_CLIENT_WIFI );
 
     if( irq_status == SMTC_RP_RADIO_ABORTED )
     {
@@ -621,7 +634,9 @@ void wifi_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
     }
     else if( irq_status == SMTC_RP_RADIO_WIFI_SCAN_DONE )
     {
-        bool scan_results_rc;
+        bool     scan_results_rc;
+        uint32_t radio_uah;
+        uint32_t demodulation_uah;
 
         memset( &wifi_results, 0, sizeof wifi_results );
 
@@ -632,7 +647,10 @@ void wifi_mw_scan_rp_task_done( smtc_modem_rp_status_t* status )
         scan_results_rc = smtc_wifi_get_results( modem_radio_ctx->ral.context, &wifi_results );
 
         /* Get scan power consumption */
-        smtc_wifi_get_power_consumption( modem_radio_ctx->ral.context, &wifi_results.power_consumption_uah );
+        smtc_wifi_get_power_consumption_split( modem_radio_ctx->ral.context, &radio_uah, &demodulation_uah );
+        smtc_modem_rp_add_user_radio_access_charge( RP_TASK_WIFI, radio_uah, demodulation_uah );
+        smtc_modem_energy_governor_add_scan_charge( SMTC_MODEM_ENERGY_ACTIVITY_WIFI, radio_uah + demodulation_uah );
+        wifi_results.power_consumption_uah = radio_uah + demodulation_uah;
 
         if( scan_results_rc == true )
         {
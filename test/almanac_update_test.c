@@ -0,0 +1,284 @@
+/*
+ * almanac_update_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Replays DAS almanac sessions through the almanac update service against a fake lr11xx
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <string.h>
+#include "test_utils.h"
+#include "lbm/smtc_modem_core/smtc_modem_services/headers/almanac_update.h"
+#include "lbm/smtc_modem_core/smtc_modem_services/smtc_modem_services_hal.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Fake lr11xx
+
+#define HEADER_BLOCK_ID 0x80
+#define SECONDS_PER_DAY (24UL * 3600)
+#define BLOCKS_PER_DOWNLINK 12
+
+static uint32_t fake_time_s = 100 * SECONDS_PER_DAY;
+static uint8_t fake_error_code = 0;
+static bool fake_push_fails = false;
+static uint32_t fake_almanac_crc = 0x12345678;
+static int fake_status_reads = 0;
+static int fake_pushes = 0;
+static uint8_t fake_pushed[1 + ALM_UPDATE_BLOCK_SIZE * BLOCKS_PER_DOWNLINK];
+static uint16_t fake_pushed_len = 0;
+
+uint32_t smtc_modem_services_get_time_s(void)
+{
+    return fake_time_s;
+}
+
+radio_return_code_t smtc_modem_services_lr11xx_gnss_get_context_status(const void* radio_ctx, uint8_t buff[9])
+{
+    ++fake_status_reads;
+    memset(buff, 0, 9);
+    buff[3] = fake_almanac_crc >> 0;     // Global almanac crc
+    buff[4] = fake_almanac_crc >> 8;
+    buff[5] = fake_almanac_crc >> 16;
+    buff[6] = fake_almanac_crc >> 24;
+    buff[7] = fake_error_code << 4;
+
+    return MODEM_SERVICES_RADIO_OK;
+}
+
+radio_return_code_t smtc_modem_services_lr11xx_gnss_push_dmc_msg(const void* radio_ctx, uint8_t* buff, uint16_t buff_len)
+{
+    if (fake_push_fails) return MODEM_SERVICES_RADIO_ERROR;
+
+    ++fake_pushes;
+    memcpy(fake_pushed, buff, buff_len);
+    fake_pushed_len = buff_len;
+
+    return MODEM_SERVICES_RADIO_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// DAS downlinks
+
+// Blocks first_id to first_id + count - 1, content derived from version
+static almanac_update_return_code_t downlink(uint8_t first_id, uint8_t count, uint8_t version)
+{
+    uint8_t payload[3 + ALM_UPDATE_BLOCK_SIZE * BLOCKS_PER_DOWNLINK];
+    payload[0] = 0;     // Up count
+    payload[1] = 0;     // Up delay
+    payload[2] = 0x0a;  // Opcode
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        uint8_t* block = &payload[3 + ALM_UPDATE_BLOCK_SIZE * i];
+        block[0] = first_id + i;
+        memset(&block[1], version ^ (first_id + i), ALM_UPDATE_BLOCK_SIZE - 1);
+    }
+
+    return almanac_update_process_downlink_payload(NULL, payload, 3 + ALM_UPDATE_BLOCK_SIZE * count);
+}
+
+static void full_almanac(uint8_t version)
+{
+    for (int first = 0; first < ALM_UPDATE_NB_BLOCKS; first += BLOCKS_PER_DOWNLINK)
+    {
+        const int count = ALM_UPDATE_NB_BLOCKS - first < BLOCKS_PER_DOWNLINK ? ALM_UPDATE_NB_BLOCKS - first : BLOCKS_PER_DOWNLINK;
+        TEST_CHECK_EQUAL(ALMANAC_OK, downlink(first, count, version));
+    }
+}
+
+static uint8_t pushed_blocks(void)
+{
+    return fake_pushed_len > 1 ? (fake_pushed_len - 1) / ALM_UPDATE_BLOCK_SIZE : 0;
+}
+
+static uint8_t nb_stale(void)
+{
+    uint8_t bitmap[ALM_UPDATE_NB_BLOCKS / 8];
+    return almanac_update_get_stale_blocks(bitmap);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_first_session(void)
+{
+    TEST_CHECK_EQUAL(ALM_UPDATE_NB_BLOCKS, nb_stale());
+
+    full_almanac(1);
+    TEST_CHECK_EQUAL((ALM_UPDATE_NB_BLOCKS + BLOCKS_PER_DOWNLINK - 1) / BLOCKS_PER_DOWNLINK, fake_pushes);
+
+    // Nothing verified yet, so no status read at the start of the session. Status is read once after the pushes, then
+    // served from the cache
+    uint8_t status[ALM_UPDATE_UPLINK_PAYLOAD_LENGTH];
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_create_uplink_payload(NULL, status));
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_create_uplink_payload(NULL, status));
+    uint32_t crc = 0;
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_verify(NULL, &crc));
+    TEST_CHECK_EQUAL(0x12345678, crc);
+    TEST_CHECK_EQUAL(1, fake_status_reads);
+
+    almanac_update_stats_t stats;
+    almanac_update_get_stats(&stats);
+    TEST_CHECK_EQUAL(ALM_UPDATE_NB_BLOCKS, stats.nb_blocks_known);
+    TEST_CHECK_EQUAL(ALM_UPDATE_NB_BLOCKS, stats.nb_blocks_pushed);
+    TEST_CHECK(stats.is_verified);
+    TEST_CHECK_EQUAL(0, nb_stale());
+}
+
+static void test_replayed_session(void)
+{
+    const int pushes = fake_pushes;
+    fake_time_s += 10 * SECONDS_PER_DAY;
+
+    // Same content: nothing reaches the lr11xx, the status read at the start of the session stays cached
+    full_almanac(1);
+    TEST_CHECK_EQUAL(pushes, fake_pushes);
+    uint32_t crc;
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_verify(NULL, &crc));
+    TEST_CHECK_EQUAL(2, fake_status_reads);
+
+    // New session of one downlink. 5 blocks changed in the middle of it: only those are pushed, in order. The message
+    // is rebuilt in place
+    TEST_CHECK_EQUAL(ALMANAC_OK, downlink(36, BLOCKS_PER_DOWNLINK, 1));
+    TEST_CHECK_EQUAL(pushes, fake_pushes);
+    uint8_t payload[3 + ALM_UPDATE_BLOCK_SIZE * BLOCKS_PER_DOWNLINK] = { 0, 0, 0x0a };
+    for (uint8_t i = 0; i < BLOCKS_PER_DOWNLINK; ++i)
+    {
+        uint8_t* block = &payload[3 + ALM_UPDATE_BLOCK_SIZE * i];
+        block[0] = 36 + i;
+        memset(&block[1], (i >= 4 && i < 9 ? 2 : 1) ^ (36 + i), ALM_UPDATE_BLOCK_SIZE - 1);
+    }
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_process_downlink_payload(NULL, payload, sizeof(payload)));
+    TEST_CHECK_EQUAL(pushes + 1, fake_pushes);
+    TEST_CHECK_EQUAL(5, pushed_blocks());
+    TEST_CHECK_EQUAL(0x0a, fake_pushed[0]);
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        const uint8_t* block = &fake_pushed[1 + ALM_UPDATE_BLOCK_SIZE * i];
+        TEST_CHECK_EQUAL(40 + i, block[0]);
+        TEST_CHECK_EQUAL(2 ^ (40 + i), block[1]);
+        TEST_CHECK_EQUAL(2 ^ (40 + i), block[ALM_UPDATE_BLOCK_SIZE - 1]);
+    }
+
+    // Status read at the start of each session, then again after the push
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_verify(NULL, &crc));
+    TEST_CHECK_EQUAL(4, fake_status_reads);
+
+    almanac_update_stats_t stats;
+    almanac_update_get_stats(&stats);
+    TEST_CHECK_EQUAL(ALM_UPDATE_NB_BLOCKS + 5, stats.nb_blocks_pushed);
+    TEST_CHECK_EQUAL(ALM_UPDATE_NB_BLOCKS + 2 * BLOCKS_PER_DOWNLINK - 5, stats.nb_blocks_skipped);
+}
+
+static void test_header_and_unknown_layout(void)
+{
+    // The header block is out of the tracked range and always pushed
+    for (int i = 0; i < 2; ++i)
+    {
+        const int pushes = fake_pushes;
+        TEST_CHECK_EQUAL(ALMANAC_OK, downlink(HEADER_BLOCK_ID, 1, 7));
+        TEST_CHECK_EQUAL(pushes + 1, fake_pushes);
+        TEST_CHECK_EQUAL(HEADER_BLOCK_ID, fake_pushed[1]);
+    }
+
+    // Not a whole number of blocks: pushed as is
+    const int pushes = fake_pushes;
+    uint8_t payload[2 + 1 + 7] = { 0, 0, 0x0b, 1, 2, 3, 4, 5, 6, 7 };
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_process_downlink_payload(NULL, payload, sizeof(payload)));
+    TEST_CHECK_EQUAL(pushes + 1, fake_pushes);
+    TEST_CHECK_EQUAL(8, fake_pushed_len);
+
+    TEST_CHECK_EQUAL(ALMANAC_ERROR, almanac_update_process_downlink_payload(NULL, payload, 2));
+}
+
+static void test_push_failure(void)
+{
+    // Blocks of a failed push are forgotten and pushed again next time
+    fake_push_fails = true;
+    TEST_CHECK_EQUAL(ALMANAC_ERROR, downlink(0, 3, 3));
+    fake_push_fails = false;
+    TEST_CHECK_EQUAL(3, nb_stale());
+
+    TEST_CHECK_EQUAL(ALMANAC_OK, downlink(0, 3, 3));
+    TEST_CHECK_EQUAL(3, pushed_blocks());
+    TEST_CHECK_EQUAL(0, nb_stale());
+}
+
+static void test_aging(void)
+{
+    // Blocks confirmed again by the DAS are younger than the others
+    fake_time_s += 20 * SECONDS_PER_DAY;
+    TEST_CHECK_EQUAL(ALMANAC_OK, downlink(36, BLOCKS_PER_DOWNLINK, 1));
+    fake_time_s += ALM_UPDATE_BLOCK_MAX_AGE_S - 20 * SECONDS_PER_DAY;
+    TEST_CHECK_EQUAL(0, nb_stale());
+
+    fake_time_s += 5 * SECONDS_PER_DAY;
+    TEST_CHECK_EQUAL(ALM_UPDATE_NB_BLOCKS - BLOCKS_PER_DOWNLINK, nb_stale());
+    uint8_t bitmap[ALM_UPDATE_NB_BLOCKS / 8];
+    almanac_update_get_stale_blocks(bitmap);
+    TEST_CHECK((bitmap[36 / 8] & (1 << (36 % 8))) == 0);
+    TEST_CHECK((bitmap[0] & 1) != 0);
+}
+
+static void test_lr11xx_error(void)
+{
+    // An error reported by the lr11xx drops the local tracking
+    TEST_CHECK_EQUAL(ALMANAC_OK, downlink(10, 1, 4));
+    fake_error_code = 3;
+    uint32_t crc;
+    TEST_CHECK_EQUAL(ALMANAC_ERROR, almanac_update_verify(NULL, &crc));
+    fake_error_code = 0;
+    TEST_CHECK_EQUAL(ALM_UPDATE_NB_BLOCKS, nb_stale());
+
+    const int pushes = fake_pushes;
+    full_almanac(1);
+    TEST_CHECK_EQUAL(pushes + (ALM_UPDATE_NB_BLOCKS + BLOCKS_PER_DOWNLINK - 1) / BLOCKS_PER_DOWNLINK, fake_pushes);
+}
+
+static void test_almanac_written_elsewhere(void)
+{
+    const int full_pushes = (ALM_UPDATE_NB_BLOCKS + BLOCKS_PER_DOWNLINK - 1) / BLOCKS_PER_DOWNLINK;
+    uint32_t crc;
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_verify(NULL, &crc));
+
+    // Almanac written by another path between two sessions: the blocks table no longer describes the lr11xx
+    fake_almanac_crc = 0x9abcdef0;
+    fake_time_s += SECONDS_PER_DAY;
+    int pushes = fake_pushes;
+    full_almanac(1);
+    TEST_CHECK_EQUAL(pushes + full_pushes, fake_pushes);
+    TEST_CHECK_EQUAL(ALMANAC_OK, almanac_update_verify(NULL, &crc));
+    TEST_CHECK_EQUAL(0x9abcdef0, crc);
+
+    // Unchanged at the next session: nothing is pushed
+    fake_time_s += SECONDS_PER_DAY;
+    pushes = fake_pushes;
+    full_almanac(1);
+    TEST_CHECK_EQUAL(pushes, fake_pushes);
+
+    // The end of that session is lost, the next one is told apart by the gap between downlinks
+    fake_almanac_crc = 0x0fedcba9;
+    fake_time_s += 2 * 3600;
+    full_almanac(1);
+    TEST_CHECK_EQUAL(pushes + full_pushes, fake_pushes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_first_session();
+    test_replayed_session();
+    test_header_and_unknown_layout();
+    test_push_failure();
+    test_aging();
+    test_lr11xx_error();
+    test_almanac_written_elsewhere();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
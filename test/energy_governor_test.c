@@ -0,0 +1,155 @@
+/*
+ * energy_governor_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Runs a synthetic uplink and GNSS consumption trace through the energy governor
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "test_utils.h"
+#include "lbm/smtc_modem_core/modem_services/energy_governor.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Trace
+
+#define BUDGET_UAH 300
+#define PERIOD_S 3600
+#define START_S 100
+#define STEP_S 60
+#define UPLINK_UA_MS (40000ULL * 100)       // 40 mA for 100 ms each minute
+#define GNSS_UA_MS (30000ULL * 5000)        // 30 mA for 5 s every 10 minutes
+#define GNSS_EVERY_STEPS 10
+#define NB_STEPS 59
+
+// First steps of each level, worked out from the thresholds: 50% is 5.4e8 uA.ms, 80% 8.64e8, 100% 1.08e9
+#define SAVING_STEP 22
+#define CRITICAL_STEP 40
+#define EXHAUSTED_STEP 50
+
+static energy_governor_level_t expected_level(int step)
+{
+    if (step >= EXHAUSTED_STEP) return ENERGY_GOVERNOR_LEVEL_EXHAUSTED;
+    if (step >= CRITICAL_STEP) return ENERGY_GOVERNOR_LEVEL_CRITICAL;
+    if (step >= SAVING_STEP) return ENERGY_GOVERNOR_LEVEL_SAVING;
+    return ENERGY_GOVERNOR_LEVEL_NORMAL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_disabled(void)
+{
+    energy_governor_t eg;
+    energy_governor_init(&eg);
+
+    // No budget: spending never degrades anything
+    energy_governor_add_charge(&eg, ENERGY_GOVERNOR_ACTIVITY_GNSS, 1000000ULL * ENERGY_GOVERNOR_UA_MS_PER_UAH);
+    TEST_CHECK(!energy_governor_update(&eg, START_S));
+    TEST_CHECK_EQUAL(ENERGY_GOVERNOR_LEVEL_NORMAL, energy_governor_get_level(&eg));
+    TEST_CHECK_EQUAL(60, energy_governor_get_scan_delay_s(&eg, 60, START_S));
+    TEST_CHECK_EQUAL(3, energy_governor_get_nb_trans(&eg, 3));
+    TEST_CHECK(energy_governor_is_optional_allowed(&eg));
+    TEST_CHECK_EQUAL(0, energy_governor_get_remaining_uah(&eg));
+
+    // Unknown activities are ignored
+    energy_governor_add_charge(&eg, ENERGY_GOVERNOR_ACTIVITY_NUMBER, 1);
+    TEST_CHECK_EQUAL(0, energy_governor_get_spent_uah(&eg, ENERGY_GOVERNOR_ACTIVITY_NUMBER));
+}
+
+static void test_synthetic_trace(void)
+{
+    energy_governor_t eg;
+    energy_governor_init(&eg);
+    energy_governor_set_budget(&eg, BUDGET_UAH, PERIOD_S, START_S);
+
+    uint32_t now_s = START_S;
+    int changes = 0;
+    for (int step = 0; step < NB_STEPS; ++step)
+    {
+        now_s += STEP_S;
+        energy_governor_add_charge(&eg, ENERGY_GOVERNOR_ACTIVITY_UPLINK, UPLINK_UA_MS);
+        if (step % GNSS_EVERY_STEPS == 0) energy_governor_add_charge(&eg, ENERGY_GOVERNOR_ACTIVITY_GNSS, GNSS_UA_MS);
+
+        const energy_governor_level_t previous = energy_governor_get_level(&eg);
+        const bool changed = energy_governor_update(&eg, now_s);
+        TEST_CHECK_EQUAL(expected_level(step), energy_governor_get_level(&eg));
+        TEST_CHECK_EQUAL(previous != expected_level(step), changed);
+        if (changed) ++changes;
+
+        // Policy applied at each level
+        switch (energy_governor_get_level(&eg))
+        {
+        case ENERGY_GOVERNOR_LEVEL_NORMAL:
+            TEST_CHECK_EQUAL(60, energy_governor_get_scan_delay_s(&eg, 60, now_s));
+            TEST_CHECK_EQUAL(3, energy_governor_get_nb_trans(&eg, 3));
+            TEST_CHECK(energy_governor_is_optional_allowed(&eg));
+            break;
+        case ENERGY_GOVERNOR_LEVEL_SAVING:
+            TEST_CHECK_EQUAL(120, energy_governor_get_scan_delay_s(&eg, 60, now_s));
+            TEST_CHECK_EQUAL(2, energy_governor_get_nb_trans(&eg, 3));
+            TEST_CHECK(!energy_governor_is_optional_allowed(&eg));
+            break;
+        case ENERGY_GOVERNOR_LEVEL_CRITICAL:
+            TEST_CHECK_EQUAL(ENERGY_GOVERNOR_CRITICAL_MIN_SCAN_DELAY_S, energy_governor_get_scan_delay_s(&eg, 60, now_s));
+            TEST_CHECK_EQUAL(1200, energy_governor_get_scan_delay_s(&eg, 300, now_s));
+            TEST_CHECK_EQUAL(1, energy_governor_get_nb_trans(&eg, 3));
+            break;
+        case ENERGY_GOVERNOR_LEVEL_EXHAUSTED:
+            // Scans wait for the next period
+            TEST_CHECK_EQUAL(START_S + PERIOD_S - now_s, energy_governor_get_scan_delay_s(&eg, 60, now_s));
+            TEST_CHECK_EQUAL(1, energy_governor_get_nb_trans(&eg, 3));
+            TEST_CHECK_EQUAL(0, energy_governor_get_remaining_uah(&eg));
+            break;
+        }
+    }
+    TEST_CHECK_EQUAL(3, changes);
+
+    // Spend per activity, in whole uAh
+    TEST_CHECK_EQUAL(NB_STEPS * UPLINK_UA_MS / ENERGY_GOVERNOR_UA_MS_PER_UAH, energy_governor_get_spent_uah(&eg, ENERGY_GOVERNOR_ACTIVITY_UPLINK));
+    TEST_CHECK_EQUAL(6 * GNSS_UA_MS / ENERGY_GOVERNOR_UA_MS_PER_UAH, energy_governor_get_spent_uah(&eg, ENERGY_GOVERNOR_ACTIVITY_GNSS));
+    TEST_CHECK_EQUAL(0, energy_governor_get_spent_uah(&eg, ENERGY_GOVERNOR_ACTIVITY_WIFI));
+
+    // A long sleep skips the periods it covers, the next one stays aligned on the first
+    now_s += 3 * PERIOD_S;
+    TEST_CHECK(energy_governor_update(&eg, now_s));
+    TEST_CHECK_EQUAL(ENERGY_GOVERNOR_LEVEL_NORMAL, energy_governor_get_level(&eg));
+    TEST_CHECK_EQUAL(START_S + 3 * PERIOD_S, eg.period_start_s);
+    TEST_CHECK_EQUAL(BUDGET_UAH, energy_governor_get_remaining_uah(&eg));
+    TEST_CHECK_EQUAL(0, energy_governor_get_spent_uah(&eg, ENERGY_GOVERNOR_ACTIVITY_GNSS));
+}
+
+static void test_budget_change(void)
+{
+    energy_governor_t eg;
+    energy_governor_init(&eg);
+    energy_governor_set_budget(&eg, 10, 0, START_S);
+    TEST_CHECK_EQUAL(ENERGY_GOVERNOR_DEFAULT_PERIOD_S, eg.period_s);
+
+    energy_governor_add_charge(&eg, ENERGY_GOVERNOR_ACTIVITY_WIFI, 10 * ENERGY_GOVERNOR_UA_MS_PER_UAH);
+    TEST_CHECK(energy_governor_update(&eg, START_S + 1));
+    TEST_CHECK_EQUAL(ENERGY_GOVERNOR_LEVEL_EXHAUSTED, energy_governor_get_level(&eg));
+
+    // A new budget clears the spend, the level follows at the next update
+    energy_governor_set_budget(&eg, 20, PERIOD_S, START_S + 2);
+    TEST_CHECK_EQUAL(ENERGY_GOVERNOR_LEVEL_EXHAUSTED, energy_governor_get_level(&eg));
+    TEST_CHECK(energy_governor_update(&eg, START_S + 3));
+    TEST_CHECK_EQUAL(ENERGY_GOVERNOR_LEVEL_NORMAL, energy_governor_get_level(&eg));
+    TEST_CHECK_EQUAL(20, energy_governor_get_remaining_uah(&eg));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_disabled();
+    test_synthetic_trace();
+    test_budget_change();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,267 @@
+/*
+ * gnss_group_codec_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Packs scan groups with the GNSS group codec and decodes them back to the single NAV uplinks
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <string.h>
+#include "test_utils.h"
+#include "mw/geolocation_middleware/gnss/src/gnss_group_codec.h"
+#include "mw/geolocation_middleware/gnss/src/gnss_queue.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Round trip
+
+#define TOKEN 0x15
+#define NAV_SIZE_MAX GNSS_RESULT_SIZE_MAX_MODE3
+
+static uint8_t navs[GNSS_SCAN_GROUP_SIZE_MAX][NAV_SIZE_MAX];
+static uint8_t nav_sizes[GNSS_SCAN_GROUP_SIZE_MAX];
+
+static void new_group(gnss_scan_group_queue_t* queue, int nb_navs)
+{
+    TEST_CHECK(gnss_scan_group_queue_new(queue, GNSS_SCAN_GROUP_SIZE_MAX, 0));
+    queue->token = TOKEN;
+    for (int i = 0; i < nb_navs; ++i)
+    {
+        gnss_scan_t scan;
+        memset(&scan, 0, sizeof(scan));
+        scan.detected_svs = 5;
+        scan.results_size = nav_sizes[i];
+        memcpy(&scan.results_buffer[GNSS_SCAN_METADATA_SIZE], navs[i], nav_sizes[i]);
+        gnss_scan_group_queue_push(queue, &scan);
+    }
+}
+
+// Pops the group in frames of at most size_max bytes and checks that they decode to the single NAV uplinks.
+// Returns the number of frames, the total size through total_size.
+static int round_trip(int nb_navs, uint8_t size_max, int* total_size)
+{
+    static gnss_scan_group_queue_t packed;
+    static gnss_scan_group_queue_t single;
+    uint8_t* frame;
+    uint8_t frame_size;
+    int nb_frames = 0;
+    int nb_decoded = 0;
+
+    new_group(&packed, nb_navs);
+    new_group(&single, nb_navs);
+    *total_size = 0;
+
+    while (gnss_scan_group_queue_pop_packed(&packed, size_max, &frame, &frame_size))
+    {
+        TEST_CHECK(frame_size <= size_max);
+        ++nb_frames;
+        *total_size += frame_size;
+
+        uint8_t* expected;
+        uint8_t expected_size;
+        if (!gnss_group_codec_is_packed(frame, frame_size))
+        {
+            // A single NAV is sent as is
+            TEST_CHECK(gnss_scan_group_queue_pop(&single, &expected, &expected_size));
+            TEST_CHECK_EQUAL(expected_size, frame_size);
+            TEST_CHECK(memcmp(expected, frame, frame_size) == 0);
+            ++nb_decoded;
+            continue;
+        }
+
+        gnss_group_codec_decoder_t decoder;
+        uint8_t msg[GNSS_GROUP_CODEC_MSG_SIZE_MAX];
+        uint8_t msg_size;
+        TEST_CHECK(gnss_group_codec_decoder_init(&decoder, frame, frame_size));
+        while (gnss_group_codec_decode_next(&decoder, msg, &msg_size))
+        {
+            TEST_CHECK(gnss_scan_group_queue_pop(&single, &expected, &expected_size));
+            TEST_CHECK_EQUAL(expected_size, msg_size);
+            TEST_CHECK(memcmp(expected, msg, msg_size) == 0);
+            ++nb_decoded;
+        }
+        TEST_CHECK_EQUAL(0, decoder.nb_navs_left);
+        TEST_CHECK_EQUAL(frame_size, decoder.index);
+    }
+    TEST_CHECK_EQUAL(nb_navs, nb_decoded);
+
+    return nb_frames;
+}
+
+static void fill(int index, uint8_t size, uint8_t seed)
+{
+    nav_sizes[index] = size;
+    for (int i = 0; i < size; ++i)
+    {
+        navs[index][i] = (uint8_t)(seed + i * 37);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_identical(void)
+{
+    int total_size;
+    for (int i = 0; i < 4; ++i) fill(i, 40, 1);
+
+    // The repeated NAVs are a single zero run each
+    TEST_CHECK_EQUAL(1, round_trip(4, 242, &total_size));
+    TEST_CHECK_EQUAL(GNSS_GROUP_CODEC_HEADER_SIZE + (1 + 40) + 3 * (1 + 1), total_size);
+}
+
+static void test_runs(void)
+{
+    int total_size;
+    fill(0, 40, 1);
+    memcpy(navs[1], navs[0], 40);
+    nav_sizes[1] = 40;
+    navs[1][0] ^= 0xFF;         // Literal at the start
+    navs[1][5] ^= 0x01;         // Zero run of 1 between literals, too short to be a run
+    navs[1][7] ^= 0x01;
+    navs[1][39] ^= 0x80;        // Literal at the end
+    memcpy(navs[2], navs[1], 40);
+    nav_sizes[2] = 40;
+    navs[2][38] ^= 0x10;        // Zero run then a literal and a zero run of 1 at the end
+
+    TEST_CHECK_EQUAL(1, round_trip(3, 242, &total_size));
+}
+
+static void test_sizes(void)
+{
+    int total_size;
+
+    // Longer, shorter then longer again than the previous NAV: the bytes past the reference are XOR-ed with 0
+    fill(0, 20, 1);
+    fill(1, 30, 1);
+    fill(2, 10, 1);
+    fill(3, NAV_SIZE_MAX, 1);
+    TEST_CHECK_EQUAL(1, round_trip(4, 242, &total_size));
+
+    // One byte NAVs
+    fill(0, 1, 9);
+    fill(1, 1, 9);
+    fill(2, 1, 10);
+    TEST_CHECK_EQUAL(1, round_trip(3, 242, &total_size));
+}
+
+static void test_unrelated(void)
+{
+    int total_size;
+
+    // No common byte: the delta would be longer, the NAVs are sent as is
+    for (int i = 0; i < 4; ++i) fill(i, 30, (uint8_t)(1 + i * 101));
+    TEST_CHECK_EQUAL(1, round_trip(4, 242, &total_size));
+    TEST_CHECK_EQUAL(GNSS_GROUP_CODEC_HEADER_SIZE + 4 * (1 + 30), total_size);
+}
+
+static void test_split(void)
+{
+    int total_size;
+    for (int i = 0; i < 4; ++i) fill(i, 30, (uint8_t)(1 + i * 101));
+
+    // Two NAVs per frame, each frame decodes on its own and only the last one has the last NAV flag
+    TEST_CHECK_EQUAL(2, round_trip(4, 2 + 2 * 31, &total_size));
+
+    // One NAV per frame: the frames are the single NAV uplinks
+    TEST_CHECK_EQUAL(4, round_trip(4, 2 + 2 * 31 - 1, &total_size));
+    TEST_CHECK_EQUAL(4 * (1 + 30), total_size);
+
+    // The space left fits the delta of the third NAV but not the NAV itself
+    fill(0, 30, 1);
+    fill(1, 30, 101);
+    fill(2, 30, 101);
+    TEST_CHECK_EQUAL(1, round_trip(3, 2 + 2 * 31 + 2, &total_size));
+}
+
+static void test_long_nav(void)
+{
+    // Longest NAV and longest zero run, with the codec alone as the queue holds shorter ones
+    static uint8_t nav[GNSS_GROUP_CODEC_NAV_SIZE_MAX];
+    uint8_t frame[255];
+    uint8_t msg[GNSS_GROUP_CODEC_MSG_SIZE_MAX];
+    uint8_t msg_size;
+    for (int i = 0; i < GNSS_GROUP_CODEC_NAV_SIZE_MAX; ++i) nav[i] = (uint8_t)(i * 7 + 3);
+
+    gnss_group_codec_encoder_t encoder;
+    gnss_group_codec_encoder_init(&encoder, frame, sizeof(frame), TOKEN);
+    TEST_CHECK(gnss_group_codec_encoder_add(&encoder, nav, sizeof(nav)));
+    TEST_CHECK(gnss_group_codec_encoder_add(&encoder, nav, sizeof(nav)));
+    TEST_CHECK(!gnss_group_codec_encoder_add(&encoder, nav, 0));
+    TEST_CHECK(!gnss_group_codec_encoder_add(&encoder, nav, GNSS_GROUP_CODEC_NAV_SIZE_MAX + 1));
+    const uint8_t frame_size = gnss_group_codec_encoder_close(&encoder, true);
+    TEST_CHECK_EQUAL(GNSS_GROUP_CODEC_HEADER_SIZE + 1 + sizeof(nav) + 1 + 1, frame_size);
+
+    gnss_group_codec_decoder_t decoder;
+    TEST_CHECK(gnss_group_codec_decoder_init(&decoder, frame, frame_size));
+    for (int i = 0; i < 2; ++i)
+    {
+        TEST_CHECK(gnss_group_codec_decode_next(&decoder, msg, &msg_size));
+        TEST_CHECK_EQUAL(1 + sizeof(nav), msg_size);
+        TEST_CHECK_EQUAL(i == 1 ? 0x80 | TOKEN : TOKEN, msg[0]);
+        TEST_CHECK(memcmp(nav, &msg[1], sizeof(nav)) == 0);
+    }
+    TEST_CHECK(!gnss_group_codec_decode_next(&decoder, msg, &msg_size));
+}
+
+static void test_malformed(void)
+{
+    uint8_t frame[242];
+    uint8_t msg[GNSS_GROUP_CODEC_MSG_SIZE_MAX];
+    uint8_t msg_size;
+    gnss_group_codec_encoder_t encoder;
+    gnss_group_codec_decoder_t decoder;
+    fill(0, 30, 1);
+    fill(1, 30, 1);
+    navs[1][10] ^= 0x55;
+
+    gnss_group_codec_encoder_init(&encoder, frame, sizeof(frame), TOKEN);
+    TEST_CHECK(gnss_group_codec_encoder_add(&encoder, navs[0], nav_sizes[0]));
+    TEST_CHECK(gnss_group_codec_encoder_add(&encoder, navs[1], nav_sizes[1]));
+    const uint8_t frame_size = gnss_group_codec_encoder_close(&encoder, true);
+
+    // Every truncation is rejected instead of read past the frame
+    for (uint8_t size = GNSS_GROUP_CODEC_HEADER_SIZE + 1; size < frame_size; ++size)
+    {
+        int nb_decoded = 0;
+        TEST_CHECK(gnss_group_codec_decoder_init(&decoder, frame, size));
+        while (gnss_group_codec_decode_next(&decoder, msg, &msg_size)) ++nb_decoded;
+        TEST_CHECK(nb_decoded < 2);
+        TEST_CHECK(decoder.index <= size);
+    }
+
+    // A delta NAV first has no reference
+    uint8_t delta_first[] = { GNSS_GROUP_CODEC_PACKED_FLAG | TOKEN, 1, 0x80 | 3, 0x80 | 2 };
+    TEST_CHECK(gnss_group_codec_decoder_init(&decoder, delta_first, sizeof(delta_first)));
+    TEST_CHECK(!gnss_group_codec_decode_next(&decoder, msg, &msg_size));
+
+    // A run longer than the NAV
+    uint8_t long_run[] = { GNSS_GROUP_CODEC_PACKED_FLAG | TOKEN, 2, 1, 0xAA, 0x80 | 1, 0x80 | 5 };
+    TEST_CHECK(gnss_group_codec_decoder_init(&decoder, long_run, sizeof(long_run)));
+    TEST_CHECK(gnss_group_codec_decode_next(&decoder, msg, &msg_size));
+    TEST_CHECK(!gnss_group_codec_decode_next(&decoder, msg, &msg_size));
+
+    // A single NAV uplink is not a packed frame
+    uint8_t single[] = { TOKEN, 0x01, 0x02, 0x03 };
+    TEST_CHECK(!gnss_group_codec_decoder_init(&decoder, single, sizeof(single)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_identical();
+    test_runs();
+    test_sizes();
+    test_unrelated();
+    test_split();
+    test_long_nav();
+    test_malformed();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
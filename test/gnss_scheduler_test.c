@@ -0,0 +1,170 @@
+/*
+ * gnss_scheduler_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Schedules GNSS scans from the visible satellites predicted by the LR11xx model, over a visibility and results trace
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "test_utils.h"
+#include "lr11xx_gnss_stub.h"
+#include "mw/geolocation_middleware/gnss/src/gnss_helpers.h"
+#include "mw/geolocation_middleware/gnss/src/gnss_scheduler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Traces
+
+#define T0 1300000000u
+#define GPS_AND_BEIDOU (LR11XX_GNSS_GPS_MASK | LR11XX_GNSS_BEIDOU_MASK)
+
+// Hand written, in the shape of the LR11xx answers for one position: a dip in the second half hour, few satellites
+// in the second hour then a good sky again
+static const stub_gnss_visibility_t visibility[] = {
+    { T0, 9, 7 },               // 16
+    { T0 + 1200, 3, 2 },        // 5
+    { T0 + 1500, 8, 6 },        // 14
+    { T0 + 1560, 9, 6 },        // 15
+    { T0 + 3000, 2, 2 },        // 4
+    { T0 + 4800, 10, 8 },       // 18
+};
+
+// Satellites detected by the scans, from a date on
+static const struct
+{
+    uint32_t date;
+    uint8_t detected_svs;
+} results[] = {
+    { T0, 6 },
+    { T0 + 900, 5 },
+    { T0 + 1800, 7 },
+    { T0 + 2700, 6 },
+    { T0 + 3600, 2 },
+    { T0 + 4800, 9 },
+    { T0 + 5400, 8 },
+};
+
+static const lr11xx_gnss_solver_assistance_position_t position = { 35.68f, 139.76f };
+
+// 10 minute window, a candidate every 85 s or so
+static const gnss_scheduler_config_t config = { 600, GNSS_SCHEDULER_NB_CANDIDATES_MAX, 6 };
+
+static uint32_t almanac_crc = 100;
+
+// A new almanac empties the visible satellites cache, each test starts from there
+static void load_almanac(void)
+{
+    uint32_t crc;
+    stub_gnss_set_visibility(visibility, sizeof(visibility) / sizeof(visibility[0]));
+    stub_gnss_almanac_crc = ++almanac_crc;
+    TEST_CHECK(smtc_gnss_get_almanac_crc(NULL, &crc));
+    stub_gnss_visibility_requests = 0;
+}
+
+static uint8_t detected_at(uint32_t date)
+{
+    uint8_t detected_svs = 0;
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]) && results[i].date <= date; ++i)
+    {
+        detected_svs = results[i].detected_svs;
+    }
+    return detected_svs;
+}
+
+static gnss_scheduler_decision_t schedule(const gnss_scheduler_config_t* c, uint32_t date, uint32_t* delay_s, uint8_t* predicted_svs)
+{
+    return gnss_scheduler_schedule(c, NULL, date, &position, GPS_AND_BEIDOU, delay_s, predicted_svs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_decisions(void)
+{
+    uint32_t delay_s;
+    uint8_t predicted_svs;
+    load_almanac();
+
+    // Good sky over the whole window
+    TEST_CHECK_EQUAL(GNSS_SCHEDULER_SCAN_NOW, schedule(&config, T0, &delay_s, &predicted_svs));
+    TEST_CHECK_EQUAL(0, delay_s);
+    TEST_CHECK_EQUAL(16, predicted_svs);
+
+    // In the dip: the earliest candidate with the most satellites, at 1628 s, not the one at 1542 s with 14. The
+    // candidates 85 s apart are not blurred by the cache
+    TEST_CHECK_EQUAL(GNSS_SCHEDULER_SCAN_POSTPONE, schedule(&config, T0 + 1200, &delay_s, &predicted_svs));
+    TEST_CHECK_EQUAL(428, delay_s);
+    TEST_CHECK_EQUAL(15, predicted_svs);
+
+    // One more satellite later is not worth waiting for
+    TEST_CHECK_EQUAL(GNSS_SCHEDULER_SCAN_NOW, schedule(&config, T0 + 1500, &delay_s, &predicted_svs));
+    TEST_CHECK_EQUAL(0, delay_s);
+    TEST_CHECK_EQUAL(14, predicted_svs);
+
+    // Too few satellites over the whole window
+    TEST_CHECK_EQUAL(GNSS_SCHEDULER_SCAN_SKIP, schedule(&config, T0 + 3000, &delay_s, &predicted_svs));
+    TEST_CHECK_EQUAL(0, delay_s);
+    TEST_CHECK_EQUAL(0, predicted_svs);
+}
+
+static void test_scan_groups(void)
+{
+    gnss_scheduler_stats_t stats = { 0 };
+    load_almanac();
+
+    // A scan group every 15 minutes for an hour and a half
+    for (uint32_t date = T0; date <= T0 + 5400; date += 900)
+    {
+        uint32_t delay_s;
+        uint8_t predicted_svs;
+        const gnss_scheduler_decision_t decision = schedule(&config, date, &delay_s, &predicted_svs);
+        gnss_scheduler_account_decision(&stats, decision);
+        if (decision != GNSS_SCHEDULER_SCAN_SKIP)
+        {
+            gnss_scheduler_account_scan(&stats, predicted_svs, detected_at(date + delay_s));
+        }
+    }
+
+    // The group at 3600 s is skipped, the one at 4500 s moved to 4842 s
+    TEST_CHECK_EQUAL(6, stats.nb_scans_predicted);
+    TEST_CHECK_EQUAL(1, stats.nb_scans_postponed);
+    TEST_CHECK_EQUAL(1, stats.nb_scans_skipped);
+    TEST_CHECK_EQUAL(16 + 16 + 15 + 15 + 18 + 18, stats.predicted_svs_sum);
+    TEST_CHECK_EQUAL(6 + 5 + 7 + 6 + 9 + 8, stats.detected_svs_sum);
+
+    // Every candidate of every group is read, 2 constellations each
+    TEST_CHECK_EQUAL(7 * GNSS_SCHEDULER_NB_CANDIDATES_MAX * 2, stub_gnss_visibility_requests);
+}
+
+static void test_skip_only(void)
+{
+    // Without window the scans are only skipped, the cache serves the groups a few minutes apart
+    const gnss_scheduler_config_t skip_only = { 0, 1, 6 };
+    uint32_t delay_s;
+    uint8_t predicted_svs;
+    load_almanac();
+
+    TEST_CHECK_EQUAL(GNSS_SCHEDULER_SCAN_NOW, schedule(&skip_only, T0, &delay_s, &predicted_svs));
+    TEST_CHECK_EQUAL(GNSS_SCHEDULER_SCAN_NOW, schedule(&skip_only, T0 + 300, &delay_s, &predicted_svs));
+    TEST_CHECK_EQUAL(16, predicted_svs);
+    TEST_CHECK_EQUAL(2, stub_gnss_visibility_requests);
+
+    TEST_CHECK_EQUAL(GNSS_SCHEDULER_SCAN_SKIP, schedule(&skip_only, T0 + 3300, &delay_s, &predicted_svs));
+    TEST_CHECK_EQUAL(4, stub_gnss_visibility_requests);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_decisions();
+    test_scan_groups();
+    test_skip_only();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
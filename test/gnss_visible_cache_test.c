@@ -0,0 +1,131 @@
+/*
+ * gnss_visible_cache_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Reuses the visible satellites read from the LR11xx across scans a few minutes apart
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "test_utils.h"
+#include "lr11xx_gnss_stub.h"
+#include "mw/geolocation_middleware/gnss/src/gnss_helpers.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+#define GPS_AND_BEIDOU (LR11XX_GNSS_GPS_MASK | LR11XX_GNSS_BEIDOU_MASK)
+
+static const lr11xx_gnss_solver_assistance_position_t position = { 35.68f, 139.76f };
+
+// A new almanac empties the cache, each test starts from there
+static void load_almanac(uint32_t crc)
+{
+    uint32_t almanac_crc;
+    stub_gnss_almanac_crc = crc;
+    TEST_CHECK(smtc_gnss_get_almanac_crc(NULL, &almanac_crc));
+    TEST_CHECK_EQUAL(crc, almanac_crc);
+    stub_gnss_visibility_requests = 0;
+}
+
+static uint8_t predict(uint32_t date, const lr11xx_gnss_solver_assistance_position_t* at)
+{
+    uint8_t nb_visible_svs = 0;
+    TEST_CHECK(smtc_gnss_get_nb_visible_svs(NULL, date, at, GPS_AND_BEIDOU, GNSS_VISIBLE_SVS_CACHE_COUNT_MAX_AGE_S, &nb_visible_svs));
+    return nb_visible_svs;
+}
+
+static void test_hit_at_scan_period(void)
+{
+    static const stub_gnss_visibility_t visibility[] = { { 0, 9, 7 }, { 1000400, 10, 7 } };
+    stub_gnss_set_visibility(visibility, 2);
+    load_almanac(1);
+
+    // Scans every 5 minutes: one read per constellation serves two scans
+    TEST_CHECK_EQUAL(16, predict(1000000, &position));
+    TEST_CHECK_EQUAL(2, stub_gnss_visibility_requests);
+    TEST_CHECK_EQUAL(16, predict(1000300, &position));
+    TEST_CHECK_EQUAL(2, stub_gnss_visibility_requests);
+
+    // Read again once too old, the satellite that rose meanwhile shows up
+    TEST_CHECK_EQUAL(17, predict(1000600, &position));
+    TEST_CHECK_EQUAL(4, stub_gnss_visibility_requests);
+
+    // An hour of scans costs half the reads: 12 scans, 6 reads per constellation
+    load_almanac(11);
+    for (uint32_t date = 1010000; date < 1010000 + 3600; date += 300)
+    {
+        predict(date, &position);
+    }
+    TEST_CHECK_EQUAL(12, stub_gnss_visibility_requests);
+}
+
+static void test_prediction_of_later_scan(void)
+{
+    static const stub_gnss_visibility_t visibility[] = { { 0, 8, 6 } };
+    stub_gnss_set_visibility(visibility, 1);
+    load_almanac(2);
+
+    // The scheduler predicts the next scans from the date of the current one, and the other way round
+    TEST_CHECK_EQUAL(14, predict(2000300, &position));
+    TEST_CHECK_EQUAL(14, predict(2000000, &position));
+    TEST_CHECK_EQUAL(2, stub_gnss_visibility_requests);
+}
+
+static void test_doppler_age(void)
+{
+    static const stub_gnss_visibility_t visibility[] = { { 0, 9, 7 } };
+    stub_gnss_set_visibility(visibility, 1);
+    load_almanac(3);
+    predict(3000000, &position);
+
+    // The dopplers of a prediction made 5 minutes earlier are too old, they are read again
+    bool doppler_error = true;
+    TEST_CHECK(smtc_gnss_get_doppler_error(NULL, 3000300, &position, LR11XX_GNSS_GPS_MASK, 0, NULL, &doppler_error));
+    TEST_CHECK(!doppler_error);
+    TEST_CHECK_EQUAL(3, stub_gnss_visibility_requests);
+
+    // The refreshed read serves the next prediction
+    TEST_CHECK_EQUAL(16, predict(3000330, &position));
+    TEST_CHECK_EQUAL(3, stub_gnss_visibility_requests);
+}
+
+static void test_key(void)
+{
+    static const stub_gnss_visibility_t visibility[] = { { 0, 9, 7 } };
+    stub_gnss_set_visibility(visibility, 1);
+    load_almanac(4);
+    predict(4000000, &position);
+
+    // Another assistance position is read
+    const lr11xx_gnss_solver_assistance_position_t moved = { 48.85f, 2.35f };
+    predict(4000060, &moved);
+    TEST_CHECK_EQUAL(4, stub_gnss_visibility_requests);
+
+    // So is a new almanac, even for the same position and date
+    load_almanac(5);
+    predict(4000060, &moved);
+    TEST_CHECK_EQUAL(2, stub_gnss_visibility_requests);
+
+    // The same almanac read again keeps the cache
+    load_almanac(5);
+    predict(4000120, &moved);
+    TEST_CHECK_EQUAL(0, stub_gnss_visibility_requests);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_hit_at_scan_period();
+    test_prediction_of_later_scan();
+    test_doppler_age();
+    test_key();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
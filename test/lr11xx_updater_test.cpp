@@ -0,0 +1,297 @@
+/*
+ * lr11xx_updater_test.cpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Streams images through Lr11xxUpdater into a simulated transceiver bootloader, with interruptions
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstring>
+#include <vector>
+#include "test_utils.h"
+#include "internal/Lr11xxUpdater.hpp"
+#include "internal/nrf_hal/flash.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Simulated bootloader
+
+class FakeBootloader : public Lr11xxUpdater::Bootloader
+{
+public:
+    std::vector<uint32_t> flash;
+    int enters = 0;
+    int erases = 0;
+    int writes = 0;
+    int failWriteAt = -1;           // Index of the write which fails, -1 for none
+    uint32_t lowestOffset = UINT32_MAX;
+    bool rejectImage = false;       // The firmware does not start after reboot
+    uint16_t version = 0x0401;
+
+    explicit FakeBootloader(size_t words) : flash(words, 0) {}
+
+    bool enter() override
+    {
+        ++enters;
+        return true;
+    }
+
+    bool erase() override
+    {
+        ++erases;
+        std::fill(flash.begin(), flash.end(), 0xffffffff);
+        return true;
+    }
+
+    bool write(uint32_t offset, const uint32_t* words, size_t count) override
+    {
+        if (writes++ == failWriteAt) return false;
+        if (count > Lr11xxUpdater::BLOCK_WORDS || offset / 4 + count > flash.size()) return false;
+
+        if (offset < lowestOffset) lowestOffset = offset;
+        std::copy(words, words + count, flash.begin() + offset / 4);
+        return true;
+    }
+
+    bool reboot() override
+    {
+        return true;
+    }
+
+    bool getFirmwareVersion(uint16_t* v) override
+    {
+        if (rejectImage) return false;
+
+        *v = version;
+        return true;
+    }
+
+    void resetCounters()
+    {
+        enters = erases = writes = 0;
+        failWriteAt = -1;
+        lowestOffset = UINT32_MAX;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Fake source
+
+class FakeSource
+{
+public:
+    std::vector<uint32_t> image;
+    uint32_t bytesRead = 0;
+    int reads = 0;
+    int failReadAt = -1;            // Index of the read which fails, -1 for none
+
+    explicit FakeSource(size_t words) : image(words)
+    {
+        for (size_t i = 0; i < words; ++i) image[i] = static_cast<uint32_t>(i * 2654435761u);
+    }
+
+    Lr11xxUpdater::Source get()
+    {
+        return [this](uint32_t offset, void* buffer, size_t size)
+        {
+            if (reads++ == failReadAt) return false;
+            if (size % 4 != 0 || offset + size > image.size() * 4) return false;
+
+            memcpy(buffer, reinterpret_cast<const uint8_t*>(image.data()) + offset, size);
+            bytesRead += size;
+            return true;
+        };
+    }
+
+    uint32_t size() const
+    {
+        return image.size() * 4;
+    }
+
+    uint32_t crc() const
+    {
+        return Lr11xxUpdater::crc32(0, image.data(), size());
+    }
+
+    void resetCounters()
+    {
+        bytesRead = 0;
+        reads = 0;
+        failReadAt = -1;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static constexpr uint32_t CHECKPOINT_PAGE = 10;
+static constexpr size_t IMAGE_WORDS = 60000 / 4;                // Not a multiple of the block size
+static constexpr size_t BLOCK_BYTES = Lr11xxUpdater::BLOCK_WORDS * 4;
+
+static void test_crc32()
+{
+    TEST_CHECK_EQUAL(0xcbf43926, Lr11xxUpdater::crc32(0, "123456789", 9));
+
+    // Chunked computation matches the one shot one
+    const uint32_t crc = Lr11xxUpdater::crc32(Lr11xxUpdater::crc32(0, "1234", 4), "56789", 5);
+    TEST_CHECK_EQUAL(0xcbf43926, crc);
+}
+
+static void test_full_update()
+{
+    nrf_hal::Flash::erase(CHECKPOINT_PAGE);
+    FakeSource source(IMAGE_WORDS);
+    FakeBootloader bootloader(IMAGE_WORDS);
+    Lr11xxUpdater updater(bootloader, CHECKPOINT_PAGE);
+
+    uint32_t lastProgress = 0;
+    int progressCalls = 0;
+    const auto result = updater.update(source.get(), source.size(), source.crc(), 0x0401, [&](uint32_t written, uint32_t total)
+    {
+        TEST_CHECK(written > lastProgress && written <= total);
+        lastProgress = written;
+        ++progressCalls;
+    });
+
+    TEST_CHECK(result == Lr11xxUpdater::Result::OK);
+    TEST_CHECK(bootloader.flash == source.image);
+    TEST_CHECK_EQUAL(1, bootloader.erases);
+    TEST_CHECK_EQUAL((source.size() + BLOCK_BYTES - 1) / BLOCK_BYTES, bootloader.writes);
+    TEST_CHECK_EQUAL(source.size(), source.bytesRead);
+    TEST_CHECK_EQUAL(source.size(), lastProgress);
+    TEST_CHECK_EQUAL(bootloader.writes, progressCalls);
+}
+
+static void test_resume_after_bootloader_failure()
+{
+    nrf_hal::Flash::erase(CHECKPOINT_PAGE);
+    FakeSource source(IMAGE_WORDS);
+    FakeBootloader bootloader(IMAGE_WORDS);
+    Lr11xxUpdater updater(bootloader, CHECKPOINT_PAGE);
+
+    // Interrupted after 3 checkpoints
+    const int failWrite = 3 * Lr11xxUpdater::CHECKPOINT_INTERVAL / BLOCK_BYTES + 10;
+    bootloader.failWriteAt = failWrite;
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0401) == Lr11xxUpdater::Result::BOOTLOADER_ERROR);
+    TEST_CHECK_EQUAL(1, bootloader.erases);
+
+    // Same image: no erase, restarts from the last checkpoint before the failure
+    bootloader.resetCounters();
+    source.resetCounters();
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0401) == Lr11xxUpdater::Result::OK);
+    TEST_CHECK_EQUAL(0, bootloader.erases);
+    TEST_CHECK(bootloader.lowestOffset > 0);
+    TEST_CHECK(bootloader.lowestOffset <= static_cast<uint32_t>(failWrite) * BLOCK_BYTES);
+    TEST_CHECK(static_cast<uint32_t>(failWrite) * BLOCK_BYTES - bootloader.lowestOffset <= Lr11xxUpdater::CHECKPOINT_INTERVAL + BLOCK_BYTES);
+    TEST_CHECK_EQUAL(source.size() - bootloader.lowestOffset, source.bytesRead);
+    TEST_CHECK(bootloader.flash == source.image);
+
+    // The checkpoint is cleared once done, the next update starts over
+    bootloader.resetCounters();
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0401) == Lr11xxUpdater::Result::OK);
+    TEST_CHECK_EQUAL(1, bootloader.erases);
+    TEST_CHECK_EQUAL(0, bootloader.lowestOffset);
+}
+
+static void test_resume_after_source_failure()
+{
+    nrf_hal::Flash::erase(CHECKPOINT_PAGE);
+    FakeSource source(IMAGE_WORDS);
+    FakeBootloader bootloader(IMAGE_WORDS);
+    Lr11xxUpdater updater(bootloader, CHECKPOINT_PAGE);
+
+    source.failReadAt = 2 * Lr11xxUpdater::CHECKPOINT_INTERVAL / BLOCK_BYTES + 5;
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0401) == Lr11xxUpdater::Result::SOURCE_ERROR);
+
+    bootloader.resetCounters();
+    source.resetCounters();
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0401) == Lr11xxUpdater::Result::OK);
+    TEST_CHECK_EQUAL(0, bootloader.erases);
+    TEST_CHECK(bootloader.lowestOffset > 0);
+    TEST_CHECK(bootloader.flash == source.image);
+}
+
+static void test_other_image_discards_checkpoint()
+{
+    nrf_hal::Flash::erase(CHECKPOINT_PAGE);
+    FakeSource source(IMAGE_WORDS);
+    FakeBootloader bootloader(IMAGE_WORDS);
+    Lr11xxUpdater updater(bootloader, CHECKPOINT_PAGE);
+
+    bootloader.failWriteAt = 2 * Lr11xxUpdater::CHECKPOINT_INTERVAL / BLOCK_BYTES + 1;
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0401) == Lr11xxUpdater::Result::BOOTLOADER_ERROR);
+
+    // A different image does not resume the interrupted one
+    FakeSource other(IMAGE_WORDS);
+    other.image[100] ^= 1;
+    bootloader.resetCounters();
+    TEST_CHECK(updater.update(other.get(), other.size(), other.crc(), 0x0401) == Lr11xxUpdater::Result::OK);
+    TEST_CHECK_EQUAL(1, bootloader.erases);
+    TEST_CHECK_EQUAL(0, bootloader.lowestOffset);
+    TEST_CHECK(bootloader.flash == other.image);
+}
+
+static void test_crc_failure()
+{
+    nrf_hal::Flash::erase(CHECKPOINT_PAGE);
+    FakeSource source(IMAGE_WORDS);
+    FakeBootloader bootloader(IMAGE_WORDS);
+    Lr11xxUpdater updater(bootloader, CHECKPOINT_PAGE);
+
+    // Image corrupted in the source: the whole stream is written, the crc does not match
+    const uint32_t expectedCrc = source.crc();
+    source.image[IMAGE_WORDS / 2] ^= 0x80000000;
+    TEST_CHECK(updater.update(source.get(), source.size(), expectedCrc, 0x0401) == Lr11xxUpdater::Result::IMAGE_MISMATCH);
+
+    // Nothing is resumed from a mismatching stream
+    source.image[IMAGE_WORDS / 2] ^= 0x80000000;
+    bootloader.resetCounters();
+    TEST_CHECK(updater.update(source.get(), source.size(), expectedCrc, 0x0401) == Lr11xxUpdater::Result::OK);
+    TEST_CHECK_EQUAL(1, bootloader.erases);
+    TEST_CHECK_EQUAL(0, bootloader.lowestOffset);
+
+    // A corrupted checkpoint is ignored
+    bootloader.resetCounters();
+    bootloader.failWriteAt = Lr11xxUpdater::CHECKPOINT_INTERVAL / BLOCK_BYTES + 3;
+    TEST_CHECK(updater.update(source.get(), source.size(), expectedCrc, 0x0401) == Lr11xxUpdater::Result::BOOTLOADER_ERROR);
+    nrf_hal::Flash::pages[CHECKPOINT_PAGE][12] ^= 0x01;
+    bootloader.resetCounters();
+    TEST_CHECK(updater.update(source.get(), source.size(), expectedCrc, 0x0401) == Lr11xxUpdater::Result::OK);
+    TEST_CHECK_EQUAL(1, bootloader.erases);
+}
+
+static void test_firmware_checks()
+{
+    nrf_hal::Flash::erase(CHECKPOINT_PAGE);
+    FakeSource source(IMAGE_WORDS);
+    FakeBootloader bootloader(IMAGE_WORDS);
+    Lr11xxUpdater updater(bootloader, CHECKPOINT_PAGE);
+
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0402) == Lr11xxUpdater::Result::VERSION_MISMATCH);
+
+    bootloader.rejectImage = true;
+    TEST_CHECK(updater.update(source.get(), source.size(), source.crc(), 0x0401) == Lr11xxUpdater::Result::BOOTLOADER_ERROR);
+
+    TEST_CHECK(updater.update(source.get(), 0, source.crc(), 0x0401) == Lr11xxUpdater::Result::SOURCE_ERROR);
+    TEST_CHECK(updater.update(source.get(), source.size() - 2, source.crc(), 0x0401) == Lr11xxUpdater::Result::SOURCE_ERROR);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main()
+{
+    test_crc32();
+    test_full_update();
+    test_resume_after_bootloader_failure();
+    test_resume_after_source_failure();
+    test_other_image_discards_checkpoint();
+    test_crc_failure();
+    test_firmware_checks();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,171 @@
+/*
+ * lr1mac_cmd_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Replays mac command blocks through lr1_stack_mac_cmd_block_check and lr1_stack_mac_cmd_ans_cut
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <string.h>
+#include "test_utils.h"
+#include "lbm/smtc_modem_core/lr1mac/src/lr1mac_defs.h"
+#include "lbm/smtc_modem_core/lr1mac/src/lr1mac_utilities.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Replay vectors
+
+typedef struct block_vector_s
+{
+    const char* name;
+    uint8_t payload[NWK_MAC_PAYLOAD_MAX_SIZE];
+    uint8_t size;
+    uint8_t expected_size;      // Size left after the check
+    uint8_t expected_ans_size;
+} block_vector_t;
+
+static const block_vector_t block_vectors[] = {
+    { "empty", { 0 }, 0, 0, 0 },
+    { "link adr + dev status",
+      { LINK_ADR_REQ, 0x50, 0x07, 0x00, 0x01, DEV_STATUS_REQ }, 6, 6, LINK_ADR_ANS_SIZE + DEV_STATUS_ANS_SIZE },
+    { "last command ends on the block boundary",
+      { DUTY_CYCLE_REQ, 0x00, NEW_CHANNEL_REQ, 0x03, 0x18, 0x4f, 0x84, 0x50 }, 8, 8,
+      DUTY_CYCLE_ANS_SIZE + NEW_CHANNEL_ANS_SIZE },
+    { "new channel truncated at the block boundary",
+      { LINK_ADR_REQ, 0x50, 0x07, 0x00, 0x01, NEW_CHANNEL_REQ, 0x03, 0x18, 0x4f }, 9, 5, LINK_ADR_ANS_SIZE },
+    { "link adr truncated after one byte",
+      { DEV_STATUS_REQ, LINK_ADR_REQ }, 2, 1, DEV_STATUS_ANS_SIZE },
+    { "unknown command in the table range",
+      { DEV_STATUS_REQ, 0x0B, DUTY_CYCLE_REQ, 0x00 }, 4, 1, DEV_STATUS_ANS_SIZE },
+    { "unknown command above the table",
+      { RXTIMING_SETUP_REQ, 0x01, 0x80, 0x01 }, 4, 2, RXTIMING_SETUP_ANS_SIZE },
+    { "unknown command first",
+      { 0x12, DEV_STATUS_REQ }, 2, 0, 0 },
+    { "unknown command on the last byte",
+      { DL_CHANNEL_REQ, 0x00, 0x18, 0x4f, 0x84, 0x01 }, 6, 5, DL_CHANNEL_ANS_SIZE },
+    { "answers from the network are not answered",
+      { LINK_CHECK_ANS, 0x14, 0x02, DEVICE_TIME_ANS, 0x00, 0x00, 0x00, 0x00, 0x00, PING_SLOT_INFO_ANS }, 10, 10, 0 },
+    { "class b requests",
+      { PING_SLOT_CHANNEL_REQ, 0x18, 0x4f, 0x84, 0x00, BEACON_FREQ_REQ, 0x18, 0x4f, 0x84 }, 9, 9,
+      PING_SLOT_CHANNEL_ANS_SIZE + BEACON_FREQ_ANS_SIZE },
+};
+
+typedef struct ans_vector_s
+{
+    const char* name;
+    uint8_t ans[32];
+    uint8_t size;
+    uint8_t max_allowed_size;
+    uint8_t expected[32];
+    uint8_t expected_size;
+} ans_vector_t;
+
+static const ans_vector_t ans_vectors[] = {
+    { "everything fits",
+      { LINK_ADR_ANS, 0x07, DEV_STATUS_ANS, 0xff, 0x20 }, 5, 5,
+      { LINK_ADR_ANS, 0x07, DEV_STATUS_ANS, 0xff, 0x20 }, 5 },
+    { "first fit skips the dev status answer",
+      { DEV_STATUS_ANS, 0xff, 0x20, DUTY_CYCLE_ANS, RXTIMING_SETUP_ANS }, 5, 2,
+      { DUTY_CYCLE_ANS, RXTIMING_SETUP_ANS }, 2 },
+    { "link adr answers are kept together",
+      { LINK_ADR_ANS, 0x07, LINK_ADR_ANS, 0x07, LINK_ADR_ANS, 0x07, DUTY_CYCLE_ANS }, 7, 5,
+      { DUTY_CYCLE_ANS }, 1 },
+    { "truncated answer at the boundary",
+      { DUTY_CYCLE_ANS, NEW_CHANNEL_ANS }, 2, 10,
+      { DUTY_CYCLE_ANS }, 1 },
+    { "unknown answer stops the packing",
+      { TXPARAM_SETUP_ANS, 0x0B, DUTY_CYCLE_ANS }, 3, 10,
+      { TXPARAM_SETUP_ANS }, 1 },
+    { "class b answers",
+      { PING_SLOT_CHANNEL_ANS, 0x03, BEACON_FREQ_ANS, 0x01, DEVICE_TIME_REQ }, 5, 3,
+      { PING_SLOT_CHANNEL_ANS, 0x03, DEVICE_TIME_REQ }, 3 },
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_block_check(void)
+{
+    for (size_t i = 0; i < sizeof(block_vectors) / sizeof(block_vectors[0]); ++i)
+    {
+        const block_vector_t* v = &block_vectors[i];
+        uint8_t size = v->size;
+        printf("block: %s\n", v->name);
+        TEST_CHECK_EQUAL(v->expected_ans_size, lr1_stack_mac_cmd_block_check(v->payload, &size));
+        TEST_CHECK_EQUAL(v->expected_size, size);
+    }
+}
+
+static void test_block_check_saturation(void)
+{
+    uint8_t payload[255];
+    memset(payload, DEV_STATUS_REQ, sizeof(payload));
+    uint8_t size = sizeof(payload);
+    TEST_CHECK_EQUAL(0xff, lr1_stack_mac_cmd_block_check(payload, &size));
+    TEST_CHECK_EQUAL(255, size);
+    TEST_CHECK(0xff > DEVICE_MAC_PAYLOAD_MAX_SIZE);     // The parser rejects the block
+}
+
+static void test_ans_cut(void)
+{
+    for (size_t i = 0; i < sizeof(ans_vectors) / sizeof(ans_vectors[0]); ++i)
+    {
+        const ans_vector_t* v = &ans_vectors[i];
+        uint8_t ans[32];
+        memcpy(ans, v->ans, sizeof(ans));
+        printf("ans: %s\n", v->name);
+        const uint8_t size = lr1_stack_mac_cmd_ans_cut(ans, v->size, v->max_allowed_size);
+        TEST_CHECK_EQUAL(v->expected_size, size);
+        TEST_CHECK(memcmp(v->expected, ans, v->expected_size) == 0);
+    }
+}
+
+// Host figure only, it gives the order of magnitude of the first pass against the per command parsing
+static void measure_block_check(void)
+{
+    // Largest realistic block: 8 LinkADRReq, DevStatusReq, 16 NewChannelReq
+    uint8_t payload[NWK_MAC_PAYLOAD_MAX_SIZE];
+    uint8_t size = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        const uint8_t link_adr[] = { LINK_ADR_REQ, 0x50, 0xff, 0x00, 0x01 };
+        memcpy(&payload[size], link_adr, sizeof(link_adr));
+        size += sizeof(link_adr);
+    }
+    payload[size++] = DEV_STATUS_REQ;
+    for (int i = 0; i < 16 && size + NEW_CHANNEL_REQ_SIZE <= sizeof(payload); ++i)
+    {
+        const uint8_t new_channel[] = { NEW_CHANNEL_REQ, (uint8_t)i, 0x18, 0x4f, 0x84, 0x50 };
+        memcpy(&payload[size], new_channel, sizeof(new_channel));
+        size += sizeof(new_channel);
+    }
+
+    const int rounds = 100000;
+    volatile uint8_t sink = 0;
+    const double start = test_now_ns();
+    for (int i = 0; i < rounds; ++i)
+    {
+        uint8_t s = size;
+        sink += lr1_stack_mac_cmd_block_check(payload, &s);
+    }
+    const double elapsed = test_now_ns() - start;
+    printf("block check: %u bytes, 25 commands, %.1f ns per block on the host\n", size, elapsed / rounds);
+    (void)sink;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_block_check();
+    test_block_check_saturation();
+    test_ans_cut();
+    measure_block_check();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
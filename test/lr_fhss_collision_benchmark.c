@@ -0,0 +1,235 @@
+/*
+ * lr_fhss_collision_benchmark.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Monte Carlo estimate of the LR-FHSS uplinks lost to collisions, for the ways of picking the hop sequence ids
+ *
+ * Not run by ctest, it takes a few minutes:
+ *   lr_fhss_collision_benchmark [hours]
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Channel model
+
+// EU868 DR8/DR9: 8 grids of 35 channels of 488 Hz in the 137 kHz band, 384 hop sequences
+#define NB_GRIDS 8
+#define NB_CHANNELS 35
+#define NB_HOP_SEQUENCES 384
+#define HEADER_MS 233.5
+#define FRAGMENT_MS 102.4
+#define MAX_SEGMENTS 64
+#define PAYLOAD_LENGTH 20
+#define PERIOD_S 300                // Mean uplink period of a device, Poisson arrivals
+
+typedef enum
+{
+    HOP_ID_RANDOM_INCLUSIVE,        // Random draw including its upper bound, id 384 is out of range
+    HOP_ID_RANDOM,                  // Random draw in [0, count - 1], as the stack does
+    HOP_ID_GOLDEN_RATIO,            // Additive recurrence on the golden ratio from a random start per device
+    HOP_ID_COUNT,
+} hop_id_mode_t;
+
+static const char* const mode_names[HOP_ID_COUNT] = { "random [0,384]", "random [0,383]", "golden ratio" };
+
+typedef struct
+{
+    double start_ms;
+    uint16_t hop_id;
+} uplink_t;
+
+typedef struct
+{
+    uint8_t nb_headers;
+    uint8_t nb_fragments;
+    uint8_t needed;                 // Fragments needed to decode
+    double airtime_ms;
+} frame_format_t;
+
+static uint64_t random_state;
+
+static uint64_t model_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+static double model_uniform(void)
+{
+    return (model_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Each hop sequence is an independent pattern on the channels of its grid
+static int model_channel(uint16_t hop_id, int segment)
+{
+    uint32_t h = hop_id * 2654435761u ^ (segment + 1) * 40503u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return (hop_id % NB_GRIDS) * NB_CHANNELS + h % NB_CHANNELS;
+}
+
+static frame_format_t model_format(int robust)
+{
+    frame_format_t format;
+    const int bits = (PAYLOAD_LENGTH + 2) * 8 + 6;             // Payload, crc and trellis tail
+    const int coded_bits = robust ? bits * 3 : bits * 3 / 2;
+    format.nb_headers = robust ? 3 : 2;
+    format.nb_fragments = (coded_bits + 47) / 48;
+    format.needed = robust ? (format.nb_fragments + 2) / 3 : (2 * format.nb_fragments + 2) / 3;
+    format.airtime_ms = format.nb_headers * HEADER_MS + format.nb_fragments * FRAGMENT_MS;
+    return format;
+}
+
+static double segment_start(const frame_format_t* format, const uplink_t* uplink, int k)
+{
+    return k < format->nb_headers ? uplink->start_ms + k * HEADER_MS
+                                  : uplink->start_ms + format->nb_headers * HEADER_MS + (k - format->nb_headers) * FRAGMENT_MS;
+}
+
+static double segment_length(const frame_format_t* format, int k)
+{
+    return k < format->nb_headers ? HEADER_MS : FRAGMENT_MS;
+}
+
+// Segment on air at offset_ms from the start of the uplink, clamped to the first and last ones
+static int segment_at(const frame_format_t* format, double offset_ms)
+{
+    const double headers_ms = format->nb_headers * HEADER_MS;
+    if (offset_ms < 0) return 0;
+    if (offset_ms < headers_ms) return (int)(offset_ms / HEADER_MS);
+
+    const int k = format->nb_headers + (int)((offset_ms - headers_ms) / FRAGMENT_MS);
+    const int last = format->nb_headers + format->nb_fragments - 1;
+    return k < last ? k : last;
+}
+
+static int compare_start(const void* a, const void* b)
+{
+    const double d = ((const uplink_t*)a)->start_ms - ((const uplink_t*)b)->start_ms;
+    return d < 0 ? -1 : d > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Simulation
+
+// Ratio of the frames decoded, a frame needs one header and enough fragments not hit by another uplink
+static double simulate(int nb_devices, int robust, hop_id_mode_t mode, double hours)
+{
+    const frame_format_t format = model_format(robust);
+    const double duration_ms = hours * 3600e3;
+    const size_t capacity = (size_t)(nb_devices * duration_ms / (PERIOD_S * 1e3) * 1.5) + 1000;
+    uplink_t* uplinks = malloc(capacity * sizeof(uplink_t));
+    size_t nb_uplinks = 0;
+
+    for (int device = 0; device < nb_devices; ++device)
+    {
+        uint32_t phase = (uint32_t)model_random();
+        for (double t = model_uniform() * PERIOD_S * 1e3; t < duration_ms && nb_uplinks < capacity; t += -log(1 - model_uniform()) * PERIOD_S * 1e3)
+        {
+            // Drawn in every mode, so that the arrivals are the same
+            const uint64_t draw = model_random();
+            uplink_t* uplink = &uplinks[nb_uplinks++];
+            uplink->start_ms = t;
+            switch (mode)
+            {
+            case HOP_ID_RANDOM_INCLUSIVE:
+                uplink->hop_id = draw % (NB_HOP_SEQUENCES + 1);
+                break;
+            case HOP_ID_RANDOM:
+                uplink->hop_id = draw % NB_HOP_SEQUENCES;
+                break;
+            default:
+                phase += 0x9E3779B9u;
+                uplink->hop_id = (uint16_t)(((uint64_t)phase * NB_HOP_SEQUENCES) >> 32);
+                break;
+            }
+        }
+    }
+    qsort(uplinks, nb_uplinks, sizeof(uplink_t), compare_start);
+
+    const int nb_segments = format.nb_headers + format.nb_fragments;
+    size_t nb_decoded = 0;
+    size_t first = 0;
+    for (size_t i = 0; i < nb_uplinks; ++i)
+    {
+        const uplink_t* a = &uplinks[i];
+        uint8_t hit[MAX_SEGMENTS] = { 0 };
+        while (uplinks[first].start_ms <= a->start_ms - format.airtime_ms) ++first;
+
+        for (size_t j = first; j < nb_uplinks && uplinks[j].start_ms < a->start_ms + format.airtime_ms; ++j)
+        {
+            if (j == i) continue;
+            const uplink_t* b = &uplinks[j];
+            for (int m = 0; m < nb_segments; ++m)
+            {
+                // Segments of a on air during the segment m of b
+                const double u0 = segment_start(&format, b, m);
+                const double u1 = u0 + segment_length(&format, m);
+                if (u1 <= a->start_ms || u0 >= a->start_ms + format.airtime_ms) continue;
+
+                const int channel = model_channel(b->hop_id, m);
+                for (int k = segment_at(&format, u0 - a->start_ms); k <= segment_at(&format, u1 - a->start_ms); ++k)
+                {
+                    const double s0 = segment_start(&format, a, k);
+                    if (u1 <= s0 || u0 >= s0 + segment_length(&format, k)) continue;
+                    if (model_channel(a->hop_id, k) == channel) hit[k] = 1;
+                }
+            }
+        }
+
+        int headers = 0;
+        int fragments = 0;
+        for (int k = 0; k < nb_segments; ++k)
+        {
+            if (hit[k]) continue;
+            if (k < format.nb_headers) ++headers;
+            else ++fragments;
+        }
+        if (headers > 0 && fragments >= format.needed) ++nb_decoded;
+    }
+
+    free(uplinks);
+    return nb_uplinks == 0 ? 0 : (double)nb_decoded / nb_uplinks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(int argc, char* argv[])
+{
+    const double hours = argc > 1 ? atof(argv[1]) : 1.0;
+    const int nb_devices[] = { 1000, 4000, 16000, 32000 };
+
+    printf("%d-byte uplinks every %d s per device, %.1f h\n", PAYLOAD_LENGTH, PERIOD_S, hours);
+    printf("devices  cr   %-16s%-16s%-16s\n", mode_names[0], mode_names[1], mode_names[2]);
+    for (size_t d = 0; d < sizeof(nb_devices) / sizeof(nb_devices[0]); ++d)
+    {
+        for (int robust = 1; robust >= 0; --robust)
+        {
+            printf("%7d  %s", nb_devices[d], robust ? "1/3" : "2/3");
+            for (int mode = 0; mode < HOP_ID_COUNT; ++mode)
+            {
+                // Same arrivals for every mode
+                random_state = 12345 + d;
+                printf("  %6.2f %%      ", 100 * simulate(nb_devices[d], robust, (hop_id_mode_t)mode, hours));
+            }
+            printf("\n");
+        }
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,139 @@
+/*
+ * lr_fhss_scheduler_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Drives the LR-FHSS datarate policy through LinkCheckReq/Ans cycles, answered, lost and aged out
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "test_utils.h"
+#include "lbm/smtc_modem_core/lr1mac/src/services/smtc_lr_fhss_scheduler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Datarates
+
+// EU868 LR-FHSS 137 kHz: DR8 is CR 1/3, DR9 is CR 2/3
+#define ROBUST_DR 8
+#define FAST_DR 9
+
+static uint8_t select_dr(const smtc_lr_fhss_scheduler_t* scheduler, uint8_t datarate)
+{
+    return smtc_lr_fhss_scheduler_select_dr(scheduler, datarate, ROBUST_DR, FAST_DR);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_link_check_cycle(void)
+{
+    smtc_lr_fhss_scheduler_t scheduler;
+    smtc_lr_fhss_scheduler_init(&scheduler);
+
+    // No margin nor delivery rate: the drawn datarate is kept
+    TEST_CHECK_EQUAL(ROBUST_DR, select_dr(&scheduler, ROBUST_DR));
+    TEST_CHECK_EQUAL(FAST_DR, select_dr(&scheduler, FAST_DR));
+
+    // Unconfirmed uplink carrying a LinkCheckReq, recorded at the radio start while the request is not yet sent
+    smtc_lr_fhss_scheduler_on_uplink(&scheduler, ROBUST_DR, false, true);
+    TEST_CHECK(scheduler.pending_link_check);
+
+    // LinkCheckAns with 12 dB on CR 1/3, 9 dB as seen by CR 2/3
+    smtc_lr_fhss_scheduler_on_downlink(&scheduler, false, true, 12, true);
+    TEST_CHECK(!scheduler.pending_link_check);
+    TEST_CHECK(scheduler.margin_valid);
+    TEST_CHECK_EQUAL(9, scheduler.margin_db);
+    TEST_CHECK_EQUAL(1, scheduler.nb_tracked[ROBUST_DR]);
+    TEST_CHECK_EQUAL(100, scheduler.delivery_rate[ROBUST_DR]);
+    TEST_CHECK_EQUAL(FAST_DR, select_dr(&scheduler, ROBUST_DR));
+
+    // Next answer on CR 2/3 with too little margin: back to CR 1/3
+    smtc_lr_fhss_scheduler_on_uplink(&scheduler, FAST_DR, false, true);
+    smtc_lr_fhss_scheduler_on_downlink(&scheduler, false, true, 5, false);
+    TEST_CHECK_EQUAL(5, scheduler.margin_db);
+    TEST_CHECK_EQUAL(ROBUST_DR, select_dr(&scheduler, FAST_DR));
+}
+
+static void test_link_check_lost(void)
+{
+    smtc_lr_fhss_scheduler_t scheduler;
+    smtc_lr_fhss_scheduler_init(&scheduler);
+
+    smtc_lr_fhss_scheduler_on_uplink(&scheduler, FAST_DR, false, true);
+    smtc_lr_fhss_scheduler_on_downlink(&scheduler, false, true, 20, false);
+    TEST_CHECK_EQUAL(FAST_DR, select_dr(&scheduler, ROBUST_DR));
+
+    // LinkCheckReq not answered: counted as lost, the margin is kept
+    for (int i = 0; i < SMTC_LR_FHSS_SCHEDULER_MIN_TRACKED - 1; ++i)
+    {
+        smtc_lr_fhss_scheduler_on_uplink(&scheduler, FAST_DR, false, true);
+        smtc_lr_fhss_scheduler_on_downlink(&scheduler, false, false, 0, false);
+    }
+    TEST_CHECK_EQUAL(SMTC_LR_FHSS_SCHEDULER_MIN_TRACKED, scheduler.nb_tracked[FAST_DR]);
+    TEST_CHECK(scheduler.delivery_rate[FAST_DR] < SMTC_LR_FHSS_SCHEDULER_DELIVERY_MIN);
+    TEST_CHECK(scheduler.margin_valid);
+
+    // The delivery rate overrides the margin
+    TEST_CHECK_EQUAL(ROBUST_DR, select_dr(&scheduler, FAST_DR));
+}
+
+static void test_not_expected(void)
+{
+    smtc_lr_fhss_scheduler_t scheduler;
+    smtc_lr_fhss_scheduler_init(&scheduler);
+
+    // An uplink recorded without its LinkCheckReq ignores the answer, neither margin nor delivery rate
+    smtc_lr_fhss_scheduler_on_uplink(&scheduler, ROBUST_DR, false, false);
+    smtc_lr_fhss_scheduler_on_downlink(&scheduler, false, true, 12, true);
+    TEST_CHECK(!scheduler.margin_valid);
+    TEST_CHECK_EQUAL(0, scheduler.nb_tracked[ROBUST_DR]);
+
+    // Confirmed uplink without LinkCheckReq: the ack is tracked, the margin is not
+    smtc_lr_fhss_scheduler_on_uplink(&scheduler, ROBUST_DR, true, false);
+    smtc_lr_fhss_scheduler_on_downlink(&scheduler, true, false, 0, true);
+    TEST_CHECK(!scheduler.margin_valid);
+    TEST_CHECK_EQUAL(1, scheduler.nb_tracked[ROBUST_DR]);
+    TEST_CHECK_EQUAL(100, scheduler.delivery_rate[ROBUST_DR]);
+}
+
+static void test_margin_age(void)
+{
+    smtc_lr_fhss_scheduler_t scheduler;
+    smtc_lr_fhss_scheduler_init(&scheduler);
+
+    smtc_lr_fhss_scheduler_on_uplink(&scheduler, ROBUST_DR, false, true);
+    smtc_lr_fhss_scheduler_on_downlink(&scheduler, false, true, 12, true);
+
+    // Uplinks without answer expected age the margin out
+    for (int i = 0; i < SMTC_LR_FHSS_SCHEDULER_MARGIN_MAX_AGE; ++i)
+    {
+        smtc_lr_fhss_scheduler_on_uplink(&scheduler, FAST_DR, false, false);
+        smtc_lr_fhss_scheduler_on_downlink(&scheduler, false, false, 0, false);
+    }
+    TEST_CHECK_EQUAL(FAST_DR, select_dr(&scheduler, ROBUST_DR));
+
+    smtc_lr_fhss_scheduler_on_uplink(&scheduler, FAST_DR, false, false);
+    TEST_CHECK(!scheduler.margin_valid);
+    TEST_CHECK_EQUAL(ROBUST_DR, select_dr(&scheduler, ROBUST_DR));
+
+    // The delivery rates are dropped with the stats
+    smtc_lr_fhss_scheduler_reset_stats(&scheduler);
+    TEST_CHECK_EQUAL(0, scheduler.nb_tracked[ROBUST_DR]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_link_check_cycle();
+    test_link_check_lost();
+    test_not_expected();
+    test_margin_age();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,206 @@
+/*
+ * per_test_loopback_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Runs a packet error rate sweep through a loopback radio model with losses, bit flips, replays and crc errors
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <stdlib.h>
+#include <string.h>
+#include "test_utils.h"
+#include "lbm/smtc_modem_core/modem_services/per_test.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Loopback radio
+
+#define NB_FRAMES 100
+#define FRAME_LENGTH 40
+#define PATH_LOSS_DB 30         // Cabled bench: the strongest steps are received above -20 dBm
+#define RSSI_JITTER_DB 4
+#define SNR_MARGIN_DB 5
+
+typedef struct
+{
+    uint16_t delivered;
+    uint16_t duplicated;
+    uint16_t corrupted;         // Frames flipped or dropped on a crc error, charged to the last valid step
+    uint16_t nb_rssi;
+    int16_t rssi[3 * NB_FRAMES];
+} model_step_t;
+
+static model_step_t model[PER_TEST_MAX_STEPS];
+
+static uint32_t random_state = 1;
+
+static uint32_t model_random(uint32_t range)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return ((random_state >> 16) & 0x7fff) % range;
+}
+
+// Losses grow as the power goes down
+static uint32_t model_loss_percent(int8_t power_dbm)
+{
+    return power_dbm >= 5 ? 2 : power_dbm >= -4 ? 30 : 100;
+}
+
+static int compare_int16(const void* a, const void* b)
+{
+    return *(const int16_t*)a - *(const int16_t*)b;
+}
+
+// Sample the percentile points to, as the receiver histogram does
+static int16_t model_percentile(model_step_t* step, uint8_t percent)
+{
+    qsort(step->rssi, step->nb_rssi, sizeof(step->rssi[0]), compare_int16);
+    const uint32_t rank = (step->nb_rssi * percent + 99) / 100;
+    return step->rssi[rank == 0 ? 0 : rank - 1];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_tx_plan(void)
+{
+    per_test_tx_t tx;
+
+    TEST_CHECK(!per_test_tx_init(&tx, 0, 14, 14, 0));
+    TEST_CHECK(!per_test_tx_init(&tx, 10, 14, 2, 0));
+    TEST_CHECK(!per_test_tx_init(&tx, 10, 14, 2, 3));
+    TEST_CHECK(!per_test_tx_init(&tx, 10, 20, -20, -1));
+    TEST_CHECK(per_test_tx_init(&tx, 10, 14, 14, 0));
+    TEST_CHECK(per_test_tx_init(&tx, NB_FRAMES, 14, -13, -3));
+    TEST_CHECK_EQUAL(10, tx.nb_steps);
+}
+
+static void test_loopback_sweep(void)
+{
+    per_test_tx_t tx;
+    per_test_rx_t rx;
+    TEST_CHECK(per_test_tx_init(&tx, NB_FRAMES, 14, -13, -3));
+    per_test_rx_init(&rx);
+
+    uint8_t frame[FRAME_LENGTH];
+    uint8_t previous[FRAME_LENGTH];
+    bool has_previous = false;
+    uint8_t last_valid_step = 0;
+    int8_t power_dbm;
+    uint32_t nb_sent = 0;
+    while (per_test_tx_get_next(&tx, frame, sizeof(frame), &power_dbm))
+    {
+        ++nb_sent;
+        const uint8_t step = frame[2];
+        const int16_t rssi_dbm = power_dbm - PATH_LOSS_DB + (int16_t)model_random(2 * RSSI_JITTER_DB + 1) - RSSI_JITTER_DB;
+        const int16_t snr_db = power_dbm - SNR_MARGIN_DB;
+
+        if (model_random(100) < model_loss_percent(power_dbm)) continue;
+
+        // Crc errors are dropped by the radio, bit flips are caught by the frame check
+        const uint32_t error = model_random(40);
+        if (error == 0)
+        {
+            per_test_rx_add_crc_error(&rx);
+            ++model[last_valid_step].corrupted;
+            continue;
+        }
+        if (error == 1)
+        {
+            uint8_t flipped[FRAME_LENGTH];
+            memcpy(flipped, frame, sizeof(frame));
+            flipped[PER_TEST_FRAME_HEADER_LENGTH + model_random(FRAME_LENGTH - PER_TEST_FRAME_HEADER_LENGTH)] ^= 1 << model_random(8);
+            TEST_CHECK_EQUAL(PER_TEST_FRAME_CORRUPTED, per_test_rx_add_frame(&rx, flipped, sizeof(flipped), rssi_dbm, snr_db));
+            ++model[last_valid_step].corrupted;
+            continue;
+        }
+
+        TEST_CHECK_EQUAL(PER_TEST_FRAME_VALID, per_test_rx_add_frame(&rx, frame, sizeof(frame), rssi_dbm, snr_db));
+        ++model[step].delivered;
+        model[step].rssi[model[step].nb_rssi++] = rssi_dbm;
+        last_valid_step = step;
+
+        // Replays of the same frame and of the one before, rssi and snr are not accounted
+        if (model_random(10) == 0)
+        {
+            TEST_CHECK_EQUAL(PER_TEST_FRAME_DUPLICATED, per_test_rx_add_frame(&rx, frame, sizeof(frame), rssi_dbm, snr_db));
+            ++model[step].duplicated;
+        }
+        if (has_previous && model_random(10) == 0)
+        {
+            TEST_CHECK_EQUAL(PER_TEST_FRAME_DUPLICATED, per_test_rx_add_frame(&rx, previous, sizeof(previous), rssi_dbm, snr_db));
+            ++model[previous[2]].duplicated;
+        }
+        memcpy(previous, frame, sizeof(frame));
+        has_previous = true;
+    }
+    TEST_CHECK_EQUAL(10 * NB_FRAMES, nb_sent);
+    TEST_CHECK_EQUAL(nb_sent, per_test_tx_get_nb_built(&tx));
+
+    const uint8_t foreign[5] = { 1, 2, 3, 4, 5 };
+    TEST_CHECK_EQUAL(PER_TEST_FRAME_FOREIGN, per_test_rx_add_frame(&rx, foreign, sizeof(foreign), 0, 0));
+    TEST_CHECK_EQUAL(1, rx.nb_foreign);
+
+    // The receiver learnt the plan from the frames and its counters match the model
+    TEST_CHECK_EQUAL(10, rx.nb_steps);
+    for (uint8_t s = 0; s < rx.nb_steps; ++s)
+    {
+        const per_test_step_t* step = &rx.steps[s];
+        const int8_t power = per_test_rx_get_power_dbm(&rx, s);
+        TEST_CHECK_EQUAL(14 - 3 * s, power);
+        TEST_CHECK_EQUAL(model[s].delivered, step->nb_received);
+        TEST_CHECK_EQUAL(NB_FRAMES - model[s].delivered, per_test_rx_get_nb_lost(&rx, s));
+        TEST_CHECK_EQUAL(model[s].duplicated, step->nb_duplicated);
+        TEST_CHECK_EQUAL(model[s].corrupted, step->nb_corrupted);
+        if (step->nb_received == 0) continue;
+
+        // Rssi statistics, resolved to the bin width over the whole range of the sweep
+        TEST_CHECK_EQUAL(model[s].nb_rssi, step->rssi.nb_samples);
+        TEST_CHECK(abs(per_test_get_mean(&step->rssi) - (power - PATH_LOSS_DB)) <= 1);
+        TEST_CHECK(abs(per_test_get_rssi_percentile(step, 50) - model_percentile(&model[s], 50)) <= PER_TEST_RSSI_BIN_WIDTH_DB / 2);
+        TEST_CHECK(abs(per_test_get_rssi_percentile(step, 10) - model_percentile(&model[s], 10)) <= PER_TEST_RSSI_BIN_WIDTH_DB / 2);
+        TEST_CHECK_EQUAL(power - SNR_MARGIN_DB, per_test_get_snr_percentile(step, 50));
+    }
+
+    // Steps under sensitivity are all lost
+    TEST_CHECK_EQUAL(NB_FRAMES, per_test_rx_get_nb_lost(&rx, 9));
+}
+
+static void test_duplicate_window(void)
+{
+    per_test_tx_t tx;
+    per_test_rx_t rx;
+    TEST_CHECK(per_test_tx_init(&tx, NB_FRAMES, 0, 0, 0));
+    per_test_rx_init(&rx);
+
+    uint8_t first[PER_TEST_FRAME_MIN_LENGTH + 7];
+    uint8_t frame[sizeof(first)];
+    int8_t power_dbm;
+    per_test_tx_get_next(&tx, first, sizeof(first), &power_dbm);
+    TEST_CHECK_EQUAL(PER_TEST_FRAME_VALID, per_test_rx_add_frame(&rx, first, sizeof(first), 0, 0));
+    for (int i = 1; i < 50; ++i)
+    {
+        per_test_tx_get_next(&tx, frame, sizeof(frame), &power_dbm);
+        if (i != 10) TEST_CHECK_EQUAL(PER_TEST_FRAME_VALID, per_test_rx_add_frame(&rx, frame, sizeof(frame), 0, 0));
+    }
+
+    // A replay older than the window is still not counted twice
+    TEST_CHECK_EQUAL(PER_TEST_FRAME_DUPLICATED, per_test_rx_add_frame(&rx, first, sizeof(first), 0, 0));
+    TEST_CHECK_EQUAL(NB_FRAMES - 49, per_test_rx_get_nb_lost(&rx, 0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_tx_plan();
+    test_loopback_sweep();
+    test_duplicate_window();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,107 @@
+/*
+ * ranging_filter_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Filters ranging rounds with outliers, unanswered exchanges and extreme distances
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "test_utils.h"
+#include "lbm/smtc_modem_core/modem_services/ranging_filter.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static void test_empty(void)
+{
+    ranging_filter_t filter;
+    ranging_filter_result_t result;
+    ranging_filter_init(&filter);
+
+    TEST_CHECK(!ranging_filter_get_result(&filter, &result));
+
+    // Only failures: no distance
+    TEST_CHECK(ranging_filter_add_failure(&filter));
+    TEST_CHECK_EQUAL(1, ranging_filter_get_nb_exchanges(&filter));
+    TEST_CHECK(!ranging_filter_get_result(&filter, &result));
+}
+
+static void test_outliers(void)
+{
+    ranging_filter_t filter;
+    ranging_filter_result_t result;
+    ranging_filter_init(&filter);
+
+    // A multipath echo and a negative distance around the peer at 100 m
+    const int32_t distance_m[] = { 100, 102, 98, 101, 99, 350, 100, -40 };
+    for (int i = 0; i < 8; ++i)
+    {
+        TEST_CHECK(ranging_filter_add_sample(&filter, distance_m[i], -60 - i));
+    }
+    TEST_CHECK(ranging_filter_add_failure(&filter));
+    TEST_CHECK(ranging_filter_add_failure(&filter));
+    TEST_CHECK_EQUAL(10, ranging_filter_get_nb_exchanges(&filter));
+
+    TEST_CHECK(ranging_filter_get_result(&filter, &result));
+    TEST_CHECK_EQUAL(100, result.distance_m);
+    TEST_CHECK_EQUAL(1, result.deviation_m);
+    TEST_CHECK_EQUAL(-62, result.rssi_dbm);        // Outliers are left out of the rssi too
+    TEST_CHECK_EQUAL(10, result.nb_exchanges);
+    TEST_CHECK_EQUAL(8, result.nb_samples);
+    TEST_CHECK_EQUAL(6, result.nb_kept);
+    TEST_CHECK_EQUAL(60, result.quality);
+}
+
+static void test_full_round(void)
+{
+    ranging_filter_t filter;
+    ranging_filter_result_t result;
+    ranging_filter_init(&filter);
+
+    // Identical samples are all kept thanks to the deviation floor
+    for (int i = 0; i < RANGING_FILTER_MAX_SAMPLES; ++i)
+    {
+        TEST_CHECK(ranging_filter_add_sample(&filter, (i % 2) ? -5 : -6, 0));
+    }
+    TEST_CHECK(!ranging_filter_add_sample(&filter, -5, 0));
+    TEST_CHECK(!ranging_filter_add_failure(&filter));
+    TEST_CHECK_EQUAL(RANGING_FILTER_MAX_SAMPLES, ranging_filter_get_nb_exchanges(&filter));
+
+    TEST_CHECK(ranging_filter_get_result(&filter, &result));
+    TEST_CHECK_EQUAL(-5, result.distance_m);
+    TEST_CHECK_EQUAL(0, result.deviation_m);
+    TEST_CHECK_EQUAL(RANGING_FILTER_MAX_SAMPLES, result.nb_kept);
+    TEST_CHECK_EQUAL(100, result.quality);
+}
+
+static void test_large_distances(void)
+{
+    ranging_filter_t filter;
+    ranging_filter_result_t result;
+    ranging_filter_init(&filter);
+
+    // The mean does not overflow
+    TEST_CHECK(ranging_filter_add_sample(&filter, 2000000000, 0));
+    TEST_CHECK(ranging_filter_add_sample(&filter, 2000000001, 0));
+    TEST_CHECK(ranging_filter_get_result(&filter, &result));
+    TEST_CHECK_EQUAL(2000000000, result.distance_m);
+    TEST_CHECK_EQUAL(2, result.nb_kept);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_empty();
+    test_outliers();
+    test_full_round();
+    test_large_distances();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,72 @@
+/*
+ * flash.hpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Host replacement of internal/nrf_hal/flash.hpp, pages live in RAM
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace nrf_hal
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// Flash
+
+class Flash
+{
+public:
+    static constexpr int PAGE_SIZE = 4096;
+    static constexpr uint32_t PAGE_COUNT = 256;
+
+    static inline uint8_t pages[PAGE_COUNT][PAGE_SIZE];
+    static inline int writeCount = 0;
+
+public:
+    static void erase(uint32_t page)
+    {
+        if (page >= PAGE_COUNT) abort();
+
+        memset(pages[page], 0xff, PAGE_SIZE);
+    }
+
+    static void write(uint32_t page, const void* buffer, size_t size)
+    {
+        if (page >= PAGE_COUNT) abort();
+        if (buffer == nullptr) abort();
+        if (size <= 0 || PAGE_SIZE < size) abort();
+
+        erase(page);
+        memcpy(pages[page], buffer, size);
+        ++writeCount;
+    }
+
+    static void read(uint32_t page, void* buffer, size_t size)
+    {
+        if (page >= PAGE_COUNT) abort();
+        if (buffer == nullptr) abort();
+        if (size <= 0 || PAGE_SIZE < size) abort();
+
+        memcpy(buffer, pages[page], size);
+    }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
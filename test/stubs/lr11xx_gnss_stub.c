@@ -0,0 +1,200 @@
+/*
+ * lr11xx_gnss_stub.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "lr11xx_gnss_stub.h"
+#include <string.h>
+#include "mw/geolocation_middleware/bsp/mw_bsp.h"
+#include "mw/geolocation_middleware/common/mw_common.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Controlled by the tests
+
+uint32_t stub_gnss_almanac_crc = 0x12345678;
+int stub_gnss_visibility_requests = 0;
+
+static const stub_gnss_visibility_t* visibility_table = NULL;
+static size_t visibility_size = 0;
+static uint8_t last_nb_visible = 0;
+static lr11xx_gnss_constellation_t last_constellation = LR11XX_GNSS_GPS_MASK;
+
+void stub_gnss_set_visibility(const stub_gnss_visibility_t* visibility, size_t size)
+{
+    visibility_table = visibility;
+    visibility_size = size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// lr11xx_gnss
+
+lr11xx_status_t lr11xx_gnss_get_nb_visible_satellites(const void* context, const lr11xx_gnss_date_t date, const lr11xx_gnss_solver_assistance_position_t* assistance_position, const lr11xx_gnss_constellation_t constellation, uint8_t* nb_visible_sv)
+{
+    ++stub_gnss_visibility_requests;
+
+    *nb_visible_sv = 0;
+    for (size_t i = 0; i < visibility_size && visibility_table[i].date <= date; ++i)
+    {
+        *nb_visible_sv = constellation == LR11XX_GNSS_GPS_MASK ? visibility_table[i].nb_gps : visibility_table[i].nb_beidou;
+    }
+    last_nb_visible = *nb_visible_sv;
+    last_constellation = constellation;
+
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_get_visible_satellites(const void* context, const uint8_t nb_visible_satellites, lr11xx_gnss_visible_satellite_t* visible_satellite_id_doppler)
+{
+    // The satellites of the last lr11xx_gnss_get_nb_visible_satellites, BeiDou ids start at 64
+    for (uint8_t i = 0; i < nb_visible_satellites && i < last_nb_visible; ++i)
+    {
+        visible_satellite_id_doppler[i].satellite_id = last_constellation == LR11XX_GNSS_GPS_MASK ? i : 64 + i;
+        visible_satellite_id_doppler[i].doppler = 0;
+        visible_satellite_id_doppler[i].doppler_error = 0;
+    }
+
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_get_context_status(const void* context, lr11xx_gnss_context_status_bytestream_t context_status_buffer)
+{
+    memset(context_status_buffer, 0, LR11XX_GNSS_CONTEXT_STATUS_LENGTH);
+    for (int i = 0; i < 4; ++i)
+    {
+        context_status_buffer[3 + i] = (uint8_t)(stub_gnss_almanac_crc >> (8 * i));
+    }
+
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_parse_context_status_buffer(const lr11xx_gnss_context_status_bytestream_t context_status_bytestream, lr11xx_gnss_context_status_t* context_status)
+{
+    memset(context_status, 0, sizeof(*context_status));
+    for (int i = 0; i < 4; ++i)
+    {
+        context_status->global_almanac_crc |= (uint32_t)context_status_bytestream[3 + i] << (8 * i);
+    }
+    context_status->freq_search_space = LR11XX_GNSS_FREQUENCY_SEARCH_SPACE_250_HZ;
+
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_read_freq_search_space(const void* radio, lr11xx_gnss_freq_search_space_t* freq_search_space)
+{
+    *freq_search_space = LR11XX_GNSS_FREQUENCY_SEARCH_SPACE_250_HZ;
+    return LR11XX_STATUS_OK;
+}
+
+// No scan is run on the host, the scan and result accessors succeed with nothing detected
+
+uint32_t lr11xx_gnss_get_consumption(lr11xx_system_reg_mode_t regulator, lr11xx_gnss_timings_t timings, lr11xx_gnss_constellation_mask_t constellations_used)
+{
+    return 0;
+}
+
+lr11xx_status_t lr11xx_gnss_get_timings(const void* context, lr11xx_gnss_timings_t* timings)
+{
+    memset(timings, 0, sizeof(*timings));
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_get_result_size(const void* context, uint16_t* result_size)
+{
+    *result_size = 0;
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_read_results(const void* context, uint8_t* result_buffer, const uint16_t result_buffer_size)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_get_nb_detected_satellites(const void* context, uint8_t* nb_detected_satellites)
+{
+    *nb_detected_satellites = 0;
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_get_detected_satellites(const void* context, const uint8_t nb_detected_satellites, lr11xx_gnss_detected_satellite_t* detected_satellite_id_snr_doppler)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_scan_assisted(const void* context, const lr11xx_gnss_date_t date, const lr11xx_gnss_search_mode_t effort_mode, const uint8_t gnss_input_parameters, const uint8_t nb_sat)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_scan_autonomous(const void* context, const lr11xx_gnss_date_t date, const lr11xx_gnss_search_mode_t effort_mode, const uint8_t gnss_input_parameters, const uint8_t nb_sat)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_set_scan_mode(const void* context, const lr11xx_gnss_scan_mode_t scan_mode)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_set_constellations_to_use(const void* context, const lr11xx_gnss_constellation_mask_t constellation_mask)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_read_used_constellations(const void* context, lr11xx_gnss_constellation_mask_t* constellations_used)
+{
+    *constellations_used = LR11XX_GNSS_GPS_MASK | LR11XX_GNSS_BEIDOU_MASK;
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_set_freq_search_space(const void* radio, const lr11xx_gnss_freq_search_space_t freq_search_space)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_set_assistance_position(const void* context, const lr11xx_gnss_solver_assistance_position_t* assistance_position)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_read_assistance_position(const void* context, lr11xx_gnss_solver_assistance_position_t* assistance_position)
+{
+    memset(assistance_position, 0, sizeof(*assistance_position));
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_gnss_push_solver_msg(const void* context, const uint8_t* payload, const uint16_t payload_size)
+{
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_system_set_dio_irq_params(const void* context, const lr11xx_system_irq_mask_t irqs_to_enable_dio1, const lr11xx_system_irq_mask_t irqs_to_enable_dio2)
+{
+    return LR11XX_STATUS_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Middleware board and radio hooks
+
+void mw_bsp_gnss_prescan_actions(void)
+{
+}
+
+void mw_bsp_gnss_postscan_actions(void)
+{
+}
+
+void mw_bsp_get_lr11xx_reg_mode(const void* context, lr11xx_system_reg_mode_t* reg_mode)
+{
+    *reg_mode = LR11XX_SYSTEM_REG_MODE_DCDC;
+}
+
+bool mw_radio_configure_for_scan(const void* radio_context)
+{
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
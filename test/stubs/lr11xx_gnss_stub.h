@@ -0,0 +1,41 @@
+/*
+ * lr11xx_gnss_stub.h
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <stddef.h>
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_gnss.h"
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_system.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Host model of the GNSS part of the LR11xx driver, the tests drive it through these
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of visible satellites from a date on, as the LR11xx reports them for a fixed position
+typedef struct
+{
+    uint32_t date;
+    uint8_t nb_gps;
+    uint8_t nb_beidou;
+} stub_gnss_visibility_t;
+
+extern uint32_t stub_gnss_almanac_crc;
+extern int stub_gnss_visibility_requests;       // lr11xx_gnss_get_nb_visible_satellites calls
+
+// Entries sorted by date, the last one at or before the requested date applies
+void stub_gnss_set_visibility(const stub_gnss_visibility_t* visibility, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,104 @@
+/*
+ * smtc_modem_hal_stub.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "smtc_modem_hal_stub.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Controlled by the tests
+
+uint32_t stub_hal_time_ms = 0;
+int8_t stub_hal_temperature = 25;
+uint32_t (*stub_hal_random_in_range)(uint32_t val_1, uint32_t val_2) = NULL;
+
+static uint32_t random_state = 1;
+
+void stub_hal_seed_random(uint32_t seed)
+{
+    random_state = seed != 0 ? seed : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// smtc_modem_hal
+
+uint32_t smtc_modem_hal_get_time_in_s(void)
+{
+    return stub_hal_time_ms / 1000;
+}
+
+uint32_t smtc_modem_hal_get_time_in_ms(void)
+{
+    return stub_hal_time_ms;
+}
+
+uint32_t smtc_modem_hal_get_time_in_100us(void)
+{
+    return stub_hal_time_ms * 10;
+}
+
+uint32_t smtc_modem_hal_get_random_nb(void)
+{
+    // xorshift32, reproducible across hosts
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+uint32_t smtc_modem_hal_get_random_nb_in_range(const uint32_t val_1, const uint32_t val_2)
+{
+    if (stub_hal_random_in_range != NULL) return stub_hal_random_in_range(val_1, val_2);
+
+    if (val_1 <= val_2) return val_1 + smtc_modem_hal_get_random_nb() % (val_2 - val_1 + 1);
+    return val_2 + smtc_modem_hal_get_random_nb() % (val_1 - val_2 + 1);
+}
+
+int32_t smtc_modem_hal_get_signed_random_nb_in_range(const int32_t val_1, const int32_t val_2)
+{
+    const int32_t low = val_1 <= val_2 ? val_1 : val_2;
+    const int32_t high = val_1 <= val_2 ? val_2 : val_1;
+    return low + (int32_t)(smtc_modem_hal_get_random_nb() % (uint32_t)(high - low + 1));
+}
+
+int8_t smtc_modem_hal_get_temperature(void)
+{
+    return stub_hal_temperature;
+}
+
+// Panics store a crashlog and reset, the test stops there
+void smtc_modem_hal_reset_mcu(void)
+{
+    printf("mcu reset\n");
+    fflush(stdout);
+    abort();
+}
+
+void smtc_modem_hal_store_crashlog(uint8_t crashlog[CRASH_LOG_SIZE])
+{
+    printf("crashlog: %.*s\n", CRASH_LOG_SIZE, (const char*)crashlog);
+}
+
+void smtc_modem_hal_set_crashlog_status(bool available)
+{
+}
+
+void smtc_modem_hal_assert_fail(uint8_t* func, uint32_t line)
+{
+    printf("assert failed in %s:%u\n", (const char*)func, (unsigned)line);
+    abort();
+}
+
+void smtc_modem_hal_print_trace(const char* fmt, ...)
+{
+    (void)fmt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
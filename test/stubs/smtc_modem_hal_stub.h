@@ -0,0 +1,31 @@
+/*
+ * smtc_modem_hal_stub.h
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include "lbm/smtc_modem_hal/smtc_modem_hal.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Host implementation of smtc_modem_hal, the tests drive it through these
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uint32_t stub_hal_time_ms;
+extern int8_t stub_hal_temperature;
+extern uint32_t (*stub_hal_random_in_range)(uint32_t val_1, uint32_t val_2);    // NULL for the default xorshift
+
+void stub_hal_seed_random(uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,56 @@
+/*
+ * test_utils.h
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ */
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <stdio.h>
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Check macros
+
+static int test_failures = 0;
+
+#define TEST_CHECK(cond)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+            ++test_failures;                                                    \
+        }                                                                       \
+    } while (0)
+
+#define TEST_CHECK_EQUAL(expected, actual)                                                              \
+    do                                                                                                  \
+    {                                                                                                   \
+        long long e_ = (long long)(expected);                                                           \
+        long long a_ = (long long)(actual);                                                             \
+        if (e_ != a_)                                                                                   \
+        {                                                                                               \
+            printf("%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_);          \
+            ++test_failures;                                                                            \
+        }                                                                                               \
+    } while (0)
+
+// Returns the process exit code
+#define TEST_END()                                                              \
+    (printf("%s\n", test_failures == 0 ? "PASSED" : "FAILED"), test_failures == 0 ? 0 : 1)
+
+////////////////////////////////////////////////////////////////////////////////
+// Host time measurement
+
+static inline double test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
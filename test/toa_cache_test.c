@@ -0,0 +1,337 @@
+/*
+ * toa_cache_test.c
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Checks the time on air cache against the full uplink parameters, for every region, datarate and payload size
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <string.h>
+#include "test_utils.h"
+#include "lbm/smtc_modem_core/lr1mac/src/services/smtc_toa_cache.h"
+#include "lbm/smtc_modem_core/lr1mac/src/smtc_real/src/smtc_real.h"
+#include "lbm/smtc_modem_core/lr1mac/src/smtc_real/src/smtc_real_defs.h"
+#include "lbm/smtc_modem_core/lr1mac/src/services/smtc_duty_cycle.h"
+#include "lbm/smtc_modem_core/smtc_ral/src/ral.h"
+#include "lbm/smtc_modem_core/smtc_ral/src/ral_lr11xx.h"
+#include "lbm/smtc_modem_core/smtc_ral/src/ral_lr11xx_bsp.h"
+#include "lbm/smtc_modem_core/smtc_ralf/src/ralf_defs.h"
+#include "lbm/smtc_modem_core/radio_drivers/lr11xx_driver/src/lr11xx_hal.h"
+#include "lbm/smtc_modem_hal/smtc_modem_hal.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Fakes
+
+// The time on air is computed on the host, the transceiver is never accessed
+static int fake_transceiver_accesses = 0;
+
+lr11xx_hal_status_t lr11xx_hal_write(const void* context, const uint8_t* command, const uint16_t command_length, const uint8_t* data, const uint16_t data_length)
+{
+    ++fake_transceiver_accesses;
+    return LR11XX_HAL_STATUS_ERROR;
+}
+
+lr11xx_hal_status_t lr11xx_hal_read(const void* context, const uint8_t* command, const uint16_t command_length, uint8_t* data, const uint16_t data_length)
+{
+    ++fake_transceiver_accesses;
+    return LR11XX_HAL_STATUS_ERROR;
+}
+
+lr11xx_hal_status_t lr11xx_hal_direct_read(const void* context, uint8_t* data, const uint16_t data_length)
+{
+    ++fake_transceiver_accesses;
+    return LR11XX_HAL_STATUS_ERROR;
+}
+
+lr11xx_hal_status_t lr11xx_hal_reset(const void* context)
+{
+    ++fake_transceiver_accesses;
+    return LR11XX_HAL_STATUS_ERROR;
+}
+
+lr11xx_hal_status_t lr11xx_hal_wakeup(const void* context)
+{
+    ++fake_transceiver_accesses;
+    return LR11XX_HAL_STATUS_ERROR;
+}
+
+void ral_lr11xx_bsp_get_rf_switch_cfg(const void* context, lr11xx_system_rfswitch_cfg_t* rf_switch_cfg)
+{
+    ++fake_transceiver_accesses;
+}
+
+void ral_lr11xx_bsp_get_tx_cfg(const void* context, const ral_lr11xx_bsp_tx_cfg_input_params_t* input_params, ral_lr11xx_bsp_tx_cfg_output_params_t* output_params)
+{
+    ++fake_transceiver_accesses;
+}
+
+void ral_lr11xx_bsp_get_reg_mode(const void* context, lr11xx_system_reg_mode_t* reg_mode)
+{
+    ++fake_transceiver_accesses;
+}
+
+void ral_lr11xx_bsp_get_xosc_cfg(const void* context, ral_xosc_cfg_t* xosc_cfg, lr11xx_system_tcxo_supply_voltage_t* supply_voltage, uint32_t* startup_time_in_tick)
+{
+    ++fake_transceiver_accesses;
+}
+
+void ral_lr11xx_bsp_get_crc_state(const void* context, bool* crc_is_activated)
+{
+    ++fake_transceiver_accesses;
+}
+
+void ral_lr11xx_bsp_get_rssi_calibration_table(const void* context, const uint32_t freq_in_hz, lr11xx_radio_rssi_calibration_table_t* rssi_calibration_table)
+{
+    ++fake_transceiver_accesses;
+}
+
+void ral_lr11xx_bsp_get_consumption_calibration(const void* context, ral_lr11xx_bsp_consumption_calibration_t* calibration)
+{
+    ++fake_transceiver_accesses;
+}
+
+// Regions without duty cycle ask for it when their channels are drawn, not used here
+bool smtc_duty_cycle_is_channel_free(smtc_dtc_t* dtc_obj, uint32_t freq_hz)
+{
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Time on air
+
+static const ral_t ral = RAL_LR11XX_INSTANTIATE(NULL);
+static smtc_real_t real;
+
+// Parameters of lr1_stack_mac_tx_radio_start, the toa the radio planner got before the cache
+static uint32_t tx_path_toa(uint8_t dr, uint32_t frequency, uint8_t payload_size)
+{
+    uint32_t toa = 0;
+    switch (smtc_real_get_modulation_type_from_datarate(&real, dr))
+    {
+    case LORA:
+    {
+        uint8_t sf;
+        lr1mac_bandwidth_t bw;
+        smtc_real_lora_dr_to_sf_bw(&real, dr, &sf, &bw);
+
+        ralf_params_lora_t lora_param;
+        memset(&lora_param, 0, sizeof(lora_param));
+        lora_param.rf_freq_in_hz = frequency;
+        lora_param.sync_word = smtc_real_get_sync_word(&real);
+        lora_param.output_pwr_in_dbm = 14;
+        lora_param.mod_params.sf = (ral_lora_sf_t)sf;
+        lora_param.mod_params.bw = (ral_lora_bw_t)bw;
+        lora_param.mod_params.cr = smtc_real_get_coding_rate(&real);
+        lora_param.mod_params.ldro = ral_compute_lora_ldro(lora_param.mod_params.sf, lora_param.mod_params.bw);
+        lora_param.pkt_params.preamble_len_in_symb = smtc_real_get_preamble_len(&real, lora_param.mod_params.sf);
+        lora_param.pkt_params.header_type = RAL_LORA_PKT_EXPLICIT;
+        lora_param.pkt_params.pld_len_in_bytes = payload_size;
+        lora_param.pkt_params.crc_is_on = true;
+        lora_param.pkt_params.invert_iq_is_on = false;
+        toa = ral_get_lora_time_on_air_in_ms(&ral, &lora_param.pkt_params, &lora_param.mod_params);
+        break;
+    }
+    case FSK:
+    {
+        uint8_t bitrate;
+        smtc_real_fsk_dr_to_bitrate(&real, dr, &bitrate);
+
+        ralf_params_gfsk_t gfsk_param;
+        memset(&gfsk_param, 0, sizeof(gfsk_param));
+        gfsk_param.dc_free_is_on = true;
+        gfsk_param.rf_freq_in_hz = frequency;
+        gfsk_param.sync_word = smtc_real_get_gfsk_sync_word(&real);
+        gfsk_param.output_pwr_in_dbm = 14;
+        gfsk_param.pkt_params.header_type = RAL_GFSK_PKT_VAR_LEN;
+        gfsk_param.pkt_params.pld_len_in_bytes = payload_size;
+        gfsk_param.pkt_params.preamble_len_in_bits = 40;
+        gfsk_param.pkt_params.sync_word_len_in_bits = 24;
+        gfsk_param.pkt_params.dc_free = RAL_GFSK_DC_FREE_WHITENING;
+        gfsk_param.pkt_params.crc_type = RAL_GFSK_CRC_2_BYTES_INV;
+        gfsk_param.mod_params.fdev_in_hz = 25000;
+        gfsk_param.mod_params.br_in_bps = bitrate * 1000;
+        gfsk_param.mod_params.bw_dsb_in_hz = 100000;
+        gfsk_param.mod_params.pulse_shape = RAL_GFSK_PULSE_SHAPE_BT_1;
+        toa = ral_get_gfsk_time_on_air_in_ms(&ral, &gfsk_param.pkt_params, &gfsk_param.mod_params);
+        break;
+    }
+    case LR_FHSS:
+    {
+        lr_fhss_v1_cr_t cr;
+        lr_fhss_v1_bw_t bw;
+        smtc_real_lr_fhss_dr_to_cr_bw(&real, dr, &cr, &bw);
+
+        ralf_params_lr_fhss_t lr_fhss_param;
+        memset(&lr_fhss_param, 0, sizeof(lr_fhss_param));
+        lr_fhss_param.output_pwr_in_dbm = 14;
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.modulation_type = LR_FHSS_V1_MODULATION_TYPE_GMSK_488;
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.cr = cr;
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.grid = smtc_real_lr_fhss_get_grid(&real);
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.enable_hopping = true;
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.bw = bw;
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.header_count = smtc_real_lr_fhss_get_header_count(cr);
+        lr_fhss_param.ral_lr_fhss_params.lr_fhss_params.sync_word = smtc_real_get_lr_fhss_sync_word(&real);
+        lr_fhss_param.ral_lr_fhss_params.center_frequency_in_hz = frequency;
+        TEST_CHECK_EQUAL(RAL_STATUS_OK, ral_lr_fhss_get_time_on_air_in_ms(&ral, &lr_fhss_param.ral_lr_fhss_params, payload_size, &toa));
+        break;
+    }
+    default:
+        TEST_CHECK(false);
+        break;
+    }
+    return toa;
+}
+
+// As lr1_stack_toa_get_for_payload_size
+static uint32_t cached_toa(smtc_toa_cache_t* cache, uint8_t dr, uint8_t payload_size, int* misses)
+{
+    uint32_t toa = 0;
+    if (!smtc_toa_cache_get(cache, real.region_type, dr, payload_size, &toa))
+    {
+        toa = smtc_toa_cache_compute(&real, &ral, dr, payload_size);
+        smtc_toa_cache_set(cache, real.region_type, dr, payload_size, toa);
+        ++*misses;
+    }
+    return toa;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+#define NB_PAYLOAD_SIZES 256
+#define NB_DATARATES 16
+
+static uint32_t expected[NB_DATARATES][NB_PAYLOAD_SIZES];
+static bool is_valid[NB_DATARATES];
+
+// Expected toa of every uplink of the current region, checked not to depend on the channel
+static int load_region(uint8_t region)
+{
+    smtc_real_init(&real, (smtc_real_region_types_t)region);
+
+    int nb_datarates = 0;
+    for (uint8_t dr = 0; dr < NB_DATARATES; ++dr)
+    {
+        is_valid[dr] = smtc_real_is_tx_dr_valid(&real, dr) == OKLORAWAN;
+        if (!is_valid[dr]) continue;
+
+        ++nb_datarates;
+        const uint32_t frequencies[] = { real.real_const.const_freq_min, (real.real_const.const_freq_min + real.real_const.const_freq_max) / 2, real.real_const.const_freq_max };
+        for (int size = 0; size < NB_PAYLOAD_SIZES; ++size)
+        {
+            expected[dr][size] = tx_path_toa(dr, frequencies[0], size);
+            TEST_CHECK(expected[dr][size] > 0);
+            for (size_t f = 1; f < sizeof(frequencies) / sizeof(frequencies[0]); ++f)
+            {
+                TEST_CHECK_EQUAL(expected[dr][size], tx_path_toa(dr, frequencies[f], size));
+            }
+        }
+    }
+    return nb_datarates;
+}
+
+static void test_all_uplinks(void)
+{
+    // One cache through all the regions, entries of the others are evicted or ignored
+    smtc_toa_cache_t cache;
+    smtc_toa_cache_init(&cache);
+
+    int nb_regions = 0;
+    int nb_lookups = 0;
+    for (uint8_t r = 0; r < SMTC_REAL_REGION_LIST_LENGTH; ++r)
+    {
+        TEST_CHECK(load_region(smtc_real_region_list[r]) > 0);
+        ++nb_regions;
+
+        // Sequential: each entry is evicted by the next payload sizes, then hit again
+        int misses = 0;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (uint8_t dr = 0; dr < NB_DATARATES; ++dr)
+            {
+                if (!is_valid[dr]) continue;
+                for (int size = 0; size < NB_PAYLOAD_SIZES; ++size)
+                {
+                    TEST_CHECK_EQUAL(expected[dr][size], cached_toa(&cache, dr, size, &misses));
+                    TEST_CHECK_EQUAL(expected[dr][size], cached_toa(&cache, dr, size, &misses));
+                    nb_lookups += 2;
+                }
+            }
+        }
+
+        // Random: hits and misses of any datarate and size in any order
+        for (int i = 0; i < 20000; ++i)
+        {
+            const uint8_t dr = smtc_modem_hal_get_random_nb_in_range(0, NB_DATARATES - 1);
+            const uint8_t size = smtc_modem_hal_get_random_nb_in_range(0, NB_PAYLOAD_SIZES - 1);
+            if (!is_valid[dr]) continue;
+            TEST_CHECK_EQUAL(expected[dr][size], cached_toa(&cache, dr, size, &misses));
+            ++nb_lookups;
+        }
+        TEST_CHECK(misses < nb_lookups);
+    }
+    TEST_CHECK_EQUAL(SMTC_REAL_REGION_LIST_LENGTH, nb_regions);
+    TEST_CHECK(nb_lookups > 0);
+    TEST_CHECK_EQUAL(0, fake_transceiver_accesses);
+}
+
+static void test_region_keying(void)
+{
+    // Same datarate and size in two regions with different toa: the other region's entry is not returned
+    smtc_toa_cache_t cache;
+    smtc_toa_cache_init(&cache);
+    int misses = 0;
+
+    load_region(SMTC_REAL_REGION_EU_868);
+    const uint32_t eu868 = cached_toa(&cache, 0, 51, &misses);
+    load_region(SMTC_REAL_REGION_US_915);
+    const uint32_t us915 = cached_toa(&cache, 0, 51, &misses);
+    TEST_CHECK(eu868 != us915);
+    TEST_CHECK_EQUAL(expected[0][51], us915);
+    TEST_CHECK_EQUAL(2, misses);
+
+    // Init forgets everything
+    TEST_CHECK_EQUAL(us915, cached_toa(&cache, 0, 51, &misses));
+    TEST_CHECK_EQUAL(2, misses);
+    smtc_toa_cache_init(&cache);
+    cached_toa(&cache, 0, 51, &misses);
+    TEST_CHECK_EQUAL(3, misses);
+}
+
+static void test_entry_sharing(void)
+{
+    // Keys sharing an entry: region types 16 apart, datarates 16 apart, or sizes shifted by the other fields
+    smtc_toa_cache_t cache;
+    smtc_toa_cache_init(&cache);
+    uint32_t toa = 0;
+
+    smtc_toa_cache_set(&cache, SMTC_REAL_REGION_EU_868, 0, 51, 100);
+    TEST_CHECK(!smtc_toa_cache_get(&cache, SMTC_REAL_REGION_AS_923_HELIUM_4, 0, 51, &toa));
+    TEST_CHECK(!smtc_toa_cache_get(&cache, SMTC_REAL_REGION_EU_868, 16, 51, &toa));
+    TEST_CHECK(!smtc_toa_cache_get(&cache, SMTC_REAL_REGION_EU_868, 1, 51 - 5, &toa));
+    TEST_CHECK(smtc_toa_cache_get(&cache, SMTC_REAL_REGION_EU_868, 0, 51, &toa));
+    TEST_CHECK_EQUAL(100, toa);
+
+    // The last one stored wins
+    smtc_toa_cache_set(&cache, SMTC_REAL_REGION_AS_923_HELIUM_4, 0, 51, 200);
+    TEST_CHECK(!smtc_toa_cache_get(&cache, SMTC_REAL_REGION_EU_868, 0, 51, &toa));
+    TEST_CHECK(smtc_toa_cache_get(&cache, SMTC_REAL_REGION_AS_923_HELIUM_4, 0, 51, &toa));
+    TEST_CHECK_EQUAL(200, toa);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(void)
+{
+    test_all_uplinks();
+    test_region_keying();
+    test_entry_sharing();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,117 @@
+/*
+ * watchdog_test.cpp
+ * Copyright (C) 2023 Seeed K.K.
+ * MIT License
+ *
+ * Heartbeat bookkeeping of the watchdog clients, including a transceiver wait preempted by an interrupt
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+
+#include <cstring>
+#include "test_utils.h"
+#include "internal/Watchdog.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+static uint8_t id(Watchdog::Client client)
+{
+    return static_cast<uint8_t>(client);
+}
+
+static void test_idle()
+{
+    Watchdog watchdog;
+
+    TEST_CHECK(watchdog.isHealthy(0));
+    TEST_CHECK(watchdog.isHealthy(UINT32_MAX));
+    TEST_CHECK_EQUAL(Watchdog::NO_CLIENT, watchdog.findStarved(UINT32_MAX));
+}
+
+static void test_deadlines()
+{
+    Watchdog watchdog;
+
+    watchdog.heartbeat(Watchdog::Client::APP, 0, 2000);
+    watchdog.heartbeat(Watchdog::Client::TRANSCEIVER, 100, 500);
+    TEST_CHECK(watchdog.isHealthy(600));
+    TEST_CHECK(!watchdog.isHealthy(601));
+
+    // Both late: the one the furthest past its deadline is blamed
+    TEST_CHECK_EQUAL(id(Watchdog::Client::TRANSCEIVER), watchdog.findStarved(2001));
+    // Both on time: the closest to its deadline is blamed
+    TEST_CHECK_EQUAL(id(Watchdog::Client::TRANSCEIVER), watchdog.findStarved(550));
+
+    // A released client is always healthy
+    watchdog.release(Watchdog::Client::TRANSCEIVER);
+    TEST_CHECK(watchdog.isHealthy(2000));
+    TEST_CHECK(!watchdog.isHealthy(2001));
+    TEST_CHECK_EQUAL(id(Watchdog::Client::APP), watchdog.findStarved(2001));
+
+    // A new beat restarts the deadline
+    watchdog.heartbeat(Watchdog::Client::APP, 1900, 2000);
+    TEST_CHECK(watchdog.isHealthy(3900));
+    TEST_CHECK(!watchdog.isHealthy(3901));
+}
+
+static void test_time_wrap()
+{
+    Watchdog watchdog;
+
+    watchdog.heartbeat(Watchdog::Client::SUPERVISOR, 0xfffffff0u, 100);
+    TEST_CHECK(watchdog.isHealthy(0x10));
+    TEST_CHECK(watchdog.isHealthy(0x54));
+    TEST_CHECK(!watchdog.isHealthy(0x55));
+}
+
+static void test_transceiver_wait_preempted()
+{
+    Watchdog watchdog;
+
+    // The main loop waits for BUSY, a radio interrupt accesses the transceiver in the middle and is done first
+    watchdog.heartbeat(Watchdog::Client::TRANSCEIVER, 1000, 100);
+    watchdog.heartbeat(Watchdog::Client::TRANSCEIVER_IRQ, 1010, 100);
+    watchdog.release(Watchdog::Client::TRANSCEIVER_IRQ);
+
+    // The main loop wait is still watched: stuck BUSY starves the watchdog and is blamed
+    TEST_CHECK(watchdog.isHealthy(1100));
+    TEST_CHECK(!watchdog.isHealthy(1101));
+    TEST_CHECK_EQUAL(id(Watchdog::Client::TRANSCEIVER), watchdog.findStarved(1101));
+
+    // Stuck BUSY in the interrupt is blamed on it
+    watchdog.release(Watchdog::Client::TRANSCEIVER);
+    watchdog.heartbeat(Watchdog::Client::TRANSCEIVER_IRQ, 2000, 100);
+    TEST_CHECK(!watchdog.isHealthy(2101));
+    TEST_CHECK_EQUAL(id(Watchdog::Client::TRANSCEIVER_IRQ), watchdog.findStarved(2101));
+}
+
+static void test_names()
+{
+    TEST_CHECK(strcmp("watchdog:supervisor", Watchdog::getName(id(Watchdog::Client::SUPERVISOR))) == 0);
+    TEST_CHECK(strcmp("watchdog:trx_irq", Watchdog::getName(id(Watchdog::Client::TRANSCEIVER_IRQ))) == 0);
+    TEST_CHECK(strcmp("watchdog", Watchdog::getName(Watchdog::NO_CLIENT)) == 0);
+
+    // Names are stored as the crash function, at most 20 characters
+    for (size_t i = 0; i < Watchdog::CLIENT_COUNT; ++i)
+    {
+        TEST_CHECK(strlen(Watchdog::getName(i)) <= 20);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main()
+{
+    test_idle();
+    test_deadlines();
+    test_time_wrap();
+    test_transceiver_wait_preempted();
+    test_names();
+
+    return TEST_END();
+}
+
+////////////////////////////////////////////////////////////////////////////////